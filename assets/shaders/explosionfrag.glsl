@@ -1,9 +1,9 @@
 #version 330 core
 
 uniform sampler2D tex;
-uniform float time;
 
 in vec2 tc;
+in float particleAge;
 
 out vec4 color;
 
@@ -13,6 +13,6 @@ void main()
 	color *= mix(
 		vec4(1.0, 1.0, 1.0, 1.0), 
 		vec4(0.1, 0.1, 0.1, 1.0),
-		min(pow(time / 1.5, 3.0), 1.0)
+		min(pow(particleAge / 1.5, 3.0), 1.0)
 	);
 }
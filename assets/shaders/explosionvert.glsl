@@ -1,29 +1,38 @@
 #version 330 core
 
-layout(location = 0) in vec4 pos;
+layout (std140) uniform FrameData {
+	mat4 persp;
+	mat4 view;
+	vec3 lightdir;
+	float time;
+	vec3 camerapos;
+	float viewdist;
+};
 
-uniform mat4 persp;
-uniform mat4 view;
-uniform mat4 transform;
-uniform float time;
-uniform float scale;
+layout(location = 0) in vec4 pos;
+layout(location = 1) in vec4 emitter;   // xyz = center, w = age
+layout(location = 2) in vec2 particle;  // x = scale, y = particle id
 
 const float SPEED = 16.0;
 
 out vec2 tc;
+out float particleAge;
 
 void main()
 {	
-	float id = float(gl_InstanceID);
+	float id = particle.y;
+	float age = emitter.w;
+	float scale = particle.x;
+	particleAge = age;
 
 	vec3 cameraRightWorldSpace = vec3(view[0][0], view[1][0], view[2][0]);
 	vec3 cameraUpWorldSpace = vec3(view[0][1], view[1][1], view[2][1]);
-	vec4 center = transform * vec4(0.0, 0.0, 0.0, 1.0);
+	vec4 center = vec4(emitter.xyz, 1.0);
 	float maxsz = 16.0 + cos(id) * 6.0;
-	float sz = (maxsz - maxsz * pow(1.0 - time, 2.0)) * scale;
+	float sz = (maxsz - maxsz * pow(1.0 - age, 2.0)) * scale;
 
 	float rotationSpeed = sin(id * cos(id)) * 3.14 / 4.0;
-	float rotation = rotationSpeed * time;
+	float rotation = rotationSpeed * age;
 
 	vec2 p = vec2(
 		pos.x * cos(rotation) - pos.z * sin(rotation),
@@ -47,7 +56,7 @@ void main()
 		cos(angle1) * cos(angle2) * SPEED, 
 		SPEED / 2.0,
 		cos(angle1) * sin(angle2) * SPEED
-	) * time * scale;
+	) * age * scale;
 
 	gl_Position = persp * view * vec4(vertPosWorldSpace.xyz, 1.0);
 
@@ -0,0 +1,24 @@
+#version 330 core
+
+uniform sampler2D grasstexture;
+uniform sampler2D shrubtexture;
+
+in vec2 tc;
+in float kind;
+in float lighting;
+
+out vec4 color;
+
+void main()
+{
+	// One draw covers both kinds, pick the texture per instance
+	vec4 grass = texture(grasstexture, tc);
+	vec4 shrub = texture(shrubtexture, tc);
+	color = mix(grass, shrub, step(0.5, kind));
+
+	if(color.a < 0.5)
+		discard;
+
+	color.rgb *= lighting;
+	color.a = 1.0;
+}
@@ -0,0 +1,44 @@
+#version 330 core
+
+layout (std140) uniform FrameData {
+	mat4 persp;
+	mat4 view;
+	vec3 lightdir;
+	float time;
+	vec3 camerapos;
+	float viewdist;
+};
+
+layout(location = 0) in vec3 pos;
+layout(location = 1) in vec2 texcoord;
+layout(location = 2) in vec4 instance;   // xyz = position, w = scale
+layout(location = 3) in vec4 params;     // x = rotation, y = kind, z = tint, w = sway phase
+
+uniform float fadestart;
+uniform float fadeend;
+
+out vec2 tc;
+out float kind;
+out float lighting;
+
+void main()
+{
+	// Shrink instances towards the end of the falloff so thinning doesn't pop
+	float d = length(instance.xz - camerapos.xz);
+	float fade = 1.0 - clamp((d - fadestart) / (fadeend - fadestart), 0.0, 1.0);
+	float scale = instance.w * (0.4 + 0.6 * fade);
+
+	float c = cos(params.x), s = sin(params.x);
+	vec3 p = vec3(c * pos.x + s * pos.z, pos.y, -s * pos.x + c * pos.z) * scale;
+
+	// Wind: only the top edge moves
+	p.x += sin(time * 1.7 + params.w) * 0.15 * pos.y * scale;
+	p.z += cos(time * 1.3 + params.w) * 0.1 * pos.y * scale;
+
+	vec4 worldpos = vec4(instance.xyz + p, 1.0);
+	gl_Position = persp * view * worldpos;
+
+	tc = texcoord;
+	kind = params.y;
+	lighting = (max(-lightdir.y, 0.0) * 0.4 + 0.6) * params.z;
+}
@@ -1,14 +1,20 @@
 #version 330 core
 
+layout (std140) uniform FrameData {
+	mat4 persp;
+	mat4 view;
+	vec3 lightdir;
+	float time;
+	vec3 camerapos;
+	float viewdist;
+};
+
 in vec3 fragPos;
 in vec3 fragNormal;
 in vec2 fragTexCoord;
 
 out vec4 color;
 
-uniform vec3 lightdir;
-uniform vec3 camerapos;
-
 // Material properties
 uniform vec3 material_ambient;
 uniform vec3 material_diffuse;
@@ -1,21 +1,44 @@
 #version 330 core
 
+layout (std140) uniform FrameData {
+	mat4 persp;
+	mat4 view;
+	vec3 lightdir;
+	float time;
+	vec3 camerapos;
+	float viewdist;
+};
+
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec3 normal;
 layout(location = 2) in vec2 texcoord;
 
-uniform mat4 persp;
-uniform mat4 view;
 uniform mat4 transform;
 
+// Vertex decode (see vertex_format.h): compact meshes store quantized
+// positions and octahedral normals, float meshes use offset 0, scale 1
+uniform vec3 position_offset;
+uniform vec3 position_scale;
+uniform float normal_scale;     // 0 = float normals
+
+vec3 decode_normal(vec3 stored) {
+    if (normal_scale == 0.0) return stored;
+    vec2 e = clamp(stored.xy * normal_scale, -1.0, 1.0);
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
 out vec3 fragPos;
 out vec3 fragNormal;
 out vec2 fragTexCoord;
 
 void main() {
-    vec4 worldPos = transform * vec4(position, 1.0);
+    vec4 worldPos = transform * vec4(position_offset + position * position_scale, 1.0);
     fragPos = worldPos.xyz;
-    fragNormal = mat3(transpose(inverse(transform))) * normal;
+    fragNormal = mat3(transpose(inverse(transform))) * decode_normal(normal);
     fragTexCoord = texcoord;
     gl_Position = persp * view * worldPos;
 }
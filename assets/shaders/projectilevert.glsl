@@ -0,0 +1,52 @@
+#version 330 core
+
+layout (std140) uniform FrameData {
+	mat4 persp;
+	mat4 view;
+	vec3 lightdir;
+	float time;
+	vec3 camerapos;
+	float viewdist;
+};
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 texcoord;
+layout(location = 3) in vec4 instance;   // xyz = position, w = scale
+layout(location = 4) in vec3 direction;  // Unit flight direction
+
+// Vertex decode (see vertex_format.h): compact meshes store quantized
+// positions and octahedral normals, float meshes use offset 0, scale 1
+uniform vec3 position_offset;
+uniform vec3 position_scale;
+uniform float normal_scale;     // 0 = float normals
+
+vec3 decode_normal(vec3 stored) {
+	if (normal_scale == 0.0) return stored;
+	vec2 e = clamp(stored.xy * normal_scale, -1.0, 1.0);
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	if (n.z < 0.0) {
+		n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	}
+	return normalize(n);
+}
+
+out vec3 fragPos;
+out vec3 fragNormal;
+out vec2 fragTexCoord;
+
+void main() {
+	// Basis with the model's +Z along the flight direction
+	vec3 forward = direction;
+	vec3 up = abs(forward.y) > 0.99 ? vec3(1.0, 0.0, 0.0) : vec3(0.0, 1.0, 0.0);
+	vec3 right = normalize(cross(up, forward));
+	up = cross(forward, right);
+	mat3 basis = mat3(right, up, forward);
+
+	vec3 local = position_offset + position * position_scale;
+	vec3 worldPos = instance.xyz + basis * (local * instance.w);
+	fragPos = worldPos;
+	fragNormal = basis * decode_normal(normal);
+	fragTexCoord = texcoord;
+	gl_Position = persp * view * vec4(worldPos, 1.0);
+}
@@ -1,15 +1,22 @@
 #version 330 core
 
-layout(location = 0) in vec4 pos;
+layout (std140) uniform FrameData {
+	mat4 persp;
+	mat4 view;
+	vec3 lightdir;
+	float time;
+	vec3 camerapos;
+	float viewdist;
+};
 
-uniform mat4 persp;
-uniform mat4 view;
+layout(location = 0) in vec4 pos;
 
 out vec3 fragpos;
 
 void main()
 {
-	vec4 p = persp * view * pos;
+	// Rotation only, the sky stays centered on the camera
+	vec4 p = persp * mat4(mat3(view)) * pos;
 	gl_Position = p.xyww;
 	fragpos = pos.xyz;
 }
@@ -1,6 +1,11 @@
 #version 330 core
 
-layout (std140) uniform GlobalVals {
+layout (std140) uniform FrameData {
+	mat4 persp;
+	mat4 view;
+	vec3 lightdir;
+	float time;
+	vec3 camerapos;
 	float viewdist;
 };
 
@@ -10,10 +15,6 @@ in float lighting;
 in float height;
 in vec3 fragpos;
 
-uniform float time;
-uniform vec3 lightdir;
-uniform vec3 camerapos;
-
 uniform sampler2D terraintexture;
 
 const float FOG_DIST = 8000.0;
@@ -1,13 +1,19 @@
 #version 330 core
 
+layout (std140) uniform FrameData {
+	mat4 persp;
+	mat4 view;
+	vec3 lightdir;
+	float time;
+	vec3 camerapos;
+	float viewdist;
+};
+
 layout(location = 0) in float y;
 layout(location = 1) in vec2 norm;
 
-uniform mat4 persp;
-uniform mat4 view;
 uniform mat4 transform;
 
-uniform vec3 lightdir;
 uniform float maxheight;
 uniform float chunksz;
 uniform int prec;
@@ -1,6 +1,11 @@
 #version 330 core
 
-layout (std140) uniform GlobalVals {
+layout (std140) uniform FrameData {
+	mat4 persp;
+	mat4 view;
+	vec3 lightdir;
+	float time;
+	vec3 camerapos;
 	float viewdist;
 };
 
@@ -13,8 +18,6 @@ in vec3 normal;
 
 in vec3 fragpos;
 
-uniform vec3 camerapos;
-uniform vec3 lightdir;
 //How strong the specular effect is
 uniform float specularfactor;
 
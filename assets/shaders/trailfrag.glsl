@@ -0,0 +1,13 @@
+#version 330 core
+
+in vec2 tc;
+in float fade;
+
+out vec4 color;
+
+void main()
+{
+	// Soft edges across the ribbon, thinning out with age
+	float edge = 1.0 - tc.x * tc.x;
+	color = vec4(0.95, 0.95, 0.97, 0.55 * edge * fade * fade);
+}
@@ -1,35 +1,55 @@
 #version 330 core
 
-layout(location = 0) in vec4 pos;
-layout(location = 1) in vec2 texcoord;
-layout(location = 2) in vec3 norm;
+layout (std140) uniform FrameData {
+	mat4 persp;
+	mat4 view;
+	vec3 lightdir;
+	float time;
+	vec3 camerapos;
+	float viewdist;
+};
 
-uniform float time;
-uniform vec3 velocity;
+// Every emitter's ring of points: xyz = position, w = emission time (-1 = empty)
+uniform samplerBuffer points;
+uniform int pointcount;
 
-uniform mat4 persp;
-uniform mat4 view;
-uniform mat4 transform;
-uniform mat3 normalmat;
+uniform float now;
+uniform float lifetime;
+uniform float width;
+uniform float spread;
 
-uniform vec3 lightdir;
-out float lighting;
-
-out vec3 fragpos;
 out vec2 tc;
-out vec3 normal;
+out float fade;
 
 void main()
 {
-	float t = min(0.003 * gl_InstanceID, time);
-	vec4 transformed = pos;
-	transformed *= 1.0 / (1.0 + 40.0 * t);
-	transformed.w = 1.0;
-	transformed = transform * transformed;
-	transformed -= t * vec4(velocity.xyz, 0.0);
-	gl_Position = persp * view * transformed;
-	fragpos = transformed.xyz;
-	normal = normalize(normalmat * norm);
-	lighting = max(-dot(lightdir, normal), 0.0) * 0.8 + 0.2;
-	tc = texcoord;
+	// Instance = segment from ring slot k to the next slot of the same ring
+	int ring = gl_InstanceID / pointcount;
+	int k = gl_InstanceID - ring * pointcount;
+	vec4 a = texelFetch(points, ring * pointcount + k);
+	vec4 b = texelFetch(points, ring * pointcount + (k + 1) % pointcount);
+
+	// Skip empty slots, the wrap from newest to oldest point and faded segments
+	if (a.w < 0.0 || b.w <= a.w || now - a.w >= lifetime) {
+		gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+		tc = vec2(0.0);
+		fade = 0.0;
+		return;
+	}
+
+	// Strip corners: vertex 0/1 at a, 2/3 at b, alternating sides
+	vec4 p = (gl_VertexID >= 2) ? b : a;
+	float side = (gl_VertexID & 1) == 0 ? -1.0 : 1.0;
+	float age = max(now - p.w, 0.0);
+
+	// Widen across the segment, facing the camera
+	vec3 dir = b.xyz - a.xyz;
+	vec3 across = cross(dir, camerapos - p.xyz);
+	float len = length(across);
+	across = len > 0.0 ? across / len : vec3(0.0);
+
+	vec3 worldPos = p.xyz + across * side * (width + spread * age);
+	gl_Position = persp * view * vec4(worldPos, 1.0);
+	tc = vec2(side, age / lifetime);
+	fade = 1.0 - clamp(age / lifetime, 0.0, 1.0);
 }
@@ -1,5 +1,14 @@
 #version 330 core
 
+layout (std140) uniform FrameData {
+	mat4 persp;
+	mat4 view;
+	vec3 lightdir;
+	float time;
+	vec3 camerapos;
+	float viewdist;
+};
+
 /*
 	A vertex shader for trees, takes in vertex position and then translates
 	it around to create a wind animation effect
@@ -10,15 +19,10 @@ layout(location = 1) in vec2 texcoord;
 layout(location = 2) in vec3 norm;
 layout(location = 3) in vec3 offset;
 
-uniform float time;
-
-uniform mat4 persp;
-uniform mat4 view;
 uniform mat4 transform;
 
 uniform float windstrength;
 
-uniform vec3 lightdir;
 out float lighting;
 
 out vec3 fragpos;
@@ -1,15 +1,21 @@
 #version 330 core
 
+layout (std140) uniform FrameData {
+	mat4 persp;
+	mat4 view;
+	vec3 lightdir;
+	float time;
+	vec3 camerapos;
+	float viewdist;
+};
+
 layout(location = 0) in vec4 pos;
 layout(location = 1) in vec2 texcoord;
 layout(location = 2) in vec3 norm;
 
-uniform mat4 persp;
-uniform mat4 view;
 uniform mat4 transform;
 uniform mat3 normalmat;
 
-uniform vec3 lightdir;
 out float lighting;
 
 out vec3 fragpos;
@@ -1,6 +1,11 @@
 #version 330 core
 
-layout (std140) uniform GlobalVals {
+layout (std140) uniform FrameData {
+	mat4 persp;
+	mat4 view;
+	vec3 lightdir;
+	float time;
+	vec3 camerapos;
 	float viewdist;
 };
 
@@ -15,10 +20,6 @@ in vec3 fragpos;
 //data into memory so to play nice with the cache I've combined the textures
 uniform sampler2D watermaps;
 
-uniform float time;
-uniform vec3 lightdir;
-uniform vec3 camerapos;
-
 const float FOG_DIST = 8000.0;
 const float WATER_FOG_DIST = 128.0;
 
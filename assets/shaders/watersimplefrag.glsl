@@ -1,14 +1,18 @@
 #version 330 core
 
+layout (std140) uniform FrameData {
+	mat4 persp;
+	mat4 view;
+	vec3 lightdir;
+	float time;
+	vec3 camerapos;
+	float viewdist;
+};
+
 out vec4 color;
 
 in vec3 fragpos;
 
-uniform vec3 lightdir;
-uniform vec3 camerapos;
-
-uniform float viewdist;
-
 const float FOG_DIST = 128.0;
 const float WATER_FOG_DIST = 24.0;
 
@@ -0,0 +1,126 @@
+// Enemy swarm benchmark: 1k, 10k and 50k agents
+// Spawns each swarm over rolling hills at a fixed density, ticks it at the
+// simulation rate on the job pool and on a single thread, and reports the
+// cost per tick against the frame budget. After the run no agent may be
+// below the ground or outside the speed limits of its kind.
+
+#define _POSIX_C_SOURCE 199309L
+#include "../src/entities/enemy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#define AREA_PER_AGENT 2500.0f      // World units^2 per agent (50 x 50)
+#define TICK_DT (1.0f / 60.0f)
+#define FRAME_BUDGET_MS 16.667
+#define WARMUP_TICKS 60
+#define TICKS 300
+
+static const unsigned int SWARM_SIZES[] = {1000, 10000, 50000};
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static float random_range(float lo, float hi) {
+    return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX);
+}
+
+// Rolling hills with a few octaves, standing in for the terrain noise
+static float hills(void* user, float x, float z) {
+    (void)user;
+    float h = 0.0f, amplitude = 60.0f, frequency = 0.004f;
+    for (int octave = 0; octave < 4; octave++) {
+        h += amplitude * sinf(x * frequency + (float)octave) * cosf(z * frequency * 1.3f - (float)octave);
+        amplitude *= 0.45f;
+        frequency *= 2.1f;
+    }
+    return h;
+}
+
+static EnemySystem* spawn_swarm(unsigned int count, JobSystem* jobs) {
+    EnemySystem* system = enemy_system_create(count, hills, NULL);
+    system->jobs = jobs;
+    enemy_set_target(system, (float[]){0.0f, 0.0f, 0.0f});
+
+    float extent = 0.5f * sqrtf(AREA_PER_AGENT * (float)count);
+    srand(1234);
+    for (unsigned int i = 0; i < count; i++) {
+        float position[3] = {random_range(-extent, extent), 0.0f, random_range(-extent, extent)};
+        position[1] = hills(NULL, position[0], position[2]) + random_range(40.0f, 200.0f);
+        float heading = random_range(0.0f, 6.2831853f);
+        float velocity[3] = {cosf(heading) * 15.0f, 0.0f, sinf(heading) * 15.0f};
+        enemy_spawn(system, (EnemyType)(i % ENEMY_TYPE_COUNT), position, velocity);
+    }
+    return system;
+}
+
+// ms per tick over TICKS, after warming up
+static double run_swarm(EnemySystem* system, double* worst) {
+    double total = 0.0;
+    *worst = 0.0;
+    for (int tick = 0; tick < WARMUP_TICKS + TICKS; tick++) {
+        double t = now_seconds();
+        enemy_system_update(system, TICK_DT);
+        double elapsed = now_seconds() - t;
+
+        if (tick < WARMUP_TICKS) continue;
+        total += elapsed;
+        if (elapsed > *worst) *worst = elapsed;
+    }
+    *worst *= 1000.0;
+    return total * 1000.0 / TICKS;
+}
+
+// Agents under the ground or outside their speed range
+static unsigned int check_swarm(const EnemySystem* system) {
+    static const float MIN_SPEED[ENEMY_TYPE_COUNT] = {8.0f, 10.0f, 30.0f};
+    static const float MAX_SPEED[ENEMY_TYPE_COUNT] = {20.0f, 25.0f, 80.0f};
+    unsigned int bad = 0;
+
+    for (unsigned int i = 0; i < system->count; i++) {
+        float vx = system->vel_x[i], vy = system->vel_y[i], vz = system->vel_z[i];
+        float speed = sqrtf(vx * vx + vy * vy + vz * vz);
+        uint8_t type = system->types[i];
+        if (speed < MIN_SPEED[type] - 1e-3f || speed > MAX_SPEED[type] + 1e-3f) bad++;
+        else if (system->pos_y[i] < hills(NULL, system->pos_x[i], system->pos_z[i])) bad++;
+    }
+    return bad;
+}
+
+int main(void) {
+    int failures = 0;
+    JobSystem* jobs = job_system_create(0);
+
+    printf("Enemy swarm, %u workers, %d ticks\n", job_system_worker_count(jobs), TICKS);
+    printf("  %-8s %12s %12s %12s %9s\n", "agents", "pool ms", "worst ms", "1 thread ms", "speedup");
+
+    for (unsigned int s = 0; s < sizeof(SWARM_SIZES) / sizeof(SWARM_SIZES[0]); s++) {
+        unsigned int count = SWARM_SIZES[s];
+        double worst, single_worst;
+
+        EnemySystem* pooled = spawn_swarm(count, jobs);
+        double pooled_ms = run_swarm(pooled, &worst);
+        unsigned int bad = check_swarm(pooled);
+
+        EnemySystem* single = spawn_swarm(count, NULL);
+        double single_ms = run_swarm(single, &single_worst);
+        bad += check_swarm(single);
+
+        printf("  %-8u %12.3f %12.3f %12.3f %8.2fx  (%.1f%% of a %.1f ms frame)\n", count, pooled_ms, worst,
+               single_ms, single_ms / pooled_ms, pooled_ms / FRAME_BUDGET_MS * 100.0, FRAME_BUDGET_MS);
+        if (bad) {
+            printf("  MISMATCH %u agents below ground or outside their speed range\n", bad);
+            failures++;
+        }
+
+        enemy_system_free(pooled);
+        enemy_system_free(single);
+    }
+
+    job_system_shutdown(jobs);
+    return failures == 0 ? 0 : 1;
+}
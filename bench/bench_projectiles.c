@@ -0,0 +1,203 @@
+// Projectile benchmark: 10k+ live projectiles over terrain and entities
+// Keeps the pool near its target population by respawning what dies, ticks
+// it at the simulation rate, and fails when the average or the 99th
+// percentile tick exceeds the frame budget. Ticks prefill heights around the
+// spawn area as the engine does around the player, starting from a warm
+// cache; a final burst fires a quarter of the pool into terrain nothing has
+// flown over, which must also fit in one frame.
+//
+// The run is repeated and every tick keeps its fastest time: the work is
+// identical each run, so that filters out preemption while a tick that is
+// slow every time still counts. Every hit is checked: terrain hits must lie
+// on the ground and entity hits on (or, for projectiles spawned inside,
+// within) the sphere hit.
+
+#define _POSIX_C_SOURCE 199309L
+#include "../src/entities/projectile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#define POOL_CAPACITY 16384
+#define ENTITY_COUNT 5000
+#define WORLD_EXTENT 1000.0f        // Entities
+#define SPAWN_EXTENT 400.0f         // Projectiles start around the player's area
+#define CELL_SIZE 64.0f
+#define HEIGHT_SPACING 2.44f        // Terrain mesh vertex spacing
+#define HILL_OCTAVES 12             // About 0.5 us a sample, like terrain_get_world_height
+#define TICK_DT (1.0f / 60.0f)
+#define FRAME_BUDGET_MS 16.667
+#define WARMUP_TICKS 120
+#define TICKS 600
+#define REPEATS 3                   // Each tick keeps its fastest run, so time the host steals doesn't count
+#define SPEED 400.0f
+#define LIFE 2.0f
+#define BURST 4096                  // Projectiles fired at once into unexplored terrain
+#define BURST_OFFSET 20000.0f       // Far beyond anything cached
+
+typedef struct {
+    unsigned int calls;
+} HeightStats;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static float random_range(float lo, float hi) {
+    return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX);
+}
+
+// Rolling hills standing in for the terrain noise, with enough octaves to
+// cost about as much per sample
+static float hills(void* user, float x, float z) {
+    HeightStats* stats = user;
+    stats->calls++;
+    float h = 0.0f, amplitude = 60.0f, frequency = 0.004f;
+    for (int octave = 0; octave < HILL_OCTAVES; octave++) {
+        h += amplitude * sinf(x * frequency + (float)octave) * cosf(z * frequency * 1.3f - (float)octave);
+        amplitude *= 0.45f;
+        frequency *= 2.1f;
+    }
+    return h;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static void spawn_random(ProjectileSystem* system, HeightStats* stats, float offset) {
+    float position[3] = {offset + random_range(-SPAWN_EXTENT, SPAWN_EXTENT), 0.0f,
+                         random_range(-SPAWN_EXTENT, SPAWN_EXTENT)};
+    position[1] = hills(stats, position[0], position[2]) + random_range(20.0f, 150.0f);
+    float yaw = random_range(0.0f, 6.2831853f), pitch = random_range(-0.4f, 0.1f);
+    float velocity[3] = {cosf(pitch) * cosf(yaw) * SPEED, sinf(pitch) * SPEED, cosf(pitch) * sinf(yaw) * SPEED};
+    projectile_spawn(system, position, velocity, random_range(0.5f, 1.0f) * LIFE, SPATIAL_GRID_NONE);
+}
+
+static void report(const char* name, double seconds, unsigned int ops) {
+    printf("  %-30s %9.3f ms  %8.2f us/op\n", name, seconds * 1000.0, seconds * 1e6 / ops);
+}
+
+int main(void) {
+    srand(1234);
+    int failures = 0;
+
+    float (*spheres)[4] = malloc(sizeof(float[4]) * ENTITY_COUNT);
+    SpatialGrid* grid = spatial_grid_create(CELL_SIZE);
+    HeightStats height_stats = {0};
+
+    for (unsigned int i = 0; i < ENTITY_COUNT; i++) {
+        spheres[i][0] = random_range(-WORLD_EXTENT, WORLD_EXTENT);
+        spheres[i][2] = random_range(-WORLD_EXTENT, WORLD_EXTENT);
+        spheres[i][1] = hills(&height_stats, spheres[i][0], spheres[i][2]) + random_range(5.0f, 150.0f);
+        spheres[i][3] = random_range(2.0f, 12.0f);
+        spatial_grid_update(grid, i, spheres[i]);
+    }
+    height_stats.calls = 0;
+
+    printf("Projectiles, pool %d, %d entities, %d ticks, fastest of %d runs\n", POOL_CAPACITY, ENTITY_COUNT,
+           TICKS, REPEATS);
+
+    unsigned int target = POOL_CAPACITY * 3 / 4;
+    static double ticks[TICKS];
+    double burst = 0.0;
+    unsigned long live_total = 0, terrain_hits = 0, entity_hits = 0;
+    unsigned int bad_terrain = 0, bad_entity = 0;
+    unsigned int tiles_filled = 0, direct_samples = 0, tick_samples = 0, burst_samples = 0;
+
+    // Identical runs (same seed, fresh pool and cache); hits are checked in all of them
+    for (int run = 0; run < REPEATS; run++) {
+        srand(5678);
+        ProjectileSystem* system = projectile_system_create(POOL_CAPACITY, hills, &height_stats, HEIGHT_SPACING);
+        system->grid = grid;
+
+        // Steady state: the ground around the player has been streamed in
+        projectile_prefill_heights(system, 0.0f, 0.0f, PROJECTILE_PREFILL_RADIUS, UINT32_MAX);
+        height_stats.calls = 0;
+        live_total = terrain_hits = entity_hits = 0;
+
+        for (int tick = 0; tick < WARMUP_TICKS + TICKS; tick++) {
+            while (system->count < target) spawn_random(system, &height_stats, 0.0f);
+
+            double t = now_seconds();
+            projectile_prefill_heights(system, 0.0f, 0.0f, PROJECTILE_PREFILL_RADIUS, PROJECTILE_PREFILL_FILLS);
+            projectile_system_update(system, TICK_DT);
+            double elapsed = now_seconds() - t;
+
+            if (tick < WARMUP_TICKS) continue;
+            double* fastest = &ticks[tick - WARMUP_TICKS];
+            if (run == 0 || elapsed < *fastest) *fastest = elapsed;
+            live_total += system->count;
+
+            for (unsigned int h = 0; h < system->hit_count; h++) {
+                const ProjectileHit* hit = &system->hits[h];
+                if (hit->target == PROJECTILE_TERRAIN) {
+                    // Within the bilinear error of the sampled surface
+                    float ground = hills(&height_stats, hit->position[0], hit->position[2]);
+                    if (fabsf(hit->position[1] - ground) > 1.0f) bad_terrain++;
+                    terrain_hits++;
+                } else {
+                    const float* s = spheres[hit->target];
+                    float dx = hit->position[0] - s[0], dy = hit->position[1] - s[1], dz = hit->position[2] - s[2];
+                    // On the surface, or inside for projectiles spawned within the sphere
+                    if (sqrtf(dx * dx + dy * dy + dz * dz) > s[3] + 1e-2f) bad_entity++;
+                    entity_hits++;
+                }
+            }
+        }
+        tiles_filled = system->tiles_filled;
+        direct_samples = system->direct_samples;
+        tick_samples = height_stats.calls;
+
+        // A quarter of the pool fired into cold terrain in one tick
+        projectile_system_clear(system);
+        while (system->count < BURST) spawn_random(system, &height_stats, BURST_OFFSET);
+        height_stats.calls = 0;
+        double t = now_seconds();
+        projectile_system_update(system, TICK_DT);
+        double elapsed = now_seconds() - t;
+        if (run == 0 || elapsed < burst) burst = elapsed;
+        burst_samples = height_stats.calls;
+
+        projectile_system_free(system);
+    }
+
+    double tick_time = 0.0;
+    for (int i = 0; i < TICKS; i++) tick_time += ticks[i];
+    double per_tick = tick_time / TICKS;
+    unsigned int average_live = (unsigned int)(live_total / TICKS);
+    qsort(ticks, TICKS, sizeof(double), compare_double);
+    double p99 = ticks[TICKS * 99 / 100];
+    report("tick", per_tick, 1);
+    report("per projectile", per_tick, average_live);
+    printf("  %u live on average, p99 tick %.3f ms, worst %.3f ms (%.1f ms frame)\n",
+           average_live, p99 * 1000.0, ticks[TICKS - 1] * 1000.0, FRAME_BUDGET_MS);
+    printf("  %lu terrain hits, %lu entity hits, %u tiles filled, %u sampled directly (%u height samples)\n",
+           terrain_hits, entity_hits, tiles_filled, direct_samples, tick_samples);
+    printf("  burst of %d into new terrain: %.3f ms (%u height samples)\n", BURST, burst * 1000.0, burst_samples);
+
+    if (bad_terrain || bad_entity) {
+        printf("  MISMATCH hits: %u off the ground, %u off their sphere\n", bad_terrain, bad_entity);
+        failures++;
+    }
+    if (per_tick * 1000.0 > FRAME_BUDGET_MS || p99 * 1000.0 > FRAME_BUDGET_MS) {
+        printf("  OVER BUDGET: %.3f ms average, %.3f ms p99\n", per_tick * 1000.0, p99 * 1000.0);
+        failures++;
+    }
+    if (burst * 1000.0 > FRAME_BUDGET_MS) {
+        printf("  OVER BUDGET: burst took %.3f ms\n", burst * 1000.0);
+        failures++;
+    }
+    if (average_live < 10000) {
+        printf("  MISMATCH population: %u live\n", average_live);
+        failures++;
+    }
+
+    spatial_grid_free(grid);
+    free(spheres);
+    return failures == 0 ? 0 : 1;
+}
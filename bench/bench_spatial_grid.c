@@ -0,0 +1,241 @@
+// Spatial grid benchmark: 10k and 100k entities
+// Builds the grid, moves a fraction of the items each frame, and runs
+// radius, k-nearest and ray queries (single and batched) against a brute
+// force scan over every sphere. Query results are checked against the scan.
+
+#define _POSIX_C_SOURCE 199309L
+#include "../src/entities/spatial_grid.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#define WORLD_EXTENT 5000.0f
+#define CELL_SIZE 64.0f
+#define QUERY_COUNT 1000
+#define QUERY_RADIUS 60.0f
+#define NEAREST_K 8
+#define RAY_LENGTH 2000.0f
+#define MOVE_FRACTION 0.1f
+#define UPDATE_FRAMES 20
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static float random_range(float lo, float hi) {
+    return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX);
+}
+
+static void random_sphere(float* s) {
+    s[0] = random_range(-WORLD_EXTENT, WORLD_EXTENT);
+    s[1] = random_range(0.0f, 300.0f);
+    s[2] = random_range(-WORLD_EXTENT, WORLD_EXTENT);
+    // A few large items exercise the overflow list
+    s[3] = (rand() % 100 == 0) ? random_range(40.0f, 120.0f) : random_range(1.0f, 20.0f);
+}
+
+static unsigned int brute_radius(const float (*spheres)[4], unsigned int count, const float* c, float radius) {
+    unsigned int found = 0;
+    for (unsigned int i = 0; i < count; i++) {
+        float dx = spheres[i][0] - c[0], dy = spheres[i][1] - c[1], dz = spheres[i][2] - c[2];
+        float reach = radius + spheres[i][3];
+        if (dx * dx + dy * dy + dz * dz <= reach * reach) found++;
+    }
+    return found;
+}
+
+// Distance to the k-th nearest surface (or INFINITY with fewer than k items)
+static float brute_nearest(const float (*spheres)[4], unsigned int count, const float* p, unsigned int k) {
+    float best[NEAREST_K];
+    unsigned int n = 0;
+    for (unsigned int i = 0; i < count; i++) {
+        float dx = spheres[i][0] - p[0], dy = spheres[i][1] - p[1], dz = spheres[i][2] - p[2];
+        float d = fmaxf(sqrtf(dx * dx + dy * dy + dz * dz) - spheres[i][3], 0.0f);
+        if (n == k && d >= best[k - 1]) continue;
+        unsigned int pos = n < k ? n++ : k - 1;
+        while (pos > 0 && best[pos - 1] > d) {
+            best[pos] = best[pos - 1];
+            pos--;
+        }
+        best[pos] = d;
+    }
+    return n == k ? best[k - 1] : INFINITY;
+}
+
+static float brute_ray(const float (*spheres)[4], unsigned int count, const float* o, const float* d, float max_t) {
+    float best = INFINITY;
+    for (unsigned int i = 0; i < count; i++) {
+        float ox = o[0] - spheres[i][0], oy = o[1] - spheres[i][1], oz = o[2] - spheres[i][2];
+        float c = ox * ox + oy * oy + oz * oz - spheres[i][3] * spheres[i][3];
+        float t;
+        if (c <= 0.0f) {
+            t = 0.0f;
+        } else {
+            float b = ox * d[0] + oy * d[1] + oz * d[2];
+            float disc = b * b - c;
+            if (b > 0.0f || disc < 0.0f) continue;
+            t = -b - sqrtf(disc);
+        }
+        if (t < max_t && t < best) best = t;
+    }
+    return best;
+}
+
+static void report(const char* name, double seconds, unsigned int ops) {
+    printf("  %-30s %9.3f ms  %8.2f us/op\n", name, seconds * 1000.0, seconds * 1e6 / ops);
+}
+
+static int run(unsigned int entity_count) {
+    float (*spheres)[4] = malloc(sizeof(float[4]) * entity_count);
+    float (*centers)[3] = malloc(sizeof(float[3]) * QUERY_COUNT);
+    float (*directions)[3] = malloc(sizeof(float[3]) * QUERY_COUNT);
+    float* radii = malloc(sizeof(float) * QUERY_COUNT);
+    uint32_t* ids = malloc(sizeof(uint32_t) * entity_count);
+    unsigned int max_total = QUERY_COUNT * 256;
+    uint32_t* batch_ids = malloc(sizeof(uint32_t) * max_total);
+    unsigned int* offsets = malloc(sizeof(unsigned int) * (QUERY_COUNT + 1));
+    uint32_t* knn_ids = malloc(sizeof(uint32_t) * QUERY_COUNT * NEAREST_K);
+    float* knn_dists = malloc(sizeof(float) * QUERY_COUNT * NEAREST_K);
+    unsigned int* knn_counts = malloc(sizeof(unsigned int) * QUERY_COUNT);
+    uint32_t* ray_ids = malloc(sizeof(uint32_t) * QUERY_COUNT);
+    float* ray_dists = malloc(sizeof(float) * QUERY_COUNT);
+
+    srand(4321 + entity_count);
+    for (unsigned int i = 0; i < entity_count; i++) random_sphere(spheres[i]);
+    for (unsigned int q = 0; q < QUERY_COUNT; q++) {
+        centers[q][0] = random_range(-WORLD_EXTENT, WORLD_EXTENT);
+        centers[q][1] = random_range(0.0f, 300.0f);
+        centers[q][2] = random_range(-WORLD_EXTENT, WORLD_EXTENT);
+        radii[q] = QUERY_RADIUS;
+
+        float yaw = random_range(0.0f, 6.2831853f), pitch = random_range(-0.3f, 0.3f);
+        directions[q][0] = cosf(pitch) * cosf(yaw);
+        directions[q][1] = sinf(pitch);
+        directions[q][2] = cosf(pitch) * sinf(yaw);
+    }
+
+    printf("Spatial grid, %u entities, %d queries\n", entity_count, QUERY_COUNT);
+    int failures = 0;
+
+    SpatialGrid* grid = spatial_grid_create(CELL_SIZE);
+    double t = now_seconds();
+    for (unsigned int i = 0; i < entity_count; i++) spatial_grid_update(grid, i, spheres[i]);
+    report("build", now_seconds() - t, entity_count);
+
+    unsigned int moved = (unsigned int)(entity_count * MOVE_FRACTION);
+    t = now_seconds();
+    for (int frame = 0; frame < UPDATE_FRAMES; frame++) {
+        for (unsigned int m = 0; m < moved; m++) {
+            unsigned int i = (unsigned int)rand() % entity_count;
+            spheres[i][0] += random_range(-8.0f, 8.0f);
+            spheres[i][2] += random_range(-8.0f, 8.0f);
+            spatial_grid_update(grid, i, spheres[i]);
+        }
+    }
+    report("incremental update (10%/frame)", (now_seconds() - t) / UPDATE_FRAMES, moved);
+
+    // Radius
+    unsigned int grid_hits = 0, brute_hits = 0;
+    t = now_seconds();
+    for (unsigned int q = 0; q < QUERY_COUNT; q++)
+        grid_hits += spatial_grid_query_radius(grid, centers[q], QUERY_RADIUS, ids, entity_count);
+    report("radius, grid", now_seconds() - t, QUERY_COUNT);
+
+    t = now_seconds();
+    spatial_grid_query_radius_batch(grid, (const float (*)[3])centers, radii, QUERY_COUNT,
+                                    batch_ids, max_total, offsets);
+    report("radius, grid batch", now_seconds() - t, QUERY_COUNT);
+
+    t = now_seconds();
+    for (unsigned int q = 0; q < QUERY_COUNT; q++)
+        brute_hits += brute_radius((const float (*)[4])spheres, entity_count, centers[q], QUERY_RADIUS);
+    report("radius, brute force", now_seconds() - t, QUERY_COUNT);
+
+    if (grid_hits != brute_hits || offsets[QUERY_COUNT] != brute_hits) {
+        printf("  MISMATCH radius: grid %u batch %u brute %u\n", grid_hits, offsets[QUERY_COUNT], brute_hits);
+        failures++;
+    }
+
+    // Nearest
+    t = now_seconds();
+    for (unsigned int q = 0; q < QUERY_COUNT; q++)
+        spatial_grid_query_nearest(grid, centers[q], NEAREST_K, INFINITY, ids, knn_dists);
+    report("k-nearest (k=8), grid", now_seconds() - t, QUERY_COUNT);
+
+    t = now_seconds();
+    spatial_grid_query_nearest_batch(grid, (const float (*)[3])centers, QUERY_COUNT, NEAREST_K, INFINITY,
+                                     knn_ids, knn_dists, knn_counts);
+    report("k-nearest (k=8), grid batch", now_seconds() - t, QUERY_COUNT);
+
+    unsigned int knn_mismatch = 0;
+    t = now_seconds();
+    for (unsigned int q = 0; q < QUERY_COUNT; q++) {
+        float expected = brute_nearest((const float (*)[4])spheres, entity_count, centers[q], NEAREST_K);
+        float got = knn_counts[q] == NEAREST_K ? knn_dists[q * NEAREST_K + NEAREST_K - 1] : INFINITY;
+        if (fabsf(got - expected) > 1e-3f) knn_mismatch++;
+    }
+    report("k-nearest (k=8), brute force", now_seconds() - t, QUERY_COUNT);
+
+    if (knn_mismatch) {
+        printf("  MISMATCH k-nearest: %u queries\n", knn_mismatch);
+        failures++;
+    }
+
+    // Rays
+    t = now_seconds();
+    for (unsigned int q = 0; q < QUERY_COUNT; q++)
+        spatial_grid_raycast(grid, centers[q], directions[q], RAY_LENGTH, NULL);
+    report("raycast, grid", now_seconds() - t, QUERY_COUNT);
+
+    t = now_seconds();
+    spatial_grid_raycast_batch(grid, (const float (*)[3])centers, (const float (*)[3])directions,
+                               QUERY_COUNT, RAY_LENGTH, ray_ids, ray_dists);
+    report("raycast, grid batch", now_seconds() - t, QUERY_COUNT);
+
+    unsigned int ray_mismatch = 0, ray_hits = 0;
+    t = now_seconds();
+    for (unsigned int q = 0; q < QUERY_COUNT; q++) {
+        float expected = brute_ray((const float (*)[4])spheres, entity_count, centers[q], directions[q], RAY_LENGTH);
+        float got = ray_ids[q] != SPATIAL_GRID_NONE ? ray_dists[q] : INFINITY;
+        if (ray_ids[q] != SPATIAL_GRID_NONE) ray_hits++;
+        if (fabsf(got - expected) > 1e-3f && !(isinf(got) && isinf(expected))) ray_mismatch++;
+    }
+    report("raycast, brute force", now_seconds() - t, QUERY_COUNT);
+    printf("  %u/%d rays hit, %u cells, %u overflow items\n", ray_hits, QUERY_COUNT,
+           grid->table_used, grid->large_count);
+
+    if (ray_mismatch) {
+        printf("  MISMATCH raycast: %u rays\n", ray_mismatch);
+        failures++;
+    }
+
+    // Remove everything; the grid must end empty
+    for (unsigned int i = 0; i < entity_count; i++) spatial_grid_remove(grid, i);
+    if (grid->item_count != 0 || grid->table_used != 0 || grid->large_count != 0) {
+        printf("  MISMATCH after removal: %u items, %u cells\n", grid->item_count, grid->table_used);
+        failures++;
+    }
+
+    spatial_grid_free(grid);
+    free(ray_dists);
+    free(ray_ids);
+    free(knn_counts);
+    free(knn_dists);
+    free(knn_ids);
+    free(offsets);
+    free(batch_ids);
+    free(ids);
+    free(radii);
+    free(directions);
+    free(centers);
+    free(spheres);
+    return failures;
+}
+
+int main(void) {
+    int failures = run(10000) + run(100000);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+// Transform composition benchmark: 100k entities
+// Compares the old per-entity matrix product path with the direct scalar
+// composition, the batched SIMD kernel, and a cached frame where only a
+// small fraction of entities moved.
+
+#define _POSIX_C_SOURCE 199309L
+#include "../src/math/math_ops.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#define ENTITY_COUNT 100000
+#define ITERATIONS 20
+#define DIRTY_FRACTION 0.01f
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static float random_range(float lo, float hi) {
+    return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX);
+}
+
+// The pre-cache path: five matrices and four full multiplies per entity
+static void compose_reference(float* out, const float* p, const float* r, const float* s) {
+    float scale_mat[16], rot_x[16], rot_y[16], rot_z[16], trans_mat[16];
+    float temp1[16], temp2[16], temp3[16];
+    mat4_scale(scale_mat, s[0], s[1], s[2]);
+    mat4_rotate_x(rot_x, r[0]);
+    mat4_rotate_y(rot_y, r[1]);
+    mat4_rotate_z(rot_z, r[2]);
+    mat4_translate(trans_mat, p[0], p[1], p[2]);
+    mat4_multiply(temp1, rot_x, scale_mat);
+    mat4_multiply(temp2, rot_y, temp1);
+    mat4_multiply(temp3, rot_z, temp2);
+    mat4_multiply(out, trans_mat, temp3);
+}
+
+static void report(const char* name, double seconds, unsigned int transforms) {
+    printf("  %-28s %8.3f ms/frame  %6.2f ns/transform\n", name,
+           seconds * 1000.0 / ITERATIONS, seconds * 1e9 / ((double)transforms * ITERATIONS));
+}
+
+int main(void) {
+    float (*positions)[3] = malloc(sizeof(float[3]) * ENTITY_COUNT);
+    float (*rotations)[3] = malloc(sizeof(float[3]) * ENTITY_COUNT);
+    float (*scales)[3] = malloc(sizeof(float[3]) * ENTITY_COUNT);
+    float (*reference)[16] = malloc(sizeof(float[16]) * ENTITY_COUNT);
+    float (*result)[16] = malloc(sizeof(float[16]) * ENTITY_COUNT);
+    uint32_t* dirty = malloc(sizeof(uint32_t) * ENTITY_COUNT);
+
+    srand(1234);
+    for (unsigned int i = 0; i < ENTITY_COUNT; i++) {
+        for (int k = 0; k < 3; k++) {
+            positions[i][k] = random_range(-5000.0f, 5000.0f);
+            rotations[i][k] = random_range(-10.0f, 10.0f);
+            scales[i][k] = random_range(0.5f, 4.0f);
+        }
+    }
+
+    unsigned int dirty_count = 0;
+    for (unsigned int i = 0; i < ENTITY_COUNT; i++) {
+        if ((float)rand() / (float)RAND_MAX < DIRTY_FRACTION) dirty[dirty_count++] = i;
+    }
+
+    printf("Transform composition, %d entities, %d frames\n", ENTITY_COUNT, ITERATIONS);
+
+    double t = now_seconds();
+    for (int it = 0; it < ITERATIONS; it++)
+        for (unsigned int i = 0; i < ENTITY_COUNT; i++)
+            compose_reference(reference[i], positions[i], rotations[i], scales[i]);
+    report("matrix products (old)", now_seconds() - t, ENTITY_COUNT);
+
+    t = now_seconds();
+    for (int it = 0; it < ITERATIONS; it++)
+        for (unsigned int i = 0; i < ENTITY_COUNT; i++)
+            mat4_compose_trs(result[i], positions[i], rotations[i], scales[i]);
+    report("direct scalar", now_seconds() - t, ENTITY_COUNT);
+
+    t = now_seconds();
+    for (int it = 0; it < ITERATIONS; it++)
+        mat4_compose_trs_batch(result, (const float (*)[3])positions, (const float (*)[3])rotations,
+                               (const float (*)[3])scales, NULL, ENTITY_COUNT);
+    double batch_time = now_seconds() - t;
+    report("SIMD batch, all dirty", batch_time, ENTITY_COUNT);
+
+    float max_error = 0.0f;
+    for (unsigned int i = 0; i < ENTITY_COUNT; i++)
+        for (int k = 0; k < 16; k++)
+            max_error = fmaxf(max_error, fabsf(result[i][k] - reference[i][k]));
+
+    t = now_seconds();
+    for (int it = 0; it < ITERATIONS; it++)
+        mat4_compose_trs_batch(result, (const float (*)[3])positions, (const float (*)[3])rotations,
+                               (const float (*)[3])scales, dirty, dirty_count);
+    double cached_time = now_seconds() - t;
+    printf("  %-28s %8.3f ms/frame  (%u dirty)\n", "SIMD batch, cached frame",
+           cached_time * 1000.0 / ITERATIONS, dirty_count);
+
+    printf("  max abs error vs old path: %g\n", max_error);
+
+    free(dirty);
+    free(result);
+    free(reference);
+    free(scales);
+    free(rotations);
+    free(positions);
+    return max_error < 1e-3f ? 0 : 1;
+}
@@ -18,6 +18,37 @@
 #define CAMERA_FAR 10000.0f
 #define CAMERA_INITIAL_Y 50.0f
 
+// Lighting and fog (shared with every shader through the FrameData block)
+#define LIGHT_DIR_X -0.57735f
+#define LIGHT_DIR_Y -0.57735f
+#define LIGHT_DIR_Z -0.57735f
+#define FOG_START_DIST 0.0f     // Shaders blend to full fog over their FOG_DIST past this
+
+// Entity draw distances by type (beyond these entities are culled)
+#define ENTITY_DRAW_DIST_PLAYER CAMERA_FAR
+#define ENTITY_DRAW_DIST_PROP 1500.0f
+#define ENTITY_DRAW_DIST_DYNAMIC 4000.0f
+#define ENTITY_DRAW_DIST_PARTICLE 800.0f
+
+// Spatial index cell size (entities with a larger bounding diameter go to its overflow list)
+#define ENTITY_GRID_CELL_SIZE 64.0f
+
+// Simulation runs at a fixed rate; rendering interpolates between ticks
+#define SIM_TICK_RATE 60
+#define SIM_TICK_DT (1.0f / SIM_TICK_RATE)
+#define SIM_MAX_TICKS_PER_FRAME 8   // Drop time beyond this after a stall
+#define SIM_PIPELINED 1             // Tick frame N + 1 on the pool while frame N renders
+
+// Projectiles (all live projectiles are drawn in one instanced call)
+#define PROJECTILE_CAPACITY 16384
+#define PROJECTILE_MODEL_SCALE 0.5f
+#define PROJECTILE_IMPACT_SCALE 0.08f   // Explosion size of a bullet impact
+
+// Enemy swarm (simulated on the job pool, drawn instanced per model)
+#define ENEMY_COUNT 2000
+#define ENEMY_SPAWN_RADIUS 800.0f       // Spawned around the player within this distance
+#define ENEMY_MODEL_SCALE 0.5f
+
 // Input settings
 #define INPUT_SPRINT_MULTIPLIER 5.0f
 #define INPUT_SLOW_MULTIPLIER 0.2f
@@ -0,0 +1,191 @@
+#include "asset_loader.h"
+#include <GLFW/glfw3.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+struct AssetRequest {
+    AssetDecodeFunc decode;
+    AssetUploadFunc upload;
+    void* data;
+    AssetStatus status;
+    bool cancelled;
+    struct AssetRequest* next;
+};
+
+// FIFO of requests
+typedef struct {
+    AssetRequest* head;
+    AssetRequest* tail;
+} AssetQueue;
+
+static struct {
+    pthread_t threads[ASSET_LOADER_THREADS];
+    unsigned int thread_count;
+    bool running;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t decode_cond;     // Signalled when a request is queued for decode
+    pthread_cond_t upload_cond;     // Signalled when a request is ready to upload
+    AssetQueue decode_queue;
+    AssetQueue upload_queue;
+    unsigned int pending;           // Requested, not yet uploaded (main thread)
+} loader;
+
+static void asset_queue_push(AssetQueue* queue, AssetRequest* request) {
+    request->next = NULL;
+    if (queue->tail) queue->tail->next = request;
+    else queue->head = request;
+    queue->tail = request;
+}
+
+static AssetRequest* asset_queue_pop(AssetQueue* queue) {
+    AssetRequest* request = queue->head;
+    if (request) {
+        queue->head = request->next;
+        if (!queue->head) queue->tail = NULL;
+    }
+    return request;
+}
+
+static void* asset_loader_thread(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&loader.mutex);
+    for (;;) {
+        while (loader.running && !loader.decode_queue.head) {
+            pthread_cond_wait(&loader.decode_cond, &loader.mutex);
+        }
+        AssetRequest* request = asset_queue_pop(&loader.decode_queue);
+        if (!request) break;
+
+        // Cancelled before a thread got to it: skip the decode
+        if (request->cancelled) {
+            request->status = ASSET_CANCELLED;
+        } else {
+            pthread_mutex_unlock(&loader.mutex);
+            bool decoded = request->decode(request->data);
+            pthread_mutex_lock(&loader.mutex);
+            request->status = decoded ? ASSET_LOADED : ASSET_FAILED;
+        }
+
+        asset_queue_push(&loader.upload_queue, request);
+        pthread_cond_signal(&loader.upload_cond);
+    }
+    pthread_mutex_unlock(&loader.mutex);
+    return NULL;
+}
+
+void asset_loader_init(void) {
+    if (loader.thread_count > 0) return;
+
+    pthread_mutex_init(&loader.mutex, NULL);
+    pthread_cond_init(&loader.decode_cond, NULL);
+    pthread_cond_init(&loader.upload_cond, NULL);
+    loader.running = true;
+
+    for (unsigned int i = 0; i < ASSET_LOADER_THREADS; i++) {
+        if (pthread_create(&loader.threads[loader.thread_count], NULL, asset_loader_thread, NULL) != 0) {
+            fprintf(stderr, "Failed to start asset loader thread %u\n", i);
+            break;
+        }
+        loader.thread_count++;
+    }
+
+    if (loader.thread_count == 0) {
+        loader.running = false;
+        pthread_cond_destroy(&loader.upload_cond);
+        pthread_cond_destroy(&loader.decode_cond);
+        pthread_mutex_destroy(&loader.mutex);
+        return;
+    }
+    printf("Asset loader started with %u threads\n", loader.thread_count);
+}
+
+void asset_loader_shutdown(void) {
+    if (loader.thread_count == 0) return;
+
+    // Uploads may be the only thing keeping a decode alive, so drain as they arrive
+    while (loader.pending > 0) {
+        if (asset_loader_update(1e9) > 0) continue;
+
+        pthread_mutex_lock(&loader.mutex);
+        while (!loader.upload_queue.head) {
+            pthread_cond_wait(&loader.upload_cond, &loader.mutex);
+        }
+        pthread_mutex_unlock(&loader.mutex);
+    }
+
+    pthread_mutex_lock(&loader.mutex);
+    loader.running = false;
+    pthread_cond_broadcast(&loader.decode_cond);
+    pthread_mutex_unlock(&loader.mutex);
+
+    for (unsigned int i = 0; i < loader.thread_count; i++) {
+        pthread_join(loader.threads[i], NULL);
+    }
+    loader.thread_count = 0;
+
+    pthread_cond_destroy(&loader.upload_cond);
+    pthread_cond_destroy(&loader.decode_cond);
+    pthread_mutex_destroy(&loader.mutex);
+}
+
+AssetRequest* asset_loader_request(AssetDecodeFunc decode, AssetUploadFunc upload, void* data) {
+    if (loader.thread_count == 0) {
+        upload(data, decode(data) ? ASSET_LOADED : ASSET_FAILED);
+        return NULL;
+    }
+
+    AssetRequest* request = (AssetRequest*)calloc(1, sizeof(AssetRequest));
+    if (!request) {
+        upload(data, decode(data) ? ASSET_LOADED : ASSET_FAILED);
+        return NULL;
+    }
+    request->decode = decode;
+    request->upload = upload;
+    request->data = data;
+
+    pthread_mutex_lock(&loader.mutex);
+    asset_queue_push(&loader.decode_queue, request);
+    pthread_cond_signal(&loader.decode_cond);
+    pthread_mutex_unlock(&loader.mutex);
+
+    loader.pending++;
+    return request;
+}
+
+void asset_loader_cancel(AssetRequest* request) {
+    if (!request) return;
+
+    // Read by the loader threads when they pick the request up
+    pthread_mutex_lock(&loader.mutex);
+    request->cancelled = true;
+    pthread_mutex_unlock(&loader.mutex);
+}
+
+unsigned int asset_loader_update(double budget_ms) {
+    if (loader.thread_count == 0 || loader.pending == 0) return 0;
+
+    double start = glfwGetTime();
+    unsigned int uploaded = 0;
+    for (;;) {
+        pthread_mutex_lock(&loader.mutex);
+        AssetRequest* request = asset_queue_pop(&loader.upload_queue);
+        pthread_mutex_unlock(&loader.mutex);
+        if (!request) break;
+
+        // Cancelled after its decode finished
+        AssetStatus status = request->cancelled ? ASSET_CANCELLED : request->status;
+        request->upload(request->data, status);
+        free(request);
+        loader.pending--;
+        uploaded++;
+
+        if ((glfwGetTime() - start) * 1000.0 >= budget_ms) break;
+    }
+    return uploaded;
+}
+
+unsigned int asset_loader_pending(void) {
+    return loader.pending;
+}
@@ -0,0 +1,57 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <stdbool.h>
+
+// Asynchronous asset loading.
+//
+// A request pairs a decode step with an upload step. Decode (file I/O,
+// image decoding, OBJ parsing) runs on the loader's own threads and fills in
+// a CPU-side payload; upload runs on the main thread from asset_loader_update,
+// which drains finished requests in order until its time budget is spent, so
+// GL work is spread over frames instead of stalling one of them.
+//
+// The loader keeps its own threads rather than using the job system: a
+// decode can take tens of milliseconds, and the main thread runs whatever
+// job it finds while waiting on the simulation.
+//
+// Until asset_loader_init is called (and after asset_loader_shutdown)
+// requests run both steps immediately on the calling thread.
+
+#define ASSET_LOADER_THREADS 2
+#define ASSET_UPLOAD_BUDGET_MS 2.0      // Main thread time per frame spent on uploads
+
+typedef enum {
+    ASSET_LOADED,       // Decode succeeded, upload the payload
+    ASSET_FAILED,       // Decode failed (it has reported why)
+    ASSET_CANCELLED     // Cancelled, only free the payload
+} AssetStatus;
+
+// Worker thread: fill data's payload, false on failure. Must not touch GL.
+typedef bool (*AssetDecodeFunc)(void* data);
+
+// Main thread: upload the payload for status, then free data
+typedef void (*AssetUploadFunc)(void* data, AssetStatus status);
+
+typedef struct AssetRequest AssetRequest;
+
+void asset_loader_init(void);
+
+// Finish every outstanding request and stop the threads
+void asset_loader_shutdown(void);
+
+// Queue a load. Returns NULL when it already ran synchronously.
+AssetRequest* asset_loader_request(AssetDecodeFunc decode, AssetUploadFunc upload, void* data);
+
+// Main thread: the request's upload will run with ASSET_CANCELLED. The
+// handle stays valid until then.
+void asset_loader_cancel(AssetRequest* request);
+
+// Main thread: run finished uploads until budget_ms has passed (at least
+// one if any is ready); returns how many ran
+unsigned int asset_loader_update(double budget_ms);
+
+// Requests not yet uploaded
+unsigned int asset_loader_pending(void);
+
+#endif // ASSET_LOADER_H
@@ -1,16 +1,21 @@
 #include "engine.h"
+#include "asset_loader.h"
 #include "../window/window.h"
 #include "../graphics/renderer.h"
 #include "../graphics/state.h"
 #include "../graphics/shader.h"
+#include "../graphics/texture.h"
 #include "../world/terrain.h"
 #include "../world/trees.h"
 #include "../entities/player.h"
 #include "../gui.h"
 #include "../config.h"
 #include "../file_ops.h"
+#include "../math/math_ops.h"
+#include "../math/frustum.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <math.h>
 #include <glad/glad.h>
@@ -80,6 +85,9 @@ static void engine_setup_world(Engine* engine) {
     *engine->water = water_manager_init();
     printf("Water initialized\n");
 
+    // Per-frame uniform block ring
+    engine->frame_data = frame_data_create();
+
     // Create skybox
     printf("Initializing skybox...\n");
     engine->skybox = malloc(sizeof(SkyboxGL));
@@ -100,16 +108,92 @@ static void engine_setup_gui(Engine* engine, GLFWwindow* window) {
     *engine->gui_debug_elements = gui_debug_elements_init();
 }
 
+// Height sampler for the projectile terrain cache
+static float engine_terrain_height(void* user, float x, float z) {
+    return terrain_get_world_height(x, z, user);
+}
+
+static void engine_setup_projectiles(Engine* engine) {
+    printf("Initializing projectiles...\n");
+
+    // Cache samples on the terrain mesh's vertex grid
+    float spacing = SCALE * (float)PREC / (float)(PREC + 1);
+    engine->projectiles = projectile_system_create(PROJECTILE_CAPACITY, engine_terrain_height,
+                                                   engine->seed, spacing);
+    if (engine->projectiles) {
+        engine->projectiles->grid = engine->entity_manager->spatial_grid;
+        engine->projectiles->hit_test = entity_manager_ray_test;
+        engine->projectiles->hit_user = engine->entity_manager;
+    }
+
+    engine->projectile_renderer = projectile_renderer_create("assets/models/bullet.obj", PROJECTILE_CAPACITY,
+                                                             PROJECTILE_MODEL_SCALE);
+}
+
+static void engine_setup_enemies(Engine* engine) {
+    printf("Initializing enemies...\n");
+
+    engine->enemies = enemy_system_create(ENEMY_COUNT, engine_terrain_height, engine->seed);
+    engine->enemy_renderer = enemy_renderer_create(ENEMY_COUNT, ENEMY_MODEL_SCALE);
+    if (!engine->enemies) return;
+    engine->enemies->jobs = engine->jobs;
+
+    // Patrol around the player, spawned at random heights above the ground
+    float center[3] = {engine->camera->pos_x, 0.0f, engine->camera->pos_z};
+    entity_manager_get_position(engine->entity_manager, engine->player, center);
+    enemy_set_target(engine->enemies, center);
+
+    for (unsigned int i = 0; i < ENEMY_COUNT; i++) {
+        float angle = (float)rand() / (float)RAND_MAX * 6.2831853f;
+        float distance = sqrtf((float)rand() / (float)RAND_MAX) * ENEMY_SPAWN_RADIUS;
+        float position[3] = {center[0] + cosf(angle) * distance, 0.0f, center[2] + sinf(angle) * distance};
+        position[1] = terrain_get_world_height(position[0], position[2], engine->seed) +
+                      ENEMY_CLEARANCE + (float)rand() / (float)RAND_MAX * 200.0f;
+
+        float heading = (float)rand() / (float)RAND_MAX * 6.2831853f;
+        float velocity[3] = {cosf(heading) * 15.0f, 0.0f, sinf(heading) * 15.0f};
+        enemy_spawn(engine->enemies, (EnemyType)(i % ENEMY_TYPE_COUNT), position, velocity);
+    }
+}
+
+// Wingtip contrails on the player; the swarm's nearest agents get theirs
+// from engine_track_contrails every tick
+static void engine_setup_contrails(Engine* engine) {
+    printf("Initializing contrails...\n");
+    engine->contrails = contrail_system_create();
+
+    unsigned int index;
+    if (!entity_manager_lookup(engine->entity_manager, engine->player, &index)) return;
+
+    // Offsets are in model space, so they follow the entity's scale
+    const Model* model = engine->entity_manager->models[index];
+    float mid_y = 0.5f * (model->min[1] + model->max[1]);
+    float mid_z = 0.5f * (model->min[2] + model->max[2]);
+    contrail_attach(engine->contrails, engine->player, (float[]){model->min[0], mid_y, mid_z});
+    contrail_attach(engine->contrails, engine->player, (float[]){model->max[0], mid_y, mid_z});
+}
+
+// Trails on the swarm agents nearest the focus, at this tick's positions
+static void engine_track_contrails(Engine* engine) {
+    const EnemySystem* enemies = engine->enemies;
+    if (!enemies) return;
+
+    ContrailSwarm swarm = {enemies->pos_x, enemies->pos_y, enemies->pos_z, enemies->ids, enemies->count};
+    contrail_track_swarm(engine->contrails, &swarm, engine->sim.focus_x, engine->sim.focus_z);
+}
+
 static void engine_setup_entities(Engine* engine) {
     printf("Initializing entity system...\n");
 
-    // Create entity manager
+    // Create entity manager and the queue its draws go through
     engine->entity_manager = entity_manager_create();
+    engine->entity_manager->jobs = engine->jobs;
+    engine->render_queue = render_queue_create();
 
     // Load and compile model shaders
     const char* model_vert = load_shader_source("assets/shaders/modelvert.glsl");
     const char* model_frag = load_shader_source("assets/shaders/modelfrag.glsl");
-    engine->entity_manager->model_shader = shader_compile(model_vert, model_frag);
+    engine->entity_manager->model_shader = shader_create(model_vert, model_frag, "model");
 
     // Load player model
     Model* player_model = entity_manager_load_model(
@@ -136,7 +220,7 @@ static void engine_setup_entities(Engine* engine) {
         );
         printf("Player entity created at (%.2f, %.2f, %.2f)\n", player_x, player_y, player_z);
     } else {
-        engine->player = NULL;
+        engine->player = ENTITY_HANDLE_NULL;
     }
 
     printf("Entity system initialized\n");
@@ -178,6 +262,7 @@ Engine* engine_init(void) {
     engine->window = window;
     engine->last_time = glfwGetTime();
     engine->running = true;
+    memset(&engine->sim, 0, sizeof(EngineSim));
     
     // Allocate and initialize camera
     engine->camera = malloc(sizeof(Camera));
@@ -196,7 +281,11 @@ Engine* engine_init(void) {
     
     // Setup OpenGL state
     renderer_set_opengl_state();
-    
+
+    // Start the worker pool, one worker per CPU
+    engine->jobs = job_system_create(0);
+    asset_loader_init();
+
     // Setup game world
     engine_setup_world(engine);
 
@@ -210,18 +299,110 @@ Engine* engine_init(void) {
     printf("Initializing tree placement system...\n");
     int tree_seed = rand();
     engine->tree_placement = tree_placement_create(engine->entity_manager, engine->seed, tree_seed);
+    engine->tree_placement->jobs = engine->jobs;
+
+    // Setup projectiles (collide with terrain and the entity grid)
+    engine_setup_projectiles(engine);
+
+    // Setup explosion particles
+    printf("Initializing explosions...\n");
+    engine->explosions = explosion_system_create();
+
+    // Setup contrails
+    engine_setup_contrails(engine);
+
+    // Setup the enemy swarm
+    engine_setup_enemies(engine);
+
+    // Setup ground cover scatter
+    printf("Initializing ground cover...\n");
+    engine->ground_cover = ground_cover_create(engine->seed, rand());
 
     // Initialize camera to follow player if player exists
-    if (engine->player) {
-        camera_follow_target(engine->camera,
-            engine->player->position[0],
-            engine->player->position[1],
-            engine->player->position[2]);
+    float player_pos[3];
+    if (entity_manager_get_position(engine->entity_manager, engine->player, player_pos)) {
+        camera_follow_target(engine->camera, player_pos[0], player_pos[1], player_pos[2]);
     }
 
     return engine;
 }
 
+// Decide how many ticks this frame's time pays for and capture their inputs
+static void engine_schedule_ticks(Engine* engine, float frame_dt) {
+    EngineSim* sim = &engine->sim;
+
+    sim->accumulator += frame_dt;
+    unsigned int ticks = (unsigned int)(sim->accumulator / SIM_TICK_DT);
+    if (ticks > SIM_MAX_TICKS_PER_FRAME) {
+        // Too far behind (debugger, window drag): drop the backlog
+        ticks = SIM_MAX_TICKS_PER_FRAME;
+        sim->accumulator = ticks * (double)SIM_TICK_DT;
+    }
+    sim->accumulator -= ticks * (double)SIM_TICK_DT;
+    sim->alpha = (float)(sim->accumulator / SIM_TICK_DT);
+    sim->pending_ticks = ticks;
+
+    player_sample_input(engine->window, &sim->input);
+    sim->focus_x = engine->camera->pos_x;
+    sim->focus_z = engine->camera->pos_z;
+}
+
+// One fixed step of everything the world simulates (no GL calls)
+static void engine_simulate_tick(Engine* engine, float dt) {
+    EngineSim* sim = &engine->sim;
+
+    entity_manager_begin_tick(engine->entity_manager);
+
+    if (entity_manager_is_alive(engine->entity_manager, engine->player)) {
+        player_apply_input(engine->entity_manager, engine->player, &sim->input, dt);
+        player_fire(engine->entity_manager, engine->player, engine->projectiles,
+                    &sim->input, &sim->fire_cooldown, dt);
+    }
+
+    // Spawn trees around the camera
+    if (engine->tree_placement) {
+        tree_placement_update(engine->tree_placement, sim->focus_x, sim->focus_z);
+    }
+
+    entity_manager_update(engine->entity_manager, dt);
+
+    // Against this tick's entity bounds, over ground cached around the player
+    projectile_prefill_heights(engine->projectiles, sim->focus_x, sim->focus_z,
+                               PROJECTILE_PREFILL_RADIUS, PROJECTILE_PREFILL_FILLS);
+    projectile_system_update(engine->projectiles, dt);
+
+    // Swarm follows the player
+    float target[3];
+    if (entity_manager_get_position(engine->entity_manager, engine->player, target)) {
+        enemy_set_target(engine->enemies, target);
+    }
+    enemy_system_update(engine->enemies, dt);
+
+    // From this tick's transforms and agent positions
+    engine_track_contrails(engine);
+    contrail_system_update(engine->contrails, engine->entity_manager, dt);
+
+    // Impacts start at age 0, so age the running explosions first
+    explosion_system_update(engine->explosions, dt);
+    if (engine->projectiles) {
+        for (unsigned int i = 0; i < engine->projectiles->hit_count; i++) {
+            explosion_spawn(engine->explosions, engine->projectiles->hits[i].position, PROJECTILE_IMPACT_SCALE);
+        }
+    }
+}
+
+// Run the scheduled ticks (job body when pipelined)
+static void engine_simulate(void* data) {
+    Engine* engine = data;
+    EngineSim* sim = &engine->sim;
+
+    for (unsigned int i = 0; i < sim->pending_ticks; i++) {
+        engine_simulate_tick(engine, SIM_TICK_DT);
+    }
+    sim->last_ticks = sim->pending_ticks;
+    sim->pending_ticks = 0;
+}
+
 void engine_run(Engine* engine) {
     Camera* camera = engine->camera;
     
@@ -235,7 +416,40 @@ void engine_run(Engine* engine) {
         // Update Engine mouse position
         engine->mouse_x = last_mouse_x;
         engine->mouse_y = last_mouse_y;
-        
+
+        // Process input
+        // Handle escape key to close window
+        if (glfwGetKey(engine->window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+            glfwSetWindowShouldClose(engine->window, true);
+
+        // Simulate. Pipelined, this frame draws the ticks scheduled last frame
+        // (one frame of latency) while the next ones run during GL submission.
+#if SIM_PIPELINED
+        job_system_wait(engine->jobs, &engine->sim.counter);
+#else
+        engine_schedule_ticks(engine, dt);
+        engine_simulate(engine);
+#endif
+        float alpha = engine->sim.alpha;
+
+        // Finished loads go live between ticks, so no simulation job sees them change
+        asset_loader_update(ASSET_UPLOAD_BUDGET_MS);
+        engine->gui_debug_elements->assets_loading = asset_loader_pending();
+
+        TextureStats texture_stats = texture_registry_stats();
+        engine->gui_debug_elements->textures = texture_stats.count;
+        engine->gui_debug_elements->texture_vram_mb = texture_stats.vram_bytes / (1024.0 * 1024.0);
+        if (engine->gui_debug_elements->is_list_textures_click) texture_registry_print();
+
+        // Clear
+        renderer_clear();
+
+        // Camera follows the player as drawn (before camera matrices)
+        float player_pos[3];
+        if (entity_manager_get_interpolated_position(engine->entity_manager, engine->player, alpha, player_pos)) {
+            camera_follow_target(camera, player_pos[0], player_pos[1], player_pos[2]);
+        }
+
 #ifdef DEBUG_MODE
         // Update Debug Elements
         fps_counter_update(engine->gui_debug_elements, current_time);
@@ -246,40 +460,25 @@ void engine_run(Engine* engine) {
         engine->gui_debug_elements->mouse_pos_x = last_mouse_x;
         engine->gui_debug_elements->mouse_pos_y = last_mouse_y;
         
-        engine->gui_debug_elements->player_pos_x = engine->player->position[0];
-        engine->gui_debug_elements->player_pos_y = engine->player->position[1];
-        engine->gui_debug_elements->player_pos_z = engine->player->position[2];
+        float debug_player_pos[3] = {0.0f, 0.0f, 0.0f};
+        entity_manager_get_position(engine->entity_manager, engine->player, debug_player_pos);
+        engine->gui_debug_elements->player_pos_x = debug_player_pos[0];
+        engine->gui_debug_elements->player_pos_y = debug_player_pos[1];
+        engine->gui_debug_elements->player_pos_z = debug_player_pos[2];
 
         engine->gui_debug_elements->entity_count = engine->entity_manager->entity_count;
+        engine->gui_debug_elements->ground_cover_instances = engine->ground_cover->drawn_instances;
+        engine->gui_debug_elements->sim_ticks = engine->sim.last_ticks;
+        engine->gui_debug_elements->projectiles = engine->projectiles ? engine->projectiles->count : 0;
 
         // if (engine->gui_debug_elements->is_place_tree_click) printf("Clicked!\n");
-#endif
 
-        // Process input
-        // Handle escape key to close window
-        if (glfwGetKey(engine->window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-            glfwSetWindowShouldClose(engine->window, true);
-
-        // Clear
-        renderer_clear();
-
-        // Process player movement input FIRST (before camera matrices)
-        if (engine->player) {
-            player_process_input(engine->player, engine->window, dt);
-
-            // Camera follows player
-            camera_follow_target(camera,
-                engine->player->position[0],
-                engine->player->position[1],
-                engine->player->position[2]);
-        }
-
-#ifdef DEBUG_MODE
         // In debug mode, allow GUI to override player rotation only (not camera position)
         // Camera follows player automatically, but we can still control player rotation from GUI
-        // engine->player->rotation[0] = engine->gui_debug_elements->player_rotation_x;
-        // engine->player->rotation[1] = engine->gui_debug_elements->player_rotation_y;
-        // engine->player->rotation[2] = engine->gui_debug_elements->player_rotation_z;
+        // entity_manager_set_rotation(engine->entity_manager, engine->player,
+        //     (float[]){engine->gui_debug_elements->player_rotation_x,
+        //               engine->gui_debug_elements->player_rotation_y,
+        //               engine->gui_debug_elements->player_rotation_z});
 
         // Update GUI to show current camera state (for debugging display)
         // engine->gui_debug_elements->cam_pos_x = camera->pos_x;
@@ -296,38 +495,102 @@ void engine_run(Engine* engine) {
         int width, height;
         window_get_size(engine->window, &width, &height);
         camera_update_projection(camera, width, height, proj_matrix);
+
+        // Build entity draw packets from the finished simulation state. After
+        // this point rendering only reads the queue and its own matrix copies.
+        render_queue_begin(engine->render_queue);
+        if (engine->entity_manager) {
+            entity_manager_cull(engine->entity_manager, view_matrix, proj_matrix,
+                                camera->pos_x, camera->pos_y, camera->pos_z);
+            entity_manager_render(engine->entity_manager, engine->render_queue, proj_matrix, alpha);
+
+            const EntityCullStats* cull_stats = &engine->entity_manager->cull_stats;
+            engine->gui_debug_elements->entities_visible = cull_stats->visible;
+            engine->gui_debug_elements->entities_frustum_culled = cull_stats->frustum_culled;
+            engine->gui_debug_elements->entities_distance_culled = cull_stats->distance_culled;
+            engine->gui_debug_elements->entity_triangles = engine->entity_manager->lod_stats.triangles;
+            engine->gui_debug_elements->entity_triangles_full = engine->entity_manager->lod_stats.full_detail_triangles;
+        }
+        if (engine->projectiles && engine->projectile_renderer) {
+            projectile_renderer_prepare(engine->projectile_renderer, engine->projectiles, alpha);
+        }
+        if (engine->contrails) {
+            contrail_system_prepare(engine->contrails, alpha);
+        }
+
+        float view_proj[16];
+        Frustum frustum;
+        mat4_multiply(view_proj, proj_matrix, view_matrix);
+        frustum_from_matrix(&frustum, view_proj);
+        if (engine->enemy_renderer) {
+            enemy_renderer_prepare(engine->enemy_renderer, engine->enemies, &frustum, alpha);
+            engine->gui_debug_elements->enemies = engine->enemies ? engine->enemies->count : 0;
+            engine->gui_debug_elements->enemies_visible = enemy_renderer_instance_count(engine->enemy_renderer);
+        }
+        if (engine->explosions) {
+            explosion_system_prepare(engine->explosions, &frustum,
+                                     camera->pos_x, camera->pos_y, camera->pos_z, alpha);
+
+            engine->gui_debug_elements->explosions = engine->explosions->drawn_emitters;
+            engine->gui_debug_elements->explosion_particles = engine->explosions->instance_count;
+            engine->gui_debug_elements->explosion_particles_wanted = engine->explosions->requested_particles;
+        }
+
+#if SIM_PIPELINED
+        engine_schedule_ticks(engine, dt);
+        job_system_submit(engine->jobs, engine_simulate, engine, &engine->sim.counter);
+#endif
         
         // Update terrain - generate new chunks as camera moves (infinite terrain)
         // Pass raw camera world position - the update function calculates chunk positions
         terrain_lod_manager_update(engine->terrain, engine->seed, camera->pos_x, camera->pos_z);
 
-        // Update tree placement - spawn trees based on camera position
-        if (engine->tree_placement) {
-            tree_placement_update(engine->tree_placement, camera->pos_x, camera->pos_z);
-        }
-
-       // Update entities
-        if (engine->entity_manager) {
-            entity_manager_update(engine->entity_manager, dt);
+        // Update ground cover - build cells that came into range
+        if (engine->ground_cover) {
+            ground_cover_update(engine->ground_cover, camera->pos_x, camera->pos_z);
         }
 
+        // Upload camera, light and time once for every pass
+        FrameData frame;
+        memcpy(frame.persp, proj_matrix, sizeof(frame.persp));
+        memcpy(frame.view, view_matrix, sizeof(frame.view));
+        frame.lightdir[0] = LIGHT_DIR_X;
+        frame.lightdir[1] = LIGHT_DIR_Y;
+        frame.lightdir[2] = LIGHT_DIR_Z;
+        frame.time = (float)current_time;
+        frame.camerapos[0] = camera->pos_x;
+        frame.camerapos[1] = camera->pos_y;
+        frame.camerapos[2] = camera->pos_z;
+        frame.viewdist = FOG_START_DIST;
+        frame_data_update(engine->frame_data, &frame);
 
         // 1. Render terrain first (with clean state)
         state_restore_defaults();
         glDepthMask(GL_TRUE);
         glDepthFunc(GL_LESS);
 
-        terrain_lod_manager_render(engine->terrain, view_matrix, proj_matrix,
-                                   camera->pos_x, camera->pos_y, camera->pos_z,
-                                   (float)current_time);
+        terrain_lod_manager_render(engine->terrain);
 
-        // 2. Render entities (opaque objects)
-        if (engine->entity_manager) {
-            state_restore_defaults();
-            entity_manager_render(engine->entity_manager, view_matrix, proj_matrix,
-                                camera->pos_x, camera->pos_y, camera->pos_z);
+        // Ground cover (alpha tested, drawn with terrain state)
+        if (engine->ground_cover) {
+            ground_cover_render(engine->ground_cover, camera->pos_x, camera->pos_z);
         }
 
+        // 2. Render entities (opaque objects) through the sorted queue
+        state_restore_defaults();
+        render_queue_submit(engine->render_queue);
+        if (engine->projectile_renderer) {
+            projectile_renderer_render(engine->projectile_renderer);
+        }
+        if (engine->enemy_renderer) {
+            enemy_renderer_render(engine->enemy_renderer);
+        }
+
+        const RenderStats* render_stats = &engine->render_queue->stats;
+        engine->gui_debug_elements->draw_calls = render_stats->draw_calls;
+        engine->gui_debug_elements->state_changes = render_stats->shader_binds + render_stats->material_binds +
+                                                    render_stats->texture_binds + render_stats->vao_binds;
+
         // 3. Render water with transparency
         glEnable(GL_DEPTH_TEST);
         glDepthFunc(GL_LEQUAL);
@@ -336,13 +599,21 @@ void engine_run(Engine* engine) {
         state_set_depth_mask(GL_FALSE);
         state_disable_cull_face();
 
-        water_render_gl(engine->water, proj_matrix, view_matrix,
-                       camera->pos_x, camera->pos_y, camera->pos_z,
-                       (float)current_time);
+        water_render_gl(engine->water, camera->pos_x, camera->pos_z);
 
         // 4. Render skybox LAST (so it doesn't affect other rendering)
         state_restore_defaults();
-        skybox_render(engine->skybox, proj_matrix, view_matrix);
+        skybox_render(engine->skybox);
+
+        // 5. Contrails and explosions blend over everything, sky included
+        if (engine->contrails) {
+            contrail_system_render(engine->contrails);
+            engine->gui_debug_elements->contrail_points = engine->contrails->uploaded_points;
+        }
+        if (engine->explosions) {
+            explosion_system_render(engine->explosions);
+        }
+        frame_data_end_frame(engine->frame_data);
         
         // Render GUI
         nk_glfw3_new_frame(&engine->nk_glfw);
@@ -358,11 +629,17 @@ void engine_run(Engine* engine) {
         glfwSwapBuffers(engine->window);
         glfwPollEvents();
     }
+
+    // Let an in-flight simulation step finish before anything is torn down
+    job_system_wait(engine->jobs, &engine->sim.counter);
 }
 
 void engine_cleanup(Engine* engine) {
     printf("\nCleaning up...\n");
 
+    // Stop the workers before tearing down anything their jobs touch
+    job_system_shutdown(engine->jobs);
+
     // Cleanup entities
     if (engine->tree_placement) {
         tree_placement_cleanup(engine->tree_placement);
@@ -370,6 +647,16 @@ void engine_cleanup(Engine* engine) {
     if (engine->entity_manager) {
         entity_manager_cleanup(engine->entity_manager);
     }
+    if (engine->ground_cover) {
+        ground_cover_cleanup(engine->ground_cover);
+    }
+    projectile_system_free(engine->projectiles);
+    projectile_renderer_cleanup(engine->projectile_renderer);
+    explosion_system_cleanup(engine->explosions);
+    contrail_system_cleanup(engine->contrails);
+    enemy_system_free(engine->enemies);
+    enemy_renderer_cleanup(engine->enemy_renderer);
+    render_queue_free(engine->render_queue);
 
     // Cleanup world
     if (engine->terrain) {
@@ -384,6 +671,7 @@ void engine_cleanup(Engine* engine) {
         skybox_cleanup(engine->skybox);
         free(engine->skybox);
     }
+    frame_data_cleanup(engine->frame_data);
     if (engine->seed) {
         free(engine->seed);
     }
@@ -393,6 +681,9 @@ void engine_cleanup(Engine* engine) {
         free(engine->camera);
     }
 
+    // Loads still pending were cancelled above; retire them while GL is up
+    asset_loader_shutdown();
+
     // Cleanup GUI
     nk_glfw3_shutdown(&engine->nk_glfw);
 
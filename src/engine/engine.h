@@ -19,9 +19,34 @@
 #include "../gui.h"
 #include "../world/terrain.h"
 #include "../world/tree_placement.h"
+#include "../world/ground_cover.h"
 #include "../entities/entity_manager.h"
+#include "../entities/player.h"
+#include "../entities/projectile.h"
+#include "../entities/projectile_renderer.h"
+#include "../entities/contrail.h"
+#include "../entities/explosion.h"
+#include "../entities/enemy.h"
+#include "../entities/enemy_renderer.h"
+#include "../graphics/render_queue.h"
+#include "../graphics/frame_data.h"
+#include "job_system.h"
 #include <stdbool.h>
 
+// Fixed-rate simulation. Each frame adds its duration to the accumulator and
+// runs whole SIM_TICK_DT ticks out of it; rendering blends the last two
+// tick states by what is left over.
+typedef struct {
+    double accumulator;         // Time not yet simulated
+    float alpha;                // Blend factor for the state being rendered
+    unsigned int pending_ticks; // Ticks the next simulation step runs
+    unsigned int last_ticks;    // Ticks run by the last step (debug overlay)
+    PlayerInput input;          // Input those ticks consume
+    float focus_x, focus_z;     // Camera position for streaming decisions
+    float fire_cooldown;        // Time until the player can fire again
+    JobCounter counter;         // Pipelined step still running
+} EngineSim;
+
 typedef struct {
     GLFWwindow* window;
     Camera* camera;
@@ -39,6 +64,7 @@ typedef struct {
     // Timing
     double last_time;
     bool running;
+    EngineSim sim;
 
     // Mouse Position
     double mouse_x;
@@ -47,11 +73,37 @@ typedef struct {
 
     // Entities
     EntityManager* entity_manager;
-    Entity* player;  // Reference to player entity for camera follow
+    EntityHandle player;  // Reference to player entity for camera follow
 
     // Tree placement
     TreePlacementManager* tree_placement;
 
+    // Bullets, simulated with the entities and drawn in one instanced pass
+    ProjectileSystem* projectiles;
+    ProjectileRenderer* projectile_renderer;
+
+    // Explosion particles (impacts and blasts)
+    ExplosionSystem* explosions;
+
+    // Trails behind aircraft
+    ContrailSystem* contrails;
+
+    // Enemy swarm, steered on the job pool and drawn instanced per model
+    EnemySystem* enemies;
+    EnemyRenderer* enemy_renderer;
+
+    // Grass and shrubs
+    GroundCoverManager* ground_cover;
+
+    // Sorted per-frame draw packets (entities)
+    RenderQueue* render_queue;
+
+    // Camera/light/time uniform block shared by all programs
+    FrameDataBuffer* frame_data;
+
+    // Worker pool (the main thread is worker 0 and owns all GL work)
+    JobSystem* jobs;
+
 } Engine;
 
 // Initialize the engine (creates window, loads resources, etc.)
@@ -0,0 +1,414 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DARWIN_C_SOURCE    // _SC_NPROCESSORS_ONLN on macOS
+#include "job_system.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define JOB_QUEUE_MASK (JOB_QUEUE_CAPACITY - 1)
+#define JOB_SPIN_LIMIT 64           // Failed searches before a worker sleeps
+#define JOB_BATCHES_PER_WORKER 4    // parallel_for oversplits for load balance
+
+// Job held back until a counter reaches zero
+typedef struct JobDeferred {
+    JobSystem* system;
+    Job job;
+    struct JobDeferred* next;
+} JobDeferred;
+
+static __thread unsigned int tls_worker_index = 0;
+
+static void job_system_run(JobSystem* system, const Job* job);
+
+// Chase-Lev deque ("Correct and Efficient Work-Stealing for Weak Memory
+// Models", Le et al. 2013). Slots are read and written field by field with
+// relaxed atomics: a thief may read a slot the owner is reusing, but then its
+// CAS on top fails and the copy is discarded.
+
+static void job_slot_store(Job* slot, const Job* job) {
+    __atomic_store_n(&slot->func, job->func, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->data, job->data, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->counter, job->counter, __ATOMIC_RELAXED);
+}
+
+static void job_slot_load(Job* slot, Job* out) {
+    out->func = __atomic_load_n(&slot->func, __ATOMIC_RELAXED);
+    out->data = __atomic_load_n(&slot->data, __ATOMIC_RELAXED);
+    out->counter = __atomic_load_n(&slot->counter, __ATOMIC_RELAXED);
+}
+
+static bool job_deque_push(JobDeque* deque, const Job* job) {
+    int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    int64_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    if (bottom - top >= JOB_QUEUE_CAPACITY) return false;
+
+    job_slot_store(&deque->slots[bottom & JOB_QUEUE_MASK], job);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+static bool job_deque_pop(JobDeque* deque, Job* out) {
+    int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&deque->bottom, bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+    if (top > bottom) {
+        // Empty
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    job_slot_load(&deque->slots[bottom & JOB_QUEUE_MASK], out);
+    if (top == bottom) {
+        // Last job: race thieves for it
+        bool won = __atomic_compare_exchange_n(&deque->top, &top, top + 1, false,
+                                               __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return won;
+    }
+    return true;
+}
+
+static bool job_deque_steal(JobDeque* deque, Job* out) {
+    int64_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+    if (top >= bottom) return false;
+
+    job_slot_load(&deque->slots[top & JOB_QUEUE_MASK], out);
+    return __atomic_compare_exchange_n(&deque->top, &top, top + 1, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+// Scheduling
+
+static void job_system_wake(JobSystem* system) {
+    if (__atomic_load_n(&system->sleeping, __ATOMIC_SEQ_CST) == 0) return;
+    pthread_mutex_lock(&system->sleep_mutex);
+    pthread_cond_signal(&system->sleep_cond);
+    pthread_mutex_unlock(&system->sleep_mutex);
+}
+
+// Queue an already counted job on the calling worker's deque
+static void job_system_push(JobSystem* system, const Job* job) {
+    JobDeque* deque = &system->deques[tls_worker_index];
+    __atomic_add_fetch(&system->queued, 1, __ATOMIC_SEQ_CST);
+    if (!job_deque_push(deque, job)) {
+        // Deque full: run it here rather than fail
+        __atomic_sub_fetch(&system->queued, 1, __ATOMIC_SEQ_CST);
+        job_system_run(system, job);
+        return;
+    }
+    job_system_wake(system);
+}
+
+static bool job_system_find(JobSystem* system, unsigned int index, Job* out) {
+    if (job_deque_pop(&system->deques[index], out)) {
+        __atomic_sub_fetch(&system->queued, 1, __ATOMIC_SEQ_CST);
+        return true;
+    }
+
+    // Steal, starting after ourselves so thieves spread over victims
+    for (unsigned int k = 1; k < system->worker_count; k++) {
+        unsigned int victim = (index + k) % system->worker_count;
+        if (job_deque_steal(&system->deques[victim], out)) {
+            __atomic_sub_fetch(&system->queued, 1, __ATOMIC_SEQ_CST);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void job_counter_lock(JobCounter* counter) {
+    while (__atomic_exchange_n(&counter->lock, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(&counter->lock, __ATOMIC_RELAXED)) sched_yield();
+    }
+}
+
+static void job_counter_unlock(JobCounter* counter) {
+    __atomic_store_n(&counter->lock, 0, __ATOMIC_RELEASE);
+}
+
+// Finish one job of counter, releasing its dependents when it drops to zero
+static void job_counter_complete(JobCounter* counter) {
+    if (!counter) return;
+    if (__atomic_sub_fetch(&counter->value, 1, __ATOMIC_ACQ_REL) != 0) return;
+
+    job_counter_lock(counter);
+    JobDeferred* waiters = counter->waiters;
+    counter->waiters = NULL;
+    job_counter_unlock(counter);
+
+    while (waiters) {
+        JobDeferred* next = waiters->next;
+        job_system_push(waiters->system, &waiters->job);
+        free(waiters);
+        waiters = next;
+    }
+}
+
+static void job_system_run(JobSystem* system, const Job* job) {
+    (void)system;
+    job->func(job->data);
+    job_counter_complete(job->counter);
+}
+
+static bool job_system_pop_main(JobSystem* system, Job* out) {
+    if (__atomic_load_n(&system->main_count, __ATOMIC_ACQUIRE) == 0) return false;
+
+    bool found = false;
+    pthread_mutex_lock(&system->main_mutex);
+    if (system->main_count > 0) {
+        *out = system->main_jobs[0];
+        unsigned int remaining = system->main_count - 1;
+        memmove(system->main_jobs, system->main_jobs + 1, sizeof(Job) * remaining);
+        __atomic_store_n(&system->main_count, remaining, __ATOMIC_RELEASE);
+        found = true;
+    }
+    pthread_mutex_unlock(&system->main_mutex);
+    return found;
+}
+
+static void* job_worker_main(void* arg) {
+    JobWorkerStart* start = arg;
+    JobSystem* system = start->system;
+    tls_worker_index = start->index;
+
+    unsigned int spins = 0;
+    while (__atomic_load_n(&system->running, __ATOMIC_ACQUIRE)) {
+        Job job;
+        if (job_system_find(system, tls_worker_index, &job)) {
+            job_system_run(system, &job);
+            spins = 0;
+            continue;
+        }
+
+        if (++spins < JOB_SPIN_LIMIT) {
+            sched_yield();
+            continue;
+        }
+
+        pthread_mutex_lock(&system->sleep_mutex);
+        __atomic_add_fetch(&system->sleeping, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&system->queued, __ATOMIC_SEQ_CST) == 0 &&
+               __atomic_load_n(&system->running, __ATOMIC_ACQUIRE)) {
+            pthread_cond_wait(&system->sleep_cond, &system->sleep_mutex);
+        }
+        __atomic_sub_fetch(&system->sleeping, 1, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&system->sleep_mutex);
+        spins = 0;
+    }
+    return NULL;
+}
+
+// Public API
+
+JobSystem* job_system_create(unsigned int worker_count) {
+    if (worker_count == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        worker_count = cpus > 0 ? (unsigned int)cpus : 1;
+    }
+    if (worker_count > JOB_MAX_WORKERS) worker_count = JOB_MAX_WORKERS;
+
+    JobSystem* system = malloc(sizeof(JobSystem));
+    if (!system) return NULL;
+    memset(system, 0, sizeof(JobSystem));
+
+    for (unsigned int i = 0; i < worker_count; i++) {
+        system->deques[i].slots = malloc(sizeof(Job) * JOB_QUEUE_CAPACITY);
+    }
+    pthread_mutex_init(&system->sleep_mutex, NULL);
+    pthread_cond_init(&system->sleep_cond, NULL);
+    pthread_mutex_init(&system->main_mutex, NULL);
+
+    // worker_count is fixed before any thread starts, since workers read it to
+    // pick victims. A worker that fails to start just leaves an empty deque.
+    tls_worker_index = 0;
+    system->running = 1;
+    system->worker_count = worker_count;
+    system->thread_count = 0;
+    for (unsigned int i = 1; i < worker_count; i++) {
+        system->starts[i].system = system;
+        system->starts[i].index = i;
+        if (pthread_create(&system->threads[system->thread_count], NULL, job_worker_main,
+                           &system->starts[i]) != 0) {
+            fprintf(stderr, "Failed to start job worker %u\n", i);
+            continue;
+        }
+        system->thread_count++;
+    }
+
+    printf("Job system started: %u pool threads + main thread\n", system->thread_count);
+    return system;
+}
+
+void job_system_shutdown(JobSystem* system) {
+    if (!system) return;
+
+    // Let queued work finish, then release the sleepers
+    Job job;
+    while (job_system_pop_main(system, &job) || job_system_find(system, tls_worker_index, &job)) {
+        job_system_run(system, &job);
+    }
+    while (__atomic_load_n(&system->queued, __ATOMIC_SEQ_CST) > 0) sched_yield();
+
+    pthread_mutex_lock(&system->sleep_mutex);
+    __atomic_store_n(&system->running, 0, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&system->sleep_cond);
+    pthread_mutex_unlock(&system->sleep_mutex);
+
+    for (unsigned int i = 0; i < system->thread_count; i++) {
+        pthread_join(system->threads[i], NULL);
+    }
+
+    for (unsigned int i = 0; i < JOB_MAX_WORKERS; i++) {
+        free(system->deques[i].slots);
+    }
+    pthread_mutex_destroy(&system->sleep_mutex);
+    pthread_cond_destroy(&system->sleep_cond);
+    pthread_mutex_destroy(&system->main_mutex);
+    free(system->main_jobs);
+
+    printf("Job system shut down\n");
+    free(system);
+}
+
+unsigned int job_system_worker_count(const JobSystem* system) {
+    return system ? system->worker_count : 1;
+}
+
+unsigned int job_system_worker_index(void) {
+    return tls_worker_index;
+}
+
+void job_system_submit(JobSystem* system, JobFunc func, void* data, JobCounter* counter) {
+    Job job = {func, data, counter};
+    if (counter) __atomic_add_fetch(&counter->value, 1, __ATOMIC_ACQ_REL);
+    job_system_push(system, &job);
+}
+
+void job_system_submit_main(JobSystem* system, JobFunc func, void* data, JobCounter* counter) {
+    if (counter) __atomic_add_fetch(&counter->value, 1, __ATOMIC_ACQ_REL);
+
+    pthread_mutex_lock(&system->main_mutex);
+    if (system->main_count >= system->main_capacity) {
+        system->main_capacity = system->main_capacity ? system->main_capacity * 2 : 64;
+        system->main_jobs = realloc(system->main_jobs, sizeof(Job) * system->main_capacity);
+    }
+    system->main_jobs[system->main_count] = (Job){func, data, counter};
+    __atomic_store_n(&system->main_count, system->main_count + 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&system->main_mutex);
+}
+
+void job_system_submit_after(JobSystem* system, JobCounter* dependency,
+                             JobFunc func, void* data, JobCounter* counter) {
+    if (counter) __atomic_add_fetch(&counter->value, 1, __ATOMIC_ACQ_REL);
+    Job job = {func, data, counter};
+
+    if (dependency) {
+        job_counter_lock(dependency);
+        if (__atomic_load_n(&dependency->value, __ATOMIC_ACQUIRE) != 0) {
+            JobDeferred* deferred = malloc(sizeof(JobDeferred));
+            deferred->system = system;
+            deferred->job = job;
+            deferred->next = dependency->waiters;
+            dependency->waiters = deferred;
+            job_counter_unlock(dependency);
+            return;
+        }
+        job_counter_unlock(dependency);
+    }
+    job_system_push(system, &job);
+}
+
+void job_system_wait(JobSystem* system, JobCounter* counter) {
+    if (!counter) return;
+
+    bool main_thread = tls_worker_index == 0;
+    while (__atomic_load_n(&counter->value, __ATOMIC_ACQUIRE) != 0) {
+        Job job;
+        if ((main_thread && job_system_pop_main(system, &job)) ||
+            job_system_find(system, tls_worker_index, &job)) {
+            job_system_run(system, &job);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+unsigned int job_system_run_main_jobs(JobSystem* system) {
+    if (!system || tls_worker_index != 0) return 0;
+
+    unsigned int ran = 0;
+    Job job;
+    while (job_system_pop_main(system, &job)) {
+        job_system_run(system, &job);
+        ran++;
+    }
+    return ran;
+}
+
+unsigned int job_system_batch_size(const JobSystem* system, unsigned int count, unsigned int min_batch) {
+    unsigned int workers = job_system_worker_count(system);
+    if (workers <= 1) return count > 0 ? count : 1;  // One inline batch
+
+    unsigned int target = workers * JOB_BATCHES_PER_WORKER;
+    if (target > JOB_PARALLEL_MAX_BATCHES) target = JOB_PARALLEL_MAX_BATCHES;
+
+    unsigned int size = (count + target - 1) / target;
+    if (size < min_batch) size = min_batch;
+
+    // Multiples of 4 keep 4-wide SIMD bodies from leaving a scalar tail in
+    // every batch, so results match a single pass over the whole range
+    return (size + 3) & ~3u;
+}
+
+typedef struct {
+    JobRangeFunc func;
+    void* data;
+    unsigned int begin;
+    unsigned int end;
+} JobRange;
+
+static void job_range_run(void* data) {
+    JobRange* range = data;
+    range->func(range->data, range->begin, range->end);
+}
+
+void job_system_parallel_for(JobSystem* system, unsigned int count, unsigned int min_batch,
+                             JobRangeFunc func, void* data) {
+    if (count == 0) return;
+
+    unsigned int size = job_system_batch_size(system, count, min_batch);
+    unsigned int batches = (count + size - 1) / size;
+
+    // Same batches either way, so per-batch results line up
+    if (!system || system->worker_count <= 1 || batches <= 1) {
+        for (unsigned int begin = 0; begin < count; begin += size) {
+            func(data, begin, begin + size < count ? begin + size : count);
+        }
+        return;
+    }
+
+    JobRange ranges[JOB_PARALLEL_MAX_BATCHES];
+    JobCounter counter;
+    memset(&counter, 0, sizeof(counter));
+
+    for (unsigned int b = 0; b < batches; b++) {
+        ranges[b].func = func;
+        ranges[b].data = data;
+        ranges[b].begin = b * size;
+        ranges[b].end = (b + 1) * size < count ? (b + 1) * size : count;
+    }
+
+    // Queue all but the first batch, which this thread runs right away
+    for (unsigned int b = batches - 1; b > 0; b--) {
+        job_system_submit(system, job_range_run, &ranges[b], &counter);
+    }
+    job_range_run(&ranges[0]);
+    job_system_wait(system, &counter);
+}
@@ -0,0 +1,117 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Work-stealing job system.
+//
+// The main thread is worker 0; the other workers are pool threads. Every
+// worker owns a Chase-Lev deque: it pushes and pops its own jobs at the
+// bottom, idle workers steal from the top. Jobs submitted with main affinity
+// (anything touching GL) go to a separate queue that only the main thread
+// drains, from job_system_wait or job_system_run_main_jobs.
+//
+// Completion is tracked with counters: submitting a job increments its
+// counter and finishing it decrements it, so waiting for zero waits for a
+// whole group. A job can also be held back until another counter reaches
+// zero, which is how dependencies are expressed.
+
+#define JOB_QUEUE_CAPACITY 4096         // Per worker, power of two
+#define JOB_MAX_WORKERS 64
+#define JOB_PARALLEL_MAX_BATCHES 256    // Jobs one parallel_for call may split into
+
+typedef void (*JobFunc)(void* data);
+
+// Range body for job_system_parallel_for: process indices [begin, end)
+typedef void (*JobRangeFunc)(void* data, unsigned int begin, unsigned int end);
+
+// Zero-initialize before first use
+typedef struct JobCounter {
+    int value;                      // Outstanding jobs (atomic)
+    int lock;                       // Spin lock guarding waiters
+    struct JobDeferred* waiters;    // Jobs released when value reaches zero
+} JobCounter;
+
+typedef struct {
+    JobFunc func;
+    void* data;
+    JobCounter* counter;            // May be NULL
+} Job;
+
+typedef struct {
+    int64_t top;                    // Steal end (atomic)
+    int64_t bottom;                 // Owner end (atomic)
+    Job* slots;                     // Ring of JOB_QUEUE_CAPACITY
+    char pad[64];                   // Keep neighbouring deques off this cache line
+} JobDeque;
+
+typedef struct JobSystem JobSystem;
+
+typedef struct {
+    JobSystem* system;
+    unsigned int index;
+} JobWorkerStart;
+
+struct JobSystem {
+    JobDeque deques[JOB_MAX_WORKERS];
+    unsigned int worker_count;      // Including the main thread
+    pthread_t threads[JOB_MAX_WORKERS];
+    unsigned int thread_count;      // Pool threads actually started
+    JobWorkerStart starts[JOB_MAX_WORKERS];
+    int running;                    // Cleared to stop the pool (atomic)
+
+    // Sleeping workers wait here until a job is queued
+    pthread_mutex_t sleep_mutex;
+    pthread_cond_t sleep_cond;
+    int queued;                     // Jobs sitting in deques (atomic)
+    int sleeping;                   // Workers blocked on sleep_cond (atomic)
+
+    // Main-affinity jobs
+    pthread_mutex_t main_mutex;
+    Job* main_jobs;
+    unsigned int main_count;
+    unsigned int main_capacity;
+};
+
+// worker_count counts the main thread; 0 sizes the pool to the online CPUs.
+// Must be called from the thread that will act as the main thread.
+JobSystem* job_system_create(unsigned int worker_count);
+
+// Finish outstanding jobs, then stop and join the pool threads
+void job_system_shutdown(JobSystem* system);
+
+unsigned int job_system_worker_count(const JobSystem* system);
+
+// Index of the calling worker (0 on the main thread)
+unsigned int job_system_worker_index(void);
+
+// Queue a job on the calling worker's deque
+void job_system_submit(JobSystem* system, JobFunc func, void* data, JobCounter* counter);
+
+// Queue a job that only the main thread may run (GL calls)
+void job_system_submit_main(JobSystem* system, JobFunc func, void* data, JobCounter* counter);
+
+// Queue a job once dependency reaches zero (immediately if it already has)
+void job_system_submit_after(JobSystem* system, JobCounter* dependency,
+                             JobFunc func, void* data, JobCounter* counter);
+
+// Run jobs until counter reaches zero. The main thread also runs main-affinity jobs.
+void job_system_wait(JobSystem* system, JobCounter* counter);
+
+// Drain the main-affinity queue (main thread only); returns the number run
+unsigned int job_system_run_main_jobs(JobSystem* system);
+
+// Batch size parallel_for uses for this range (a multiple of 4 when split);
+// batch b covers [b * size, min((b + 1) * size, count)), for callers keeping
+// per-batch results
+unsigned int job_system_batch_size(const JobSystem* system, unsigned int count, unsigned int min_batch);
+
+// Split [0, count) into batches of job_system_batch_size indices, run them
+// on the pool and wait. Runs the batches inline when system is NULL or
+// single threaded.
+void job_system_parallel_for(JobSystem* system, unsigned int count, unsigned int min_batch,
+                             JobRangeFunc func, void* data);
+
+#endif // JOB_SYSTEM_H
@@ -0,0 +1,343 @@
+#include "contrail.h"
+#include "../file_ops.h"
+#include "../graphics/state.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+ContrailSystem* contrail_system_create(void) {
+    ContrailSystem* system = malloc(sizeof(ContrailSystem));
+    memset(system, 0, sizeof(ContrailSystem));
+
+    // Emission time -1 marks a slot that never held a point
+    unsigned int total = CONTRAIL_MAX_EMITTERS * CONTRAIL_POINTS;
+    system->points = malloc(sizeof(float[4]) * total);
+    for (unsigned int i = 0; i < total; i++) {
+        system->points[i][0] = 0.0f;
+        system->points[i][1] = 0.0f;
+        system->points[i][2] = 0.0f;
+        system->points[i][3] = -1.0f;
+    }
+    system->staging = malloc(sizeof(float[4]) * total);
+
+    for (unsigned int t = 0; t < CONTRAIL_SWARM_TRAILS; t++) {
+        system->swarm_trails[t].emitter = -1;
+    }
+    system->swarm_ranked = -CONTRAIL_SWARM_INTERVAL;
+
+    glGenBuffers(1, &system->buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, system->buffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(float[4]) * total, system->points, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glGenTextures(1, &system->buffer_texture);
+    glBindTexture(GL_TEXTURE_BUFFER, system->buffer_texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, system->buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    // Core profile needs a bound VAO even with no attributes
+    glGenVertexArrays(1, &system->vao);
+
+    const char* vert_src = load_shader_source("assets/shaders/trailvert.glsl");
+    const char* frag_src = load_shader_source("assets/shaders/trailfrag.glsl");
+    system->shader = shader_create(vert_src, frag_src, "contrail");
+    free((void*)vert_src);
+    free((void*)frag_src);
+
+    ContrailUniforms* u = &system->uniforms;
+    u->points = shader_uniform(&system->shader, "points");
+    u->pointcount = shader_uniform(&system->shader, "pointcount");
+    u->now = shader_uniform(&system->shader, "now");
+    u->lifetime = shader_uniform(&system->shader, "lifetime");
+    u->width = shader_uniform(&system->shader, "width");
+    u->spread = shader_uniform(&system->shader, "spread");
+
+    printf("Contrails initialized (%d emitters, %d points each)\n", CONTRAIL_MAX_EMITTERS, CONTRAIL_POINTS);
+
+    return system;
+}
+
+// Take a free emitter and start it emitting; -1 if none is free
+static int contrail_claim(ContrailSystem* system) {
+    for (unsigned int i = 0; i < CONTRAIL_MAX_EMITTERS; i++) {
+        ContrailEmitter* emitter = &system->emitters[i];
+        if (emitter->in_use) continue;
+
+        // A reused ring still holds the previous trail, all of it past its
+        // lifetime by now, so the shader drops it until it is overwritten
+        memset(emitter, 0, sizeof(ContrailEmitter));
+        emitter->in_use = true;
+        emitter->emitting = true;
+        emitter->last_emit = system->time - CONTRAIL_POINT_INTERVAL;
+
+        if (i + 1 > system->emitter_span) system->emitter_span = i + 1;
+        return (int)i;
+    }
+    return -1;
+}
+
+int contrail_attach(ContrailSystem* system, EntityHandle owner, const float offset[3]) {
+    if (!system) return -1;
+
+    int e = contrail_claim(system);
+    if (e < 0) {
+        fprintf(stderr, "Warning: No free contrail emitter\n");
+        return -1;
+    }
+
+    ContrailEmitter* emitter = &system->emitters[e];
+    emitter->owner = owner;
+    memcpy(emitter->offset, offset, sizeof(float[3]));
+    return e;
+}
+
+void contrail_detach(ContrailSystem* system, int emitter) {
+    if (!system || emitter < 0 || emitter >= CONTRAIL_MAX_EMITTERS) return;
+    system->emitters[emitter].emitting = false;
+}
+
+// Index of the agent with id, trying where it was last found first
+static bool contrail_find_agent(const ContrailSwarm* swarm, uint32_t id, unsigned int* index) {
+    if (*index < swarm->count && swarm->ids[*index] == id) return true;
+
+    for (unsigned int i = 0; i < swarm->count; i++) {
+        if (swarm->ids[i] == id) {
+            *index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool contrail_is_trailing(const ContrailSystem* system, uint32_t id) {
+    for (unsigned int t = 0; t < CONTRAIL_SWARM_TRAILS; t++) {
+        const ContrailSwarmTrail* trail = &system->swarm_trails[t];
+        if (trail->emitter >= 0 && trail->id == id) return true;
+    }
+    return false;
+}
+
+// Move the trails onto the agents nearest the focus
+static void contrail_rank_swarm(ContrailSystem* system, const ContrailSwarm* swarm, float focus_x, float focus_z) {
+    const float range_sq = CONTRAIL_SWARM_RANGE * CONTRAIL_SWARM_RANGE;
+    const float keep = 0.64f;   // Squared distance scale of trailing agents (a fifth closer)
+
+    // Nearest agents by squared distance, sorted
+    float nearest_sq[CONTRAIL_SWARM_TRAILS];
+    unsigned int nearest[CONTRAIL_SWARM_TRAILS];
+    unsigned int nearest_count = 0;
+
+    for (unsigned int i = 0; i < swarm->count; i++) {
+        float dx = swarm->x[i] - focus_x;
+        float dz = swarm->z[i] - focus_z;
+        float d = dx * dx + dz * dz;
+
+        // Out even with the trailing bonus: skip the trail lookup
+        float cut = nearest_count == CONTRAIL_SWARM_TRAILS ? nearest_sq[nearest_count - 1] : range_sq;
+        if (d * keep >= cut) continue;
+        if (contrail_is_trailing(system, swarm->ids[i])) d *= keep;
+        if (d >= cut) continue;
+
+        unsigned int slot = nearest_count < CONTRAIL_SWARM_TRAILS ? nearest_count++ : nearest_count - 1;
+        while (slot > 0 && nearest_sq[slot - 1] > d) {
+            nearest_sq[slot] = nearest_sq[slot - 1];
+            nearest[slot] = nearest[slot - 1];
+            slot--;
+        }
+        nearest_sq[slot] = d;
+        nearest[slot] = i;
+    }
+
+    // Drop trails that fell out; they fade like detached ones
+    for (unsigned int t = 0; t < CONTRAIL_SWARM_TRAILS; t++) {
+        ContrailSwarmTrail* trail = &system->swarm_trails[t];
+        if (trail->emitter < 0) continue;
+
+        bool kept = false;
+        for (unsigned int n = 0; n < nearest_count && !kept; n++) {
+            kept = swarm->ids[nearest[n]] == trail->id;
+        }
+        if (!kept) {
+            contrail_detach(system, trail->emitter);
+            trail->emitter = -1;
+        }
+    }
+
+    // Start trails on the newcomers, nearest first, while emitters last
+    unsigned int t = 0;
+    for (unsigned int n = 0; n < nearest_count; n++) {
+        uint32_t id = swarm->ids[nearest[n]];
+        if (contrail_is_trailing(system, id)) continue;
+
+        while (t < CONTRAIL_SWARM_TRAILS && system->swarm_trails[t].emitter >= 0) t++;
+        if (t == CONTRAIL_SWARM_TRAILS) break;
+
+        int e = contrail_claim(system);
+        if (e < 0) break;
+        system->emitters[e].tracked = true;
+
+        ContrailSwarmTrail* trail = &system->swarm_trails[t];
+        trail->id = id;
+        trail->index = nearest[n];
+        trail->emitter = e;
+    }
+}
+
+void contrail_track_swarm(ContrailSystem* system, const ContrailSwarm* swarm, float focus_x, float focus_z) {
+    if (!system || !swarm) return;
+
+    // Agents removed since the last tick leave their trail behind
+    for (unsigned int t = 0; t < CONTRAIL_SWARM_TRAILS; t++) {
+        ContrailSwarmTrail* trail = &system->swarm_trails[t];
+        if (trail->emitter >= 0 && !contrail_find_agent(swarm, trail->id, &trail->index)) {
+            contrail_detach(system, trail->emitter);
+            trail->emitter = -1;
+        }
+    }
+
+    if (system->time - system->swarm_ranked >= CONTRAIL_SWARM_INTERVAL) {
+        system->swarm_ranked = system->time;
+        contrail_rank_swarm(system, swarm, focus_x, focus_z);
+    }
+
+    // Picked up by contrail_system_update
+    for (unsigned int t = 0; t < CONTRAIL_SWARM_TRAILS; t++) {
+        const ContrailSwarmTrail* trail = &system->swarm_trails[t];
+        if (trail->emitter < 0) continue;
+
+        ContrailEmitter* emitter = &system->emitters[trail->emitter];
+        emitter->position[0] = swarm->x[trail->index];
+        emitter->position[1] = swarm->y[trail->index];
+        emitter->position[2] = swarm->z[trail->index];
+    }
+}
+
+void contrail_system_update(ContrailSystem* system, const EntityManager* manager, float dt) {
+    if (!system) return;
+    system->time += dt;
+    system->tick_dt = dt;
+
+    for (unsigned int e = 0; e < system->emitter_span; e++) {
+        ContrailEmitter* emitter = &system->emitters[e];
+        if (!emitter->in_use) continue;
+
+        unsigned int index = 0;
+        if (emitter->emitting && !emitter->tracked && !entity_manager_lookup(manager, emitter->owner, &index)) {
+            emitter->emitting = false;
+        }
+        if (!emitter->emitting) {
+            // Free the ring once its newest point has faded
+            if (system->time - emitter->last_emit > CONTRAIL_LIFETIME) emitter->in_use = false;
+            continue;
+        }
+        if (system->time - emitter->last_emit < CONTRAIL_POINT_INTERVAL) continue;
+
+        float* point = system->points[e * CONTRAIL_POINTS + (emitter->written & (CONTRAIL_POINTS - 1))];
+        if (emitter->tracked) {
+            memcpy(point, emitter->position, sizeof(float[3]));
+        } else {
+            const float* m = manager->transforms[index];
+            const float* o = emitter->offset;
+            point[0] = m[0] * o[0] + m[4] * o[1] + m[8] * o[2] + m[12];
+            point[1] = m[1] * o[0] + m[5] * o[1] + m[9] * o[2] + m[13];
+            point[2] = m[2] * o[0] + m[6] * o[1] + m[10] * o[2] + m[14];
+        }
+        point[3] = system->time;
+
+        emitter->written++;
+        emitter->last_emit = system->time;
+    }
+
+    while (system->emitter_span > 0 && !system->emitters[system->emitter_span - 1].in_use) {
+        system->emitter_span--;
+    }
+}
+
+void contrail_system_prepare(ContrailSystem* system, float alpha) {
+    system->upload_count = 0;
+    unsigned int staged = 0;
+    for (unsigned int e = 0; e < system->emitter_span; e++) {
+        ContrailEmitter* emitter = &system->emitters[e];
+        unsigned int remaining = emitter->written - emitter->uploaded;
+        emitter->uploaded = emitter->written;
+
+        // More than a ring behind (a hitch): only the last ring's worth survives
+        if (remaining > CONTRAIL_POINTS) remaining = CONTRAIL_POINTS;
+        unsigned int slot = (emitter->written - remaining) & (CONTRAIL_POINTS - 1);
+
+        while (remaining > 0) {
+            unsigned int run = CONTRAIL_POINTS - slot;
+            if (run > remaining) run = remaining;
+
+            ContrailUpload* upload = &system->uploads[system->upload_count++];
+            upload->first = e * CONTRAIL_POINTS + slot;
+            upload->count = run;
+            upload->staged = staged;
+            memcpy(system->staging[staged], system->points[upload->first], sizeof(float[4]) * run);
+
+            staged += run;
+            remaining -= run;
+            slot = 0;
+        }
+    }
+
+    // Clock as drawn: alpha of the way through the last tick, matching the entities
+    system->draw_time = system->time - (1.0f - alpha) * system->tick_dt;
+    system->draw_span = system->emitter_span;
+}
+
+void contrail_system_render(ContrailSystem* system) {
+    if (system->draw_span == 0) return;
+
+    // New points only, from prepare's copy
+    system->uploaded_points = 0;
+    glBindBuffer(GL_TEXTURE_BUFFER, system->buffer);
+    for (unsigned int u = 0; u < system->upload_count; u++) {
+        const ContrailUpload* upload = &system->uploads[u];
+        glBufferSubData(GL_TEXTURE_BUFFER, sizeof(float[4]) * upload->first, sizeof(float[4]) * upload->count,
+                        system->staging[upload->staged]);
+        system->uploaded_points += upload->count;
+    }
+    system->upload_count = 0;
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    Shader* shader = &system->shader;
+    const ContrailUniforms* u = &system->uniforms;
+    shader_use(shader);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, system->buffer_texture);
+    shader_uniform_int(shader, u->points, 0);
+    shader_uniform_int(shader, u->pointcount, CONTRAIL_POINTS);
+    shader_uniform_float(shader, u->now, system->draw_time);
+    shader_uniform_float(shader, u->lifetime, CONTRAIL_LIFETIME);
+    shader_uniform_float(shader, u->width, CONTRAIL_WIDTH);
+    shader_uniform_float(shader, u->spread, CONTRAIL_SPREAD);
+
+    // Blended over everything opaque, without occluding each other
+    glEnable(GL_DEPTH_TEST);
+    state_enable_blend();
+    state_set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state_set_depth_mask(GL_FALSE);
+    state_disable_cull_face();
+
+    // One instance per ring slot, each a quad from that point to the next
+    glBindVertexArray(system->vao);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, system->draw_span * CONTRAIL_POINTS);
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    state_restore_defaults();
+}
+
+void contrail_system_cleanup(ContrailSystem* system) {
+    if (!system) return;
+
+    glDeleteVertexArrays(1, &system->vao);
+    glDeleteBuffers(1, &system->buffer);
+    glDeleteTextures(1, &system->buffer_texture);
+    shader_destroy(&system->shader);
+
+    free(system->points);
+    free(system->staging);
+    free(system);
+}
@@ -0,0 +1,138 @@
+#ifndef CONTRAIL_H
+#define CONTRAIL_H
+
+#include "entity_manager.h"
+#include "../graphics/shader.h"
+
+// Contrail configuration
+#define CONTRAIL_MAX_EMITTERS 128
+#define CONTRAIL_POINTS 128             // Ring size per emitter (power of two)
+#define CONTRAIL_POINT_INTERVAL 0.05f   // Seconds between trail points
+#define CONTRAIL_LIFETIME 6.0f          // Must stay below CONTRAIL_POINTS * CONTRAIL_POINT_INTERVAL
+#define CONTRAIL_WIDTH 0.4f             // Half width of a fresh trail
+#define CONTRAIL_SPREAD 1.2f            // Half width gained per second
+#define CONTRAIL_SWARM_TRAILS 24        // Swarm agents trailing at once, nearest first
+#define CONTRAIL_SWARM_RANGE 600.0f     // Agents farther than this from the focus get none
+#define CONTRAIL_SWARM_INTERVAL 0.5f    // Seconds between choosing the nearest agents
+
+// Contrails behind aircraft.
+//
+// Every emitter owns a fixed ring of CONTRAIL_POINTS points (xyz + emission
+// time) in one shared GPU buffer, read by trailvert.glsl as a buffer texture.
+// Appending a point only writes its ring slot, and a frame uploads just the
+// slots appended since the last one, so upload cost follows the number of new
+// points and never the trail lengths. All segments of all trails are drawn in
+// one instanced call; the shader drops segments across the ring's wrap point
+// (where the next slot is older) and those past their lifetime.
+//
+// An emitter follows either an entity or a swarm agent. Swarms are too large
+// to trail every agent, so contrail_track_swarm keeps trails on the
+// CONTRAIL_SWARM_TRAILS agents nearest the focus: it re-ranks them every
+// CONTRAIL_SWARM_INTERVAL, and agents already trailing rank as if a fifth
+// closer so ones near the cut don't swap back and forth. A dropped trail
+// fades out like a detached one, and when the pool has no free emitter a new
+// trail waits for the next ranking, so the cost stays flat with swarm size.
+
+typedef struct {
+    EntityHandle owner;
+    float offset[3];            // Attachment point in the owner's model space
+    bool tracked;               // Follows a swarm agent instead of owner
+    float position[3];          // Tracked agent's position this tick
+    bool in_use;
+    bool emitting;              // Cleared when detached or the owner dies
+    float last_emit;            // Time of the newest point
+    unsigned int written;       // Points appended since the emitter started
+    unsigned int uploaded;      // written as of the last upload snapshot
+} ContrailEmitter;
+
+// A run of ring slots to upload, staged by prepare
+typedef struct {
+    unsigned int first;         // Slot in the shared buffer
+    unsigned int count;
+    unsigned int staged;        // Its first point in the staging copy
+} ContrailUpload;
+
+// Positions of a swarm's agents (read this tick; ids stay with an agent
+// when removals move it to another index)
+typedef struct {
+    const float* x;
+    const float* y;
+    const float* z;
+    const uint32_t* ids;
+    unsigned int count;
+} ContrailSwarm;
+
+// A swarm agent being trailed
+typedef struct {
+    uint32_t id;
+    unsigned int index;         // Where the agent was last found
+    int emitter;                // -1 while the slot is empty
+} ContrailSwarmTrail;
+
+// Contrail shader uniforms, resolved once at creation
+typedef struct {
+    ShaderUniform points, pointcount;
+    ShaderUniform now, lifetime, width, spread;
+} ContrailUniforms;
+
+typedef struct {
+    ContrailEmitter emitters[CONTRAIL_MAX_EMITTERS];
+    unsigned int emitter_span;  // 1 + highest emitter index in use
+
+    ContrailSwarmTrail swarm_trails[CONTRAIL_SWARM_TRAILS];
+    float swarm_ranked;         // Time of the last nearest-agent ranking
+
+    // CPU mirror of the GPU rings: emitter e owns [e * CONTRAIL_POINTS, (e + 1) * CONTRAIL_POINTS)
+    float (*points)[4];
+
+    float time;                 // Simulation clock
+    float tick_dt;
+    float draw_time;            // Clock as drawn (interpolated), from the last prepare
+    unsigned int draw_span;
+
+    // Render-owned copy of the new points, so render never reads the rings
+    // the simulation may be appending to (at most two runs per emitter,
+    // split where the ring wraps)
+    ContrailUpload uploads[CONTRAIL_MAX_EMITTERS * 2];
+    unsigned int upload_count;
+    float (*staging)[4];
+
+    GLuint vao;                 // Empty; vertices come from gl_VertexID and the buffer texture
+    GLuint buffer;
+    GLuint buffer_texture;
+
+    Shader shader;
+    ContrailUniforms uniforms;
+
+    // Stats from the last render
+    unsigned int uploaded_points;
+} ContrailSystem;
+
+// Create contrail system (loads shader, allocates the rings)
+ContrailSystem* contrail_system_create(void);
+
+// Start a trail at offset (model space) on owner. Returns the emitter index, -1 if none is free.
+int contrail_attach(ContrailSystem* system, EntityHandle owner, const float offset[3]);
+
+// Stop emitting; the trail fades out and the emitter is then reused
+void contrail_detach(ContrailSystem* system, int emitter);
+
+// Keep trails on the swarm agents nearest (focus_x, focus_z) and pick up
+// their positions for this tick. Call before contrail_system_update, after
+// the swarm has moved (no GL calls).
+void contrail_track_swarm(ContrailSystem* system, const ContrailSwarm* swarm, float focus_x, float focus_z);
+
+// Advance the clock and append points for emitters that are due. Reads the
+// owners' world matrices, so call after the tick's entity update (no GL calls).
+void contrail_system_update(ContrailSystem* system, const EntityManager* manager, float dt);
+
+// Copy the points to upload and snapshot the clock to draw with (no GL calls)
+void contrail_system_prepare(ContrailSystem* system, float alpha);
+
+// Upload the staged points and draw every trail in one call
+void contrail_system_render(ContrailSystem* system);
+
+// Cleanup contrail system
+void contrail_system_cleanup(ContrailSystem* system);
+
+#endif // CONTRAIL_H
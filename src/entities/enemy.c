@@ -0,0 +1,375 @@
+#include "enemy.h"
+#include "../math/simd.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+// Steering weights
+#define ENEMY_SEPARATION 1.5f
+#define ENEMY_ALIGNMENT 0.8f
+#define ENEMY_COHESION 0.05f
+#define ENEMY_SEEK 1.0f
+#define ENEMY_TERRAIN 2.0f
+#define ENEMY_LEVEL 0.5f        // Damping of vertical speed (agents prefer level flight)
+#define ENEMY_MIN_CLEARANCE (0.25f * ENEMY_CLEARANCE)   // Hard floor above the sampled ground
+
+typedef struct {
+    float min_speed;
+    float max_speed;
+    float max_accel;
+} EnemyTypeInfo;
+
+static const EnemyTypeInfo ENEMY_TYPES[ENEMY_TYPE_COUNT] = {
+    [ENEMY_BALLOON] = {8.0f, 20.0f, 6.0f},
+    [ENEMY_BLIMP] = {10.0f, 25.0f, 5.0f},
+    [ENEMY_UFO] = {30.0f, 80.0f, 40.0f},
+};
+
+static float* enemy_alloc_lane(unsigned int padded) {
+    return calloc(padded, sizeof(float));
+}
+
+static inline uint32_t enemy_hash(int x, int y, int z) {
+    return ((uint32_t)x * 73856093u) ^ ((uint32_t)y * 19349663u) ^ ((uint32_t)z * 83492791u);
+}
+
+// Unmasked hash of the cell containing a point; the low bits pick the bucket
+static inline uint32_t enemy_cell_key(const EnemySystem* system, float x, float y, float z) {
+    return enemy_hash((int)floorf(x * system->inv_cell_size), (int)floorf(y * system->inv_cell_size),
+                      (int)floorf(z * system->inv_cell_size));
+}
+
+static float enemy_ground(const EnemySystem* system, float x, float z) {
+    return system->height_func ? system->height_func(system->height_user, x, z) : 0.0f;
+}
+
+EnemySystem* enemy_system_create(unsigned int capacity, EnemyHeightFunc height_func, void* user) {
+    if (capacity == 0) {
+        fprintf(stderr, "Invalid enemy swarm capacity %u\n", capacity);
+        return NULL;
+    }
+
+    EnemySystem* system = malloc(sizeof(EnemySystem));
+    if (!system) return NULL;
+    memset(system, 0, sizeof(EnemySystem));
+
+    // SIMD passes run over whole groups of 4
+    unsigned int padded = (capacity + 3) & ~3u;
+    system->capacity = capacity;
+    system->pos_x = enemy_alloc_lane(padded);
+    system->pos_y = enemy_alloc_lane(padded);
+    system->pos_z = enemy_alloc_lane(padded);
+    system->prev_x = enemy_alloc_lane(padded);
+    system->prev_y = enemy_alloc_lane(padded);
+    system->prev_z = enemy_alloc_lane(padded);
+    system->vel_x = enemy_alloc_lane(padded);
+    system->vel_y = enemy_alloc_lane(padded);
+    system->vel_z = enemy_alloc_lane(padded);
+    system->steer_x = enemy_alloc_lane(padded);
+    system->steer_y = enemy_alloc_lane(padded);
+    system->steer_z = enemy_alloc_lane(padded);
+    system->ground = enemy_alloc_lane(padded);
+    system->types = calloc(padded, sizeof(uint8_t));
+    system->ids = calloc(padded, sizeof(uint32_t));
+
+    system->hash_size = 1;
+    while (system->hash_size < capacity * 2) system->hash_size <<= 1;
+    system->cell_start = calloc(system->hash_size + 1, sizeof(uint32_t));
+    system->cell_agents = calloc(capacity, sizeof(uint32_t));
+    system->agent_key = calloc(capacity, sizeof(uint32_t));
+    system->sorted = calloc(capacity, sizeof(EnemyNeighbour));
+    system->inv_cell_size = 0.5f / ENEMY_NEIGHBOUR_RADIUS;
+
+    system->height_func = height_func;
+    system->height_user = user;
+
+    if (!system->pos_x || !system->pos_y || !system->pos_z || !system->prev_x || !system->prev_y ||
+        !system->prev_z || !system->vel_x || !system->vel_y || !system->vel_z || !system->steer_x ||
+        !system->steer_y || !system->steer_z || !system->ground || !system->types || !system->ids ||
+        !system->cell_start || !system->cell_agents || !system->agent_key || !system->sorted) {
+        fprintf(stderr, "Failed to allocate enemy swarm of %u\n", capacity);
+        enemy_system_free(system);
+        return NULL;
+    }
+
+    return system;
+}
+
+void enemy_system_free(EnemySystem* system) {
+    if (!system) return;
+
+    free(system->pos_x);
+    free(system->pos_y);
+    free(system->pos_z);
+    free(system->prev_x);
+    free(system->prev_y);
+    free(system->prev_z);
+    free(system->vel_x);
+    free(system->vel_y);
+    free(system->vel_z);
+    free(system->steer_x);
+    free(system->steer_y);
+    free(system->steer_z);
+    free(system->ground);
+    free(system->types);
+    free(system->ids);
+    free(system->cell_start);
+    free(system->cell_agents);
+    free(system->agent_key);
+    free(system->sorted);
+    free(system);
+}
+
+int enemy_spawn(EnemySystem* system, EnemyType type, const float position[3], const float velocity[3]) {
+    if (!system || system->count == system->capacity || type >= ENEMY_TYPE_COUNT) return -1;
+
+    unsigned int i = system->count++;
+    system->pos_x[i] = system->prev_x[i] = position[0];
+    system->pos_y[i] = system->prev_y[i] = position[1];
+    system->pos_z[i] = system->prev_z[i] = position[2];
+    system->vel_x[i] = velocity[0];
+    system->vel_y[i] = velocity[1];
+    system->vel_z[i] = velocity[2];
+    system->ground[i] = enemy_ground(system, position[0], position[2]);
+    system->types[i] = (uint8_t)type;
+    system->ids[i] = system->next_id++;
+    return (int)i;
+}
+
+void enemy_remove(EnemySystem* system, unsigned int index) {
+    if (!system || index >= system->count) return;
+
+    unsigned int last = --system->count;
+    system->pos_x[index] = system->pos_x[last];
+    system->pos_y[index] = system->pos_y[last];
+    system->pos_z[index] = system->pos_z[last];
+    system->prev_x[index] = system->prev_x[last];
+    system->prev_y[index] = system->prev_y[last];
+    system->prev_z[index] = system->prev_z[last];
+    system->vel_x[index] = system->vel_x[last];
+    system->vel_y[index] = system->vel_y[last];
+    system->vel_z[index] = system->vel_z[last];
+    system->ground[index] = system->ground[last];
+    system->types[index] = system->types[last];
+    system->ids[index] = system->ids[last];
+}
+
+void enemy_set_target(EnemySystem* system, const float target[3]) {
+    if (!system) return;
+    memcpy(system->target, target, sizeof(float[3]));
+    system->has_target = true;
+}
+
+// Counting sort of agents by hash bucket, copying each agent's neighbour
+// data into its sorted slot so bucket scans read contiguous memory
+static void enemy_build_hash(EnemySystem* system) {
+    uint32_t* start = system->cell_start;
+    uint32_t mask = system->hash_size - 1;
+    memset(start, 0, sizeof(uint32_t) * (system->hash_size + 1));
+
+    for (unsigned int i = 0; i < system->count; i++) {
+        uint32_t key = enemy_cell_key(system, system->pos_x[i], system->pos_y[i], system->pos_z[i]);
+        system->agent_key[i] = key;
+        start[(key & mask) + 1]++;
+    }
+    for (unsigned int b = 0; b < system->hash_size; b++) {
+        start[b + 1] += start[b];
+    }
+
+    // Fill each bucket from its end so start[] ends up at the bucket starts again
+    for (unsigned int i = system->count; i-- > 0;) {
+        uint32_t key = system->agent_key[i];
+        uint32_t k = --start[(key & mask) + 1];
+        EnemyNeighbour* slot = &system->sorted[k];
+        slot->pos[0] = system->pos_x[i];
+        slot->pos[1] = system->pos_y[i];
+        slot->pos[2] = system->pos_z[i];
+        slot->vel[0] = system->vel_x[i];
+        slot->vel[1] = system->vel_y[i];
+        slot->vel[2] = system->vel_z[i];
+        slot->key = key;
+        slot->type = system->types[i];
+        system->cell_agents[k] = i;
+    }
+    for (unsigned int b = system->hash_size; b > 0; b--) {
+        start[b] = start[b - 1];
+    }
+    start[0] = 0;
+}
+
+// Clamp a vector's length to max
+static inline void enemy_clamp(float* x, float* y, float* z, float max) {
+    float length2 = *x * *x + *y * *y + *z * *z;
+    if (length2 > max * max) {
+        float scale = max / sqrtf(length2);
+        *x *= scale;
+        *y *= scale;
+        *z *= scale;
+    }
+}
+
+// New velocity for agents in sorted slots [begin, end) from the last tick's
+// state (runs on pool threads). Walking in bucket order keeps consecutive
+// agents on mostly the same neighbour buckets.
+static void enemy_steer_range(void* data, unsigned int begin, unsigned int end) {
+    EnemySystem* system = data;
+    const EnemyNeighbour* sorted = system->sorted;
+    const float radius2 = ENEMY_NEIGHBOUR_RADIUS * ENEMY_NEIGHBOUR_RADIUS;
+    const float dt = system->tick_dt;
+    const uint32_t mask = system->hash_size - 1;
+
+    for (unsigned int n = begin; n < end; n++) {
+        unsigned int i = system->cell_agents[n];
+        float px = sorted[n].pos[0], py = sorted[n].pos[1], pz = sorted[n].pos[2];
+        float vx = sorted[n].vel[0], vy = sorted[n].vel[1], vz = sorted[n].vel[2];
+        uint32_t type = sorted[n].type;
+        const EnemyTypeInfo* info = &ENEMY_TYPES[type];
+
+        // Staggered terrain sample under the agent and where it will be
+        if ((i + system->tick) % ENEMY_HEIGHT_INTERVAL == 0) {
+            float here = enemy_ground(system, px, pz);
+            float ahead = enemy_ground(system, px + vx * ENEMY_LOOKAHEAD, pz + vz * ENEMY_LOOKAHEAD);
+            system->ground[i] = fmaxf(here, ahead);
+        }
+
+        // Cells are twice the radius, so the neighbourhood spans the agent's
+        // cell and the next one towards whichever half of the cell it is in
+        float fx = px * system->inv_cell_size, fy = py * system->inv_cell_size, fz = pz * system->inv_cell_size;
+        int cx = (int)floorf(fx - 0.5f), cy = (int)floorf(fy - 0.5f), cz = (int)floorf(fz - 0.5f);
+        unsigned int neighbours = 0, flockmates = 0;
+        float sep_x = 0.0f, sep_y = 0.0f, sep_z = 0.0f;
+        float align_x = 0.0f, align_y = 0.0f, align_z = 0.0f;
+        float center_x = 0.0f, center_y = 0.0f, center_z = 0.0f;
+
+        for (int dz = 0; dz <= 1 && neighbours < ENEMY_MAX_NEIGHBOURS; dz++) {
+            for (int dy = 0; dy <= 1 && neighbours < ENEMY_MAX_NEIGHBOURS; dy++) {
+                for (int dx = 0; dx <= 1 && neighbours < ENEMY_MAX_NEIGHBOURS; dx++) {
+                    // Buckets are shared by distinct cells; the key keeps only this one
+                    uint32_t key = enemy_hash(cx + dx, cy + dy, cz + dz);
+                    uint32_t b = key & mask;
+
+                    for (uint32_t k = system->cell_start[b]; k < system->cell_start[b + 1]; k++) {
+                        const EnemyNeighbour* other = &sorted[k];
+                        if (other->key != key || k == n) continue;
+
+                        float ox = other->pos[0] - px;
+                        float oy = other->pos[1] - py;
+                        float oz = other->pos[2] - pz;
+                        float d2 = ox * ox + oy * oy + oz * oz;
+                        if (d2 >= radius2 || d2 <= 0.0f) continue;
+
+                        // Away from everyone, harder the closer they are
+                        float push = ENEMY_NEIGHBOUR_RADIUS / d2;
+                        sep_x -= ox * push;
+                        sep_y -= oy * push;
+                        sep_z -= oz * push;
+
+                        // Flock only with the same kind
+                        if (other->type == type) {
+                            align_x += other->vel[0];
+                            align_y += other->vel[1];
+                            align_z += other->vel[2];
+                            center_x += ox;
+                            center_y += oy;
+                            center_z += oz;
+                            flockmates++;
+                        }
+                        if (++neighbours == ENEMY_MAX_NEIGHBOURS) break;
+                    }
+                }
+            }
+        }
+
+        float ax = 0.0f, ay = 0.0f, az = 0.0f;
+        if (neighbours > 0) {
+            float sep = ENEMY_SEPARATION * info->max_accel;
+            ax += sep_x * sep;
+            ay += sep_y * sep;
+            az += sep_z * sep;
+        }
+        if (flockmates > 0) {
+            float inv = 1.0f / (float)flockmates;
+            ax += (align_x * inv - vx) * ENEMY_ALIGNMENT + center_x * inv * ENEMY_COHESION;
+            ay += (align_y * inv - vy) * ENEMY_ALIGNMENT + center_y * inv * ENEMY_COHESION;
+            az += (align_z * inv - vz) * ENEMY_ALIGNMENT + center_z * inv * ENEMY_COHESION;
+        }
+
+        // Back towards the target once outside the patrol radius
+        if (system->has_target) {
+            float tx = system->target[0] - px, tz = system->target[2] - pz;
+            float dist = sqrtf(tx * tx + tz * tz);
+            if (dist > ENEMY_PATROL_RADIUS) {
+                float pull = fminf((dist - ENEMY_PATROL_RADIUS) / ENEMY_PATROL_RADIUS, 1.0f) *
+                             ENEMY_SEEK * info->max_accel / dist;
+                ax += tx * pull;
+                az += tz * pull;
+            }
+        }
+        enemy_clamp(&ax, &ay, &az, info->max_accel);
+
+        // Terrain avoidance on top of the flocking budget, so it always wins
+        float floor = system->ground[i] + ENEMY_CLEARANCE;
+        float ceiling = system->ground[i] + ENEMY_CEILING;
+        float lift = -vy * ENEMY_LEVEL;
+        if (py < floor) lift += (floor - py) / ENEMY_CLEARANCE * ENEMY_TERRAIN * info->max_accel;
+        if (py > ceiling) lift -= (py - ceiling) / ENEMY_CLEARANCE * info->max_accel;
+        ay += fmaxf(fminf(lift, ENEMY_TERRAIN * info->max_accel), -ENEMY_TERRAIN * info->max_accel);
+
+        vx += ax * dt;
+        vy += ay * dt;
+        vz += az * dt;
+
+        float speed = sqrtf(vx * vx + vy * vy + vz * vz);
+        if (speed > info->max_speed) {
+            float scale = info->max_speed / speed;
+            vx *= scale;
+            vy *= scale;
+            vz *= scale;
+        } else if (speed < info->min_speed) {
+            if (speed > 0.0f) {
+                float scale = info->min_speed / speed;
+                vx *= scale;
+                vy *= scale;
+                vz *= scale;
+            } else {
+                vx = info->min_speed;
+            }
+        }
+
+        system->steer_x[i] = vx;
+        system->steer_y[i] = vy;
+        system->steer_z[i] = vz;
+    }
+}
+
+void enemy_system_update(EnemySystem* system, float dt) {
+    if (!system || system->count == 0) return;
+    system->tick_dt = dt;
+
+    enemy_build_hash(system);
+    job_system_parallel_for(system->jobs, system->count, ENEMY_MIN_BATCH, enemy_steer_range, system);
+
+    // Steered velocities become current
+    float* swap;
+    swap = system->vel_x; system->vel_x = system->steer_x; system->steer_x = swap;
+    swap = system->vel_y; system->vel_y = system->steer_y; system->steer_y = swap;
+    swap = system->vel_z; system->vel_z = system->steer_z; system->steer_z = swap;
+
+    // Integrate four at a time, never below the hard floor
+    unsigned int padded = (system->count + 3) & ~3u;
+    memcpy(system->prev_x, system->pos_x, sizeof(float) * padded);
+    memcpy(system->prev_y, system->pos_y, sizeof(float) * padded);
+    memcpy(system->prev_z, system->pos_z, sizeof(float) * padded);
+
+    v4f vdt = v4_set1(dt);
+    v4f min_clearance = v4_set1(ENEMY_MIN_CLEARANCE);
+    for (unsigned int i = 0; i < padded; i += 4) {
+        v4f y = v4_add(v4_load(system->pos_y + i), v4_mul(v4_load(system->vel_y + i), vdt));
+        v4_store(system->pos_x + i, v4_add(v4_load(system->pos_x + i), v4_mul(v4_load(system->vel_x + i), vdt)));
+        v4_store(system->pos_y + i, v4_max(y, v4_add(v4_load(system->ground + i), min_clearance)));
+        v4_store(system->pos_z + i, v4_add(v4_load(system->pos_z + i), v4_mul(v4_load(system->vel_z + i), vdt)));
+    }
+
+    system->tick++;
+}
@@ -0,0 +1,105 @@
+#ifndef ENEMY_H
+#define ENEMY_H
+
+#include "../engine/job_system.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Enemy swarm.
+//
+// Agents are stored densely as structure-of-arrays, like projectiles, and
+// steered as boids: separation, alignment and cohesion over neighbours found
+// through a spatial hash, a pull back towards the target when they stray
+// beyond the patrol radius, and terrain avoidance against the ground height
+// ahead of them. Each tick rebuilds the hash (a counting sort of agents by
+// hashed cell), computes every agent's new velocity in parallel from the
+// previous tick's state, then integrates.
+//
+// Terrain is sampled every ENEMY_HEIGHT_INTERVAL ticks per agent, staggered
+// across the swarm, so height queries stay a fixed fraction of the agents.
+
+#define ENEMY_NEIGHBOUR_RADIUS 60.0f    // Boid perception radius (hash cells are twice this)
+#define ENEMY_MAX_NEIGHBOURS 12         // Neighbours considered per agent (bounds dense clumps)
+#define ENEMY_PATROL_RADIUS 800.0f      // Agents roam freely this close to the target
+#define ENEMY_CLEARANCE 40.0f           // Preferred height above ground
+#define ENEMY_CEILING 400.0f            // Height above ground agents turn back from
+#define ENEMY_LOOKAHEAD 2.0f            // Seconds ahead the ground is sampled
+#define ENEMY_HEIGHT_INTERVAL 8         // Ticks between an agent's terrain samples
+#define ENEMY_MIN_BATCH 256             // Agents per steering job
+
+typedef enum {
+    ENEMY_BALLOON,
+    ENEMY_BLIMP,
+    ENEMY_UFO,
+    ENEMY_TYPE_COUNT
+} EnemyType;
+
+// An agent's neighbour data, copied in bucket order when the hash is built
+typedef struct {
+    float pos[3];
+    float vel[3];
+    uint32_t key;                   // Unmasked cell hash (tells apart cells sharing a bucket)
+    uint32_t type;
+} EnemyNeighbour;
+
+// Terrain height at a world position (called from pool threads, must be thread safe)
+typedef float (*EnemyHeightFunc)(void* user, float x, float z);
+
+typedef struct {
+    // Dense agents, arrays padded to a multiple of 4 entries
+    float* pos_x;
+    float* pos_y;
+    float* pos_z;
+    float* prev_x;                  // Position at the start of the last tick
+    float* prev_y;
+    float* prev_z;
+    float* vel_x;
+    float* vel_y;
+    float* vel_z;
+    float* steer_x;                 // Velocity for the next step, written by the steering pass
+    float* steer_y;
+    float* steer_z;
+    float* ground;                  // Highest ground under and ahead, from the last sample
+    uint8_t* types;                 // EnemyType
+    uint32_t* ids;                  // Stay with an agent when removals move it
+    unsigned int count;
+    unsigned int capacity;
+
+    // Spatial hash, rebuilt every tick: sorted slots [cell_start[b], cell_start[b + 1])
+    // hold the agents of bucket b, cell_agents maps slots back to agent indices
+    uint32_t* cell_start;           // hash_size + 1 entries
+    uint32_t* cell_agents;
+    EnemyNeighbour* sorted;
+    uint32_t* agent_key;            // Cell hash of each agent
+    unsigned int hash_size;         // Power of two, at least twice the capacity
+    float inv_cell_size;
+
+    uint32_t next_id;
+
+    float target[3];                // Point the swarm patrols around
+    bool has_target;
+
+    EnemyHeightFunc height_func;    // May be NULL (flat ground at 0)
+    void* height_user;
+
+    JobSystem* jobs;                // May be NULL (steer on the calling thread)
+    float tick_dt;
+    unsigned int tick;
+} EnemySystem;
+
+EnemySystem* enemy_system_create(unsigned int capacity, EnemyHeightFunc height_func, void* user);
+void enemy_system_free(EnemySystem* system);
+
+// Add an agent; returns its index, or -1 when the swarm is full
+int enemy_spawn(EnemySystem* system, EnemyType type, const float position[3], const float velocity[3]);
+
+// Remove an agent (the last agent moves into its index)
+void enemy_remove(EnemySystem* system, unsigned int index);
+
+// Point the swarm patrols around
+void enemy_set_target(EnemySystem* system, const float target[3]);
+
+// Rebuild the hash, steer every agent and integrate one step (no GL calls)
+void enemy_system_update(EnemySystem* system, float dt);
+
+#endif // ENEMY_H
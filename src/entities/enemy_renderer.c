@@ -0,0 +1,214 @@
+#include "enemy_renderer.h"
+#include "../file_ops.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+static const char* ENEMY_MODEL_PATHS[ENEMY_TYPE_COUNT] = {
+    [ENEMY_BALLOON] = "assets/models/balloon.obj",
+    [ENEMY_BLIMP] = "assets/models/blimp.obj",
+    [ENEMY_UFO] = "assets/models/ufo.obj",
+};
+
+static bool enemy_model_create(EnemyModel* em, const char* path, unsigned int capacity, float scale) {
+    em->model = model_load(path);
+    if (!em->model) {
+        fprintf(stderr, "Failed to load enemy model: %s\n", path);
+        return false;
+    }
+
+    Model* model = em->model;
+    em->scale = scale;
+    em->radius = model_bounding_radius(model) * scale;
+    em->instances = malloc(sizeof(EnemyInstance) * capacity);
+    em->vaos = calloc(model->mesh_count, sizeof(GLuint));
+
+    glGenBuffers(1, &em->instance_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, em->instance_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(EnemyInstance) * capacity, NULL, GL_STREAM_DRAW);
+
+    // Mesh attributes as mesh_upload binds them, plus two per-instance attributes
+    for (unsigned int i = 0; i < model->mesh_count; i++) {
+        const Mesh* mesh = &model->meshes[i];
+
+        glGenVertexArrays(1, &em->vaos[i]);
+        glBindVertexArray(em->vaos[i]);
+
+        // Position (location 0), normal (location 1), texcoord (location 2)
+        mesh_bind_vertex_attributes(mesh);
+
+        // Instance position + scale (location 3), direction (location 4)
+        glBindBuffer(GL_ARRAY_BUFFER, em->instance_vbo);
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(EnemyInstance), (void*)0);
+        glEnableVertexAttribArray(3);
+        glVertexAttribDivisor(3, 1);
+        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(EnemyInstance), (void*)(4 * sizeof(float)));
+        glEnableVertexAttribArray(4);
+        glVertexAttribDivisor(4, 1);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ibo);
+    }
+    glBindVertexArray(0);
+
+    return true;
+}
+
+EnemyRenderer* enemy_renderer_create(unsigned int capacity, float scale) {
+    EnemyRenderer* renderer = malloc(sizeof(EnemyRenderer));
+    memset(renderer, 0, sizeof(EnemyRenderer));
+    renderer->capacity = capacity;
+
+    unsigned int loaded = 0;
+    for (unsigned int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        if (enemy_model_create(&renderer->models[t], ENEMY_MODEL_PATHS[t], capacity, scale)) loaded++;
+    }
+
+    const char* vert_src = load_shader_source("assets/shaders/projectilevert.glsl");
+    const char* frag_src = load_shader_source("assets/shaders/modelfrag.glsl");
+    renderer->shader = shader_create(vert_src, frag_src, "enemy");
+    free((void*)vert_src);
+    free((void*)frag_src);
+
+    EnemyUniforms* u = &renderer->uniforms;
+    u->ambient = shader_uniform(&renderer->shader, "material_ambient");
+    u->diffuse = shader_uniform(&renderer->shader, "material_diffuse");
+    u->specular = shader_uniform(&renderer->shader, "material_specular");
+    u->shininess = shader_uniform(&renderer->shader, "material_shininess");
+    u->diffuse_map = shader_uniform(&renderer->shader, "diffuse_map");
+    u->has_diffuse_map = shader_uniform(&renderer->shader, "has_diffuse_map");
+    u->has_specular_map = shader_uniform(&renderer->shader, "has_specular_map");
+    u->position_offset = shader_uniform(&renderer->shader, "position_offset");
+    u->position_scale = shader_uniform(&renderer->shader, "position_scale");
+    u->normal_scale = shader_uniform(&renderer->shader, "normal_scale");
+
+    printf("Enemy renderer initialized (%u instances, %u of %d models)\n", capacity, loaded, ENEMY_TYPE_COUNT);
+
+    return renderer;
+}
+
+void enemy_renderer_prepare(EnemyRenderer* renderer, const EnemySystem* system, const Frustum* frustum,
+                            float alpha) {
+    for (unsigned int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        renderer->models[t].instance_count = 0;
+    }
+    if (!system) return;
+
+    v4f va = v4_set1(alpha);
+    unsigned int padded = (system->count + 3) & ~3u;
+    for (unsigned int i = 0; i < padded; i += 4) {
+        // Interpolated positions and per-kind radii, four at a time
+        v4f px = v4_load(system->prev_x + i), py = v4_load(system->prev_y + i), pz = v4_load(system->prev_z + i);
+        px = v4_add(px, v4_mul(v4_sub(v4_load(system->pos_x + i), px), va));
+        py = v4_add(py, v4_mul(v4_sub(v4_load(system->pos_y + i), py), va));
+        pz = v4_add(pz, v4_mul(v4_sub(v4_load(system->pos_z + i), pz), va));
+
+        float radii[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (unsigned int lane = 0; lane < 4 && i + lane < system->count; lane++) {
+            radii[lane] = renderer->models[system->types[i + lane]].radius;
+        }
+        int mask = frustum_test_spheres4(frustum, px, py, pz, v4_load(radii));
+        if (!mask) continue;
+
+        float x[4], y[4], z[4];
+        v4_store(x, px);
+        v4_store(y, py);
+        v4_store(z, pz);
+
+        for (unsigned int lane = 0; lane < 4 && i + lane < system->count; lane++) {
+            if (!(mask & (1 << lane))) continue;
+            unsigned int e = i + lane;
+            EnemyModel* em = &renderer->models[system->types[e]];
+            if (!em->model || em->instance_count == renderer->capacity) continue;
+
+            EnemyInstance* inst = &em->instances[em->instance_count++];
+            inst->position[0] = x[lane];
+            inst->position[1] = y[lane];
+            inst->position[2] = z[lane];
+            inst->scale = em->scale;
+
+            // Level heading, so balloons and blimps don't pitch with their climb
+            float vx = system->vel_x[e], vz = system->vel_z[e];
+            float length = sqrtf(vx * vx + vz * vz);
+            float inv = length > 0.0f ? 1.0f / length : 0.0f;
+            inst->direction[0] = vx * inv;
+            inst->direction[1] = 0.0f;
+            inst->direction[2] = length > 0.0f ? vz * inv : 1.0f;
+            inst->pad = 0.0f;
+        }
+    }
+}
+
+void enemy_renderer_render(EnemyRenderer* renderer) {
+    Shader* shader = &renderer->shader;
+    const EnemyUniforms* u = &renderer->uniforms;
+    bool bound = false;
+
+    for (unsigned int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        EnemyModel* em = &renderer->models[t];
+        if (em->instance_count == 0) continue;
+
+        if (!bound) {
+            shader_use(shader);
+            shader_uniform_int(shader, u->diffuse_map, 0);
+            shader_uniform_int(shader, u->has_specular_map, 0);
+            glActiveTexture(GL_TEXTURE0);
+            bound = true;
+        }
+
+        // Orphan last frame's storage instead of waiting for the GPU to release it
+        glBindBuffer(GL_ARRAY_BUFFER, em->instance_vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(EnemyInstance) * renderer->capacity, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(EnemyInstance) * em->instance_count, em->instances);
+
+        for (unsigned int i = 0; i < em->model->mesh_count; i++) {
+            const Mesh* mesh = &em->model->meshes[i];
+            const Material* material = mesh->material;
+            if (material) {
+                shader_uniform_vec3v(shader, u->ambient, material->ambient);
+                shader_uniform_vec3v(shader, u->diffuse, material->diffuse);
+                shader_uniform_vec3v(shader, u->specular, material->specular);
+                shader_uniform_float(shader, u->shininess, material->shininess);
+                shader_uniform_int(shader, u->has_diffuse_map, material->diffuse_map ? 1 : 0);
+                glBindTexture(GL_TEXTURE_2D, material->diffuse_map);
+            } else {
+                shader_uniform_int(shader, u->has_diffuse_map, 0);
+            }
+
+            shader_uniform_vec3v(shader, u->position_offset, mesh->decode.offset);
+            shader_uniform_vec3v(shader, u->position_scale, mesh->decode.scale);
+            shader_uniform_float(shader, u->normal_scale, mesh->decode.normal_scale);
+            glBindVertexArray(em->vaos[i]);
+            glDrawElementsInstanced(GL_TRIANGLES, mesh->index_count, mesh->index_type, 0, em->instance_count);
+        }
+    }
+
+    if (bound) {
+        glBindVertexArray(0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+unsigned int enemy_renderer_instance_count(const EnemyRenderer* renderer) {
+    unsigned int count = 0;
+    for (unsigned int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        count += renderer->models[t].instance_count;
+    }
+    return count;
+}
+
+void enemy_renderer_cleanup(EnemyRenderer* renderer) {
+    if (!renderer) return;
+
+    for (unsigned int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        EnemyModel* em = &renderer->models[t];
+        if (!em->model) continue;
+        glDeleteVertexArrays(em->model->mesh_count, em->vaos);
+        glDeleteBuffers(1, &em->instance_vbo);
+        free(em->vaos);
+        free(em->instances);
+        model_free(em->model);
+    }
+    shader_destroy(&renderer->shader);
+    free(renderer);
+}
@@ -0,0 +1,64 @@
+#ifndef ENEMY_RENDERER_H
+#define ENEMY_RENDERER_H
+
+#include "enemy.h"
+#include "model.h"
+#include "../graphics/shader.h"
+#include "../math/frustum.h"
+
+// Draws the swarm with one instanced call per mesh of each enemy model.
+// prepare culls agents against the frustum and buckets the visible ones by
+// type (no GL, so it can run before the next simulation tick starts);
+// render uploads each bucket and draws it. Instances use the projectile
+// layout and vertex shader: the model's +Z follows the agent's heading.
+
+// Per-instance data, uploaded as-is to the instance buffers
+typedef struct {
+    float position[3];
+    float scale;
+    float direction[3];     // Unit heading in the xz plane
+    float pad;
+} EnemyInstance;
+
+typedef struct {
+    ShaderUniform ambient, diffuse, specular, shininess;
+    ShaderUniform diffuse_map, has_diffuse_map, has_specular_map;
+    ShaderUniform position_offset, position_scale, normal_scale;
+} EnemyUniforms;
+
+// One enemy kind: its model and the instances drawn with it
+typedef struct {
+    Model* model;
+    GLuint* vaos;                   // One per mesh: mesh buffers + instance buffer
+    GLuint instance_vbo;
+    float scale;
+    float radius;                   // Bounding radius at that scale, for culling
+
+    EnemyInstance* instances;       // Snapshot from the last prepare
+    unsigned int instance_count;
+} EnemyModel;
+
+typedef struct {
+    EnemyModel models[ENEMY_TYPE_COUNT];
+    unsigned int capacity;          // Instances each buffer holds
+
+    Shader shader;
+    EnemyUniforms uniforms;
+} EnemyRenderer;
+
+// Loads every enemy model; kinds whose model fails to load are not drawn
+EnemyRenderer* enemy_renderer_create(unsigned int capacity, float scale);
+
+// Cull and snapshot the swarm, alpha of the way from the previous tick to the current one
+void enemy_renderer_prepare(EnemyRenderer* renderer, const EnemySystem* system, const Frustum* frustum,
+                            float alpha);
+
+// Upload the snapshot and draw it
+void enemy_renderer_render(EnemyRenderer* renderer);
+
+// Instances drawn by the last prepare
+unsigned int enemy_renderer_instance_count(const EnemyRenderer* renderer);
+
+void enemy_renderer_cleanup(EnemyRenderer* renderer);
+
+#endif // ENEMY_RENDERER_H
@@ -2,44 +2,37 @@
 #define ENTITY_H
 
 #include "model.h"
+#include "../graphics/render_queue.h"
 #include <stdbool.h>
+#include <stdint.h>
 #include <glad/glad.h>
 
 typedef enum {
     ENTITY_TYPE_PLAYER,
     ENTITY_TYPE_PROP,
     ENTITY_TYPE_DYNAMIC,
-    ENTITY_TYPE_PARTICLE
+    ENTITY_TYPE_PARTICLE,
+    ENTITY_TYPE_COUNT
 } EntityType;
 
+// Stable reference to an entity owned by an EntityManager.
+// The generation changes whenever a slot is reused, so handles to
+// destroyed entities stop resolving instead of aliasing new ones.
 typedef struct {
-    unsigned int id;
-    EntityType type;
+    uint32_t index;       // Slot in the manager's sparse table
+    uint32_t generation;  // 0 is never a live generation
+} EntityHandle;
 
-    // Transform
-    float position[3];
-    float rotation[3];    // Euler angles (yaw, pitch, roll)
-    float scale[3];
+#define ENTITY_HANDLE_NULL ((EntityHandle){0, 0})
 
-    // Rendering
-    Model* model;         // Shared reference
-    bool visible;
+static inline bool entity_handle_is_null(EntityHandle handle) {
+    return handle.generation == 0;
+}
 
-    // Optional: physics, animation state can be added later
-} Entity;
-
-// Create entity
-Entity* entity_create(unsigned int id, EntityType type, Model* model,
-                     float pos[3], float rot[3], float scale[3]);
-
-// Get transform matrix for entity
-void entity_get_transform_matrix(Entity* entity, float* out_matrix);
-
-// Render entity
-void entity_render(Entity* entity, GLuint shader, float* view, float* proj,
-                  float cam_x, float cam_y, float cam_z);
-
-// Free entity
-void entity_free(Entity* entity);
+// Queue the meshes of one detail level of a model with the given world transform.
+// transform must stay valid until the queue is submitted; depth01 is the
+// camera distance normalized to [0, 1] for front-to-back ordering.
+void entity_queue_model(RenderQueue* queue, const Model* model, unsigned int lod,
+                        const float* transform, Shader* shader, float depth01);
 
 #endif // ENTITY_H
@@ -1,20 +1,60 @@
 #include "entity_manager.h"
 #include "../graphics/shader.h"
+#include "../math/math_ops.h"
+#include "../math/frustum.h"
+#include "../config.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <math.h>
 
 #define INITIAL_ENTITY_CAPACITY 32
 #define INITIAL_MODEL_CAPACITY 16
 
+// Smallest slices handed to the job system
+#define TRANSFORM_MIN_BATCH 256
+#define CULL_MIN_BATCH 1024
+
+// Grow every dense array together
+static void entity_manager_grow_dense(EntityManager* manager, unsigned int capacity) {
+    manager->positions = realloc(manager->positions, sizeof(float[3]) * capacity);
+    manager->rotations = realloc(manager->rotations, sizeof(float[3]) * capacity);
+    manager->scales = realloc(manager->scales, sizeof(float[3]) * capacity);
+    manager->prev_positions = realloc(manager->prev_positions, sizeof(float[3]) * capacity);
+    manager->prev_rotations = realloc(manager->prev_rotations, sizeof(float[3]) * capacity);
+    manager->models = realloc(manager->models, sizeof(Model*) * capacity);
+    manager->visible = realloc(manager->visible, sizeof(bool) * capacity);
+    manager->lods = realloc(manager->lods, sizeof(unsigned int) * capacity);
+    manager->types = realloc(manager->types, sizeof(EntityType) * capacity);
+    manager->dense_slots = realloc(manager->dense_slots, sizeof(uint32_t) * capacity);
+    manager->transforms = realloc(manager->transforms, sizeof(float[16]) * capacity);
+    manager->transform_dirty = realloc(manager->transform_dirty, sizeof(bool) * capacity);
+    manager->dirty_scratch = realloc(manager->dirty_scratch, sizeof(uint32_t) * capacity);
+    manager->bounds = realloc(manager->bounds, sizeof(float[4]) * capacity);
+    manager->visible_list = realloc(manager->visible_list, sizeof(uint32_t) * capacity);
+    manager->visible_dists = realloc(manager->visible_dists, sizeof(float) * capacity);
+    manager->entity_capacity = capacity;
+}
+
 EntityManager* entity_manager_create(void) {
     EntityManager* manager = (EntityManager*)malloc(sizeof(EntityManager));
     if (!manager) return NULL;
+    memset(manager, 0, sizeof(EntityManager));
+
+    // Initialize entity storage
+    entity_manager_grow_dense(manager, INITIAL_ENTITY_CAPACITY);
+
+    manager->slot_capacity = INITIAL_ENTITY_CAPACITY;
+    manager->slot_dense = (uint32_t*)malloc(sizeof(uint32_t) * manager->slot_capacity);
+    manager->slot_generations = (uint32_t*)malloc(sizeof(uint32_t) * manager->slot_capacity);
+    manager->free_slot = UINT32_MAX;
 
-    // Initialize entities array
-    manager->entities = (Entity*)malloc(sizeof(Entity) * INITIAL_ENTITY_CAPACITY);
-    manager->entity_count = 0;
-    manager->entity_capacity = INITIAL_ENTITY_CAPACITY;
+    manager->max_distance[ENTITY_TYPE_PLAYER] = ENTITY_DRAW_DIST_PLAYER;
+    manager->max_distance[ENTITY_TYPE_PROP] = ENTITY_DRAW_DIST_PROP;
+    manager->max_distance[ENTITY_TYPE_DYNAMIC] = ENTITY_DRAW_DIST_DYNAMIC;
+    manager->max_distance[ENTITY_TYPE_PARTICLE] = ENTITY_DRAW_DIST_PARTICLE;
+
+    manager->spatial_grid = spatial_grid_create(ENTITY_GRID_CELL_SIZE);
 
     // Initialize models array
     manager->loaded_models = (Model**)malloc(sizeof(Model*) * INITIAL_MODEL_CAPACITY);
@@ -22,10 +62,7 @@ EntityManager* entity_manager_create(void) {
     manager->loaded_model_capacity = INITIAL_MODEL_CAPACITY;
 
     // Initialize shader (will be set later)
-    manager->model_shader = 0;
-
-    // Initialize entity ID counter
-    manager->next_entity_id = 1;
+    memset(&manager->model_shader, 0, sizeof(Shader));
 
     printf("EntityManager created\n");
 
@@ -43,8 +80,8 @@ Model* entity_manager_load_model(EntityManager* manager, const char* obj_path) {
         }
     }
 
-    // Load new model
-    Model* model = model_load(obj_path);
+    // Load new model with every LOD level its import built
+    Model* model = model_load_with_lods(obj_path, MODEL_MAX_LODS);
     if (!model) {
         fprintf(stderr, "Failed to load model: %s\n", obj_path);
         return NULL;
@@ -63,30 +100,171 @@ Model* entity_manager_load_model(EntityManager* manager, const char* obj_path) {
     return model;
 }
 
-Entity* entity_manager_create_entity(EntityManager* manager, EntityType type,
-                                    Model* model, float pos[3], float rot[3], float scale[3]) {
-    if (!manager) return NULL;
+// Take a slot from the free list (or append one)
+static uint32_t entity_manager_alloc_slot(EntityManager* manager) {
+    if (manager->free_slot != UINT32_MAX) {
+        uint32_t slot = manager->free_slot;
+        manager->free_slot = manager->slot_dense[slot];
+        return slot;
+    }
 
-    // Expand entity array if needed
+    if (manager->slot_count >= manager->slot_capacity) {
+        manager->slot_capacity *= 2;
+        manager->slot_dense = (uint32_t*)realloc(manager->slot_dense,
+                                                 sizeof(uint32_t) * manager->slot_capacity);
+        manager->slot_generations = (uint32_t*)realloc(manager->slot_generations,
+                                                       sizeof(uint32_t) * manager->slot_capacity);
+    }
+
+    uint32_t slot = manager->slot_count++;
+    manager->slot_generations[slot] = 1;
+    return slot;
+}
+
+EntityHandle entity_manager_create_entity(EntityManager* manager, EntityType type,
+                                          Model* model, float pos[3], float rot[3], float scale[3]) {
+    if (!manager) return ENTITY_HANDLE_NULL;
+
+    // Expand entity arrays if needed
     if (manager->entity_count >= manager->entity_capacity) {
-        manager->entity_capacity *= 2;
-        manager->entities = (Entity*)realloc(manager->entities,
-                                            sizeof(Entity) * manager->entity_capacity);
+        entity_manager_grow_dense(manager, manager->entity_capacity * 2);
+    }
+
+    uint32_t slot = entity_manager_alloc_slot(manager);
+    unsigned int index = manager->entity_count++;
+
+    memcpy(manager->positions[index], pos, sizeof(float) * 3);
+    memcpy(manager->rotations[index], rot, sizeof(float) * 3);
+    memcpy(manager->scales[index], scale, sizeof(float) * 3);
+    memcpy(manager->prev_positions[index], pos, sizeof(float) * 3);
+    memcpy(manager->prev_rotations[index], rot, sizeof(float) * 3);
+    manager->models[index] = model;
+    manager->visible[index] = true;
+    manager->lods[index] = 0;
+    manager->types[index] = type;
+    manager->dense_slots[index] = slot;
+    manager->transform_dirty[index] = true;
+    manager->slot_dense[slot] = index;
+
+    // Index the pivot until the first transform update provides real bounds
+    memcpy(manager->bounds[index], pos, sizeof(float) * 3);
+    manager->bounds[index][3] = 0.0f;
+    spatial_grid_update(manager->spatial_grid, slot, manager->bounds[index]);
+
+    return (EntityHandle){slot, manager->slot_generations[slot]};
+}
+
+bool entity_manager_lookup(const EntityManager* manager, EntityHandle handle, unsigned int* out_index) {
+    if (!manager || handle.index >= manager->slot_count) return false;
+    if (manager->slot_generations[handle.index] != handle.generation) return false;
+
+    *out_index = manager->slot_dense[handle.index];
+    return true;
+}
+
+bool entity_manager_is_alive(const EntityManager* manager, EntityHandle handle) {
+    unsigned int index;
+    return entity_manager_lookup(manager, handle, &index);
+}
+
+bool entity_manager_destroy_entity(EntityManager* manager, EntityHandle handle) {
+    unsigned int index;
+    if (!entity_manager_lookup(manager, handle, &index)) return false;
+
+    spatial_grid_remove(manager->spatial_grid, handle.index);
+
+    // Move the last entity into the hole
+    unsigned int last = manager->entity_count - 1;
+    if (index != last) {
+        memcpy(manager->positions[index], manager->positions[last], sizeof(float) * 3);
+        memcpy(manager->rotations[index], manager->rotations[last], sizeof(float) * 3);
+        memcpy(manager->scales[index], manager->scales[last], sizeof(float) * 3);
+        memcpy(manager->prev_positions[index], manager->prev_positions[last], sizeof(float) * 3);
+        memcpy(manager->prev_rotations[index], manager->prev_rotations[last], sizeof(float) * 3);
+        manager->models[index] = manager->models[last];
+        manager->visible[index] = manager->visible[last];
+        manager->lods[index] = manager->lods[last];
+        manager->types[index] = manager->types[last];
+        manager->dense_slots[index] = manager->dense_slots[last];
+        memcpy(manager->transforms[index], manager->transforms[last], sizeof(float) * 16);
+        manager->transform_dirty[index] = manager->transform_dirty[last];
+        memcpy(manager->bounds[index], manager->bounds[last], sizeof(float) * 4);
+        manager->slot_dense[manager->dense_slots[index]] = index;
     }
+    manager->entity_count--;
 
-    // Create entity
-    Entity* entity = entity_create(manager->next_entity_id++, type, model, pos, rot, scale);
-    if (!entity) return NULL;
+    // Retire the slot; skip generation 0 so it never looks like a null handle
+    uint32_t slot = handle.index;
+    manager->slot_generations[slot]++;
+    if (manager->slot_generations[slot] == 0) manager->slot_generations[slot] = 1;
+    manager->slot_dense[slot] = manager->free_slot;
+    manager->free_slot = slot;
 
-    // Copy entity to array (since we're using a direct array, not pointers)
-    memcpy(&manager->entities[manager->entity_count], entity, sizeof(Entity));
-    Entity* stored_entity = &manager->entities[manager->entity_count];
-    manager->entity_count++;
+    return true;
+}
 
-    // Free the temporary entity (we copied it)
-    free(entity);
+bool entity_manager_get_position(const EntityManager* manager, EntityHandle handle, float out[3]) {
+    unsigned int index;
+    if (!entity_manager_lookup(manager, handle, &index)) return false;
+    memcpy(out, manager->positions[index], sizeof(float) * 3);
+    return true;
+}
+
+bool entity_manager_get_rotation(const EntityManager* manager, EntityHandle handle, float out[3]) {
+    unsigned int index;
+    if (!entity_manager_lookup(manager, handle, &index)) return false;
+    memcpy(out, manager->rotations[index], sizeof(float) * 3);
+    return true;
+}
+
+void entity_manager_model_changed(EntityManager* manager, const Model* model) {
+    for (unsigned int i = 0; i < manager->entity_count; i++) {
+        if (manager->models[i] == model) manager->transform_dirty[i] = true;
+    }
+}
 
-    return stored_entity;
+void entity_manager_set_position(EntityManager* manager, EntityHandle handle, const float position[3]) {
+    unsigned int index;
+    if (!entity_manager_lookup(manager, handle, &index)) return;
+    memcpy(manager->positions[index], position, sizeof(float) * 3);
+    manager->transform_dirty[index] = true;
+}
+
+void entity_manager_set_rotation(EntityManager* manager, EntityHandle handle, const float rotation[3]) {
+    unsigned int index;
+    if (!entity_manager_lookup(manager, handle, &index)) return;
+    memcpy(manager->rotations[index], rotation, sizeof(float) * 3);
+    manager->transform_dirty[index] = true;
+}
+
+void entity_manager_set_scale(EntityManager* manager, EntityHandle handle, const float scale[3]) {
+    unsigned int index;
+    if (!entity_manager_lookup(manager, handle, &index)) return;
+    memcpy(manager->scales[index], scale, sizeof(float) * 3);
+    manager->transform_dirty[index] = true;
+}
+
+void entity_manager_set_visible(EntityManager* manager, EntityHandle handle, bool visible) {
+    unsigned int index;
+    if (!entity_manager_lookup(manager, handle, &index)) return;
+    manager->visible[index] = visible;
+}
+
+void entity_manager_begin_tick(EntityManager* manager) {
+    if (!manager) return;
+
+    memcpy(manager->prev_positions, manager->positions, sizeof(float[3]) * manager->entity_count);
+    memcpy(manager->prev_rotations, manager->rotations, sizeof(float[3]) * manager->entity_count);
+}
+
+bool entity_manager_get_interpolated_position(const EntityManager* manager, EntityHandle handle,
+                                              float alpha, float out[3]) {
+    unsigned int index;
+    if (!entity_manager_lookup(manager, handle, &index)) return false;
+    for (int k = 0; k < 3; k++) {
+        out[k] = lerp(manager->prev_positions[index][k], manager->positions[index][k], alpha);
+    }
+    return true;
 }
 
 void entity_manager_update(EntityManager* manager, float delta_time) {
@@ -99,19 +277,359 @@ void entity_manager_update(EntityManager* manager, float delta_time) {
     // For now, this is a placeholder for future functionality
     // Example: Rotate entities slowly
     // for (unsigned int i = 0; i < manager->entity_count; i++) {
-    //     Entity* entity = &manager->entities[i];
-    //     entity->rotation[1] += delta_time * 0.5f; // Rotate around Y axis
+    //     manager->rotations[i][1] += delta_time * 0.5f; // Rotate around Y axis
+    //     manager->transform_dirty[i] = true;
     // }
+
+    entity_manager_update_transforms(manager);
 }
 
-void entity_manager_render(EntityManager* manager, float* view, float* proj,
-                          float cam_x, float cam_y, float cam_z) {
-    if (!manager || manager->model_shader == 0) return;
+// Compose one slice of the dirty list and move its bounds into world space
+static void entity_manager_transform_range(void* data, unsigned int begin, unsigned int end) {
+    EntityManager* manager = data;
+
+    mat4_compose_trs_batch(manager->transforms,
+                           (const float (*)[3])manager->positions,
+                           (const float (*)[3])manager->rotations,
+                           (const float (*)[3])manager->scales,
+                           manager->dirty_scratch + begin, end - begin);
+
+    for (unsigned int d = begin; d < end; d++) {
+        unsigned int i = manager->dirty_scratch[d];
+        const Model* model = manager->models[i];
+        const float* m = manager->transforms[i];
+        float* sphere = manager->bounds[i];
+
+        if (!model) {
+            sphere[0] = m[12];
+            sphere[1] = m[13];
+            sphere[2] = m[14];
+            sphere[3] = 0.0f;
+            continue;
+        }
 
-    // Render all entities
+        float c[3];
+        for (int k = 0; k < 3; k++) c[k] = 0.5f * (model->min[k] + model->max[k]);
+        for (int k = 0; k < 3; k++) {
+            sphere[k] = m[k] * c[0] + m[4 + k] * c[1] + m[8 + k] * c[2] + m[12 + k];
+        }
+
+        // Largest axis scale of the (possibly non-uniform) transform
+        float sx = m[0] * m[0] + m[1] * m[1] + m[2] * m[2];
+        float sy = m[4] * m[4] + m[5] * m[5] + m[6] * m[6];
+        float sz = m[8] * m[8] + m[9] * m[9] + m[10] * m[10];
+        sphere[3] = model_bounding_radius(model) * sqrtf(fmaxf(sx, fmaxf(sy, sz)));
+    }
+}
+
+unsigned int entity_manager_update_transforms(EntityManager* manager) {
+    if (!manager) return 0;
+
+    // Collect dirty entities, then compose them in SIMD batches across the pool
+    unsigned int dirty_count = 0;
     for (unsigned int i = 0; i < manager->entity_count; i++) {
-        Entity* entity = &manager->entities[i];
-        entity_render(entity, manager->model_shader, view, proj, cam_x, cam_y, cam_z);
+        if (manager->transform_dirty[i]) {
+            manager->dirty_scratch[dirty_count++] = i;
+            manager->transform_dirty[i] = false;
+        }
+    }
+
+    job_system_parallel_for(manager->jobs, dirty_count, TRANSFORM_MIN_BATCH,
+                            entity_manager_transform_range, manager);
+
+    // The grid is not thread safe; reindex on this thread
+    for (unsigned int d = 0; d < dirty_count; d++) {
+        unsigned int i = manager->dirty_scratch[d];
+        spatial_grid_update(manager->spatial_grid, manager->dense_slots[i], manager->bounds[i]);
+    }
+
+    return dirty_count;
+}
+
+// One parallel culling slice. Visible entries are written from the slice's
+// first index onwards, then packed together once every slice is done.
+typedef struct {
+    unsigned int begin;
+    unsigned int visible;
+    EntityCullStats stats;
+} EntityCullBatch;
+
+typedef struct {
+    EntityManager* manager;
+    Frustum frustum;
+    float cam_x, cam_y, cam_z;
+    unsigned int batch_size;
+    EntityCullBatch batches[JOB_PARALLEL_MAX_BATCHES];
+} EntityCullJob;
+
+// Classify one entity from its distance and frustum results
+static void entity_manager_cull_classify(EntityManager* manager, EntityCullBatch* batch, unsigned int index,
+                                         bool too_far, bool in_frustum, float dist_sq) {
+    if (!manager->visible[index] || !manager->models[index]) return;
+
+    EntityCullStats* stats = &batch->stats;
+    stats->tested++;
+    if (too_far) {
+        stats->distance_culled++;
+    } else if (!in_frustum) {
+        stats->frustum_culled++;
+    } else {
+        unsigned int slot = batch->begin + batch->visible++;
+        manager->visible_list[slot] = index;
+        manager->visible_dists[slot] = sqrtf(dist_sq);
+    }
+}
+
+static void entity_manager_cull_range(void* data, unsigned int begin, unsigned int end) {
+    EntityCullJob* job = data;
+    EntityManager* manager = job->manager;
+    const Frustum* frustum = &job->frustum;
+    float cam_x = job->cam_x, cam_y = job->cam_y, cam_z = job->cam_z;
+
+    EntityCullBatch* batch = &job->batches[begin / job->batch_size];
+    memset(batch, 0, sizeof(EntityCullBatch));
+    batch->begin = begin;
+
+    const float (*bounds)[4] = (const float (*)[4])manager->bounds;
+    unsigned int i = begin;
+
+    // Four spheres per iteration: AoS bounds are transposed into x/y/z/r lanes
+    v4f eye_x = v4_set1(cam_x), eye_y = v4_set1(cam_y), eye_z = v4_set1(cam_z);
+    for (; i + 4 <= end; i += 4) {
+        v4f cx = v4_load(bounds[i]);
+        v4f cy = v4_load(bounds[i + 1]);
+        v4f cz = v4_load(bounds[i + 2]);
+        v4f r = v4_load(bounds[i + 3]);
+        v4_transpose(&cx, &cy, &cz, &r);
+
+        v4f limit = v4_add(v4_set(manager->max_distance[manager->types[i]],
+                                  manager->max_distance[manager->types[i + 1]],
+                                  manager->max_distance[manager->types[i + 2]],
+                                  manager->max_distance[manager->types[i + 3]]), r);
+        v4f dx = v4_sub(cx, eye_x), dy = v4_sub(cy, eye_y), dz = v4_sub(cz, eye_z);
+        v4f dist_sq = v4_add(v4_add(v4_mul(dx, dx), v4_mul(dy, dy)), v4_mul(dz, dz));
+
+        int far_mask = v4_lt_mask(v4_mul(limit, limit), dist_sq);
+        int in_mask = frustum_test_spheres4(frustum, cx, cy, cz, r);
+
+        float dists[4];
+        v4_store(dists, dist_sq);
+        for (int lane = 0; lane < 4; lane++) {
+            entity_manager_cull_classify(manager, batch, i + lane, (far_mask >> lane) & 1,
+                                         (in_mask >> lane) & 1, dists[lane]);
+        }
+    }
+
+    for (; i < end; i++) {
+        const float* sphere = bounds[i];
+        float dx = sphere[0] - cam_x, dy = sphere[1] - cam_y, dz = sphere[2] - cam_z;
+        float dist_sq = dx * dx + dy * dy + dz * dz;
+        float limit = manager->max_distance[manager->types[i]] + sphere[3];
+        entity_manager_cull_classify(manager, batch, i, dist_sq > limit * limit,
+                                     frustum_test_sphere(frustum, sphere, sphere[3]), dist_sq);
+    }
+
+}
+
+unsigned int entity_manager_cull(EntityManager* manager, const float* view, const float* proj,
+                                 float cam_x, float cam_y, float cam_z) {
+    if (!manager) return 0;
+
+    EntityCullJob job;
+    job.manager = manager;
+    job.cam_x = cam_x;
+    job.cam_y = cam_y;
+    job.cam_z = cam_z;
+
+    float view_proj[16];
+    mat4_multiply(view_proj, proj, view);
+    frustum_from_matrix(&job.frustum, view_proj);
+
+    memset(&manager->cull_stats, 0, sizeof(EntityCullStats));
+    manager->visible_count = 0;
+
+    unsigned int count = manager->entity_count;
+    job.batch_size = job_system_batch_size(manager->jobs, count, CULL_MIN_BATCH);
+    job_system_parallel_for(manager->jobs, count, CULL_MIN_BATCH, entity_manager_cull_range, &job);
+
+    // Pack the per-slice visible runs (each starts at or after the write cursor)
+    unsigned int batch_count = count ? (count + job.batch_size - 1) / job.batch_size : 0;
+    for (unsigned int b = 0; b < batch_count; b++) {
+        const EntityCullBatch* batch = &job.batches[b];
+        if (batch->begin != manager->visible_count) {
+            memmove(&manager->visible_list[manager->visible_count], &manager->visible_list[batch->begin],
+                    sizeof(uint32_t) * batch->visible);
+            memmove(&manager->visible_dists[manager->visible_count], &manager->visible_dists[batch->begin],
+                    sizeof(float) * batch->visible);
+        }
+        manager->visible_count += batch->visible;
+
+        manager->cull_stats.tested += batch->stats.tested;
+        manager->cull_stats.distance_culled += batch->stats.distance_culled;
+        manager->cull_stats.frustum_culled += batch->stats.frustum_culled;
+    }
+
+    manager->cull_stats.visible = manager->visible_count;
+    return manager->visible_count;
+}
+
+
+void entity_manager_render(EntityManager* manager, RenderQueue* queue, const float* proj, float alpha) {
+    if (!manager || !queue || manager->model_shader.program == 0) return;
+
+    if (manager->visible_count > manager->render_capacity) {
+        manager->render_capacity = manager->entity_capacity;
+        manager->render_transforms = realloc(manager->render_transforms,
+                                             sizeof(float[16]) * manager->render_capacity);
+    }
+    memset(&manager->lod_stats, 0, sizeof(EntityLODStats));
+
+    for (unsigned int k = 0; k < manager->visible_count; k++) {
+        unsigned int i = manager->visible_list[k];
+        float* transform = manager->render_transforms[k];
+
+        // Entities that moved this tick are recomposed between the two states
+        if (memcmp(manager->prev_positions[i], manager->positions[i], sizeof(float) * 3) != 0 ||
+            memcmp(manager->prev_rotations[i], manager->rotations[i], sizeof(float) * 3) != 0) {
+            float position[3], rotation[3];
+            for (int c = 0; c < 3; c++) {
+                position[c] = lerp(manager->prev_positions[i][c], manager->positions[i][c], alpha);
+                rotation[c] = lerp(manager->prev_rotations[i][c], manager->rotations[i][c], alpha);
+            }
+            mat4_compose_trs(transform, position, rotation, manager->scales[i]);
+        } else {
+            memcpy(transform, manager->transforms[i], sizeof(float) * 16);
+        }
+
+        Model* model = manager->models[i];
+        float dist = fmaxf(manager->visible_dists[k], 0.001f);
+
+        // Pick detail level from the bounding sphere's projected size
+        // (proj[5] is the vertical focal length, so this is relative to screen height)
+        if (model->lod_count > 0) {
+            manager->lods[i] = model_select_lod(model, manager->bounds[i][3] * proj[5] / dist, manager->lods[i]);
+        }
+        manager->lod_stats.triangles += model_triangle_count(model, manager->lods[i]);
+        manager->lod_stats.full_detail_triangles += model_triangle_count(model, 0);
+
+        entity_queue_model(queue, model, manager->lods[i], transform,
+                           &manager->model_shader, dist / CAMERA_FAR);
+    }
+}
+
+EntityHandle entity_manager_slot_handle(const EntityManager* manager, uint32_t slot) {
+    if (slot == SPATIAL_GRID_NONE) return ENTITY_HANDLE_NULL;
+    return (EntityHandle){slot, manager->slot_generations[slot]};
+}
+
+static uint32_t* entity_manager_query_ids(EntityManager* manager, unsigned int count) {
+    if (count > manager->query_scratch_capacity) {
+        manager->query_scratch_capacity = count;
+        manager->query_scratch = realloc(manager->query_scratch, sizeof(uint32_t) * count);
+    }
+    return manager->query_scratch;
+}
+
+unsigned int entity_manager_query_radius(EntityManager* manager, const float center[3], float radius,
+                                         EntityHandle* out, unsigned int max_results) {
+    if (!manager) return 0;
+
+    uint32_t* ids = entity_manager_query_ids(manager, max_results);
+    unsigned int found = spatial_grid_query_radius(manager->spatial_grid, center, radius, ids, max_results);
+    unsigned int written = found < max_results ? found : max_results;
+    for (unsigned int i = 0; i < written; i++) out[i] = entity_manager_slot_handle(manager, ids[i]);
+    return found;
+}
+
+unsigned int entity_manager_query_nearest(EntityManager* manager, const float point[3], unsigned int k,
+                                          float max_distance, EntityHandle* out, float* out_distances) {
+    if (!manager) return 0;
+
+    uint32_t* ids = entity_manager_query_ids(manager, k);
+    unsigned int count = spatial_grid_query_nearest(manager->spatial_grid, point, k, max_distance,
+                                                    ids, out_distances);
+    for (unsigned int i = 0; i < count; i++) out[i] = entity_manager_slot_handle(manager, ids[i]);
+    return count;
+}
+
+// Slab test in model space against the model's bounding box. The ray is
+// mapped through the inverse of the cached T * R * S matrix: column j of
+// its upper 3x3 is the rotated axis scaled by s_j, so the local coordinate
+// is dot(column, v) / |column|^2. Affine maps keep the ray parameter t.
+bool entity_manager_ray_test(void* user, uint32_t slot, const float origin[3],
+                             const float direction[3], float* t) {
+    const EntityManager* manager = user;
+    unsigned int index = manager->slot_dense[slot];
+    const Model* model = manager->models[index];
+    if (!model) return true;  // Pivot-only entities keep the sphere hit
+
+    const float* m = manager->transforms[index];
+    float rel[3] = {origin[0] - m[12], origin[1] - m[13], origin[2] - m[14]};
+    float t_near = 0.0f, t_far = INFINITY;
+
+    for (int axis = 0; axis < 3; axis++) {
+        const float* col = &m[axis * 4];
+        float len_sq = col[0] * col[0] + col[1] * col[1] + col[2] * col[2];
+        if (len_sq <= 0.0f) return false;
+
+        float o = (col[0] * rel[0] + col[1] * rel[1] + col[2] * rel[2]) / len_sq;
+        float d = (col[0] * direction[0] + col[1] * direction[1] + col[2] * direction[2]) / len_sq;
+
+        if (fabsf(d) < 1e-12f) {
+            if (o < model->min[axis] || o > model->max[axis]) return false;
+            continue;
+        }
+        float t0 = (model->min[axis] - o) / d;
+        float t1 = (model->max[axis] - o) / d;
+        if (t0 > t1) { float tmp = t0; t0 = t1; t1 = tmp; }
+        t_near = fmaxf(t_near, t0);
+        t_far = fminf(t_far, t1);
+        if (t_near > t_far) return false;
+    }
+
+    *t = fmaxf(t_near, *t);
+    return true;
+}
+
+EntityHandle entity_manager_raycast(EntityManager* manager, const float origin[3], const float direction[3],
+                                    float max_distance, float* out_distance) {
+    if (!manager) return ENTITY_HANDLE_NULL;
+
+    uint32_t slot = spatial_grid_raycast_filtered(manager->spatial_grid, origin, direction, max_distance,
+                                                  entity_manager_ray_test, manager, out_distance);
+    return entity_manager_slot_handle(manager, slot);
+}
+
+void entity_manager_query_radius_batch(EntityManager* manager, const float (*centers)[3], const float* radii,
+                                       unsigned int count, EntityHandle* out, unsigned int max_total,
+                                       unsigned int* out_offsets) {
+    if (!manager) return;
+
+    uint32_t* ids = entity_manager_query_ids(manager, max_total);
+    spatial_grid_query_radius_batch(manager->spatial_grid, centers, radii, count, ids, max_total, out_offsets);
+    for (unsigned int i = 0; i < out_offsets[count]; i++) out[i] = entity_manager_slot_handle(manager, ids[i]);
+}
+
+void entity_manager_query_nearest_batch(EntityManager* manager, const float (*points)[3], unsigned int count,
+                                        unsigned int k, float max_distance, EntityHandle* out,
+                                        float* out_distances, unsigned int* out_counts) {
+    if (!manager) return;
+
+    for (unsigned int q = 0; q < count; q++) {
+        out_counts[q] = entity_manager_query_nearest(manager, points[q], k, max_distance, out + (size_t)q * k,
+                                                     out_distances ? out_distances + (size_t)q * k : NULL);
+    }
+}
+
+void entity_manager_raycast_batch(EntityManager* manager, const float (*origins)[3],
+                                  const float (*directions)[3], unsigned int count, float max_distance,
+                                  EntityHandle* out, float* out_distances) {
+    if (!manager) return;
+
+    for (unsigned int q = 0; q < count; q++) {
+        float t = max_distance;
+        out[q] = entity_manager_raycast(manager, origins[q], directions[q], max_distance, &t);
+        if (out_distances) out_distances[q] = t;
     }
 }
 
@@ -126,13 +644,31 @@ void entity_manager_cleanup(EntityManager* manager) {
     }
     free(manager->loaded_models);
 
-    // Free entities array (entities themselves don't own models)
-    free(manager->entities);
+    // Free entity storage (entities themselves don't own models)
+    free(manager->positions);
+    free(manager->rotations);
+    free(manager->scales);
+    free(manager->prev_positions);
+    free(manager->prev_rotations);
+    free(manager->render_transforms);
+    free(manager->models);
+    free(manager->visible);
+    free(manager->lods);
+    free(manager->types);
+    free(manager->dense_slots);
+    free(manager->transforms);
+    free(manager->transform_dirty);
+    free(manager->dirty_scratch);
+    free(manager->bounds);
+    free(manager->visible_list);
+    free(manager->visible_dists);
+    free(manager->slot_dense);
+    free(manager->slot_generations);
+    spatial_grid_free(manager->spatial_grid);
+    free(manager->query_scratch);
 
     // Delete shader
-    if (manager->model_shader) {
-        glDeleteProgram(manager->model_shader);
-    }
+    shader_destroy(&manager->model_shader);
 
     free(manager);
 
@@ -2,22 +2,88 @@
 #define ENTITYMANAGER_H
 
 #include "entity.h"
+#include "spatial_grid.h"
+#include "../engine/job_system.h"
 
+// Results of the last entity_manager_cull
 typedef struct {
-    Entity* entities;
+    unsigned int tested;
+    unsigned int distance_culled;
+    unsigned int frustum_culled;
+    unsigned int visible;
+} EntityCullStats;
+
+// Triangles queued by the last entity_manager_render
+typedef struct {
+    unsigned int triangles;             // At the selected detail levels
+    unsigned int full_detail_triangles; // Had every entity been drawn at full detail
+} EntityLODStats;
+
+// Entities are stored densely as structure-of-arrays: index [0, entity_count)
+// of every array below belongs to the same live entity. Destroying an entity
+// moves the last one into its place, so dense indices (and pointers into the
+// arrays) are only valid until the next create/destroy. Hold EntityHandles
+// across frames instead.
+//
+// World matrices are cached and only recomposed for entities whose
+// transform_dirty flag is set. The setters below set it; code writing the
+// position/rotation/scale arrays directly must set it too.
+typedef struct {
+    // Dense hot data
+    float (*positions)[3];
+    float (*rotations)[3];    // Euler angles (x, y, z)
+    float (*scales)[3];
+    float (*prev_positions)[3];  // State at the start of the current tick, for interpolation
+    float (*prev_rotations)[3];
+    Model** models;           // Shared references
+    bool* visible;
+    unsigned int* lods;       // Detail level drawn last frame
+    EntityType* types;
+    uint32_t* dense_slots;    // Sparse slot owning each dense entry
+    float (*transforms)[16];  // Cached world matrices (T * Rz * Ry * Rx * S)
+    float (*bounds)[4];       // World bounding sphere (center xyz, radius), follows transforms
+    bool* transform_dirty;    // Transform changed since the last recompose
+    uint32_t* dirty_scratch;  // Dense indices recomposed this frame
     unsigned int entity_count;
     unsigned int entity_capacity;
 
+    // Sparse handle table: slot -> dense index (or next free slot)
+    uint32_t* slot_dense;
+    uint32_t* slot_generations;
+    unsigned int slot_count;
+    unsigned int slot_capacity;
+    uint32_t free_slot;       // Head of the free slot list, UINT32_MAX if empty
+
+    // Culling output: dense indices of entities to draw this frame and
+    // their camera distances (valid until the next create/destroy)
+    uint32_t* visible_list;
+    float* visible_dists;
+    unsigned int visible_count;
+    float max_distance[ENTITY_TYPE_COUNT];  // Draw distance per type
+    EntityCullStats cull_stats;
+    EntityLODStats lod_stats;
+
+    // Proximity index over world bounds, keyed by sparse slot
+    SpatialGrid* spatial_grid;
+    uint32_t* query_scratch;
+    unsigned int query_scratch_capacity;
+
     // Model cache (shared models)
     Model** loaded_models;
     unsigned int loaded_model_count;
     unsigned int loaded_model_capacity;
 
     // Shader for model rendering
-    GLuint model_shader;
+    Shader model_shader;
+
+    // Pool for transform updates and culling (NULL runs them inline)
+    JobSystem* jobs;
 
-    // Next entity ID
-    unsigned int next_entity_id;
+    // Interpolated matrices of the visible entities, one per visible_list
+    // entry. Render packets point here rather than at transforms, so the
+    // next simulation tick can run while the queue is being submitted.
+    float (*render_transforms)[16];
+    unsigned int render_capacity;
 } EntityManager;
 
 // Create entity manager
@@ -26,16 +92,89 @@ EntityManager* entity_manager_create(void);
 // Load a model (caches it if not already loaded)
 Model* entity_manager_load_model(EntityManager* manager, const char* obj_path);
 
+// A model's meshes and bounds changed (an async load finished): recompute
+// the bounds of every entity using it on the next transform update
+void entity_manager_model_changed(EntityManager* manager, const Model* model);
+
 // Create entity and add to manager
-Entity* entity_manager_create_entity(EntityManager* manager, EntityType type,
-                                    Model* model, float pos[3], float rot[3], float scale[3]);
+EntityHandle entity_manager_create_entity(EntityManager* manager, EntityType type,
+                                          Model* model, float pos[3], float rot[3], float scale[3]);
+
+// Destroy entity, O(1). Returns false if the handle is stale.
+bool entity_manager_destroy_entity(EntityManager* manager, EntityHandle handle);
+
+// Check whether a handle still refers to a live entity
+bool entity_manager_is_alive(const EntityManager* manager, EntityHandle handle);
 
-// Update all entities
+// Dense index of a live entity (for direct array access), false if stale
+bool entity_manager_lookup(const EntityManager* manager, EntityHandle handle, unsigned int* out_index);
+
+// Transform accessors (getters return false and leave out untouched if stale)
+bool entity_manager_get_position(const EntityManager* manager, EntityHandle handle, float out[3]);
+bool entity_manager_get_rotation(const EntityManager* manager, EntityHandle handle, float out[3]);
+void entity_manager_set_position(EntityManager* manager, EntityHandle handle, const float position[3]);
+void entity_manager_set_rotation(EntityManager* manager, EntityHandle handle, const float rotation[3]);
+void entity_manager_set_scale(EntityManager* manager, EntityHandle handle, const float scale[3]);
+void entity_manager_set_visible(EntityManager* manager, EntityHandle handle, bool visible);
+
+// Start a simulation tick: the current state becomes the interpolation origin
+void entity_manager_begin_tick(EntityManager* manager);
+
+// Update all entities (ends by recomposing dirty transforms)
 void entity_manager_update(EntityManager* manager, float delta_time);
 
-// Render all entities
-void entity_manager_render(EntityManager* manager, float* view, float* proj,
-                          float cam_x, float cam_y, float cam_z);
+// Position blended between the previous and current tick (alpha in [0, 1])
+bool entity_manager_get_interpolated_position(const EntityManager* manager, EntityHandle handle,
+                                              float alpha, float out[3]);
+
+// Recompose world matrices of dirty entities in one batch.
+// Returns the number of matrices rebuilt.
+unsigned int entity_manager_update_transforms(EntityManager* manager);
+
+// Test world bounding spheres against the view frustum and per-type draw
+// distances, filling visible_list. Call after the frame's update.
+unsigned int entity_manager_cull(EntityManager* manager, const float* view, const float* proj,
+                                 float cam_x, float cam_y, float cam_z);
+
+// Pick detail levels and queue draw packets for the entities in visible_list,
+// drawn alpha of the way from the previous tick's state to the current one.
+// Packets reference render_transforms, which stay valid until the next call.
+void entity_manager_render(EntityManager* manager, RenderQueue* queue, const float* proj, float alpha);
+
+// Spatial queries against world bounds (current as of the last transform
+// update; new entities are indexed at their position until then).
+// Radius: entities whose bounds intersect the sphere, writes up to max_results
+// handles and returns the total found.
+unsigned int entity_manager_query_radius(EntityManager* manager, const float center[3], float radius,
+                                         EntityHandle* out, unsigned int max_results);
+
+// Up to k nearest entities by distance to their bounds, nearest first
+unsigned int entity_manager_query_nearest(EntityManager* manager, const float point[3], unsigned int k,
+                                          float max_distance, EntityHandle* out, float* out_distances);
+
+// First entity whose model bounds (its oriented box) the ray hits.
+// direction must be normalized. Returns ENTITY_HANDLE_NULL on a miss.
+EntityHandle entity_manager_raycast(EntityManager* manager, const float origin[3], const float direction[3],
+                                    float max_distance, float* out_distance);
+
+// Batched forms, see spatial_grid.h for the output layouts
+void entity_manager_query_radius_batch(EntityManager* manager, const float (*centers)[3], const float* radii,
+                                       unsigned int count, EntityHandle* out, unsigned int max_total,
+                                       unsigned int* out_offsets);
+void entity_manager_query_nearest_batch(EntityManager* manager, const float (*points)[3], unsigned int count,
+                                        unsigned int k, float max_distance, EntityHandle* out,
+                                        float* out_distances, unsigned int* out_counts);
+void entity_manager_raycast_batch(EntityManager* manager, const float (*origins)[3],
+                                  const float (*directions)[3], unsigned int count, float max_distance,
+                                  EntityHandle* out, float* out_distances);
+
+// Spatial grid ids are entity slots. These let other systems walk the grid
+// directly: the handle of a slot (ENTITY_HANDLE_NULL for SPATIAL_GRID_NONE),
+// and the oriented box test entity_manager_raycast refines hits with
+// (a SpatialRayTest, user = the manager).
+EntityHandle entity_manager_slot_handle(const EntityManager* manager, uint32_t slot);
+bool entity_manager_ray_test(void* user, uint32_t slot, const float origin[3],
+                             const float direction[3], float* t);
 
 // Cleanup entity manager
 void entity_manager_cleanup(EntityManager* manager);
@@ -0,0 +1,264 @@
+#include "explosion.h"
+#include "../file_ops.h"
+#include "../graphics/texture.h"
+#include "../graphics/state.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+// Billboard corners in the xz plane, as explosionvert expects (tc = pos.xz)
+static const float EXPLOSION_QUAD[] = {
+    -1.0f, 0.0f, -1.0f, 1.0f,
+     1.0f, 0.0f, -1.0f, 1.0f,
+     1.0f, 0.0f,  1.0f, 1.0f,
+    -1.0f, 0.0f, -1.0f, 1.0f,
+     1.0f, 0.0f,  1.0f, 1.0f,
+    -1.0f, 0.0f,  1.0f, 1.0f,
+};
+
+// Bounding radius of an explosion at a given age: particle offset (up to
+// 20) plus particle size (up to 22) plus drift (16 per second), all * scale
+static inline v4f explosion_radius4(v4f age, v4f scale) {
+    return v4_mul(v4_add(v4_set1(45.0f), v4_mul(age, v4_set1(18.0f))), scale);
+}
+
+// xorshift32
+static unsigned int next_seed(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+ExplosionSystem* explosion_system_create(void) {
+    ExplosionSystem* system = malloc(sizeof(ExplosionSystem));
+    memset(system, 0, sizeof(ExplosionSystem));
+
+    unsigned int padded = (EXPLOSION_MAX_EMITTERS + 3) & ~3u;
+    system->capacity = EXPLOSION_MAX_EMITTERS;
+    system->center_x = calloc(padded, sizeof(float));
+    system->center_y = calloc(padded, sizeof(float));
+    system->center_z = calloc(padded, sizeof(float));
+    system->age = calloc(padded, sizeof(float));
+    system->scale = calloc(padded, sizeof(float));
+    system->seed = calloc(padded, sizeof(float));
+    system->instances = malloc(sizeof(ExplosionInstance) * EXPLOSION_PARTICLE_BUDGET);
+    system->seed_state = 0x9E3779B9u;
+
+    glGenVertexArrays(1, &system->vao);
+    glGenBuffers(1, &system->quad_vbo);
+    glGenBuffers(1, &system->instance_vbo);
+    glBindVertexArray(system->vao);
+
+    // Corner (location 0)
+    glBindBuffer(GL_ARRAY_BUFFER, system->quad_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(EXPLOSION_QUAD), EXPLOSION_QUAD, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    // Center + age (location 1), scale + particle id (location 2)
+    glBindBuffer(GL_ARRAY_BUFFER, system->instance_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(ExplosionInstance) * EXPLOSION_PARTICLE_BUDGET, NULL, GL_STREAM_DRAW);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(ExplosionInstance), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(ExplosionInstance), (void*)(4 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glBindVertexArray(0);
+
+    const char* vert_src = load_shader_source("assets/shaders/explosionvert.glsl");
+    const char* frag_src = load_shader_source("assets/shaders/explosionfrag.glsl");
+    system->shader = shader_create(vert_src, frag_src, "explosion");
+    free((void*)vert_src);
+    free((void*)frag_src);
+    system->uniforms.tex = shader_uniform(&system->shader, "tex");
+
+    system->texture = texture_load_flags("assets/textures/explosionparticle.png", TEXTURE_CLAMP);
+    if (system->texture == 0) {
+        fprintf(stderr, "Warning: Failed to load explosion texture\n");
+    }
+
+    printf("Explosions initialized (%d emitters, %d particle budget)\n",
+           EXPLOSION_MAX_EMITTERS, EXPLOSION_PARTICLE_BUDGET);
+
+    return system;
+}
+
+void explosion_spawn(ExplosionSystem* system, const float position[3], float scale) {
+    if (!system || scale <= 0.0f) return;
+
+    unsigned int i = system->count;
+    if (i == system->capacity) {
+        // Full: the oldest explosion is the least visible, replace it
+        i = 0;
+        for (unsigned int j = 1; j < system->count; j++) {
+            if (system->age[j] > system->age[i]) i = j;
+        }
+    } else {
+        system->count++;
+    }
+
+    system->center_x[i] = position[0];
+    system->center_y[i] = position[1];
+    system->center_z[i] = position[2];
+    system->age[i] = 0.0f;
+    system->scale[i] = scale;
+    // Whole blocks of indices so explosions don't share particle layouts
+    system->seed[i] = (float)((next_seed(&system->seed_state) % 1024u) * EXPLOSION_PARTICLES);
+}
+
+void explosion_system_update(ExplosionSystem* system, float dt) {
+    if (!system) return;
+    system->tick_dt = dt;
+
+    v4f vdt = v4_set1(dt);
+    unsigned int padded = (system->count + 3) & ~3u;
+    for (unsigned int i = 0; i < padded; i += 4) {
+        v4_store(system->age + i, v4_add(v4_load(system->age + i), vdt));
+    }
+
+    // Retire finished explosions, moving the last one into the gap
+    for (unsigned int i = system->count; i-- > 0;) {
+        if (system->age[i] < EXPLOSION_LIFETIME) continue;
+        unsigned int last = --system->count;
+        system->center_x[i] = system->center_x[last];
+        system->center_y[i] = system->center_y[last];
+        system->center_z[i] = system->center_z[last];
+        system->age[i] = system->age[last];
+        system->scale[i] = system->scale[last];
+        system->seed[i] = system->seed[last];
+    }
+}
+
+// Fraction of an explosion's particles drawn at a distance (in units of its scale)
+static float explosion_density(float scaled_dist) {
+    if (scaled_dist <= EXPLOSION_FULL_DENSITY_DIST) return 1.0f;
+    if (scaled_dist >= EXPLOSION_MIN_DENSITY_DIST) return EXPLOSION_MIN_DENSITY;
+    float t = (scaled_dist - EXPLOSION_FULL_DENSITY_DIST) /
+              (EXPLOSION_MIN_DENSITY_DIST - EXPLOSION_FULL_DENSITY_DIST);
+    return 1.0f + (EXPLOSION_MIN_DENSITY - 1.0f) * t;
+}
+
+void explosion_system_prepare(ExplosionSystem* system, const Frustum* frustum,
+                              float camera_x, float camera_y, float camera_z, float alpha) {
+    system->instance_count = 0;
+    system->drawn_emitters = 0;
+    system->requested_particles = 0;
+    if (system->count == 0) return;
+
+    // Age as drawn: alpha of the way through the last tick
+    float age_offset = (1.0f - alpha) * system->tick_dt;
+
+    // Visible explosions and the particles each would like at its distance
+    unsigned int visible[EXPLOSION_MAX_EMITTERS];
+    unsigned int wanted[EXPLOSION_MAX_EMITTERS];
+    unsigned int visible_count = 0;
+    unsigned int total = 0;
+
+    unsigned int padded = (system->count + 3) & ~3u;
+    for (unsigned int i = 0; i < padded; i += 4) {
+        v4f radius = explosion_radius4(v4_load(system->age + i), v4_load(system->scale + i));
+        int mask = frustum_test_spheres4(frustum, v4_load(system->center_x + i), v4_load(system->center_y + i),
+                                         v4_load(system->center_z + i), radius);
+
+        for (unsigned int lane = 0; lane < 4 && i + lane < system->count; lane++) {
+            if (!(mask & (1 << lane))) continue;
+            unsigned int e = i + lane;
+
+            float dx = system->center_x[e] - camera_x;
+            float dy = system->center_y[e] - camera_y;
+            float dz = system->center_z[e] - camera_z;
+            float dist = sqrtf(dx * dx + dy * dy + dz * dz);
+
+            unsigned int n = (unsigned int)ceilf(EXPLOSION_PARTICLES * explosion_density(dist / system->scale[e]));
+            if (n < EXPLOSION_MIN_PARTICLES) n = EXPLOSION_MIN_PARTICLES;
+
+            visible[visible_count] = e;
+            wanted[visible_count] = n;
+            visible_count++;
+            total += n;
+        }
+    }
+    system->requested_particles = total;
+    if (visible_count == 0) return;
+
+    // Over budget: thin every explosion by the same factor
+    float keep = total > EXPLOSION_PARTICLE_BUDGET ? (float)EXPLOSION_PARTICLE_BUDGET / (float)total : 1.0f;
+
+    for (unsigned int v = 0; v < visible_count; v++) {
+        unsigned int e = visible[v];
+        unsigned int n = (unsigned int)((float)wanted[v] * keep);
+        if (n < EXPLOSION_MIN_PARTICLES) n = EXPLOSION_MIN_PARTICLES;
+        if (n > EXPLOSION_PARTICLE_BUDGET - system->instance_count) {
+            n = EXPLOSION_PARTICLE_BUDGET - system->instance_count;
+        }
+        if (n == 0) break;
+
+        float age = fmaxf(system->age[e] - age_offset, 0.0f);
+        ExplosionInstance* inst = &system->instances[system->instance_count];
+        for (unsigned int p = 0; p < n; p++) {
+            inst[p].center[0] = system->center_x[e];
+            inst[p].center[1] = system->center_y[e];
+            inst[p].center[2] = system->center_z[e];
+            inst[p].age = age;
+            inst[p].scale = system->scale[e];
+            inst[p].id = system->seed[e] + (float)p;
+            inst[p].pad[0] = 0.0f;
+            inst[p].pad[1] = 0.0f;
+        }
+        system->instance_count += n;
+        system->drawn_emitters++;
+    }
+}
+
+void explosion_system_render(ExplosionSystem* system) {
+    if (system->instance_count == 0) return;
+
+    // Orphan last frame's storage instead of waiting for the GPU to release it
+    glBindBuffer(GL_ARRAY_BUFFER, system->instance_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(ExplosionInstance) * EXPLOSION_PARTICLE_BUDGET, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(ExplosionInstance) * system->instance_count, system->instances);
+
+    Shader* shader = &system->shader;
+    shader_use(shader);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, system->texture);
+    shader_uniform_int(shader, system->uniforms.tex, 0);
+
+    // Blended over everything opaque, without occluding each other
+    glEnable(GL_DEPTH_TEST);
+    state_enable_blend();
+    state_set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state_set_depth_mask(GL_FALSE);
+    state_disable_cull_face();
+
+    glBindVertexArray(system->vao);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, system->instance_count);
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    state_restore_defaults();
+}
+
+void explosion_system_cleanup(ExplosionSystem* system) {
+    if (!system) return;
+
+    glDeleteVertexArrays(1, &system->vao);
+    glDeleteBuffers(1, &system->quad_vbo);
+    glDeleteBuffers(1, &system->instance_vbo);
+    shader_destroy(&system->shader);
+    texture_release(system->texture);
+
+    free(system->center_x);
+    free(system->center_y);
+    free(system->center_z);
+    free(system->age);
+    free(system->scale);
+    free(system->seed);
+    free(system->instances);
+    free(system);
+}
@@ -0,0 +1,89 @@
+#ifndef EXPLOSION_H
+#define EXPLOSION_H
+
+#include <glad/glad.h>
+#include <stdbool.h>
+#include "../graphics/shader.h"
+#include "../math/frustum.h"
+
+// Explosion configuration
+#define EXPLOSION_MAX_EMITTERS 1024         // Live explosions; the oldest is recycled when full
+#define EXPLOSION_PARTICLES 48              // Particles of an explosion at full density
+#define EXPLOSION_LIFETIME 2.0f             // Particle size returns to zero at age 2 (explosionvert)
+#define EXPLOSION_PARTICLE_BUDGET 24000     // Particles drawn per frame, across all explosions
+#define EXPLOSION_FULL_DENSITY_DIST 300.0f  // Distance / scale up to which every particle is drawn
+#define EXPLOSION_MIN_DENSITY_DIST 3000.0f  // Distance / scale where density bottoms out
+#define EXPLOSION_MIN_DENSITY 0.25f
+#define EXPLOSION_MIN_PARTICLES 4           // Never thin a visible explosion below this
+
+// Explosions are emitters only: particle motion is a closed-form function of
+// the emitter's age and the particle index (explosionvert.glsl), so the CPU
+// only ages emitters and writes one instance per drawn particle. Particles
+// are indexed in random order, so drawing a prefix of an explosion's
+// particles is an even thinning of it; that is how distance falloff and the
+// frame budget degrade dense scenes.
+
+// Per-particle instance data, uploaded as-is to the instance buffer
+typedef struct {
+    float center[3];
+    float age;
+    float scale;
+    float id;               // Particle index, offset by the emitter's seed
+    float pad[2];
+} ExplosionInstance;
+
+// Explosion shader uniforms, resolved once at creation
+typedef struct {
+    ShaderUniform tex;
+} ExplosionUniforms;
+
+typedef struct {
+    // Live emitters, dense structure-of-arrays padded to a multiple of 4
+    float* center_x;
+    float* center_y;
+    float* center_z;
+    float* age;
+    float* scale;
+    float* seed;
+    unsigned int count;
+    unsigned int capacity;
+    float tick_dt;                  // Step of the last update, for interpolating age
+    unsigned int seed_state;
+
+    // Billboard quad and per-particle instance buffer
+    GLuint vao;
+    GLuint quad_vbo;
+    GLuint instance_vbo;
+    ExplosionInstance* instances;   // Snapshot from the last prepare
+    unsigned int instance_count;
+
+    Shader shader;
+    ExplosionUniforms uniforms;
+    GLuint texture;
+
+    // Stats from the last prepare
+    unsigned int drawn_emitters;
+    unsigned int requested_particles;   // Before the budget
+} ExplosionSystem;
+
+// Create explosion system (loads shader and texture)
+ExplosionSystem* explosion_system_create(void);
+
+// Start an explosion; scale 1 is a large blast, impacts use a fraction
+void explosion_spawn(ExplosionSystem* system, const float position[3], float scale);
+
+// Age every explosion by dt and retire the finished ones (no GL calls)
+void explosion_system_update(ExplosionSystem* system, float dt);
+
+// Cull, thin and snapshot particles to draw, alpha of the way through the
+// last tick (no GL calls)
+void explosion_system_prepare(ExplosionSystem* system, const Frustum* frustum,
+                              float camera_x, float camera_y, float camera_z, float alpha);
+
+// Upload the snapshot and draw it in one instanced call (blended, no depth writes)
+void explosion_system_render(ExplosionSystem* system);
+
+// Cleanup explosion system
+void explosion_system_cleanup(ExplosionSystem* system);
+
+#endif // EXPLOSION_H
@@ -1,4 +1,5 @@
 #include "material.h"
+#include "../graphics/texture.h"
 #include <string.h>
 
 Material material_create_default(void) {
@@ -30,8 +31,9 @@ Material material_create_default(void) {
 }
 
 void material_cleanup(Material* mat) {
-    if (mat->diffuse_map) glDeleteTextures(1, &mat->diffuse_map);
-    if (mat->specular_map) glDeleteTextures(1, &mat->specular_map);
-    if (mat->normal_map) glDeleteTextures(1, &mat->normal_map);
-    if (mat->alpha_map) glDeleteTextures(1, &mat->alpha_map);
+    // Maps may still be loading (see texture_load_async)
+    texture_release(mat->diffuse_map);
+    texture_release(mat->specular_map);
+    texture_release(mat->normal_map);
+    texture_release(mat->alpha_map);
 }
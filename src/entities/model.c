@@ -1,50 +1,117 @@
 #include "model.h"
 #include "../graphics/texture.h"
-#include <fast_obj.h>
+#include "model_cook.h"
+#include "../engine/asset_loader.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
-
-// Helper to resolve texture paths from MTL files
-static char* resolve_texture_path(const char* texture_name, const char* base_dir) {
-    if (!texture_name || strlen(texture_name) == 0) {
-        return NULL;
+#include <stdint.h>
+
+void mesh_bind_vertex_attributes(const Mesh* mesh) {
+    glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+    GLsizei stride = (GLsizei)vertex_format_stride(mesh->format);
+
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+
+    switch (mesh->format) {
+    case VERTEX_FORMAT_COMPACT16:
+        // unorm16 position, int16 octahedral normal, half texcoord
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)0);
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_FALSE, stride, (void*)8);
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)12);
+        break;
+    case VERTEX_FORMAT_COMPACT12:
+        // unorm16 position, int8 octahedral normal, half texcoord
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)0);
+        glVertexAttribPointer(1, 2, GL_BYTE, GL_FALSE, stride, (void*)6);
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)8);
+        break;
+    default:
+        // Position (location 0), normal (location 1), texcoord (location 2)
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+        break;
     }
+}
+
+void mesh_upload_raw(Mesh* mesh, VertexFormat format, const VertexDecode* decode,
+                     const void* vertex_data, unsigned int vertex_count,
+                     const void* index_data, GLenum index_type, unsigned int index_count) {
+    mesh->vertex_count = vertex_count;
+    mesh->index_count = index_count;
+    mesh->index_type = index_type;
+    mesh->format = format;
+    mesh->decode = *decode;
+
+    glGenVertexArrays(1, &mesh->vao);
+    glGenBuffers(1, &mesh->vbo);
+    glGenBuffers(1, &mesh->ibo);
+
+    glBindVertexArray(mesh->vao);
 
-    // Extract filename from path (handle absolute paths in MTL)
-    const char* filename = strrchr(texture_name, '/');
-    if (!filename) {
-        filename = strrchr(texture_name, '\\');
+    // Upload vertex data
+    glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+    glBufferData(GL_ARRAY_BUFFER, (size_t)vertex_count * vertex_format_stride(format), vertex_data, GL_STATIC_DRAW);
+    mesh_bind_vertex_attributes(mesh);
+
+    // Upload index data
+    size_t index_size = index_type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ibo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_count * index_size, index_data, GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+}
+
+// Upload float vertices in format, narrowing indices to 16 bits when every vertex is reachable
+static void mesh_upload_format(Mesh* mesh, VertexFormat format, const float* min, const float* max,
+                               const float* vertex_data, unsigned int vertex_count,
+                               const unsigned int* index_data, unsigned int index_count) {
+    VertexDecode decode = vertex_format_decode_params(format, min, max);
+
+    void* encoded = NULL;
+    const void* vertices = vertex_data;
+    if (format != VERTEX_FORMAT_FLOAT) {
+        encoded = malloc((size_t)vertex_count * vertex_format_stride(format));
+        vertex_format_encode(encoded, format, vertex_data, vertex_count, min, max);
+        vertices = encoded;
     }
-    if (filename) {
-        filename++; // Skip the slash
+
+    if (vertex_count <= 65536) {
+        uint16_t* short_indices = (uint16_t*)malloc(sizeof(uint16_t) * index_count);
+        for (unsigned int i = 0; i < index_count; i++) {
+            short_indices[i] = (uint16_t)index_data[i];
+        }
+        mesh_upload_raw(mesh, format, &decode, vertices, vertex_count, short_indices, GL_UNSIGNED_SHORT, index_count);
+        free(short_indices);
     } else {
-        filename = texture_name; // No path separator, use as-is
+        mesh_upload_raw(mesh, format, &decode, vertices, vertex_count, index_data, GL_UNSIGNED_INT, index_count);
     }
 
-    // Build path: base_dir + filename
-    static char resolved_path[512];
-    snprintf(resolved_path, sizeof(resolved_path), "%s%s", base_dir, filename);
+    free(encoded);
+}
 
-    return resolved_path;
+void mesh_upload(Mesh* mesh, const float* vertex_data, unsigned int vertex_count,
+                 const unsigned int* index_data, unsigned int index_count) {
+    mesh_upload_format(mesh, VERTEX_FORMAT_FLOAT, NULL, NULL, vertex_data, vertex_count, index_data, index_count);
 }
 
-Model* model_load(const char* obj_path) {
-    printf("Loading model: %s\n", obj_path);
+// Projected size thresholds for each coarser level
+static const float MODEL_LOD_SCREEN_SIZES[MODEL_MAX_LODS] = {0.12f, 0.05f, 0.02f, 0.008f};
 
-    // Load OBJ file with fast_obj
-    fastObjMesh* obj = fast_obj_read(obj_path);
-    if (!obj) {
-        fprintf(stderr, "Failed to load OBJ file: %s\n", obj_path);
-        return NULL;
-    }
+// Bytes a mesh occupies on the GPU
+static size_t mesh_gpu_bytes(const Mesh* mesh) {
+    size_t index_size = mesh->index_type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+    return (size_t)mesh->vertex_count * vertex_format_stride(mesh->format) + (size_t)mesh->index_count * index_size;
+}
 
+// Empty model for obj_path with room for mesh_count meshes and lod_count levels
+static Model* model_create(const char* obj_path, unsigned int mesh_count, unsigned int lod_count) {
     Model* model = (Model*)malloc(sizeof(Model));
-    if (!model) {
-        fast_obj_destroy(obj);
-        return NULL;
-    }
+    if (!model) return NULL;
 
     // Initialize model
     memset(model, 0, sizeof(Model));
@@ -57,260 +124,348 @@ Model* model_load(const char* obj_path) {
     else name_start = obj_path;
     strncpy(model->name, name_start, sizeof(model->name) - 1);
 
-    // Load materials
-    model->material_count = obj->material_count;
-    printf("Found %u materials, %u textures\n", obj->material_count, obj->texture_count);
+    model->mesh_count = mesh_count;
+    model->meshes = (Mesh*)calloc(mesh_count ? mesh_count : 1, sizeof(Mesh));
 
-    // Debug: Print all textures
-    for (unsigned int i = 0; i < obj->texture_count; i++) {
-        fastObjTexture* tex = &obj->textures[i];
-        printf("Texture %u: name='%s', path='%s'\n", i,
-               tex->name ? tex->name : "NULL",
-               tex->path ? tex->path : "NULL");
+    model->lod_count = lod_count < MODEL_MAX_LODS ? lod_count : MODEL_MAX_LODS;
+    for (unsigned int l = 0; l < model->lod_count; l++) {
+        model->lods[l].meshes = (Mesh*)calloc(mesh_count ? mesh_count : 1, sizeof(Mesh));
+        model->lods[l].mesh_count = mesh_count;
+        model->lods[l].screen_size = MODEL_LOD_SCREEN_SIZES[l];
     }
 
-    if (model->material_count > 0) {
-        model->materials = (Material*)malloc(sizeof(Material) * model->material_count);
-
-        for (unsigned int i = 0; i < model->material_count; i++) {
-            fastObjMaterial* mtl = &obj->materials[i];
-            Material* mat = &model->materials[i];
-
-            // Copy material properties
-            memcpy(mat->ambient, mtl->Ka, sizeof(float) * 3);
-            memcpy(mat->diffuse, mtl->Kd, sizeof(float) * 3);
-            memcpy(mat->specular, mtl->Ks, sizeof(float) * 3);
-            mat->shininess = mtl->Ns;
-
-            printf("Material %u: '%s'\n", i, mtl->name);
-            printf("  Texture indices: Kd=%u, Ks=%u, bump=%u, d=%u\n",
-                   mtl->map_Kd, mtl->map_Ks, mtl->map_bump, mtl->map_d);
-            strncpy(mat->name, mtl->name, sizeof(mat->name) - 1);
-
-            // Load textures (resolve paths to assets/textures/)
-            mat->diffuse_map = 0;
-            mat->specular_map = 0;
-            mat->normal_map = 0;
-            mat->alpha_map = 0;
-
-            // fast_obj uses direct array indices (not 1-based OBJ indices)
-            // Index 0 is often NULL/reserved, actual textures start at higher indices
-            if (mtl->map_Kd > 0 && mtl->map_Kd < obj->texture_count) {
-                fastObjTexture* tex = &obj->textures[mtl->map_Kd];
-                printf("  Diffuse texture: name='%s', path='%s'\n",
-                       tex->name ? tex->name : "NULL",
-                       tex->path ? tex->path : "NULL");
-                if (tex->path) {
-                    char* path = resolve_texture_path(tex->path, "assets/textures/");
-                    printf("  Resolved to: %s\n", path);
-                    mat->diffuse_map = texture_load(path);
-                    if (mat->diffuse_map == 0) {
-                        printf("  ERROR: Failed to load diffuse map: %s\n", path);
-                    } else {
-                        printf("  SUCCESS: Loaded texture ID %u\n", mat->diffuse_map);
-                    }
-                }
-            }
-
-            if (mtl->map_Ks > 0 && mtl->map_Ks < obj->texture_count) {
-                fastObjTexture* tex = &obj->textures[mtl->map_Ks];
-                printf("   Ks texture: name='%s', path='%s'\n",
-                                       tex->name ? tex->name : "NULL",
-                                       tex->path ? tex->path : "NULL");
-                if (tex->path) {
-                    char* path = resolve_texture_path(tex->path, "assets/textures/");
-                    mat->specular_map = texture_load(path);
-                }
-            }
-
-            if (mtl->map_bump > 0 && mtl->map_bump < obj->texture_count) {
-                fastObjTexture* tex = &obj->textures[mtl->map_bump];
-                printf("  BUMP texture: name='%s', path='%s'\n",
-                                       tex->name ? tex->name : "NULL",
-                                       tex->path ? tex->path : "NULL");
-                if (tex->path) {
-                    char* path = resolve_texture_path(tex->path, "assets/textures/");
-                    mat->normal_map = texture_load(path);
-                }
-            }
-
-            if (mtl->map_d > 0 && mtl->map_d < obj->texture_count) {
-                fastObjTexture* tex = &obj->textures[mtl->map_d];
-                printf("  d texture: name='%s', path='%s'\n",
-                                                       tex->name ? tex->name : "NULL",
-                                                       tex->path ? tex->path : "NULL");
-                if (tex->path) {
-                    char* path = resolve_texture_path(tex->path, "assets/textures/");
-                    mat->alpha_map = texture_load(path);
-                }
-            }
-        }
+    return model;
+}
+
+// Load a texture named in a material (paths from cooked files are bounded here)
+static GLuint model_load_texture(const char* path) {
+    char bounded[MODEL_PATH_MAX];
+    memcpy(bounded, path, MODEL_PATH_MAX);
+    bounded[MODEL_PATH_MAX - 1] = '\0';
+    if (bounded[0] == '\0') return 0;
+
+    return texture_load_async(bounded);
+}
+
+// Create the model's materials and load their textures
+static void model_load_materials(Model* model, const ModelMaterialData* materials, unsigned int material_count) {
+    model->material_count = material_count;
+    if (material_count == 0) return;
+
+    model->materials = (Material*)calloc(material_count, sizeof(Material));
+    for (unsigned int i = 0; i < material_count; i++) {
+        const ModelMaterialData* src = &materials[i];
+        Material* mat = &model->materials[i];
+
+        memcpy(mat->ambient, src->ambient, sizeof(float) * 3);
+        memcpy(mat->diffuse, src->diffuse, sizeof(float) * 3);
+        memcpy(mat->specular, src->specular, sizeof(float) * 3);
+        mat->shininess = src->shininess;
+        memcpy(mat->name, src->name, sizeof(mat->name) - 1);
+
+        mat->diffuse_map = model_load_texture(src->textures[MODEL_TEXTURE_DIFFUSE]);
+        mat->specular_map = model_load_texture(src->textures[MODEL_TEXTURE_SPECULAR]);
+        mat->normal_map = model_load_texture(src->textures[MODEL_TEXTURE_NORMAL]);
+        mat->alpha_map = model_load_texture(src->textures[MODEL_TEXTURE_ALPHA]);
     }
+}
 
-    // Create one mesh per material
-    model->mesh_count = obj->group_count > 0 ? obj->group_count : 1;
-    model->meshes = (Mesh*)malloc(sizeof(Mesh) * model->mesh_count);
-    memset(model->meshes, 0, sizeof(Mesh) * model->mesh_count);
+static Material* model_material(Model* model, int material) {
+    return (material >= 0 && (unsigned int)material < model->material_count) ? &model->materials[material] : NULL;
+}
 
-    // Initialize bounding box
-    model->min[0] = model->min[1] = model->min[2] = INFINITY;
-    model->max[0] = model->max[1] = model->max[2] = -INFINITY;
+// Upload a cooked model straight from the mapped file
+static Model* model_from_cooked(const char* obj_path, const ModelCookBlob* blob, unsigned int lod_count) {
+    Model* model = model_create(obj_path, blob->mesh_count, lod_count < blob->lod_count ? lod_count : blob->lod_count);
+    if (!model) return NULL;
+
+    memcpy(model->min, blob->min, sizeof(model->min));
+    memcpy(model->max, blob->max, sizeof(model->max));
+    model_load_materials(model, blob->materials, blob->material_count);
+
+    for (unsigned int i = 0; i < blob->mesh_count; i++) {
+        const ModelCookMesh* src = &blob->meshes[i];
+        VertexFormat format = (VertexFormat)src->vertex_format;
+        VertexDecode decode = vertex_format_decode_params(format, blob->min, blob->max);
+        Material* material = model_material(model, src->material);
+
+        // Full detail, then the coarser levels asked for
+        for (unsigned int l = 0; l <= model->lod_count; l++) {
+            const ModelCookLevel* level = &src->levels[l];
+            Mesh* mesh = l == 0 ? &model->meshes[i] : &model->lods[l - 1].meshes[i];
+            mesh->material = material;
+            mesh_upload_raw(mesh, format, &decode, model_cook_vertices(blob, i, l), level->vertex_count,
+                            model_cook_indices(blob, i, l),
+                            level->index_size == sizeof(uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                            level->index_count);
+        }
+    }
 
-    // Process each group (or create one default group)
-    unsigned int mesh_idx = 0;
-    for (unsigned int g = 0; g < (obj->group_count > 0 ? obj->group_count : 1); g++) {
-        fastObjGroup* group = obj->group_count > 0 ? &obj->groups[g] : NULL;
+    return model;
+}
 
-        unsigned int face_start = group ? group->face_offset : 0;
-        unsigned int face_count = group ? group->face_count : obj->face_count;
+// Upload a model parsed from its OBJ
+static Model* model_from_data(const char* obj_path, const ModelData* data, unsigned int lod_count) {
+    Model* model = model_create(obj_path, data->mesh_count, lod_count < data->lod_count ? lod_count : data->lod_count);
+    if (!model) return NULL;
 
-        if (face_count == 0) continue;
+    memcpy(model->min, data->min, sizeof(model->min));
+    memcpy(model->max, data->max, sizeof(model->max));
+    model_load_materials(model, data->materials, data->material_count);
 
-        // Count vertices for this mesh
-        unsigned int vertex_count = 0;
-        unsigned int index_count = 0;
-        for (unsigned int f = face_start; f < face_start + face_count; f++) {
-            unsigned int fv = obj->face_vertices[f];
-            vertex_count += fv;
-            index_count += (fv - 2) * 3; // Triangulate
+    for (unsigned int i = 0; i < data->mesh_count; i++) {
+        const ModelMeshData* src = &data->meshes[i];
+
+        Mesh* mesh = &model->meshes[i];
+        mesh->material = model_material(model, src->material);
+        mesh_upload_format(mesh, src->format, data->min, data->max,
+                           src->vertices, src->vertex_count, src->indices, src->index_count);
+
+        for (unsigned int l = 0; l < model->lod_count; l++) {
+            const ModelLODData* lod = &src->lods[l];
+            Mesh* lod_mesh = &model->lods[l].meshes[i];
+            lod_mesh->material = mesh->material;
+            mesh_upload_format(lod_mesh, src->format, data->min, data->max,
+                               lod->vertices, lod->vertex_count, lod->indices, lod->index_count);
         }
+    }
 
-        if (vertex_count == 0) continue;
+    return model;
+}
 
-        // Allocate vertex data (interleaved: pos + normal + uv)
-        float* vertex_data = (float*)malloc(sizeof(float) * vertex_count * 8);
-        unsigned int* index_data = (unsigned int*)malloc(sizeof(unsigned int) * index_count);
+Model* model_load(const char* obj_path) {
+    return model_load_with_lods(obj_path, 0);
+}
 
-        unsigned int v_offset = 0;
-        unsigned int i_offset = 0;
-        unsigned int base_vertex = 0;
+// Load stats: corners as they would be expanded, unique vertices as stored
+static void model_print_stats(const Model* model, unsigned int corner_count, double seconds, const char* source) {
+    unsigned int total_vertices = 0, total_indices = 0;
+    size_t indexed_bytes = 0, vertex_bytes = 0;
+    for (unsigned int m = 0; m < model->mesh_count; m++) {
+        const Mesh* mesh = &model->meshes[m];
+        total_vertices += mesh->vertex_count;
+        total_indices += mesh->index_count;
+        indexed_bytes += mesh_gpu_bytes(mesh);
+        vertex_bytes += (size_t)mesh->vertex_count * vertex_format_stride(mesh->format);
+    }
+    size_t expanded_bytes = (size_t)corner_count * 8 * sizeof(float) + (size_t)total_indices * sizeof(unsigned int);
+
+    printf("Model loaded: %s (%u meshes, %u materials) in %.1f ms%s\n",
+           model->name, model->mesh_count, model->material_count, seconds * 1000.0, source);
+    printf("  %u vertices from %u corners, %.1f KB on the GPU (%.1f KB unindexed)\n",
+           total_vertices, corner_count, indexed_bytes / 1024.0, expanded_bytes / 1024.0);
+    printf("  Vertex data %.1f KB (%.1f KB as floats)\n",
+           vertex_bytes / 1024.0, (double)total_vertices * VERTEX_FLOATS * sizeof(float) / 1024.0);
+
+    unsigned int full = model_triangle_count(model, 0);
+    for (unsigned int l = 0; l < model->lod_count; l++) {
+        unsigned int reduced = model_triangle_count(model, l + 1);
+        printf("  LOD %u: %u / %u triangles (%.0f%%)\n", l + 1, reduced, full, full ? 100.0 * reduced / full : 0.0);
+    }
+}
 
-        // Get material for this mesh
-        unsigned int mat_idx = 0;
-        if (obj->face_count > 0 && obj->face_materials) {
-            mat_idx = obj->face_materials[face_start];
-        }
+Model* model_load_with_lods(const char* obj_path, unsigned int lod_count) {
+    printf("Loading model: %s\n", obj_path);
+    double load_start = glfwGetTime();
+
+    // Cooked file first, the OBJ (cooked for next time) when it's missing or stale
+    Model* model = NULL;
+    unsigned int corner_count = 0;
+    bool cooked = false;
+    ModelCookBlob blob;
+    if (model_cook_open(obj_path, &blob)) {
+        model = model_from_cooked(obj_path, &blob, lod_count);
+        corner_count = blob.corner_count;
+        cooked = true;
+        model_cook_close(&blob);
+    } else {
+        ModelData data;
+        if (!model_data_load_obj(obj_path, &data)) return NULL;
 
-        // Extract vertex data
-        for (unsigned int f = face_start; f < face_start + face_count; f++) {
-            unsigned int fv = obj->face_vertices[f];
-
-            // Calculate correct index offset
-            unsigned int index_base = 0;
-            for (unsigned int ff = 0; ff < f; ff++) {
-                index_base += obj->face_vertices[ff];
-            }
-
-            for (unsigned int v = 0; v < fv; v++) {
-                fastObjIndex idx = obj->indices[index_base + v];
-
-                // Position
-                vertex_data[v_offset++] = obj->positions[idx.p * 3 + 0];
-                vertex_data[v_offset++] = obj->positions[idx.p * 3 + 1];
-                vertex_data[v_offset++] = obj->positions[idx.p * 3 + 2];
-
-                // Update bounding box
-                model->min[0] = fminf(model->min[0], obj->positions[idx.p * 3 + 0]);
-                model->min[1] = fminf(model->min[1], obj->positions[idx.p * 3 + 1]);
-                model->min[2] = fminf(model->min[2], obj->positions[idx.p * 3 + 2]);
-                model->max[0] = fmaxf(model->max[0], obj->positions[idx.p * 3 + 0]);
-                model->max[1] = fmaxf(model->max[1], obj->positions[idx.p * 3 + 1]);
-                model->max[2] = fmaxf(model->max[2], obj->positions[idx.p * 3 + 2]);
-
-                // Normal
-                if (idx.n > 0 && obj->normals) {
-                    vertex_data[v_offset++] = obj->normals[idx.n * 3 + 0];
-                    vertex_data[v_offset++] = obj->normals[idx.n * 3 + 1];
-                    vertex_data[v_offset++] = obj->normals[idx.n * 3 + 2];
-                } else {
-                    vertex_data[v_offset++] = 0.0f;
-                    vertex_data[v_offset++] = 1.0f;
-                    vertex_data[v_offset++] = 0.0f;
-                }
-
-                // Texcoord
-                if (idx.t > 0 && obj->texcoords) {
-                    vertex_data[v_offset++] = obj->texcoords[idx.t * 2 + 0];
-                    vertex_data[v_offset++] = obj->texcoords[idx.t * 2 + 1];
-                } else {
-                    vertex_data[v_offset++] = 0.0f;
-                    vertex_data[v_offset++] = 0.0f;
-                }
-            }
-
-            // Triangulate face (fan triangulation)
-            for (unsigned int t = 2; t < fv; t++) {
-                index_data[i_offset++] = base_vertex;
-                index_data[i_offset++] = base_vertex + t - 1;
-                index_data[i_offset++] = base_vertex + t;
-            }
-
-            base_vertex += fv;
-        }
+        model = model_from_data(obj_path, &data, lod_count);
+        corner_count = data.corner_count;
+        model_cook_write(obj_path, &data);
+        model_data_free(&data);
+    }
+    if (!model) return NULL;
 
-        // Create OpenGL buffers
-        Mesh* mesh = &model->meshes[mesh_idx];
-        mesh->vertex_count = vertex_count;
-        mesh->index_count = index_count;
-        mesh->material = (mat_idx < model->material_count) ? &model->materials[mat_idx] : NULL;
+    model_print_stats(model, corner_count, glfwGetTime() - load_start, cooked ? " (cooked)" : "");
+    return model;
+}
 
-        glGenVertexArrays(1, &mesh->vao);
-        glGenBuffers(1, &mesh->vbo);
-        glGenBuffers(1, &mesh->ibo);
+// CPU side of a model_load_async load, filled on a loader thread
+typedef struct ModelLoad {
+    char path[256];
+    unsigned int lod_count;
+    Model* model;               // Placeholder to fill, NULL once freed
+    ModelReadyFunc on_ready;
+    void* user;
+    AssetRequest* request;
+
+    bool decoded;
+    bool cooked;
+    ModelCookBlob blob;         // Mapped cooked file when cooked
+    ModelData data;             // Parsed OBJ otherwise
+    double decode_seconds;
+} ModelLoad;
+
+static bool model_decode(void* data) {
+    ModelLoad* load = (ModelLoad*)data;
+    double start = glfwGetTime();
+
+    if (model_cook_open(load->path, &load->blob)) {
+        load->cooked = true;
+    } else if (model_data_load_obj(load->path, &load->data)) {
+        model_cook_write(load->path, &load->data);
+    } else {
+        return false;
+    }
 
-        glBindVertexArray(mesh->vao);
+    load->decode_seconds = glfwGetTime() - start;
+    load->decoded = true;
+    return true;
+}
 
-        // Upload vertex data
-        glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
-        glBufferData(GL_ARRAY_BUFFER, vertex_count * 8 * sizeof(float), vertex_data, GL_STATIC_DRAW);
+static void model_upload(void* data, AssetStatus status) {
+    ModelLoad* load = (ModelLoad*)data;
+    Model* model = load->model;
+
+    if (status == ASSET_LOADED && model) {
+        double start = glfwGetTime();
+        Model* loaded = load->cooked ? model_from_cooked(load->path, &load->blob, load->lod_count)
+                                     : model_from_data(load->path, &load->data, load->lod_count);
+        model->loading = NULL;
+
+        if (loaded) {
+            // Move into the placeholder so handles given out stay valid
+            free(model->meshes);
+            *model = *loaded;
+            free(loaded);
+
+            unsigned int corner_count = load->cooked ? load->blob.corner_count : load->data.corner_count;
+            model_print_stats(model, corner_count, load->decode_seconds + (glfwGetTime() - start),
+                              load->cooked ? " (cooked, async)" : " (async)");
+            if (load->on_ready) load->on_ready(model, load->user);
+        }
+    } else if (model) {
+        fprintf(stderr, "Failed to load model: %s\n", load->path);
+        model->loading = NULL;
+    }
+
+    // Also set when cancelled after the decode finished
+    if (load->decoded) {
+        if (load->cooked) model_cook_close(&load->blob);
+        else model_data_free(&load->data);
+    }
+    free(load);
+}
+
+Model* model_load_async(const char* obj_path, unsigned int lod_count, ModelReadyFunc on_ready, void* user) {
+    printf("Loading model: %s (async)\n", obj_path);
 
-        // Set vertex attributes
-        // Position (location 0)
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    ModelLoad* load = (ModelLoad*)calloc(1, sizeof(ModelLoad));
+    Model* model = model_create(obj_path, 0, 0);
+    if (!load || !model) {
+        free(load);
+        free(model ? model->meshes : NULL);
+        free(model);
+        return NULL;
+    }
+
+    strncpy(load->path, obj_path, sizeof(load->path) - 1);
+    load->lod_count = lod_count;
+    load->model = model;
+    load->on_ready = on_ready;
+    load->user = user;
 
-        // Normal (location 1)
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    // Set before the request, which may run the upload right away
+    model->loading = load;
+    AssetRequest* request = asset_loader_request(model_decode, model_upload, load);
+    if (request) load->request = request;   // Else it already ran and load is gone
+    return model;
+}
 
-        // Texcoord (location 2)
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+void model_add_lod(Model* model, Model* lod_model) {
+    if (!lod_model) return;
 
-        // Upload index data
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ibo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_count * sizeof(unsigned int), index_data, GL_STATIC_DRAW);
+    if (model->lod_count >= MODEL_MAX_LODS) {
+        model_free(lod_model);
+        return;
+    }
 
-        glBindVertexArray(0);
+    ModelLOD* lod = &model->lods[model->lod_count];
+    lod->meshes = lod_model->meshes;
+    lod->mesh_count = lod_model->mesh_count;
+    lod->screen_size = MODEL_LOD_SCREEN_SIZES[model->lod_count];
+    model->lod_count++;
 
-        free(vertex_data);
-        free(index_data);
+    free(lod_model->materials);
+    free(lod_model);
+}
 
-        mesh_idx++;
+const Mesh* model_lod_meshes(const Model* model, unsigned int level, unsigned int* mesh_count) {
+    if (level == 0 || level > model->lod_count) {
+        *mesh_count = model->mesh_count;
+        return model->meshes;
     }
+    *mesh_count = model->lods[level - 1].mesh_count;
+    return model->lods[level - 1].meshes;
+}
 
-    // Adjust mesh count if some were skipped
-    model->mesh_count = mesh_idx;
+unsigned int model_triangle_count(const Model* model, unsigned int level) {
+    unsigned int mesh_count;
+    const Mesh* meshes = model_lod_meshes(model, level, &mesh_count);
 
-    fast_obj_destroy(obj);
+    unsigned int triangles = 0;
+    for (unsigned int m = 0; m < mesh_count; m++) {
+        triangles += meshes[m].index_count / 3;
+    }
+    return triangles;
+}
 
-    printf("Model loaded: %s (%u meshes, %u materials)\n",
-           model->name, model->mesh_count, model->material_count);
+float model_bounding_radius(const Model* model) {
+    float dx = model->max[0] - model->min[0];
+    float dy = model->max[1] - model->min[1];
+    float dz = model->max[2] - model->min[2];
+    return 0.5f * sqrtf(dx * dx + dy * dy + dz * dz);
+}
 
-    return model;
+unsigned int model_select_lod(const Model* model, float screen_size, unsigned int current_level) {
+    unsigned int level = 0;
+    for (unsigned int l = 1; l <= model->lod_count; l++) {
+        // Thresholds already crossed must be re-crossed by a margin to switch back
+        float bias = (l <= current_level) ? (1.0f + MODEL_LOD_HYSTERESIS) : (1.0f - MODEL_LOD_HYSTERESIS);
+        if (screen_size < model->lods[l - 1].screen_size * bias) {
+            level = l;
+        }
+    }
+    return level;
+}
+
+static void free_meshes(Mesh* meshes, unsigned int mesh_count) {
+    for (unsigned int i = 0; i < mesh_count; i++) {
+        Mesh* mesh = &meshes[i];
+        glDeleteVertexArrays(1, &mesh->vao);
+        glDeleteBuffers(1, &mesh->vbo);
+        glDeleteBuffers(1, &mesh->ibo);
+    }
+    free(meshes);
 }
 
 void model_free(Model* model) {
     if (!model) return;
 
+    // The upload still runs, it only has to free what was decoded
+    if (model->loading) {
+        model->loading->model = NULL;
+        asset_loader_cancel(model->loading->request);
+    }
+
     // Free meshes
-    for (unsigned int i = 0; i < model->mesh_count; i++) {
-        Mesh* mesh = &model->meshes[i];
-        glDeleteVertexArrays(1, &mesh->vao);
-        glDeleteBuffers(1, &mesh->vbo);
-        glDeleteBuffers(1, &mesh->ibo);
+    free_meshes(model->meshes, model->mesh_count);
+    for (unsigned int l = 0; l < model->lod_count; l++) {
+        free_meshes(model->lods[l].meshes, model->lods[l].mesh_count);
     }
-    free(model->meshes);
 
     // Free materials
     for (unsigned int i = 0; i < model->material_count; i++) {
@@ -2,20 +2,38 @@
 #define MODEL_H
 
 #include "material.h"
+#include "model_data.h"
 #include <GLFW/glfw3.h>
 
 typedef struct {
   GLuint vao;
-  GLuint vbo;           // Interleaved: position, normal, texcoord
+  GLuint vbo;           // Interleaved: position, normal, texcoord (laid out per format)
   GLuint ibo;
 
 
   unsigned int vertex_count;
   unsigned int index_count;
+  GLenum index_type;    // GL_UNSIGNED_SHORT when every index fits, else GL_UNSIGNED_INT
+
+  VertexFormat format;
+  VertexDecode decode;  // Shader uniforms that rebuild model space attributes
 
   Material* material;
 }Mesh;  
 
+// Fraction of a threshold that the projected size must cross before the
+// selected level changes, so instances don't flicker at the boundary
+#define MODEL_LOD_HYSTERESIS 0.15f
+
+// A coarser version of a model's meshes (same mesh order and materials)
+typedef struct {
+    Mesh* meshes;
+    unsigned int mesh_count;
+
+    // Used when the projected size (fraction of screen height) is below this
+    float screen_size;
+} ModelLOD;
+
 typedef struct {
     Mesh* meshes;
     unsigned int mesh_count;
@@ -29,12 +47,65 @@ typedef struct {
     // For bounding boxes
     float min[3];
     float max[3];
+
+    // Coarser detail levels, lods[0] is the first step down from meshes
+    ModelLOD lods[MODEL_MAX_LODS];
+    unsigned int lod_count;
+
+    struct ModelLoad* loading;  // Set while model_load_async is still in flight
 } Model;
 
-// Load model from OBJ file
+// Main thread callback once a model_load_async model has its meshes
+typedef void (*ModelReadyFunc)(Model* model, void* user);
+
+// Create VAO/VBO/IBO for interleaved vertex data (pos + normal + uv).
+// Indices are stored as 16 bits when vertex_count allows it.
+void mesh_upload(Mesh* mesh, const float* vertex_data, unsigned int vertex_count,
+                 const unsigned int* index_data, unsigned int index_count);
+
+// Same, with vertices already encoded in format (see vertex_format.h) and
+// indices in their final width (index_type is GL_UNSIGNED_SHORT or
+// GL_UNSIGNED_INT); data is handed to GL untouched
+void mesh_upload_raw(Mesh* mesh, VertexFormat format, const VertexDecode* decode,
+                     const void* vertex_data, unsigned int vertex_count,
+                     const void* index_data, GLenum index_type, unsigned int index_count);
+
+// Point attributes 0 (position), 1 (normal) and 2 (texcoord) of the bound
+// VAO at the mesh's vertex buffer, for renderers building their own VAOs
+void mesh_bind_vertex_attributes(const Mesh* mesh);
+
+// Load model from OBJ file. Uses the cooked copy under MODEL_COOK_DIR when
+// it is up to date, otherwise parses the OBJ and cooks it for next time.
 Model* model_load(const char* obj_path);
 
-// Free model and all its resources
+// Load model from OBJ file with up to lod_count levels of the LOD chain
+// built at import (see model_data.h); fewer if the chain ended early
+Model* model_load_with_lods(const char* obj_path, unsigned int lod_count);
+
+// Same, with the cooked file read (or the OBJ parsed and cooked) on a loader
+// thread (see asset_loader.h). Returns a placeholder with no meshes and an
+// empty bounding box that is filled in place once the upload has run, after
+// which on_ready (may be NULL) is called. A model that fails to load stays
+// empty. Textures load asynchronously with every load path.
+Model* model_load_async(const char* obj_path, unsigned int lod_count, ModelReadyFunc on_ready, void* user);
+
+// Append lod_model's meshes as the next coarser level of model.
+// lod_model is consumed (its struct is freed, its meshes now belong to model).
+void model_add_lod(Model* model, Model* lod_model);
+
+// Meshes for a detail level (0 = full detail)
+const Mesh* model_lod_meshes(const Model* model, unsigned int level, unsigned int* mesh_count);
+
+// Triangles drawn for a detail level (0 = full detail)
+unsigned int model_triangle_count(const Model* model, unsigned int level);
+
+// Radius of the sphere around the bounding box center enclosing the model
+float model_bounding_radius(const Model* model);
+
+// Pick the detail level for a projected size, biased towards current_level
+unsigned int model_select_lod(const Model* model, float screen_size, unsigned int current_level);
+
+// Free model and all its resources, cancelling a pending async load
 void model_free(Model* model);
 
 #endif // MODEL_H
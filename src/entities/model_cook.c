@@ -0,0 +1,333 @@
+#include "model_cook.h"
+#include "../file_ops.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MODEL_COOK_MAGIC 0x4c444d43u  // "CMDL"
+
+// Vertex and index ranges start on this boundary
+#define MODEL_COOK_ALIGN 16
+
+// A file the model was parsed from, as it was when cooked
+typedef struct {
+    char path[MODEL_PATH_MAX];
+    uint64_t size;
+    int64_t mtime;
+} ModelCookSource;
+
+// On-disk header, followed by the material table, the mesh table, then
+// each mesh's vertex and index data, level by level
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t source_hash;               // FNV-1a over the contents of every source
+    ModelCookSource sources[MODEL_MAX_SOURCES];
+    uint32_t source_count;
+    uint32_t mesh_count;
+    uint32_t material_count;
+    uint32_t corner_count;
+    uint32_t lod_count;
+    float min[3];
+    float max[3];
+    uint64_t file_size;
+} ModelCookHeader;
+
+// Hash the contents of every source; returns false if one can't be read
+static bool hash_sources(const char (*paths)[MODEL_PATH_MAX], unsigned int count, uint64_t* out) {
+    uint64_t h = FNV1A_BASIS;
+    for (unsigned int i = 0; i < count; i++) {
+        if (!hash_file(paths[i], &h)) return false;
+    }
+
+    *out = h;
+    return true;
+}
+
+static size_t align_up(size_t offset) {
+    return (offset + MODEL_COOK_ALIGN - 1) & ~(size_t)(MODEL_COOK_ALIGN - 1);
+}
+
+// Same rule as mesh_upload, so cooked indices upload as they are
+static uint32_t index_size_for(unsigned int vertex_count) {
+    return vertex_count <= 65536 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+void model_cook_path(const char* obj_path, char* out, size_t out_size) {
+    const char* name = strrchr(obj_path, '/');
+    name = name ? name + 1 : obj_path;
+    size_t length = strlen(name);
+    const char* ext = strrchr(name, '.');
+    if (ext) length = (size_t)(ext - name);
+
+    snprintf(out, out_size, "%s/%.*s.cmdl", MODEL_COOK_DIR, (int)length, name);
+}
+
+// Every index of a level names one of its vertices. The mapping goes
+// straight to glDrawElements, so a corrupt file must not get past here.
+static bool model_cook_indices_valid(const ModelCookHeader* header, const ModelCookLevel* level) {
+    const void* indices = (const char*)header + level->index_offset;
+    if (level->index_size == sizeof(uint16_t)) {
+        const uint16_t* short_indices = (const uint16_t*)indices;
+        for (unsigned int i = 0; i < level->index_count; i++) {
+            if (short_indices[i] >= level->vertex_count) return false;
+        }
+    } else {
+        const uint32_t* long_indices = (const uint32_t*)indices;
+        for (unsigned int i = 0; i < level->index_count; i++) {
+            if (long_indices[i] >= level->vertex_count) return false;
+        }
+    }
+    return true;
+}
+
+// Header and tables describe ranges that lie inside the file, and indices
+// stay inside their level
+static bool model_cook_valid(const ModelCookHeader* header, const char* obj_path, size_t file_size) {
+    if (header->magic != MODEL_COOK_MAGIC || header->version != MODEL_COOK_VERSION ||
+        header->file_size != file_size ||
+        header->source_count == 0 || header->source_count > MODEL_MAX_SOURCES ||
+        header->lod_count > MODEL_MAX_LODS ||
+        strncmp(header->sources[0].path, obj_path, MODEL_PATH_MAX) != 0) {
+        return false;
+    }
+
+    size_t tables = sizeof(ModelCookHeader) +
+                    (size_t)header->material_count * sizeof(ModelMaterialData) +
+                    (size_t)header->mesh_count * sizeof(ModelCookMesh);
+    if (tables > file_size) return false;
+
+    const ModelCookMesh* meshes = (const ModelCookMesh*)((const char*)(header + 1) +
+                                  (size_t)header->material_count * sizeof(ModelMaterialData));
+    for (unsigned int i = 0; i < header->mesh_count; i++) {
+        const ModelCookMesh* mesh = &meshes[i];
+        if (mesh->vertex_format >= VERTEX_FORMAT_COUNT || mesh->material >= (int32_t)header->material_count) {
+            return false;
+        }
+
+        for (unsigned int l = 0; l <= header->lod_count; l++) {
+            const ModelCookLevel* level = &mesh->levels[l];
+            uint64_t vertex_bytes = (uint64_t)level->vertex_count * vertex_format_stride((VertexFormat)mesh->vertex_format);
+            uint64_t index_bytes = (uint64_t)level->index_count * level->index_size;
+
+            if ((level->index_size != 2 && level->index_size != 4) ||
+                level->vertex_offset % MODEL_COOK_ALIGN != 0 || level->index_offset % MODEL_COOK_ALIGN != 0 ||
+                level->vertex_offset < tables || level->vertex_offset + vertex_bytes > file_size ||
+                level->index_offset < tables || level->index_offset + index_bytes > file_size ||
+                !model_cook_indices_valid(header, level)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Sources unchanged since cooking: same size and mtime, or failing that the same contents
+static bool model_cook_fresh(const ModelCookHeader* header) {
+    char paths[MODEL_MAX_SOURCES][MODEL_PATH_MAX];
+    bool touched = false;
+    for (unsigned int i = 0; i < header->source_count; i++) {
+        memcpy(paths[i], header->sources[i].path, MODEL_PATH_MAX);
+        paths[i][MODEL_PATH_MAX - 1] = '\0';
+
+        uint64_t size;
+        int64_t mtime;
+        if (!file_stamp(paths[i], &size, &mtime)) return false;
+        if (size != header->sources[i].size) return false;
+        if (mtime != header->sources[i].mtime) touched = true;
+    }
+    if (!touched) return true;
+
+    uint64_t hash;
+    return hash_sources((const char (*)[MODEL_PATH_MAX])paths, header->source_count, &hash) &&
+           hash == header->source_hash;
+}
+
+bool model_cook_open(const char* obj_path, ModelCookBlob* blob) {
+    char path[MODEL_PATH_MAX];
+    model_cook_path(obj_path, path, sizeof(path));
+
+    memset(blob, 0, sizeof(*blob));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ModelCookHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    const ModelCookHeader* header = (const ModelCookHeader*)mapping;
+    if (!model_cook_valid(header, obj_path, (size_t)st.st_size) || !model_cook_fresh(header)) {
+        printf("Stale cooked model: %s\n", path);
+        munmap(mapping, (size_t)st.st_size);
+        return false;
+    }
+
+    blob->mapping = mapping;
+    blob->mapping_size = (size_t)st.st_size;
+    blob->materials = (const ModelMaterialData*)(header + 1);
+    blob->material_count = header->material_count;
+    blob->meshes = (const ModelCookMesh*)(blob->materials + header->material_count);
+    blob->mesh_count = header->mesh_count;
+    blob->corner_count = header->corner_count;
+    blob->lod_count = header->lod_count;
+    memcpy(blob->min, header->min, sizeof(blob->min));
+    memcpy(blob->max, header->max, sizeof(blob->max));
+
+    return true;
+}
+
+void model_cook_close(ModelCookBlob* blob) {
+    if (blob->mapping) {
+        munmap(blob->mapping, blob->mapping_size);
+    }
+    memset(blob, 0, sizeof(*blob));
+}
+
+const void* model_cook_vertices(const ModelCookBlob* blob, unsigned int mesh, unsigned int level) {
+    return (const char*)blob->mapping + blob->meshes[mesh].levels[level].vertex_offset;
+}
+
+const void* model_cook_indices(const ModelCookBlob* blob, unsigned int mesh, unsigned int level) {
+    return (const char*)blob->mapping + blob->meshes[mesh].levels[level].index_offset;
+}
+
+// Pad the file out to offset with zeros
+static bool write_padding(FILE* file, size_t* written, size_t offset) {
+    static const char zeros[MODEL_COOK_ALIGN] = {0};
+    size_t pad = offset - *written;
+    *written = offset;
+    return pad == 0 || fwrite(zeros, 1, pad, file) == pad;
+}
+
+// Lay out one level's vertices then indices from offset; returns the end
+static size_t layout_level(ModelCookLevel* level, size_t offset, VertexFormat format,
+                           unsigned int vertex_count, unsigned int index_count) {
+    level->vertex_count = vertex_count;
+    level->index_count = index_count;
+    level->index_size = index_size_for(vertex_count);
+
+    offset = align_up(offset);
+    level->vertex_offset = offset;
+    offset += (size_t)vertex_count * vertex_format_stride(format);
+
+    offset = align_up(offset);
+    level->index_offset = offset;
+    return offset + (size_t)index_count * level->index_size;
+}
+
+// Encode and write one level's vertices and indices at their offsets
+static bool write_level(FILE* file, size_t* written, const ModelCookLevel* level, VertexFormat format,
+                        const float* vertices, const unsigned int* indices, const ModelData* data) {
+    size_t vertex_bytes = (size_t)level->vertex_count * vertex_format_stride(format);
+
+    void* encoded = malloc(vertex_bytes ? vertex_bytes : 1);
+    vertex_format_encode(encoded, format, vertices, level->vertex_count, data->min, data->max);
+    bool ok = write_padding(file, written, level->vertex_offset) &&
+              fwrite(encoded, 1, vertex_bytes, file) == vertex_bytes;
+    *written += vertex_bytes;
+    free(encoded);
+
+    ok = ok && write_padding(file, written, level->index_offset);
+    if (ok && level->index_size == sizeof(uint16_t)) {
+        uint16_t* short_indices = (uint16_t*)malloc(sizeof(uint16_t) * (level->index_count ? level->index_count : 1));
+        for (unsigned int j = 0; j < level->index_count; j++) {
+            short_indices[j] = (uint16_t)indices[j];
+        }
+        ok = fwrite(short_indices, sizeof(uint16_t), level->index_count, file) == level->index_count;
+        free(short_indices);
+    } else if (ok) {
+        ok = fwrite(indices, sizeof(uint32_t), level->index_count, file) == level->index_count;
+    }
+    *written += (size_t)level->index_count * level->index_size;
+    return ok;
+}
+
+bool model_cook_write(const char* obj_path, const ModelData* data) {
+    if (data->source_count == 0) return false;
+    if (!ensure_cache_dir(MODEL_COOK_DIR)) return false;
+
+    char path[MODEL_PATH_MAX];
+    model_cook_path(obj_path, path, sizeof(path));
+
+    ModelCookHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = MODEL_COOK_MAGIC;
+    header.version = MODEL_COOK_VERSION;
+    header.source_count = data->source_count;
+    header.mesh_count = data->mesh_count;
+    header.material_count = data->material_count;
+    header.corner_count = data->corner_count;
+    header.lod_count = data->lod_count;
+    memcpy(header.min, data->min, sizeof(header.min));
+    memcpy(header.max, data->max, sizeof(header.max));
+
+    for (unsigned int i = 0; i < data->source_count; i++) {
+        ModelCookSource* source = &header.sources[i];
+        memcpy(source->path, data->sources[i], MODEL_PATH_MAX);
+        if (!file_stamp(data->sources[i], &source->size, &source->mtime)) return false;
+    }
+    if (!hash_sources((const char (*)[MODEL_PATH_MAX])data->sources, data->source_count, &header.source_hash)) {
+        return false;
+    }
+
+    // Lay out each mesh's levels after the tables
+    ModelCookMesh* meshes = (ModelCookMesh*)calloc(data->mesh_count ? data->mesh_count : 1, sizeof(ModelCookMesh));
+    size_t offset = sizeof(ModelCookHeader) +
+                    (size_t)data->material_count * sizeof(ModelMaterialData) +
+                    (size_t)data->mesh_count * sizeof(ModelCookMesh);
+    for (unsigned int i = 0; i < data->mesh_count; i++) {
+        const ModelMeshData* mesh = &data->meshes[i];
+        meshes[i].material = mesh->material;
+        meshes[i].vertex_format = mesh->format;
+
+        offset = layout_level(&meshes[i].levels[0], offset, mesh->format, mesh->vertex_count, mesh->index_count);
+        for (unsigned int l = 0; l < data->lod_count; l++) {
+            offset = layout_level(&meshes[i].levels[l + 1], offset, mesh->format,
+                                  mesh->lods[l].vertex_count, mesh->lods[l].index_count);
+        }
+    }
+    header.file_size = offset;
+
+    FILE* file = cache_write_begin(path);
+    if (!file) {
+        fprintf(stderr, "Failed to write cooked model: %s\n", path);
+        free(meshes);
+        return false;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(data->materials, sizeof(ModelMaterialData), data->material_count, file) == data->material_count &&
+              fwrite(meshes, sizeof(ModelCookMesh), data->mesh_count, file) == data->mesh_count;
+    size_t written = sizeof(ModelCookHeader) +
+                     (size_t)data->material_count * sizeof(ModelMaterialData) +
+                     (size_t)data->mesh_count * sizeof(ModelCookMesh);
+
+    for (unsigned int i = 0; ok && i < data->mesh_count; i++) {
+        const ModelMeshData* mesh = &data->meshes[i];
+        ok = write_level(file, &written, &meshes[i].levels[0], mesh->format, mesh->vertices, mesh->indices, data);
+        for (unsigned int l = 0; ok && l < data->lod_count; l++) {
+            ok = write_level(file, &written, &meshes[i].levels[l + 1], mesh->format,
+                             mesh->lods[l].vertices, mesh->lods[l].indices, data);
+        }
+    }
+    free(meshes);
+
+    if (!cache_write_end(file, path, ok)) {
+        fprintf(stderr, "Failed to write cooked model: %s\n", path);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,70 @@
+#ifndef MODEL_COOK_H
+#define MODEL_COOK_H
+
+#include "model_data.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Cooked (binary) models
+// A .cmdl file holds a parsed OBJ exactly as the GPU wants it: interleaved
+// vertices in each mesh's chosen layout, indices (16-bit when every vertex
+// is reachable) for the full mesh and each level of its LOD chain, the
+// material table with resolved texture paths, and the bounds. model_load
+// mmaps it and hands the mapped ranges straight to glBufferData.
+//
+// The header records every source file (the OBJ and its MTL libraries) with
+// size, mtime and a content hash. Matching size and mtime is enough to trust
+// a file; otherwise the sources are re-hashed, and a mismatch means stale.
+//
+// Bump MODEL_COOK_VERSION whenever the layout or the OBJ import changes.
+#define MODEL_COOK_DIR "cache/models"
+#define MODEL_COOK_VERSION 4
+
+// One detail level of a mesh (offsets are from the start of the file)
+typedef struct {
+    uint32_t vertex_count;
+    uint32_t index_count;
+    uint32_t index_size;                // 2 or 4 bytes
+    uint32_t pad;
+    uint64_t vertex_offset;
+    uint64_t index_offset;
+} ModelCookLevel;
+
+// One mesh in a cooked file
+typedef struct {
+    int32_t material;                   // -1 for none
+    uint32_t vertex_format;             // VertexFormat, shared by every level
+    ModelCookLevel levels[1 + MODEL_MAX_LODS];  // Full detail, then the file's lod_count coarser levels
+} ModelCookMesh;
+
+// Read-only view of a cooked model (pointers into the mapped file)
+typedef struct {
+    void* mapping;
+    size_t mapping_size;
+
+    const ModelCookMesh* meshes;
+    unsigned int mesh_count;
+    const ModelMaterialData* materials;
+    unsigned int material_count;
+    unsigned int corner_count;
+    unsigned int lod_count;
+    float min[3];
+    float max[3];
+} ModelCookBlob;
+
+// Where obj_path's cooked file lives
+void model_cook_path(const char* obj_path, char* out, size_t out_size);
+
+// Map obj_path's cooked file; returns false on miss or stale/corrupt file
+bool model_cook_open(const char* obj_path, ModelCookBlob* blob);
+void model_cook_close(ModelCookBlob* blob);
+
+// Vertex and index ranges of a mapped mesh's detail level (0 = full detail)
+const void* model_cook_vertices(const ModelCookBlob* blob, unsigned int mesh, unsigned int level);
+const void* model_cook_indices(const ModelCookBlob* blob, unsigned int mesh, unsigned int level);
+
+// Cook parsed data for obj_path (overwrites stale files)
+bool model_cook_write(const char* obj_path, const ModelData* data);
+
+#endif // MODEL_COOK_H
@@ -0,0 +1,361 @@
+#include "model_data.h"
+#include "../graphics/mesh_optimize.h"
+#include "../graphics/mesh_simplify.h"
+#include <fast_obj.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Each level keeps this fraction of the previous level's triangles
+#define MODEL_LOD_REDUCTION 0.5f
+
+// Largest simplification error allowed, relative to the mesh extent
+#define MODEL_LOD_MAX_ERROR 0.05f
+
+// The chain ends at the first level keeping more than this fraction of the
+// previous level's triangles (seams and the error bound have stalled it)
+#define MODEL_LOD_MIN_REDUCTION 0.8f
+
+// (position, normal, texcoord) index triple -> mesh vertex, open addressing
+typedef struct {
+    unsigned int p, n, t;
+    unsigned int vertex;        // UINT32_MAX = empty slot
+} ModelVertexSlot;
+
+// fast_obj file callbacks that remember every file opened (the OBJ and its MTLs)
+static void* model_file_open(const char* path, void* user) {
+    ModelData* data = (ModelData*)user;
+    FILE* file = fopen(path, "rb");
+    if (file && data->source_count < MODEL_MAX_SOURCES) {
+        snprintf(data->sources[data->source_count++], MODEL_PATH_MAX, "%s", path);
+    }
+    return file;
+}
+
+static void model_file_close(void* file, void* user) {
+    (void)user;
+    fclose((FILE*)file);
+}
+
+static size_t model_file_read(void* file, void* dst, size_t bytes, void* user) {
+    (void)user;
+    return fread(dst, 1, bytes, (FILE*)file);
+}
+
+static unsigned long model_file_size(void* file, void* user) {
+    (void)user;
+    FILE* f = (FILE*)file;
+    long position = ftell(f);
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, position, SEEK_SET);
+    return size > 0 ? (unsigned long)size : 0;
+}
+
+// Resolve a texture path from an MTL file into base_dir (MTL paths are often absolute)
+static void resolve_texture_path(char* out, const char* texture_name, const char* base_dir) {
+    out[0] = '\0';
+    if (!texture_name || strlen(texture_name) == 0) {
+        return;
+    }
+
+    // Extract filename from path (handle absolute paths in MTL)
+    const char* filename = strrchr(texture_name, '/');
+    if (!filename) {
+        filename = strrchr(texture_name, '\\');
+    }
+    if (filename) {
+        filename++; // Skip the slash
+    } else {
+        filename = texture_name; // No path separator, use as-is
+    }
+
+    snprintf(out, MODEL_PATH_MAX, "%s%s", base_dir, filename);
+}
+
+// Resolved path of one of a material's maps ("" when unused)
+static void model_texture_path(char* out, const fastObjMesh* obj, unsigned int texture, const char* label) {
+    out[0] = '\0';
+
+    // fast_obj uses direct array indices (not 1-based OBJ indices)
+    // Index 0 is often NULL/reserved, actual textures start at higher indices
+    if (texture == 0 || texture >= obj->texture_count) return;
+
+    const fastObjTexture* tex = &obj->textures[texture];
+    printf("  %s texture: name='%s', path='%s'\n", label,
+           tex->name ? tex->name : "NULL",
+           tex->path ? tex->path : "NULL");
+    if (tex->path) {
+        resolve_texture_path(out, tex->path, "assets/textures/");
+        printf("  Resolved to: %s\n", out);
+    }
+}
+
+// Write the interleaved vertex for an OBJ corner
+static void model_write_vertex(float* out, const fastObjMesh* obj, fastObjIndex idx) {
+    out[0] = obj->positions[idx.p * 3 + 0];
+    out[1] = obj->positions[idx.p * 3 + 1];
+    out[2] = obj->positions[idx.p * 3 + 2];
+
+    if (idx.n > 0 && obj->normals) {
+        out[3] = obj->normals[idx.n * 3 + 0];
+        out[4] = obj->normals[idx.n * 3 + 1];
+        out[5] = obj->normals[idx.n * 3 + 2];
+    } else {
+        out[3] = 0.0f;
+        out[4] = 1.0f;
+        out[5] = 0.0f;
+    }
+
+    if (idx.t > 0 && obj->texcoords) {
+        out[6] = obj->texcoords[idx.t * 2 + 0];
+        out[7] = obj->texcoords[idx.t * 2 + 1];
+    } else {
+        out[6] = 0.0f;
+        out[7] = 0.0f;
+    }
+}
+
+// Build one indexed mesh from a run of faces; returns false if it has no corners
+static bool model_data_build_mesh(ModelData* data, ModelMeshData* mesh, const fastObjMesh* obj,
+                                  unsigned int face_start, unsigned int face_count, unsigned int index_base) {
+    // Count corners for this mesh
+    unsigned int corner_count = 0;
+    unsigned int index_count = 0;
+    for (unsigned int f = face_start; f < face_start + face_count; f++) {
+        unsigned int fv = obj->face_vertices[f];
+        corner_count += fv;
+        index_count += (fv - 2) * 3; // Triangulate
+    }
+
+    if (corner_count == 0) return false;
+
+    // Allocate for the worst case (no shared corners)
+    float* vertex_data = (float*)malloc(sizeof(float) * corner_count * MODEL_VERTEX_STRIDE);
+    unsigned int* index_data = (unsigned int*)malloc(sizeof(unsigned int) * index_count);
+    unsigned int* face_corners = (unsigned int*)malloc(sizeof(unsigned int) * corner_count);
+
+    unsigned int table_size = 1;
+    while (table_size < corner_count * 2) table_size <<= 1;
+    ModelVertexSlot* table = (ModelVertexSlot*)malloc(sizeof(ModelVertexSlot) * table_size);
+    for (unsigned int i = 0; i < table_size; i++) table[i].vertex = UINT32_MAX;
+
+    unsigned int vertex_count = 0;
+    unsigned int i_offset = 0;
+
+    // Faces are stored back to back, so a running offset walks their corners
+    for (unsigned int f = face_start; f < face_start + face_count; f++) {
+        unsigned int fv = obj->face_vertices[f];
+
+        // Share one vertex between corners with the same (p, n, t)
+        for (unsigned int v = 0; v < fv; v++) {
+            fastObjIndex idx = obj->indices[index_base + v];
+            unsigned int slot = (idx.p * 73856093u ^ idx.n * 19349663u ^ idx.t * 83492791u) & (table_size - 1);
+            while (table[slot].vertex != UINT32_MAX &&
+                   (table[slot].p != idx.p || table[slot].n != idx.n || table[slot].t != idx.t)) {
+                slot = (slot + 1) & (table_size - 1);
+            }
+
+            if (table[slot].vertex == UINT32_MAX) {
+                table[slot].p = idx.p;
+                table[slot].n = idx.n;
+                table[slot].t = idx.t;
+                table[slot].vertex = vertex_count;
+
+                float* out = &vertex_data[vertex_count * MODEL_VERTEX_STRIDE];
+                model_write_vertex(out, obj, idx);
+                for (int axis = 0; axis < 3; axis++) {
+                    data->min[axis] = fminf(data->min[axis], out[axis]);
+                    data->max[axis] = fmaxf(data->max[axis], out[axis]);
+                }
+                vertex_count++;
+            }
+            face_corners[v] = table[slot].vertex;
+        }
+
+        // Triangulate face (fan triangulation)
+        for (unsigned int t = 2; t < fv; t++) {
+            index_data[i_offset++] = face_corners[0];
+            index_data[i_offset++] = face_corners[t - 1];
+            index_data[i_offset++] = face_corners[t];
+        }
+
+        index_base += fv;
+    }
+    free(table);
+    free(face_corners);
+
+    // Reorder for the vertex cache, overdraw and vertex fetch
+    float acmr_before = mesh_acmr(index_data, index_count, vertex_count, MESH_CACHE_SIZE);
+    vertex_count = mesh_optimize(vertex_data, index_data, index_count, vertex_count, MODEL_VERTEX_STRIDE);
+    float acmr_after = mesh_acmr(index_data, index_count, vertex_count, MESH_CACHE_SIZE);
+    printf("  Mesh %u: ACMR %.2f -> %.2f\n", data->mesh_count, acmr_before, acmr_after);
+
+    // Get material for this mesh
+    unsigned int mat_idx = 0;
+    if (obj->face_count > 0 && obj->face_materials) {
+        mat_idx = obj->face_materials[face_start];
+    }
+
+    mesh->vertices = vertex_data;
+    mesh->indices = index_data;
+    mesh->vertex_count = vertex_count;
+    mesh->index_count = index_count;
+    mesh->material = mat_idx < data->material_count ? (int)mat_idx : -1;
+    data->corner_count += corner_count;
+    return true;
+}
+
+// Build the LOD chain of every mesh. Each level simplifies the previous one
+// (indices into the full vertex buffer) so the chain stays consistent.
+static void model_data_build_lods(ModelData* data) {
+    unsigned int** chain = (unsigned int**)calloc(data->mesh_count ? data->mesh_count : 1, sizeof(unsigned int*));
+    unsigned int* chain_counts = (unsigned int*)calloc(data->mesh_count ? data->mesh_count : 1, sizeof(unsigned int));
+    unsigned int max_index_count = 1;
+    unsigned int full = 0;
+
+    for (unsigned int i = 0; i < data->mesh_count; i++) {
+        const ModelMeshData* mesh = &data->meshes[i];
+        chain[i] = (unsigned int*)malloc(sizeof(unsigned int) * (mesh->index_count ? mesh->index_count : 1));
+        memcpy(chain[i], mesh->indices, sizeof(unsigned int) * mesh->index_count);
+        chain_counts[i] = mesh->index_count;
+        if (mesh->index_count > max_index_count) max_index_count = mesh->index_count;
+        full += mesh->index_count / 3;
+    }
+    unsigned int* scratch = (unsigned int*)malloc(sizeof(unsigned int) * max_index_count);
+
+    unsigned int previous = full;
+    for (unsigned int level = 0; level < MODEL_MAX_LODS && full > 0; level++) {
+        unsigned int triangles = 0;
+        for (unsigned int i = 0; i < data->mesh_count; i++) {
+            const ModelMeshData* mesh = &data->meshes[i];
+            unsigned int target = (unsigned int)(chain_counts[i] * MODEL_LOD_REDUCTION) / 3 * 3;
+            chain_counts[i] = mesh_simplify(scratch, chain[i], chain_counts[i], mesh->vertices, mesh->vertex_count,
+                                            MODEL_VERTEX_STRIDE, target, MODEL_LOD_MAX_ERROR);
+            memcpy(chain[i], scratch, sizeof(unsigned int) * chain_counts[i]);
+            triangles += chain_counts[i] / 3;
+        }
+        if (triangles > previous * MODEL_LOD_MIN_REDUCTION) break;
+
+        // Keep only the vertices this level still references, reordered like the full mesh
+        for (unsigned int i = 0; i < data->mesh_count; i++) {
+            const ModelMeshData* mesh = &data->meshes[i];
+            ModelLODData* lod = &data->meshes[i].lods[level];
+            unsigned int count = chain_counts[i];
+
+            lod->indices = (unsigned int*)malloc(sizeof(unsigned int) * (count ? count : 1));
+            memcpy(lod->indices, chain[i], sizeof(unsigned int) * count);
+            lod->vertices = (float*)malloc(sizeof(float) * MODEL_VERTEX_STRIDE * (mesh->vertex_count ? mesh->vertex_count : 1));
+            lod->vertex_count = mesh_compact_vertices(lod->vertices, lod->indices, count,
+                                                      mesh->vertices, mesh->vertex_count, MODEL_VERTEX_STRIDE);
+            lod->vertex_count = mesh_optimize(lod->vertices, lod->indices, count, lod->vertex_count,
+                                              MODEL_VERTEX_STRIDE);
+            lod->index_count = count;
+        }
+
+        printf("  LOD %u: %u triangles (%.0f%% of full detail)\n", level + 1, triangles, 100.0 * triangles / full);
+        data->lod_count++;
+        previous = triangles;
+    }
+
+    free(scratch);
+    for (unsigned int i = 0; i < data->mesh_count; i++) {
+        free(chain[i]);
+    }
+    free(chain_counts);
+    free(chain);
+}
+
+bool model_data_load_obj(const char* obj_path, ModelData* data) {
+    memset(data, 0, sizeof(ModelData));
+
+    // Load OBJ file with fast_obj
+    fastObjCallbacks callbacks = {model_file_open, model_file_close, model_file_read, model_file_size};
+    fastObjMesh* obj = fast_obj_read_with_callbacks(obj_path, &callbacks, data);
+    if (!obj) {
+        fprintf(stderr, "Failed to load OBJ file: %s\n", obj_path);
+        return false;
+    }
+
+    // Load materials
+    data->material_count = obj->material_count;
+    printf("Found %u materials, %u textures\n", obj->material_count, obj->texture_count);
+
+    if (data->material_count > 0) {
+        data->materials = (ModelMaterialData*)calloc(data->material_count, sizeof(ModelMaterialData));
+
+        for (unsigned int i = 0; i < data->material_count; i++) {
+            fastObjMaterial* mtl = &obj->materials[i];
+            ModelMaterialData* mat = &data->materials[i];
+
+            // Copy material properties
+            memcpy(mat->ambient, mtl->Ka, sizeof(float) * 3);
+            memcpy(mat->diffuse, mtl->Kd, sizeof(float) * 3);
+            memcpy(mat->specular, mtl->Ks, sizeof(float) * 3);
+            mat->shininess = mtl->Ns;
+
+            printf("Material %u: '%s'\n", i, mtl->name);
+            strncpy(mat->name, mtl->name, sizeof(mat->name) - 1);
+
+            // Texture paths (resolved to assets/textures/)
+            model_texture_path(mat->textures[MODEL_TEXTURE_DIFFUSE], obj, mtl->map_Kd, "Diffuse");
+            model_texture_path(mat->textures[MODEL_TEXTURE_SPECULAR], obj, mtl->map_Ks, "Ks");
+            model_texture_path(mat->textures[MODEL_TEXTURE_NORMAL], obj, mtl->map_bump, "BUMP");
+            model_texture_path(mat->textures[MODEL_TEXTURE_ALPHA], obj, mtl->map_d, "d");
+        }
+    }
+
+    // Initialize bounding box
+    data->min[0] = data->min[1] = data->min[2] = INFINITY;
+    data->max[0] = data->max[1] = data->max[2] = -INFINITY;
+
+    // One mesh per group (or one default group)
+    unsigned int group_count = obj->group_count > 0 ? obj->group_count : 1;
+    data->meshes = (ModelMeshData*)calloc(group_count, sizeof(ModelMeshData));
+
+    for (unsigned int g = 0; g < group_count; g++) {
+        fastObjGroup* group = obj->group_count > 0 ? &obj->groups[g] : NULL;
+
+        unsigned int face_start = group ? group->face_offset : 0;
+        unsigned int face_count = group ? group->face_count : obj->face_count;
+        unsigned int index_base = group ? group->index_offset : 0;
+
+        if (face_count == 0) continue;
+
+        // Skipped groups leave no gap
+        if (model_data_build_mesh(data, &data->meshes[data->mesh_count], obj, face_start, face_count, index_base)) {
+            data->mesh_count++;
+        }
+    }
+
+    fast_obj_destroy(obj);
+
+    // Layouts are chosen once the bounds cover every mesh
+    for (unsigned int i = 0; i < data->mesh_count; i++) {
+        ModelMeshData* mesh = &data->meshes[i];
+        mesh->format = VERTEX_FORMAT_FLOAT;
+#if MODEL_COMPACT_VERTICES
+        mesh->format = vertex_format_choose(mesh->vertices, mesh->vertex_count, data->min, data->max);
+#endif
+    }
+
+    // LOD vertices are a subset of their mesh's, so they share its layout
+    model_data_build_lods(data);
+
+    return true;
+}
+
+void model_data_free(ModelData* data) {
+    for (unsigned int i = 0; i < data->mesh_count; i++) {
+        free(data->meshes[i].vertices);
+        free(data->meshes[i].indices);
+        for (unsigned int l = 0; l < data->lod_count; l++) {
+            free(data->meshes[i].lods[l].vertices);
+            free(data->meshes[i].lods[l].indices);
+        }
+    }
+    free(data->meshes);
+    free(data->materials);
+    memset(data, 0, sizeof(ModelData));
+}
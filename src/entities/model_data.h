@@ -0,0 +1,85 @@
+#ifndef MODEL_DATA_H
+#define MODEL_DATA_H
+
+#include "../graphics/vertex_format.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// CPU side of a model, before anything touches GL: indexed meshes with
+// interleaved vertices (position, normal, texcoord) and materials whose
+// textures are still paths. model_load uploads it; the model cooker bakes it.
+//
+// Each mesh also records the vertex layout it is stored and uploaded in:
+// the most compact one within the vertex_format.h error bounds, positions
+// quantized against the model's bounds (floats when MODEL_COMPACT_VERTICES is 0).
+//
+// Import also builds a LOD chain: each level simplifies the previous one
+// (mesh_simplify.h, seams preserved) to about half its triangles, and the
+// chain ends early once a level stops paying for itself. Every mesh has
+// lod_count levels, each with its own compacted copy of the vertices it uses.
+
+#define MODEL_VERTEX_STRIDE 8       // Floats per interleaved vertex
+#define MODEL_PATH_MAX 256
+#define MODEL_MAX_SOURCES 4         // OBJ + MTL libraries remembered per model
+#define MODEL_COMPACT_VERTICES 1    // Pick compact vertex layouts at import
+#define MODEL_MAX_LODS 4            // Coarser detail levels kept next to the full mesh
+
+typedef enum {
+    MODEL_TEXTURE_DIFFUSE,          // map_Kd
+    MODEL_TEXTURE_SPECULAR,         // map_Ks
+    MODEL_TEXTURE_NORMAL,           // map_bump/bump
+    MODEL_TEXTURE_ALPHA,            // map_d
+    MODEL_TEXTURE_SLOTS
+} ModelTextureSlot;
+
+// Fixed-size and pointer free, so cooked files store it as-is
+typedef struct {
+    float ambient[3];               // Ka
+    float diffuse[3];               // Kd
+    float specular[3];              // Ks
+    float shininess;                // Ns
+    char name[64];
+    char textures[MODEL_TEXTURE_SLOTS][MODEL_PATH_MAX];   // Resolved paths, "" if unused
+} ModelMaterialData;
+
+// A coarser copy of a mesh (same material and layout)
+typedef struct {
+    float* vertices;                // vertex_count * MODEL_VERTEX_STRIDE floats
+    unsigned int* indices;
+    unsigned int vertex_count;
+    unsigned int index_count;
+} ModelLODData;
+
+typedef struct {
+    float* vertices;                // vertex_count * MODEL_VERTEX_STRIDE floats
+    unsigned int* indices;
+    unsigned int vertex_count;
+    unsigned int index_count;
+    int material;                   // Index into materials, -1 for none
+    VertexFormat format;            // Layout the mesh is stored and uploaded in
+    ModelLODData lods[MODEL_MAX_LODS];  // lods[0] is the first step down, ModelData.lod_count used
+} ModelMeshData;
+
+typedef struct {
+    ModelMeshData* meshes;
+    unsigned int mesh_count;
+    ModelMaterialData* materials;
+    unsigned int material_count;
+    float min[3];
+    float max[3];
+    unsigned int corner_count;      // Face corners before vertices were shared
+    unsigned int lod_count;         // Levels in every mesh's lods
+
+    // Files the parser read (the OBJ first), for cooked file staleness checks
+    char sources[MODEL_MAX_SOURCES][MODEL_PATH_MAX];
+    unsigned int source_count;
+} ModelData;
+
+// Parse an OBJ (and its MTL files): one mesh per group, faces fan
+// triangulated, corners with the same (position, normal, texcoord) sharing
+// a vertex. Returns false if the file can't be read.
+bool model_data_load_obj(const char* obj_path, ModelData* data);
+
+void model_data_free(ModelData* data);
+
+#endif // MODEL_DATA_H
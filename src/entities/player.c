@@ -4,8 +4,18 @@
 #include <stdio.h>
 
 
-void player_process_input(Entity* player, GLFWwindow* window, float dt) {
-    if (!player) return;
+void player_sample_input(GLFWwindow* window, PlayerInput* input) {
+    input->forward = glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS;
+    input->back = glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS;
+    input->left = glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS;
+    input->right = glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS;
+    input->fire = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+}
+
+void player_apply_input(EntityManager* manager, EntityHandle player, const PlayerInput* input, float dt) {
+    float position[3], rotation[3];
+    if (!entity_manager_get_position(manager, player, position) ||
+        !entity_manager_get_rotation(manager, player, rotation)) return;
 
     float speed = PLAYER_SPEED * dt;
 
@@ -23,30 +33,30 @@ void player_process_input(Entity* player, GLFWwindow* window, float dt) {
     // Always move to -Z direction
     // move_z -= right_z;
     
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
+    if (input->forward) {
         move_z -= right_z;
         target_rotation_x = 0.5f;
-        player->position[1] -= speed;
+        position[1] -= speed;
     }
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
+    if (input->back) {
         move_z += right_z;
         target_rotation_x = -0.5f;
-        player->position[1] += speed;
+        position[1] += speed;
     }
 
 
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
+    if (input->left) {
         move_x += forward_x;
         target_rotation = -1.0f;
     }
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
+    if (input->right) {
         move_x -= forward_x;
         target_rotation = 1.0f;
     }
 
     // Smoothly interpolate current rotation towards target rotation
-    player->rotation[2] = lerp(player->rotation[2], target_rotation, rotation_speed * dt);
-    player->rotation[0] = lerp(player->rotation[0], target_rotation_x,  dt);
+    rotation[2] = lerp(rotation[2], target_rotation, rotation_speed * dt);
+    rotation[0] = lerp(rotation[0], target_rotation_x,  dt);
 
     // Normalize movement vector if moving diagonally
     float move_length = sqrtf(move_x * move_x + move_z * move_z);
@@ -55,8 +65,37 @@ void player_process_input(Entity* player, GLFWwindow* window, float dt) {
         move_z /= move_length;
 
         // Update player position
-        player->position[0] += move_x * speed;
-        player->position[2] += move_z * speed;
+        position[0] += move_x * speed;
+        position[2] += move_z * speed;
     }
+
+    entity_manager_set_position(manager, player, position);
+    entity_manager_set_rotation(manager, player, rotation);
 }
 
+void player_fire(EntityManager* manager, EntityHandle player, ProjectileSystem* projectiles,
+                 const PlayerInput* input, float* cooldown, float dt) {
+    *cooldown = fmaxf(*cooldown - dt, 0.0f);
+    if (!input->fire || *cooldown > 0.0f) return;
+
+    unsigned int index;
+    if (!entity_manager_lookup(manager, player, &index)) return;
+
+    // Facing is the model's +Z axis in the cached world matrix
+    const float* m = manager->transforms[index];
+    float length = sqrtf(m[8] * m[8] + m[9] * m[9] + m[10] * m[10]);
+    if (length <= 0.0f) return;
+    float forward[3] = {m[8] / length, m[9] / length, m[10] / length};
+
+    const float* p = manager->positions[index];
+    float muzzle[3] = {p[0] + forward[0] * PLAYER_MUZZLE_OFFSET,
+                       p[1] + forward[1] * PLAYER_MUZZLE_OFFSET,
+                       p[2] + forward[2] * PLAYER_MUZZLE_OFFSET};
+    float velocity[3] = {forward[0] * PLAYER_BULLET_SPEED,
+                         forward[1] * PLAYER_BULLET_SPEED,
+                         forward[2] * PLAYER_BULLET_SPEED};
+
+    if (projectile_spawn(projectiles, muzzle, velocity, PLAYER_BULLET_LIFE, player.index)) {
+        *cooldown = PLAYER_FIRE_INTERVAL;
+    }
+}
@@ -1,7 +1,8 @@
 #ifndef PLAYER_H
 #define PLAYER_H
 
-#include "entity.h"
+#include "entity_manager.h"
+#include "projectile.h"
 #include <GLFW/glfw3.h>
 
 // Player movement configuration
@@ -9,8 +10,31 @@
 #define PLAYER_SPRINT_MULTIPLIER 2.5f
 #define PLAYER_TURN_SPEED 120.0f  // degrees per second
 
-// Process player input and update entity position/rotation
-void player_process_input(Entity* player, GLFWwindow* window, float dt);
+// Player gun
+#define PLAYER_FIRE_INTERVAL 0.06f      // Seconds between shots
+#define PLAYER_BULLET_SPEED 600.0f
+#define PLAYER_BULLET_LIFE 2.5f
+#define PLAYER_MUZZLE_OFFSET 4.0f       // Spawn distance ahead of the player's origin
+
+// Keys held when input was last sampled. Sampled on the main thread (GLFW
+// requirement) and consumed by simulation ticks, which may run elsewhere.
+typedef struct {
+    bool forward;
+    bool back;
+    bool left;
+    bool right;
+    bool fire;
+} PlayerInput;
+
+void player_sample_input(GLFWwindow* window, PlayerInput* input);
+
+// Update the player entity's position/rotation for one tick of dt seconds
+void player_apply_input(EntityManager* manager, EntityHandle player, const PlayerInput* input, float dt);
+
+// Fire along the player's facing while fire is held. cooldown carries the
+// time until the next shot across ticks.
+void player_fire(EntityManager* manager, EntityHandle player, ProjectileSystem* projectiles,
+                 const PlayerInput* input, float* cooldown, float dt);
 
 
 #endif // PLAYER_H
@@ -0,0 +1,371 @@
+#include "projectile.h"
+#include "../math/simd.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#define PROJECTILE_GRAVITY 9.81f
+#define TILE_STRIDE (PROJECTILE_HEIGHT_TILE + 1)
+
+// Owner filter wrapped around the caller's exact test
+typedef struct {
+    const ProjectileSystem* system;
+    uint32_t owner;
+} ProjectileRayFilter;
+
+static float* projectile_alloc_lane(unsigned int padded) {
+    return calloc(padded, sizeof(float));
+}
+
+ProjectileSystem* projectile_system_create(unsigned int capacity, ProjectileHeightFunc height_func,
+                                           void* height_user, float height_spacing) {
+    if (capacity == 0 || (height_func && height_spacing <= 0.0f)) {
+        fprintf(stderr, "Invalid projectile pool (capacity %u, height spacing %f)\n", capacity, height_spacing);
+        return NULL;
+    }
+
+    ProjectileSystem* system = malloc(sizeof(ProjectileSystem));
+    if (!system) return NULL;
+    memset(system, 0, sizeof(ProjectileSystem));
+
+    // SIMD passes run over whole groups of 4
+    unsigned int padded = (capacity + 3) & ~3u;
+    system->capacity = capacity;
+    system->pos_x = projectile_alloc_lane(padded);
+    system->pos_y = projectile_alloc_lane(padded);
+    system->pos_z = projectile_alloc_lane(padded);
+    system->prev_x = projectile_alloc_lane(padded);
+    system->prev_y = projectile_alloc_lane(padded);
+    system->prev_z = projectile_alloc_lane(padded);
+    system->vel_x = projectile_alloc_lane(padded);
+    system->vel_y = projectile_alloc_lane(padded);
+    system->vel_z = projectile_alloc_lane(padded);
+    system->life = projectile_alloc_lane(padded);
+    system->owners = calloc(padded, sizeof(uint32_t));
+
+    system->gravity = PROJECTILE_GRAVITY;
+
+    system->height_func = height_func;
+    system->height_user = height_user;
+    system->height_spacing = height_spacing;
+    system->inv_height_spacing = height_func ? 1.0f / height_spacing : 0.0f;
+    system->fills_left = PROJECTILE_TILE_FILLS;
+    if (height_func) {
+        system->tiles = calloc(PROJECTILE_HEIGHT_SLOTS * PROJECTILE_HEIGHT_SLOTS, sizeof(ProjectileHeightTile));
+    }
+
+    if (!system->pos_x || !system->pos_y || !system->pos_z || !system->prev_x || !system->prev_y ||
+        !system->prev_z || !system->vel_x || !system->vel_y || !system->vel_z || !system->life ||
+        !system->owners || (height_func && !system->tiles)) {
+        fprintf(stderr, "Failed to allocate projectile pool of %u\n", capacity);
+        projectile_system_free(system);
+        return NULL;
+    }
+
+    return system;
+}
+
+void projectile_system_free(ProjectileSystem* system) {
+    if (!system) return;
+
+    free(system->pos_x);
+    free(system->pos_y);
+    free(system->pos_z);
+    free(system->prev_x);
+    free(system->prev_y);
+    free(system->prev_z);
+    free(system->vel_x);
+    free(system->vel_y);
+    free(system->vel_z);
+    free(system->life);
+    free(system->owners);
+    free(system->tiles);
+    free(system);
+}
+
+bool projectile_spawn(ProjectileSystem* system, const float position[3], const float velocity[3],
+                      float life, uint32_t owner) {
+    if (!system || system->count >= system->capacity) return false;
+
+    unsigned int i = system->count++;
+    system->pos_x[i] = system->prev_x[i] = position[0];
+    system->pos_y[i] = system->prev_y[i] = position[1];
+    system->pos_z[i] = system->prev_z[i] = position[2];
+    system->vel_x[i] = velocity[0];
+    system->vel_y[i] = velocity[1];
+    system->vel_z[i] = velocity[2];
+    system->life[i] = life;
+    system->owners[i] = owner;
+    return true;
+}
+
+void projectile_system_clear(ProjectileSystem* system) {
+    if (!system) return;
+    system->count = 0;
+    system->hit_count = 0;
+}
+
+// Floor division for tile coordinates
+static int projectile_tile_coord(int sample) {
+    return sample >= 0 ? sample / PROJECTILE_HEIGHT_TILE
+                       : -((-sample + PROJECTILE_HEIGHT_TILE - 1) / PROJECTILE_HEIGHT_TILE);
+}
+
+static ProjectileHeightTile* projectile_tile_slot(ProjectileSystem* system, int tx, int tz) {
+    const int S = PROJECTILE_HEIGHT_SLOTS;
+    int sx = ((tx % S) + S) % S;
+    int sz = ((tz % S) + S) % S;
+    return &system->tiles[sz * S + sx];
+}
+
+static bool projectile_tile_cached(const ProjectileHeightTile* tile, int tx, int tz) {
+    return tile->valid && tile->tx == tx && tile->tz == tz;
+}
+
+static void projectile_fill_tile(ProjectileSystem* system, ProjectileHeightTile* tile, int tx, int tz) {
+    float max_height = -INFINITY;
+    for (int j = 0; j < TILE_STRIDE; j++) {
+        float z = (float)(tz * PROJECTILE_HEIGHT_TILE + j) * system->height_spacing;
+        for (int i = 0; i < TILE_STRIDE; i++) {
+            float x = (float)(tx * PROJECTILE_HEIGHT_TILE + i) * system->height_spacing;
+            float h = system->height_func(system->height_user, x, z);
+            tile->heights[j * TILE_STRIDE + i] = h;
+            max_height = fmaxf(max_height, h);
+        }
+    }
+    tile->tx = tx;
+    tile->tz = tz;
+    tile->max_height = max_height;
+    tile->valid = true;
+    system->tiles_filled++;
+}
+
+// Tile covering samples [tx * TILE, (tx + 1) * TILE] on each axis, filled on
+// first use; NULL when it isn't cached and this update's fills are spent
+static const ProjectileHeightTile* projectile_height_tile(ProjectileSystem* system, int tx, int tz) {
+    ProjectileHeightTile* tile = projectile_tile_slot(system, tx, tz);
+    if (projectile_tile_cached(tile, tx, tz)) return tile;
+    if (system->fills_left == 0) return NULL;
+
+    system->fills_left--;
+    projectile_fill_tile(system, tile, tx, tz);
+    return tile;
+}
+
+unsigned int projectile_prefill_heights(ProjectileSystem* system, float x, float z, float radius,
+                                        unsigned int max_fills) {
+    if (!system || !system->height_func) return 0;
+
+    float tile_size = system->height_spacing * PROJECTILE_HEIGHT_TILE;
+    int cx = projectile_tile_coord((int)floorf(x * system->inv_height_spacing));
+    int cz = projectile_tile_coord((int)floorf(z * system->inv_height_spacing));
+    int rings = (int)ceilf(radius / tile_size);
+    if (rings > PROJECTILE_HEIGHT_SLOTS / 2 - 1) rings = PROJECTILE_HEIGHT_SLOTS / 2 - 1;
+
+    // Square rings outwards, so the nearest tiles fill first
+    unsigned int filled = 0;
+    for (int r = 0; r <= rings && filled < max_fills; r++) {
+        for (int tz = cz - r; tz <= cz + r && filled < max_fills; tz++) {
+            int step = (tz == cz - r || tz == cz + r) ? 1 : 2 * r;
+            for (int tx = cx - r; tx <= cx + r && filled < max_fills; tx += step) {
+                ProjectileHeightTile* tile = projectile_tile_slot(system, tx, tz);
+                if (projectile_tile_cached(tile, tx, tz)) continue;
+                projectile_fill_tile(system, tile, tx, tz);
+                filled++;
+            }
+        }
+    }
+    return filled;
+}
+
+float projectile_terrain_height(ProjectileSystem* system, float x, float z) {
+    float gx = x * system->inv_height_spacing;
+    float gz = z * system->inv_height_spacing;
+    float fx = floorf(gx);
+    float fz = floorf(gz);
+    int ix = (int)fx;
+    int iz = (int)fz;
+
+    int tx = projectile_tile_coord(ix);
+    int tz = projectile_tile_coord(iz);
+    const ProjectileHeightTile* tile = projectile_height_tile(system, tx, tz);
+    if (!tile) {
+        system->direct_samples++;
+        return system->height_func(system->height_user, x, z);
+    }
+
+    const float* h = &tile->heights[(iz - tz * PROJECTILE_HEIGHT_TILE) * TILE_STRIDE +
+                                    (ix - tx * PROJECTILE_HEIGHT_TILE)];
+    float u = gx - fx;
+    float v = gz - fz;
+    float h0 = h[0] + (h[1] - h[0]) * u;
+    float h1 = h[TILE_STRIDE] + (h[TILE_STRIDE + 1] - h[TILE_STRIDE]) * u;
+    return h0 + (h1 - h0) * v;
+}
+
+// Highest cached sample over the tiles an XZ box touches
+static float projectile_terrain_max(ProjectileSystem* system, float min_x, float min_z, float max_x, float max_z) {
+    int tx0 = projectile_tile_coord((int)floorf(min_x * system->inv_height_spacing));
+    int tz0 = projectile_tile_coord((int)floorf(min_z * system->inv_height_spacing));
+    int tx1 = projectile_tile_coord((int)floorf(max_x * system->inv_height_spacing));
+    int tz1 = projectile_tile_coord((int)floorf(max_z * system->inv_height_spacing));
+
+    // Paths longer than a tile take the full walk
+    if (tx1 - tx0 > 1 || tz1 - tz0 > 1) return INFINITY;
+
+    float result = -INFINITY;
+    for (int tz = tz0; tz <= tz1; tz++) {
+        for (int tx = tx0; tx <= tx1; tx++) {
+            const ProjectileHeightTile* tile = projectile_height_tile(system, tx, tz);
+            if (!tile) return INFINITY;     // Not cached yet: full walk too
+            result = fmaxf(result, tile->max_height);
+        }
+    }
+    return result;
+}
+
+// Fraction of the path p0 -> p0 + d where it first drops below the terrain,
+// stepping at the sample spacing. False if it stays above.
+static bool projectile_sweep_terrain(ProjectileSystem* system, const float p0[3], const float d[3], float* t) {
+    float lowest = fminf(p0[1], p0[1] + d[1]);
+    float max_height = projectile_terrain_max(system, fminf(p0[0], p0[0] + d[0]), fminf(p0[2], p0[2] + d[2]),
+                                              fmaxf(p0[0], p0[0] + d[0]), fmaxf(p0[2], p0[2] + d[2]));
+    if (lowest > max_height) return false;
+
+    float length_xz = sqrtf(d[0] * d[0] + d[2] * d[2]);
+    unsigned int steps = (unsigned int)ceilf(length_xz * system->inv_height_spacing);
+    if (steps == 0) steps = 1;
+
+    float prev_f = 0.0f;
+    float prev_gap = p0[1] - projectile_terrain_height(system, p0[0], p0[2]);
+    if (prev_gap <= 0.0f) {
+        *t = 0.0f;
+        return true;
+    }
+
+    for (unsigned int s = 1; s <= steps; s++) {
+        float f = (float)s / (float)steps;
+        float gap = p0[1] + d[1] * f - projectile_terrain_height(system, p0[0] + d[0] * f, p0[2] + d[2] * f);
+        if (gap <= 0.0f) {
+            // Linear crossing between the last sample above and this one
+            *t = prev_f + (f - prev_f) * prev_gap / (prev_gap - gap);
+            return true;
+        }
+        prev_f = f;
+        prev_gap = gap;
+    }
+    return false;
+}
+
+static bool projectile_ray_test(void* user, uint32_t id, const float origin[3],
+                                const float direction[3], float* t) {
+    const ProjectileRayFilter* filter = user;
+    if (id == filter->owner) return false;
+    if (!filter->system->hit_test) return true;
+    return filter->system->hit_test(filter->system->hit_user, id, origin, direction, t);
+}
+
+// Move every projectile by one step: v += g dt, p += v dt, life -= dt
+static void projectile_integrate(ProjectileSystem* system, float dt) {
+    unsigned int count = system->count;
+    memcpy(system->prev_x, system->pos_x, sizeof(float) * count);
+    memcpy(system->prev_y, system->pos_y, sizeof(float) * count);
+    memcpy(system->prev_z, system->pos_z, sizeof(float) * count);
+
+    v4f vdt = v4_set1(dt);
+    v4f vdv = v4_set1(-system->gravity * dt);
+    unsigned int padded = (count + 3) & ~3u;
+
+    for (unsigned int i = 0; i < padded; i += 4) {
+        v4f vy = v4_add(v4_load(system->vel_y + i), vdv);
+        v4_store(system->vel_y + i, vy);
+
+        v4_store(system->pos_x + i, v4_add(v4_load(system->pos_x + i), v4_mul(v4_load(system->vel_x + i), vdt)));
+        v4_store(system->pos_y + i, v4_add(v4_load(system->pos_y + i), v4_mul(vy, vdt)));
+        v4_store(system->pos_z + i, v4_add(v4_load(system->pos_z + i), v4_mul(v4_load(system->vel_z + i), vdt)));
+        v4_store(system->life + i, v4_sub(v4_load(system->life + i), vdt));
+    }
+}
+
+// Sweep projectile i's last step; on a hit, record it and end its life
+static void projectile_collide(ProjectileSystem* system, unsigned int i) {
+    float p0[3] = {system->prev_x[i], system->prev_y[i], system->prev_z[i]};
+    float d[3] = {system->pos_x[i] - p0[0], system->pos_y[i] - p0[1], system->pos_z[i] - p0[2]};
+    float length = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    if (length <= 0.0f) return;
+
+    float t = 1.0f;
+    uint32_t target = SPATIAL_GRID_NONE;
+    bool hit = false;
+
+    if (system->height_func && projectile_sweep_terrain(system, p0, d, &t)) {
+        target = PROJECTILE_TERRAIN;
+        hit = true;
+    }
+
+    // Entities only count when they are reached before the ground
+    if (system->grid && t > 0.0f) {
+        float direction[3] = {d[0] / length, d[1] / length, d[2] / length};
+        ProjectileRayFilter filter = {system, system->owners[i]};
+        float distance;
+        uint32_t id = spatial_grid_raycast_filtered(system->grid, p0, direction, length * t,
+                                                    projectile_ray_test, &filter, &distance);
+        if (id != SPATIAL_GRID_NONE) {
+            t = distance / length;
+            target = id;
+            hit = true;
+        }
+    }
+
+    if (!hit) return;
+
+    if (system->hit_count < PROJECTILE_MAX_HITS) {
+        ProjectileHit* h = &system->hits[system->hit_count++];
+        h->position[0] = p0[0] + d[0] * t;
+        h->position[1] = p0[1] + d[1] * t;
+        h->position[2] = p0[2] + d[2] * t;
+        h->velocity[0] = system->vel_x[i];
+        h->velocity[1] = system->vel_y[i];
+        h->velocity[2] = system->vel_z[i];
+        h->target = target;
+        h->owner = system->owners[i];
+    }
+    system->life[i] = 0.0f;
+}
+
+// Move the last projectile into slot i
+static void projectile_remove(ProjectileSystem* system, unsigned int i) {
+    unsigned int last = --system->count;
+    if (i == last) return;
+
+    system->pos_x[i] = system->pos_x[last];
+    system->pos_y[i] = system->pos_y[last];
+    system->pos_z[i] = system->pos_z[last];
+    system->prev_x[i] = system->prev_x[last];
+    system->prev_y[i] = system->prev_y[last];
+    system->prev_z[i] = system->prev_z[last];
+    system->vel_x[i] = system->vel_x[last];
+    system->vel_y[i] = system->vel_y[last];
+    system->vel_z[i] = system->vel_z[last];
+    system->life[i] = system->life[last];
+    system->owners[i] = system->owners[last];
+}
+
+void projectile_system_update(ProjectileSystem* system, float dt) {
+    if (!system) return;
+    system->hit_count = 0;
+    system->fills_left = PROJECTILE_TILE_FILLS;
+    if (system->count == 0) return;
+
+    projectile_integrate(system, dt);
+
+    for (unsigned int i = 0; i < system->count; i++) {
+        if (system->life[i] > 0.0f) projectile_collide(system, i);
+    }
+
+    // Walk backwards so every projectile moved into a slot was already visited
+    for (unsigned int i = system->count; i-- > 0;) {
+        if (system->life[i] <= 0.0f) projectile_remove(system, i);
+    }
+}
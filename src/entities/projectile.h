@@ -0,0 +1,115 @@
+#ifndef PROJECTILE_H
+#define PROJECTILE_H
+
+#include "spatial_grid.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Pooled projectiles.
+//
+// Live projectiles are stored densely as structure-of-arrays in a pool of
+// fixed capacity; a projectile that dies is replaced by the last one. Each
+// tick integrates the whole pool four at a time, then sweeps every
+// projectile's path for that tick (previous to current position) against
+// terrain heights and against the spatial grid, so fast projectiles can't
+// tunnel through thin ground or entities.
+//
+// Terrain heights come from a caller-supplied sampler, cached in square
+// tiles of samples. Tiles are direct mapped by tile coordinate and filled the
+// first time a projectile needs them, so only the ground projectiles actually
+// fly over is sampled. An update fills at most PROJECTILE_TILE_FILLS tiles;
+// past that, sweeps over uncached ground sample the height function directly
+// at their steps, so a burst of projectiles into unexplored terrain costs a
+// few samples each instead of whole tiles in one tick. The caller streams
+// tiles in around the player with projectile_prefill_heights, so its shots
+// rarely reach uncached ground.
+
+#define PROJECTILE_TERRAIN SPATIAL_GRID_NONE   // Hit target id for the ground
+
+#define PROJECTILE_HEIGHT_TILE 16       // Sample intervals per tile side
+#define PROJECTILE_HEIGHT_SLOTS 64      // Tile slots per side of the cache
+#define PROJECTILE_TILE_FILLS 8         // Tile fills per update
+#define PROJECTILE_PREFILL_RADIUS 1200.0f   // Prefilled around the focus (within the cache's reach)
+#define PROJECTILE_PREFILL_FILLS 4      // Tile fills per prefill call
+#define PROJECTILE_MAX_HITS 1024        // Hits kept per update
+
+// Terrain height at a world position (must be safe to call from the thread running updates)
+typedef float (*ProjectileHeightFunc)(void* user, float x, float z);
+
+typedef struct {
+    float position[3];
+    float velocity[3];              // At impact
+    uint32_t target;                // Grid id of the item hit, or PROJECTILE_TERRAIN
+    uint32_t owner;
+} ProjectileHit;
+
+typedef struct {
+    int tx, tz;                     // Tile coordinates
+    bool valid;
+    float max_height;
+    float heights[(PROJECTILE_HEIGHT_TILE + 1) * (PROJECTILE_HEIGHT_TILE + 1)];
+} ProjectileHeightTile;
+
+typedef struct {
+    // Dense pool, arrays padded to a multiple of 4 entries
+    float* pos_x;
+    float* pos_y;
+    float* pos_z;
+    float* prev_x;                  // Position at the start of the last tick
+    float* prev_y;
+    float* prev_z;
+    float* vel_x;
+    float* vel_y;
+    float* vel_z;
+    float* life;                    // Seconds left
+    uint32_t* owners;               // Grid id the projectile ignores (its shooter)
+    unsigned int count;
+    unsigned int capacity;
+
+    float gravity;
+
+    // Collision
+    SpatialGrid* grid;              // May be NULL (terrain only)
+    SpatialRayTest hit_test;        // Exact test for grid items, may be NULL
+    void* hit_user;
+
+    // Terrain height cache
+    ProjectileHeightFunc height_func;   // May be NULL (no terrain)
+    void* height_user;
+    float height_spacing;           // World units between samples
+    float inv_height_spacing;
+    ProjectileHeightTile* tiles;    // PROJECTILE_HEIGHT_SLOTS^2
+    unsigned int fills_left;        // Tile fills left in this update
+    unsigned int tiles_filled;      // Tile fills since creation (stats)
+    unsigned int direct_samples;    // Heights sampled past the fill budget since creation (stats)
+
+    // Hits from the last update
+    ProjectileHit hits[PROJECTILE_MAX_HITS];
+    unsigned int hit_count;
+} ProjectileSystem;
+
+// height_spacing should match the terrain mesh vertex spacing so the cached
+// heights interpolate the same samples the ground is drawn from
+ProjectileSystem* projectile_system_create(unsigned int capacity, ProjectileHeightFunc height_func,
+                                           void* height_user, float height_spacing);
+void projectile_system_free(ProjectileSystem* system);
+
+// Launch a projectile. Returns false if the pool is full.
+bool projectile_spawn(ProjectileSystem* system, const float position[3], const float velocity[3],
+                      float life, uint32_t owner);
+
+// Advance every projectile by dt, collide, and remove the dead. Fills hits.
+void projectile_system_update(ProjectileSystem* system, float dt);
+
+// Fill up to max_fills uncached tiles in the square of half size radius
+// around (x, z), nearest first; returns how many were filled
+unsigned int projectile_prefill_heights(ProjectileSystem* system, float x, float z, float radius,
+                                        unsigned int max_fills);
+
+// Cached terrain height (bilinear between samples), sampled directly when
+// the tile isn't cached and the update's fills are spent
+float projectile_terrain_height(ProjectileSystem* system, float x, float z);
+
+void projectile_system_clear(ProjectileSystem* system);
+
+#endif // PROJECTILE_H
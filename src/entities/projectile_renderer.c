@@ -0,0 +1,138 @@
+#include "projectile_renderer.h"
+#include "../file_ops.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+ProjectileRenderer* projectile_renderer_create(const char* model_path, unsigned int capacity, float scale) {
+    Model* model = model_load(model_path);
+    if (!model) {
+        fprintf(stderr, "Failed to load projectile model: %s\n", model_path);
+        return NULL;
+    }
+
+    ProjectileRenderer* renderer = malloc(sizeof(ProjectileRenderer));
+    memset(renderer, 0, sizeof(ProjectileRenderer));
+
+    renderer->model = model;
+    renderer->capacity = capacity;
+    renderer->scale = scale;
+    renderer->instances = malloc(sizeof(ProjectileInstance) * capacity);
+    renderer->vaos = calloc(model->mesh_count, sizeof(GLuint));
+
+    glGenBuffers(1, &renderer->instance_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->instance_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(ProjectileInstance) * capacity, NULL, GL_STREAM_DRAW);
+
+    // Mesh attributes as mesh_upload binds them, plus two per-instance attributes
+    for (unsigned int i = 0; i < model->mesh_count; i++) {
+        const Mesh* mesh = &model->meshes[i];
+
+        glGenVertexArrays(1, &renderer->vaos[i]);
+        glBindVertexArray(renderer->vaos[i]);
+
+        // Position (location 0), normal (location 1), texcoord (location 2)
+        mesh_bind_vertex_attributes(mesh);
+
+        // Instance position + scale (location 3), direction (location 4)
+        glBindBuffer(GL_ARRAY_BUFFER, renderer->instance_vbo);
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(ProjectileInstance), (void*)0);
+        glEnableVertexAttribArray(3);
+        glVertexAttribDivisor(3, 1);
+        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(ProjectileInstance), (void*)(4 * sizeof(float)));
+        glEnableVertexAttribArray(4);
+        glVertexAttribDivisor(4, 1);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ibo);
+    }
+    glBindVertexArray(0);
+
+    const char* vert_src = load_shader_source("assets/shaders/projectilevert.glsl");
+    const char* frag_src = load_shader_source("assets/shaders/modelfrag.glsl");
+    renderer->shader = shader_create(vert_src, frag_src, "projectile");
+    free((void*)vert_src);
+    free((void*)frag_src);
+
+    ProjectileUniforms* u = &renderer->uniforms;
+    u->ambient = shader_uniform(&renderer->shader, "material_ambient");
+    u->diffuse = shader_uniform(&renderer->shader, "material_diffuse");
+    u->specular = shader_uniform(&renderer->shader, "material_specular");
+    u->shininess = shader_uniform(&renderer->shader, "material_shininess");
+    u->has_diffuse_map = shader_uniform(&renderer->shader, "has_diffuse_map");
+    u->has_specular_map = shader_uniform(&renderer->shader, "has_specular_map");
+    u->position_offset = shader_uniform(&renderer->shader, "position_offset");
+    u->position_scale = shader_uniform(&renderer->shader, "position_scale");
+    u->normal_scale = shader_uniform(&renderer->shader, "normal_scale");
+
+    printf("Projectile renderer initialized (%u instances, %u meshes)\n", capacity, model->mesh_count);
+
+    return renderer;
+}
+
+void projectile_renderer_prepare(ProjectileRenderer* renderer, const ProjectileSystem* system, float alpha) {
+    unsigned int count = system->count < renderer->capacity ? system->count : renderer->capacity;
+
+    for (unsigned int i = 0; i < count; i++) {
+        ProjectileInstance* inst = &renderer->instances[i];
+        inst->position[0] = system->prev_x[i] + (system->pos_x[i] - system->prev_x[i]) * alpha;
+        inst->position[1] = system->prev_y[i] + (system->pos_y[i] - system->prev_y[i]) * alpha;
+        inst->position[2] = system->prev_z[i] + (system->pos_z[i] - system->prev_z[i]) * alpha;
+        inst->scale = renderer->scale;
+
+        float vx = system->vel_x[i], vy = system->vel_y[i], vz = system->vel_z[i];
+        float length = sqrtf(vx * vx + vy * vy + vz * vz);
+        float inv = length > 0.0f ? 1.0f / length : 0.0f;
+        inst->direction[0] = vx * inv;
+        inst->direction[1] = vy * inv;
+        inst->direction[2] = length > 0.0f ? vz * inv : 1.0f;
+        inst->pad = 0.0f;
+    }
+    renderer->instance_count = count;
+}
+
+void projectile_renderer_render(ProjectileRenderer* renderer) {
+    if (renderer->instance_count == 0) return;
+
+    // Orphan last frame's storage instead of waiting for the GPU to release it
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->instance_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(ProjectileInstance) * renderer->capacity, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(ProjectileInstance) * renderer->instance_count,
+                    renderer->instances);
+
+    Shader* shader = &renderer->shader;
+    const ProjectileUniforms* u = &renderer->uniforms;
+    shader_use(shader);
+    shader_uniform_int(shader, u->has_diffuse_map, 0);
+    shader_uniform_int(shader, u->has_specular_map, 0);
+
+    for (unsigned int i = 0; i < renderer->model->mesh_count; i++) {
+        const Mesh* mesh = &renderer->model->meshes[i];
+        const Material* material = mesh->material;
+        if (material) {
+            shader_uniform_vec3v(shader, u->ambient, material->ambient);
+            shader_uniform_vec3v(shader, u->diffuse, material->diffuse);
+            shader_uniform_vec3v(shader, u->specular, material->specular);
+            shader_uniform_float(shader, u->shininess, material->shininess);
+        }
+
+        shader_uniform_vec3v(shader, u->position_offset, mesh->decode.offset);
+        shader_uniform_vec3v(shader, u->position_scale, mesh->decode.scale);
+        shader_uniform_float(shader, u->normal_scale, mesh->decode.normal_scale);
+        glBindVertexArray(renderer->vaos[i]);
+        glDrawElementsInstanced(GL_TRIANGLES, mesh->index_count, mesh->index_type, 0, renderer->instance_count);
+    }
+    glBindVertexArray(0);
+}
+
+void projectile_renderer_cleanup(ProjectileRenderer* renderer) {
+    if (!renderer) return;
+
+    glDeleteVertexArrays(renderer->model->mesh_count, renderer->vaos);
+    glDeleteBuffers(1, &renderer->instance_vbo);
+    free(renderer->vaos);
+    free(renderer->instances);
+    model_free(renderer->model);
+    shader_destroy(&renderer->shader);
+    free(renderer);
+}
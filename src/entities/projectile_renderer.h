@@ -0,0 +1,51 @@
+#ifndef PROJECTILE_RENDERER_H
+#define PROJECTILE_RENDERER_H
+
+#include "projectile.h"
+#include "model.h"
+#include "../graphics/shader.h"
+
+// Draws every live projectile with one instanced call per mesh of the
+// projectile model. prepare snapshots interpolated positions on the CPU (no
+// GL, so it can run before the next simulation tick starts); render uploads
+// the snapshot and draws it.
+
+// Per-instance data, uploaded as-is to the instance buffer
+typedef struct {
+    float position[3];
+    float scale;
+    float direction[3];     // Unit flight direction (model +Z is aligned to it)
+    float pad;
+} ProjectileInstance;
+
+typedef struct {
+    ShaderUniform ambient, diffuse, specular, shininess;
+    ShaderUniform has_diffuse_map, has_specular_map;
+    ShaderUniform position_offset, position_scale, normal_scale;
+} ProjectileUniforms;
+
+typedef struct {
+    Model* model;
+    GLuint* vaos;                   // One per mesh: mesh buffers + instance buffer
+    GLuint instance_vbo;
+    unsigned int capacity;          // Instances the buffer holds
+
+    ProjectileInstance* instances;  // Snapshot from the last prepare
+    unsigned int instance_count;
+    float scale;
+
+    Shader shader;
+    ProjectileUniforms uniforms;
+} ProjectileRenderer;
+
+ProjectileRenderer* projectile_renderer_create(const char* model_path, unsigned int capacity, float scale);
+
+// Snapshot the pool, alpha of the way from the previous tick to the current one
+void projectile_renderer_prepare(ProjectileRenderer* renderer, const ProjectileSystem* system, float alpha);
+
+// Upload the snapshot and draw it
+void projectile_renderer_render(ProjectileRenderer* renderer);
+
+void projectile_renderer_cleanup(ProjectileRenderer* renderer);
+
+#endif // PROJECTILE_RENDERER_H
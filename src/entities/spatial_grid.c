@@ -0,0 +1,549 @@
+#include "spatial_grid.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#define INITIAL_TABLE_SIZE 256
+#define INITIAL_CELL_ITEMS 8
+#define INITIAL_ITEM_CAPACITY 64
+
+static uint32_t spatial_grid_hash(int cx, int cz) {
+    uint32_t h = (uint32_t)cx * 0x9E3779B1u ^ (uint32_t)cz * 0x85EBCA77u;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 13;
+    return h;
+}
+
+static int spatial_grid_coord(const SpatialGrid* grid, float v) {
+    return (int)floorf(v * grid->inv_cell_size);
+}
+
+SpatialGrid* spatial_grid_create(float cell_size) {
+    if (cell_size <= 0.0f) {
+        fprintf(stderr, "Spatial grid cell size must be positive (%f)\n", cell_size);
+        return NULL;
+    }
+
+    SpatialGrid* grid = malloc(sizeof(SpatialGrid));
+    if (!grid) return NULL;
+    memset(grid, 0, sizeof(SpatialGrid));
+
+    grid->cell_size = cell_size;
+    grid->inv_cell_size = 1.0f / cell_size;
+
+    grid->table_size = INITIAL_TABLE_SIZE;
+    grid->table = malloc(sizeof(uint32_t) * grid->table_size);
+    memset(grid->table, 0xFF, sizeof(uint32_t) * grid->table_size);
+
+    return grid;
+}
+
+void spatial_grid_free(SpatialGrid* grid) {
+    if (!grid) return;
+
+    for (unsigned int i = 0; i < grid->cell_count; i++) {
+        free(grid->cells[i].items);
+    }
+    free(grid->cells);
+    free(grid->free_cells);
+    free(grid->table);
+    free(grid->spheres);
+    free(grid->item_cell);
+    free(grid->item_slot);
+    free(grid->item_stamp);
+    free(grid->large_items);
+    free(grid->knn_dists);
+    free(grid);
+}
+
+// Hash table
+
+static uint32_t spatial_grid_find_cell(const SpatialGrid* grid, int cx, int cz) {
+    unsigned int mask = grid->table_size - 1;
+    for (unsigned int slot = spatial_grid_hash(cx, cz) & mask; grid->table[slot] != SPATIAL_GRID_NONE;
+         slot = (slot + 1) & mask) {
+        const SpatialCell* cell = &grid->cells[grid->table[slot]];
+        if (cell->cx == cx && cell->cz == cz) return grid->table[slot];
+    }
+    return SPATIAL_GRID_NONE;
+}
+
+static void spatial_grid_table_insert(SpatialGrid* grid, uint32_t cell_index) {
+    const SpatialCell* cell = &grid->cells[cell_index];
+    unsigned int mask = grid->table_size - 1;
+    unsigned int slot = spatial_grid_hash(cell->cx, cell->cz) & mask;
+    while (grid->table[slot] != SPATIAL_GRID_NONE) slot = (slot + 1) & mask;
+    grid->table[slot] = cell_index;
+    grid->table_used++;
+}
+
+static void spatial_grid_grow_table(SpatialGrid* grid) {
+    uint32_t* old = grid->table;
+    unsigned int old_size = grid->table_size;
+
+    grid->table_size *= 2;
+    grid->table = malloc(sizeof(uint32_t) * grid->table_size);
+    memset(grid->table, 0xFF, sizeof(uint32_t) * grid->table_size);
+    grid->table_used = 0;
+
+    for (unsigned int i = 0; i < old_size; i++) {
+        if (old[i] != SPATIAL_GRID_NONE) spatial_grid_table_insert(grid, old[i]);
+    }
+    free(old);
+}
+
+// Linear probing delete: shift later entries of the cluster back into the hole
+static void spatial_grid_table_remove(SpatialGrid* grid, uint32_t cell_index) {
+    const SpatialCell* cell = &grid->cells[cell_index];
+    unsigned int mask = grid->table_size - 1;
+    unsigned int hole = spatial_grid_hash(cell->cx, cell->cz) & mask;
+    while (grid->table[hole] != cell_index) hole = (hole + 1) & mask;
+
+    unsigned int slot = hole;
+    for (;;) {
+        slot = (slot + 1) & mask;
+        uint32_t entry = grid->table[slot];
+        if (entry == SPATIAL_GRID_NONE) break;
+
+        const SpatialCell* other = &grid->cells[entry];
+        unsigned int home = spatial_grid_hash(other->cx, other->cz) & mask;
+        // Move the entry if its home is not cyclically within (hole, slot]
+        bool stays = (hole <= slot) ? (hole < home && home <= slot) : (hole < home || home <= slot);
+        if (!stays) {
+            grid->table[hole] = entry;
+            hole = slot;
+        }
+    }
+    grid->table[hole] = SPATIAL_GRID_NONE;
+    grid->table_used--;
+}
+
+static uint32_t spatial_grid_acquire_cell(SpatialGrid* grid, int cx, int cz) {
+    uint32_t index = spatial_grid_find_cell(grid, cx, cz);
+    if (index != SPATIAL_GRID_NONE) return index;
+
+    if (grid->free_cell_count > 0) {
+        index = grid->free_cells[--grid->free_cell_count];
+    } else {
+        if (grid->cell_count >= grid->cell_capacity) {
+            grid->cell_capacity = grid->cell_capacity ? grid->cell_capacity * 2 : 64;
+            grid->cells = realloc(grid->cells, sizeof(SpatialCell) * grid->cell_capacity);
+            grid->free_cells = realloc(grid->free_cells, sizeof(uint32_t) * grid->cell_capacity);
+        }
+        index = grid->cell_count++;
+        memset(&grid->cells[index], 0, sizeof(SpatialCell));
+    }
+
+    grid->cells[index].cx = cx;
+    grid->cells[index].cz = cz;
+    grid->cells[index].count = 0;
+    grid->cells[index].max_radius = 0.0f;
+
+    // Keep the load factor under 1/2
+    if ((grid->table_used + 1) * 2 > grid->table_size) spatial_grid_grow_table(grid);
+    spatial_grid_table_insert(grid, index);
+    return index;
+}
+
+// Item lists
+
+static void spatial_grid_list_push(uint32_t** items, unsigned int* count, unsigned int* capacity, uint32_t id) {
+    if (*count >= *capacity) {
+        *capacity = *capacity ? *capacity * 2 : INITIAL_CELL_ITEMS;
+        *items = realloc(*items, sizeof(uint32_t) * *capacity);
+    }
+    (*items)[(*count)++] = id;
+}
+
+static void spatial_grid_grow_items(SpatialGrid* grid, uint32_t id) {
+    unsigned int capacity = grid->item_capacity ? grid->item_capacity : INITIAL_ITEM_CAPACITY;
+    while (capacity <= id) capacity *= 2;
+
+    grid->spheres = realloc(grid->spheres, sizeof(float[4]) * capacity);
+    grid->item_cell = realloc(grid->item_cell, sizeof(uint32_t) * capacity);
+    grid->item_slot = realloc(grid->item_slot, sizeof(uint32_t) * capacity);
+    grid->item_stamp = realloc(grid->item_stamp, sizeof(uint32_t) * capacity);
+    for (unsigned int i = grid->item_capacity; i < capacity; i++) {
+        grid->item_cell[i] = SPATIAL_GRID_NONE;
+        grid->item_stamp[i] = 0;
+    }
+    grid->item_capacity = capacity;
+}
+
+// Unlink an item from its cell (or the overflow list), swap-removing it
+static void spatial_grid_unlink(SpatialGrid* grid, uint32_t id) {
+    uint32_t cell_index = grid->item_cell[id];
+    uint32_t slot = grid->item_slot[id];
+
+    if (cell_index == SPATIAL_GRID_LARGE) {
+        uint32_t moved = grid->large_items[--grid->large_count];
+        grid->large_items[slot] = moved;
+        grid->item_slot[moved] = slot;
+    } else {
+        SpatialCell* cell = &grid->cells[cell_index];
+        uint32_t moved = cell->items[--cell->count];
+        cell->items[slot] = moved;
+        grid->item_slot[moved] = slot;
+
+        if (cell->count == 0) {
+            spatial_grid_table_remove(grid, cell_index);
+            grid->free_cells[grid->free_cell_count++] = cell_index;
+        }
+    }
+    grid->item_cell[id] = SPATIAL_GRID_NONE;
+}
+
+void spatial_grid_update(SpatialGrid* grid, uint32_t id, const float sphere[4]) {
+    if (!grid || id >= SPATIAL_GRID_LARGE) return;
+    if (id >= grid->item_capacity) spatial_grid_grow_items(grid, id);
+
+    uint32_t target;
+    int cx = 0, cz = 0;
+    if (sphere[3] > 0.5f * grid->cell_size) {
+        target = SPATIAL_GRID_LARGE;
+    } else {
+        cx = spatial_grid_coord(grid, sphere[0]);
+        cz = spatial_grid_coord(grid, sphere[2]);
+        target = SPATIAL_GRID_NONE;
+        grid->cell_radius = fmaxf(grid->cell_radius, sphere[3]);
+    }
+
+    memcpy(grid->spheres[id], sphere, sizeof(float) * 4);
+
+    // Common case: the item moved but stayed in its cell
+    uint32_t current = grid->item_cell[id];
+    if (current != SPATIAL_GRID_NONE) {
+        if (current == SPATIAL_GRID_LARGE) {
+            if (target == SPATIAL_GRID_LARGE) return;
+        } else if (target != SPATIAL_GRID_LARGE &&
+                   grid->cells[current].cx == cx && grid->cells[current].cz == cz) {
+            grid->cells[current].max_radius = fmaxf(grid->cells[current].max_radius, sphere[3]);
+            return;
+        }
+        spatial_grid_unlink(grid, id);
+    } else {
+        grid->item_count++;
+    }
+
+    if (target == SPATIAL_GRID_LARGE) {
+        grid->item_slot[id] = grid->large_count;
+        spatial_grid_list_push(&grid->large_items, &grid->large_count, &grid->large_capacity, id);
+    } else {
+        target = spatial_grid_acquire_cell(grid, cx, cz);
+        SpatialCell* cell = &grid->cells[target];
+        grid->item_slot[id] = cell->count;
+        spatial_grid_list_push(&cell->items, &cell->count, &cell->capacity, id);
+        cell->max_radius = fmaxf(cell->max_radius, sphere[3]);
+    }
+    grid->item_cell[id] = target;
+}
+
+void spatial_grid_remove(SpatialGrid* grid, uint32_t id) {
+    if (!spatial_grid_contains(grid, id)) return;
+    spatial_grid_unlink(grid, id);
+    grid->item_count--;
+}
+
+bool spatial_grid_contains(const SpatialGrid* grid, uint32_t id) {
+    return grid && id < grid->item_capacity && grid->item_cell[id] != SPATIAL_GRID_NONE;
+}
+
+// New stamp for "already tested" marks, clearing them on wrap-around
+static uint32_t spatial_grid_next_stamp(SpatialGrid* grid) {
+    if (++grid->stamp == 0) {
+        if (grid->item_stamp) memset(grid->item_stamp, 0, sizeof(uint32_t) * grid->item_capacity);
+        grid->stamp = 1;
+    }
+    return grid->stamp;
+}
+
+// Radius queries
+
+static unsigned int spatial_grid_test_radius(const SpatialGrid* grid, const uint32_t* items, unsigned int count,
+                                             const float center[3], float radius,
+                                             uint32_t* out_ids, unsigned int max_results, unsigned int found) {
+    for (unsigned int i = 0; i < count; i++) {
+        const float* s = grid->spheres[items[i]];
+        float dx = s[0] - center[0], dy = s[1] - center[1], dz = s[2] - center[2];
+        float reach = radius + s[3];
+        if (dx * dx + dy * dy + dz * dz <= reach * reach) {
+            if (found < max_results) out_ids[found] = items[i];
+            found++;
+        }
+    }
+    return found;
+}
+
+unsigned int spatial_grid_query_radius(SpatialGrid* grid, const float center[3], float radius,
+                                       uint32_t* out_ids, unsigned int max_results) {
+    if (!grid || grid->item_count == 0) return 0;
+
+    unsigned int found = spatial_grid_test_radius(grid, grid->large_items, grid->large_count,
+                                                  center, radius, out_ids, max_results, 0);
+
+    // Loose cells: an item's sphere reaches at most half a cell outside its cell
+    float reach = radius + 0.5f * grid->cell_size;
+    int x0 = spatial_grid_coord(grid, center[0] - reach), x1 = spatial_grid_coord(grid, center[0] + reach);
+    int z0 = spatial_grid_coord(grid, center[2] - reach), z1 = spatial_grid_coord(grid, center[2] + reach);
+
+    // Very large queries walk the occupied cells instead of the covered range
+    double covered = ((double)x1 - x0 + 1.0) * ((double)z1 - z0 + 1.0);
+    if (covered > (double)grid->table_used) {
+        for (unsigned int c = 0; c < grid->cell_count; c++) {
+            const SpatialCell* cell = &grid->cells[c];
+            if (cell->count == 0 || cell->cx < x0 || cell->cx > x1 || cell->cz < z0 || cell->cz > z1) continue;
+            found = spatial_grid_test_radius(grid, cell->items, cell->count, center, radius,
+                                             out_ids, max_results, found);
+        }
+        return found;
+    }
+
+    for (int cz = z0; cz <= z1; cz++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            uint32_t c = spatial_grid_find_cell(grid, cx, cz);
+            if (c == SPATIAL_GRID_NONE) continue;
+            found = spatial_grid_test_radius(grid, grid->cells[c].items, grid->cells[c].count,
+                                             center, radius, out_ids, max_results, found);
+        }
+    }
+    return found;
+}
+
+void spatial_grid_query_radius_batch(SpatialGrid* grid, const float (*centers)[3], const float* radii,
+                                     unsigned int count, uint32_t* out_ids, unsigned int max_total,
+                                     unsigned int* out_offsets) {
+    unsigned int written = 0;
+    for (unsigned int q = 0; q < count; q++) {
+        out_offsets[q] = written;
+        unsigned int room = max_total - written;
+        unsigned int found = spatial_grid_query_radius(grid, centers[q], radii[q], out_ids + written, room);
+        written += found < room ? found : room;
+    }
+    out_offsets[count] = written;
+}
+
+// Nearest queries
+
+static float spatial_grid_surface_distance(const float* sphere, const float point[3]) {
+    float dx = sphere[0] - point[0], dy = sphere[1] - point[1], dz = sphere[2] - point[2];
+    return fmaxf(sqrtf(dx * dx + dy * dy + dz * dz) - sphere[3], 0.0f);
+}
+
+// Insert into the sorted best-k list if close enough
+static void spatial_grid_consider(SpatialGrid* grid, uint32_t id, const float point[3], unsigned int k,
+                                  float max_distance, uint32_t* ids, float* dists, unsigned int* count) {
+    if (grid->item_stamp[id] == grid->stamp) return;
+    grid->item_stamp[id] = grid->stamp;
+
+    float d = spatial_grid_surface_distance(grid->spheres[id], point);
+    if (d > max_distance) return;
+    if (*count == k && d >= dists[k - 1]) return;
+
+    unsigned int pos = *count < k ? (*count)++ : k - 1;
+    while (pos > 0 && dists[pos - 1] > d) {
+        dists[pos] = dists[pos - 1];
+        ids[pos] = ids[pos - 1];
+        pos--;
+    }
+    dists[pos] = d;
+    ids[pos] = id;
+}
+
+unsigned int spatial_grid_query_nearest(SpatialGrid* grid, const float point[3], unsigned int k,
+                                        float max_distance, uint32_t* out_ids, float* out_distances) {
+    if (!grid || k == 0 || grid->item_count == 0) return 0;
+
+    float* dists = out_distances;
+    if (!dists) {
+        if (k > grid->knn_capacity) {
+            grid->knn_capacity = k;
+            grid->knn_dists = realloc(grid->knn_dists, sizeof(float) * k);
+        }
+        dists = grid->knn_dists;
+    }
+
+    spatial_grid_next_stamp(grid);
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < grid->large_count; i++) {
+        spatial_grid_consider(grid, grid->large_items[i], point, k, max_distance, out_ids, dists, &count);
+    }
+
+    // Expand square rings of cells around the point. Items in ring r + 1 or
+    // beyond are at least r * cell_size - cell_size / 2 away, which bounds
+    // how far the search must go.
+    int pcx = spatial_grid_coord(grid, point[0]);
+    int pcz = spatial_grid_coord(grid, point[2]);
+    unsigned int seen_cells = 0;
+    for (int r = 0;; r++) {
+        for (int cz = pcz - r; cz <= pcz + r; cz++) {
+            bool edge_row = (cz == pcz - r || cz == pcz + r);
+            int step = edge_row ? 1 : 2 * r;
+            for (int cx = pcx - r; cx <= pcx + r; cx += (step > 0 ? step : 1)) {
+                uint32_t c = spatial_grid_find_cell(grid, cx, cz);
+                if (c == SPATIAL_GRID_NONE) continue;
+                seen_cells++;
+                const SpatialCell* cell = &grid->cells[c];
+                for (unsigned int i = 0; i < cell->count; i++) {
+                    spatial_grid_consider(grid, cell->items[i], point, k, max_distance, out_ids, dists, &count);
+                }
+            }
+        }
+
+        float bound = (float)r * grid->cell_size - 0.5f * grid->cell_size;
+        if (bound > max_distance) break;
+        if (count == k && dists[k - 1] <= bound) break;
+        if (seen_cells >= grid->table_used) break;  // Every occupied cell visited
+    }
+
+    return count;
+}
+
+void spatial_grid_query_nearest_batch(SpatialGrid* grid, const float (*points)[3], unsigned int count,
+                                      unsigned int k, float max_distance,
+                                      uint32_t* out_ids, float* out_distances, unsigned int* out_counts) {
+    for (unsigned int q = 0; q < count; q++) {
+        out_counts[q] = spatial_grid_query_nearest(grid, points[q], k, max_distance, out_ids + (size_t)q * k,
+                                                   out_distances ? out_distances + (size_t)q * k : NULL);
+    }
+}
+
+// Ray casts
+
+// Entry distance of the ray into a sphere (0 if the origin is inside), or -1
+static float spatial_grid_ray_sphere(const float* sphere, const float origin[3], const float direction[3]) {
+    float ox = origin[0] - sphere[0], oy = origin[1] - sphere[1], oz = origin[2] - sphere[2];
+    float c = ox * ox + oy * oy + oz * oz - sphere[3] * sphere[3];
+    if (c <= 0.0f) return 0.0f;
+
+    float b = ox * direction[0] + oy * direction[1] + oz * direction[2];
+    if (b > 0.0f) return -1.0f;
+
+    float disc = b * b - c;
+    if (disc < 0.0f) return -1.0f;
+    return -b - sqrtf(disc);
+}
+
+static void spatial_grid_ray_test(SpatialGrid* grid, const uint32_t* items, unsigned int count,
+                                  const float origin[3], const float direction[3],
+                                  SpatialRayTest test, void* user, uint32_t* best_id, float* best_t) {
+    for (unsigned int i = 0; i < count; i++) {
+        uint32_t id = items[i];
+        if (grid->item_stamp[id] == grid->stamp) continue;
+        grid->item_stamp[id] = grid->stamp;
+
+        float t = spatial_grid_ray_sphere(grid->spheres[id], origin, direction);
+        if (t < 0.0f || t >= *best_t) continue;
+        if (test && !test(user, id, origin, direction, &t)) continue;
+        if (t < *best_t) {
+            *best_t = t;
+            *best_id = id;
+        }
+    }
+}
+
+// Cells whose items can't reach the ray's XZ extent (box: min x, min z,
+// max x, max z) are skipped: before the hash lookup by the grid's largest
+// cell item radius, after it by the cell's own.
+// Short rays usually touch only a few cells of the 3x3 blocks the walk visits.
+static void spatial_grid_ray_cell(SpatialGrid* grid, int cx, int cz, const float box[4],
+                                  const float origin[3], const float direction[3],
+                                  SpatialRayTest test, void* user, uint32_t* best_id, float* best_t) {
+    float cs = grid->cell_size;
+    float min_x = (float)cx * cs;
+    float min_z = (float)cz * cs;
+    float loose = grid->cell_radius;
+    if (min_x - loose > box[2] || min_x + cs + loose < box[0] ||
+        min_z - loose > box[3] || min_z + cs + loose < box[1]) return;
+
+    uint32_t c = spatial_grid_find_cell(grid, cx, cz);
+    if (c == SPATIAL_GRID_NONE) return;
+
+    const SpatialCell* cell = &grid->cells[c];
+    float r = cell->max_radius;
+    if (min_x - r > box[2] || min_x + cs + r < box[0] ||
+        min_z - r > box[3] || min_z + cs + r < box[1]) return;
+    spatial_grid_ray_test(grid, cell->items, cell->count, origin, direction, test, user, best_id, best_t);
+}
+
+uint32_t spatial_grid_raycast_filtered(SpatialGrid* grid, const float origin[3], const float direction[3],
+                                       float max_distance, SpatialRayTest test, void* user,
+                                       float* out_distance) {
+    if (!grid || grid->item_count == 0) return SPATIAL_GRID_NONE;
+    if (!isfinite(max_distance)) {
+        fprintf(stderr, "Spatial grid raycast needs a finite max distance\n");
+        return SPATIAL_GRID_NONE;
+    }
+
+    spatial_grid_next_stamp(grid);
+    uint32_t best_id = SPATIAL_GRID_NONE;
+    float best_t = max_distance;
+
+    spatial_grid_ray_test(grid, grid->large_items, grid->large_count, origin, direction,
+                          test, user, &best_id, &best_t);
+
+    // 2D DDA over the cells under the ray. A hit at distance t lies within half
+    // a cell of its item's center, so it is found from the 3x3 block around the
+    // cell containing the ray point at t. Once the walk leaves a cell beyond the
+    // best hit, nothing closer can remain.
+    float cs = grid->cell_size;
+    int cx = spatial_grid_coord(grid, origin[0]);
+    int cz = spatial_grid_coord(grid, origin[2]);
+    float end_x = origin[0] + direction[0] * max_distance;
+    float end_z = origin[2] + direction[2] * max_distance;
+    float box[4] = {fminf(origin[0], end_x), fminf(origin[2], end_z), fmaxf(origin[0], end_x), fmaxf(origin[2], end_z)};
+    int step_x = direction[0] > 0.0f ? 1 : -1;
+    int step_z = direction[2] > 0.0f ? 1 : -1;
+
+    float delta_x = direction[0] != 0.0f ? fabsf(cs / direction[0]) : INFINITY;
+    float delta_z = direction[2] != 0.0f ? fabsf(cs / direction[2]) : INFINITY;
+    float next_x = direction[0] != 0.0f
+                 ? ((float)(cx + (step_x > 0)) * cs - origin[0]) / direction[0] : INFINITY;
+    float next_z = direction[2] != 0.0f
+                 ? ((float)(cz + (step_z > 0)) * cs - origin[2]) / direction[2] : INFINITY;
+
+    for (int dz = -1; dz <= 1; dz++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            spatial_grid_ray_cell(grid, cx + dx, cz + dz, box, origin, direction, test, user, &best_id, &best_t);
+        }
+    }
+
+    // Each step only exposes the leading row or column of the next 3x3 block
+    for (;;) {
+        float exit_t = fminf(next_x, next_z);
+        if (exit_t >= best_t) break;  // Also ends vertical rays (exit_t = inf)
+
+        if (next_x < next_z) {
+            cx += step_x;
+            next_x += delta_x;
+            for (int d = -1; d <= 1; d++) {
+                spatial_grid_ray_cell(grid, cx + step_x, cz + d, box, origin, direction, test, user, &best_id, &best_t);
+            }
+        } else {
+            cz += step_z;
+            next_z += delta_z;
+            for (int d = -1; d <= 1; d++) {
+                spatial_grid_ray_cell(grid, cx + d, cz + step_z, box, origin, direction, test, user, &best_id, &best_t);
+            }
+        }
+    }
+
+    if (best_id != SPATIAL_GRID_NONE && out_distance) *out_distance = best_t;
+    return best_id;
+}
+
+uint32_t spatial_grid_raycast(SpatialGrid* grid, const float origin[3], const float direction[3],
+                              float max_distance, float* out_distance) {
+    return spatial_grid_raycast_filtered(grid, origin, direction, max_distance, NULL, NULL, out_distance);
+}
+
+void spatial_grid_raycast_batch(SpatialGrid* grid, const float (*origins)[3], const float (*directions)[3],
+                                unsigned int count, float max_distance,
+                                uint32_t* out_ids, float* out_distances) {
+    for (unsigned int q = 0; q < count; q++) {
+        float t = max_distance;
+        out_ids[q] = spatial_grid_raycast(grid, origins[q], directions[q], max_distance, &t);
+        if (out_distances) out_distances[q] = t;
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Loose hashed grid over bounding spheres, for proximity and ray queries.
+//
+// Cells are square columns on the XZ plane (the world is a heightfield, so
+// Y is only used in the exact sphere tests). Only occupied cells exist, kept
+// in an open-addressed hash table, so the grid works for an unbounded world.
+// An item lives in the single cell containing its center; cells are "loose"
+// by half a cell, so any item with radius <= cell_size / 2 stays inside its
+// cell's loose bounds. Larger items go to an overflow list that every query
+// checks.
+//
+// Items are identified by caller-chosen ids (dense small integers such as
+// entity slots). Updating an item that stays in its cell only rewrites its
+// sphere.
+
+#define SPATIAL_GRID_NONE UINT32_MAX
+#define SPATIAL_GRID_LARGE (UINT32_MAX - 1)
+
+// Exact hit test run for items whose bounding sphere the ray enters.
+// *t holds the sphere entry distance; return false on a miss, or true with
+// *t set to the hit distance (which must not be less than the entry distance).
+typedef bool (*SpatialRayTest)(void* user, uint32_t id, const float origin[3],
+                               const float direction[3], float* t);
+
+typedef struct {
+    int cx, cz;                 // Cell coordinates
+    uint32_t* items;            // Item ids in this cell
+    unsigned int count;
+    unsigned int capacity;
+    float max_radius;           // Largest radius any item has had since the cell was acquired
+} SpatialCell;
+
+typedef struct {
+    float cell_size;
+    float inv_cell_size;
+
+    // Occupied cells; a cell is recycled when it empties
+    SpatialCell* cells;
+    unsigned int cell_count;
+    unsigned int cell_capacity;
+    uint32_t* free_cells;
+    unsigned int free_cell_count;
+
+    // Hash table (cx, cz) -> cell index, linear probing, SPATIAL_GRID_NONE = empty
+    uint32_t* table;
+    unsigned int table_size;    // Power of two
+    unsigned int table_used;
+
+    // Per item (indexed by id)
+    float (*spheres)[4];        // Center xyz, radius
+    uint32_t* item_cell;        // Cell index, SPATIAL_GRID_LARGE or SPATIAL_GRID_NONE if absent
+    uint32_t* item_slot;        // Position inside the cell (or overflow) list
+    uint32_t* item_stamp;       // Query stamp to skip items already tested
+    unsigned int item_capacity;
+    unsigned int item_count;    // Items currently in the grid
+    uint32_t stamp;
+    float cell_radius;          // Largest radius any item in a cell has had (at most cell_size / 2)
+
+    // Items too large for loose cells
+    uint32_t* large_items;
+    unsigned int large_count;
+    unsigned int large_capacity;
+
+    // Distance scratch for nearest queries without a distance output
+    float* knn_dists;
+    unsigned int knn_capacity;
+} SpatialGrid;
+
+SpatialGrid* spatial_grid_create(float cell_size);
+void spatial_grid_free(SpatialGrid* grid);
+
+// Insert the item or move it to its new bounds
+void spatial_grid_update(SpatialGrid* grid, uint32_t id, const float sphere[4]);
+void spatial_grid_remove(SpatialGrid* grid, uint32_t id);
+bool spatial_grid_contains(const SpatialGrid* grid, uint32_t id);
+
+// Items whose sphere intersects the query sphere. Writes up to max_results
+// ids and returns the total number found (may exceed max_results).
+unsigned int spatial_grid_query_radius(SpatialGrid* grid, const float center[3], float radius,
+                                       uint32_t* out_ids, unsigned int max_results);
+
+// Up to k items nearest to point (distance to the sphere surface, 0 inside),
+// searching no further than max_distance. Results are sorted nearest first;
+// out_distances may be NULL. Returns the number written.
+unsigned int spatial_grid_query_nearest(SpatialGrid* grid, const float point[3], unsigned int k,
+                                        float max_distance, uint32_t* out_ids, float* out_distances);
+
+// First item whose sphere the ray hits within max_distance (which must be
+// finite). direction must be normalized. Returns SPATIAL_GRID_NONE on a miss.
+uint32_t spatial_grid_raycast(SpatialGrid* grid, const float origin[3], const float direction[3],
+                              float max_distance, float* out_distance);
+
+// Same walk, with test refining each sphere hit against the item's real bounds
+uint32_t spatial_grid_raycast_filtered(SpatialGrid* grid, const float origin[3], const float direction[3],
+                                       float max_distance, SpatialRayTest test, void* user,
+                                       float* out_distance);
+
+// Batched forms. Radius results are packed: query q's ids are
+// out_ids[out_offsets[q] .. out_offsets[q + 1]), with at most max_total ids
+// overall (out_offsets has count + 1 entries). Nearest results use k slots
+// per query and out_counts[q] entries of them. Ray misses are SPATIAL_GRID_NONE.
+void spatial_grid_query_radius_batch(SpatialGrid* grid, const float (*centers)[3], const float* radii,
+                                     unsigned int count, uint32_t* out_ids, unsigned int max_total,
+                                     unsigned int* out_offsets);
+void spatial_grid_query_nearest_batch(SpatialGrid* grid, const float (*points)[3], unsigned int count,
+                                      unsigned int k, float max_distance,
+                                      uint32_t* out_ids, float* out_distances, unsigned int* out_counts);
+void spatial_grid_raycast_batch(SpatialGrid* grid, const float (*origins)[3], const float (*directions)[3],
+                                unsigned int count, float max_distance,
+                                uint32_t* out_ids, float* out_distances);
+
+#endif // SPATIAL_GRID_H
@@ -1,4 +1,8 @@
 #include "file_ops.h"
+#include <errno.h>
+#include <sys/stat.h>
+
+#define CACHE_TMP_PATH_MAX 512
 
 char* load_shader_source(const char* path){
   FILE* file = fopen(path, "rb");
@@ -18,3 +22,62 @@ char* load_shader_source(const char* path){
   fclose(file);
   return buffer; // Caller is responsible for free()
 }
+
+uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+bool hash_file(const char* path, uint64_t* hash) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+
+    unsigned char buffer[65536];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        *hash = fnv1a(*hash, buffer, read);
+    }
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+bool file_stamp(const char* path, uint64_t* size, int64_t* mtime) {
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    *size = (uint64_t)st.st_size;
+    *mtime = (int64_t)st.st_mtime;
+    return true;
+}
+
+bool ensure_cache_dir(const char* dir) {
+    if (mkdir("cache", 0755) != 0 && errno != EEXIST) return false;
+    return mkdir(dir, 0755) == 0 || errno == EEXIST;
+}
+
+static bool cache_tmp_path(const char* path, char* out) {
+    int length = snprintf(out, CACHE_TMP_PATH_MAX, "%s.tmp", path);
+    return length > 0 && length < CACHE_TMP_PATH_MAX;
+}
+
+FILE* cache_write_begin(const char* path) {
+    char tmp_path[CACHE_TMP_PATH_MAX];
+    if (!cache_tmp_path(path, tmp_path)) return NULL;
+    return fopen(tmp_path, "wb");
+}
+
+bool cache_write_end(FILE* file, const char* path, bool ok) {
+    char tmp_path[CACHE_TMP_PATH_MAX];
+    cache_tmp_path(path, tmp_path);
+
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return false;
+    }
+    return true;
+}
@@ -3,7 +3,33 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 char* load_shader_source(const char* path);
 
+// ===== Cache files =====
+// Shared by the on-disk caches (cooked models and textures, tree meshes)
+
+// FNV-1a 64-bit; start from FNV1A_BASIS and chain calls to hash several ranges
+#define FNV1A_BASIS 0xcbf29ce484222325ull
+uint64_t fnv1a(uint64_t hash, const void* data, size_t size);
+
+// Fold path's contents into *hash; returns false if it can't be read
+bool hash_file(const char* path, uint64_t* hash);
+
+// Size and mtime of path. Stamp a source before hashing it, so an edit made
+// in between reads as stale later.
+bool file_stamp(const char* path, uint64_t* size, int64_t* mtime);
+
+// Create dir, a directory directly under cache/, if it doesn't exist
+bool ensure_cache_dir(const char* dir);
+
+// Write path through a temporary sibling that cache_write_end renames over
+// it, so a crashed run never leaves a half-written file behind. End removes
+// the temporary instead when ok is false or closing fails; returns whether
+// path now holds the new file.
+FILE* cache_write_begin(const char* path);
+bool cache_write_end(FILE* file, const char* path, bool ok);
+
 #endif
@@ -0,0 +1,71 @@
+#include "frame_data.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#define FRAME_DATA_FENCE_TIMEOUT_NS 100000000ull  // 100ms
+
+FrameDataBuffer* frame_data_create(void) {
+    FrameDataBuffer* buffer = malloc(sizeof(FrameDataBuffer));
+    memset(buffer, 0, sizeof(FrameDataBuffer));
+
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment <= 0) alignment = 256;
+
+    buffer->region_size = ((GLsizeiptr)sizeof(FrameData) + alignment - 1) / alignment * alignment;
+    buffer->region = FRAME_DATA_RING_SIZE - 1;
+
+    glGenBuffers(1, &buffer->ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer->ubo);
+    glBufferData(GL_UNIFORM_BUFFER, buffer->region_size * FRAME_DATA_RING_SIZE, NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    printf("FrameData UBO initialized (%d x %ld bytes)\n",
+           FRAME_DATA_RING_SIZE, (long)buffer->region_size);
+
+    return buffer;
+}
+
+void frame_data_update(FrameDataBuffer* buffer, const FrameData* data) {
+    buffer->region = (buffer->region + 1) % FRAME_DATA_RING_SIZE;
+    GLintptr offset = (GLintptr)buffer->region * buffer->region_size;
+
+    // Only blocks if the GPU is still FRAME_DATA_RING_SIZE frames behind
+    GLsync fence = buffer->fences[buffer->region];
+    if (fence) {
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FRAME_DATA_FENCE_TIMEOUT_NS);
+        glDeleteSync(fence);
+        buffer->fences[buffer->region] = 0;
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer->ubo);
+    void* dst = glMapBufferRange(GL_UNIFORM_BUFFER, offset, sizeof(FrameData),
+                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (dst) {
+        memcpy(dst, data, sizeof(FrameData));
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+    } else {
+        glBufferSubData(GL_UNIFORM_BUFFER, offset, sizeof(FrameData), data);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    glBindBufferRange(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, buffer->ubo, offset, sizeof(FrameData));
+}
+
+void frame_data_end_frame(FrameDataBuffer* buffer) {
+    if (buffer->fences[buffer->region]) {
+        glDeleteSync(buffer->fences[buffer->region]);
+    }
+    buffer->fences[buffer->region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void frame_data_cleanup(FrameDataBuffer* buffer) {
+    if (!buffer) return;
+
+    for (int i = 0; i < FRAME_DATA_RING_SIZE; i++) {
+        if (buffer->fences[i]) glDeleteSync(buffer->fences[i]);
+    }
+    glDeleteBuffers(1, &buffer->ubo);
+    free(buffer);
+}
@@ -0,0 +1,50 @@
+#ifndef FRAME_DATA_H
+#define FRAME_DATA_H
+
+#include <glad/glad.h>
+
+// Uniform block shared by every program that declares it:
+//
+//   layout (std140) uniform FrameData {
+//       mat4 persp;
+//       mat4 view;
+//       vec3 lightdir;
+//       float time;
+//       vec3 camerapos;
+//       float viewdist;
+//   };
+#define FRAME_DATA_BLOCK_NAME "FrameData"
+#define FRAME_DATA_BINDING 0
+#define FRAME_DATA_RING_SIZE 3      // Frames the GPU may still be reading
+
+// CPU mirror of the block (std140: vec3 + float share one 16 byte slot)
+typedef struct {
+    float persp[16];
+    float view[16];
+    float lightdir[3];
+    float time;
+    float camerapos[3];
+    float viewdist;
+} FrameData;
+
+// Ring of FRAME_DATA_RING_SIZE block copies in one buffer. Each frame writes
+// the next region unsynchronized, after waiting on the fence of the frame
+// that last used it, and binds it to FRAME_DATA_BINDING.
+typedef struct {
+    GLuint ubo;
+    GLsizeiptr region_size;         // sizeof(FrameData) rounded to the offset alignment
+    GLsync fences[FRAME_DATA_RING_SIZE];
+    unsigned int region;            // Region written by the last update
+} FrameDataBuffer;
+
+FrameDataBuffer* frame_data_create(void);
+
+// Upload this frame's values and bind them for all programs
+void frame_data_update(FrameDataBuffer* buffer, const FrameData* data);
+
+// Fence the region just drawn with (call after the frame's draws are issued)
+void frame_data_end_frame(FrameDataBuffer* buffer);
+
+void frame_data_cleanup(FrameDataBuffer* buffer);
+
+#endif // FRAME_DATA_H
@@ -0,0 +1,279 @@
+#include "mesh_optimize.h"
+#include "mesh_simplify.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+float mesh_acmr(const unsigned int* indices, unsigned int index_count,
+                unsigned int vertex_count, unsigned int cache_size) {
+    if (index_count < 3) return 0.0f;
+
+    // A vertex is cached while fewer than cache_size misses happened since its own
+    unsigned int* cache_time = calloc(vertex_count, sizeof(unsigned int));
+    unsigned int timestamp = cache_size + 1;
+    unsigned int misses = 0;
+
+    for (unsigned int i = 0; i < index_count; i++) {
+        unsigned int v = indices[i];
+        if (timestamp - cache_time[v] > cache_size) {
+            cache_time[v] = timestamp++;
+            misses++;
+        }
+    }
+
+    free(cache_time);
+    return (float)misses / (float)(index_count / 3);
+}
+
+// Vertex -> triangles adjacency (offsets has vertex_count + 1 entries)
+static void build_adjacency(unsigned int* offsets, unsigned int* triangles,
+                            const unsigned int* indices, unsigned int index_count,
+                            unsigned int vertex_count) {
+    memset(offsets, 0, (vertex_count + 1) * sizeof(unsigned int));
+    for (unsigned int i = 0; i < index_count; i++) {
+        offsets[indices[i] + 1]++;
+    }
+    for (unsigned int v = 0; v < vertex_count; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    unsigned int* fill = malloc(vertex_count * sizeof(unsigned int));
+    memcpy(fill, offsets, vertex_count * sizeof(unsigned int));
+    for (unsigned int i = 0; i < index_count; i++) {
+        triangles[fill[indices[i]]++] = i / 3;
+    }
+    free(fill);
+}
+
+void mesh_optimize_vertex_cache(unsigned int* out_indices, const unsigned int* indices,
+                                unsigned int index_count, unsigned int vertex_count,
+                                unsigned int cache_size) {
+    unsigned int tri_count = index_count / 3;
+    if (tri_count == 0 || vertex_count == 0) {
+        memcpy(out_indices, indices, index_count * sizeof(unsigned int));
+        return;
+    }
+
+    unsigned int* offsets = malloc((vertex_count + 1) * sizeof(unsigned int));
+    unsigned int* adjacency = malloc(tri_count * 3 * sizeof(unsigned int));
+    build_adjacency(offsets, adjacency, indices, tri_count * 3, vertex_count);
+
+    // Triangles not yet emitted that use each vertex
+    unsigned int* live = malloc(vertex_count * sizeof(unsigned int));
+    for (unsigned int v = 0; v < vertex_count; v++) {
+        live[v] = offsets[v + 1] - offsets[v];
+    }
+
+    unsigned int* cache_time = calloc(vertex_count, sizeof(unsigned int));
+    unsigned char* emitted = calloc(tri_count, 1);
+    unsigned int* dead_end = malloc(tri_count * 3 * sizeof(unsigned int));
+    unsigned int* candidates = malloc(tri_count * 3 * sizeof(unsigned int));
+    unsigned int dead_end_top = 0;
+    unsigned int timestamp = cache_size + 1;
+    unsigned int cursor = 0;
+    unsigned int out_count = 0;
+
+    int fan = -1;
+    for (;;) {
+        if (fan < 0) {
+            // Dead end: most recently used vertex with work left, else the next one in order
+            while (dead_end_top > 0 && fan < 0) {
+                unsigned int v = dead_end[--dead_end_top];
+                if (live[v] > 0) fan = (int)v;
+            }
+            while (cursor < vertex_count && fan < 0) {
+                if (live[cursor] > 0) fan = (int)cursor;
+                cursor++;
+            }
+            if (fan < 0) break;
+        }
+
+        // Emit every remaining triangle around the fanning vertex
+        unsigned int candidate_count = 0;
+        for (unsigned int a = offsets[fan]; a < offsets[fan + 1]; a++) {
+            unsigned int t = adjacency[a];
+            if (emitted[t]) continue;
+            emitted[t] = 1;
+
+            for (int k = 0; k < 3; k++) {
+                unsigned int v = indices[t * 3 + k];
+                out_indices[out_count++] = v;
+                dead_end[dead_end_top++] = v;
+                candidates[candidate_count++] = v;
+                live[v]--;
+                if (timestamp - cache_time[v] > cache_size) {
+                    cache_time[v] = timestamp++;
+                }
+            }
+        }
+
+        // Next fan: the candidate that will still be cached after its own triangles, oldest first
+        int best = -1;
+        int best_priority = -1;
+        for (unsigned int c = 0; c < candidate_count; c++) {
+            unsigned int v = candidates[c];
+            if (live[v] == 0) continue;
+
+            int priority = 0;
+            if (timestamp - cache_time[v] + 2 * live[v] <= cache_size) {
+                priority = (int)(timestamp - cache_time[v]);
+            }
+            if (priority > best_priority) {
+                best_priority = priority;
+                best = (int)v;
+            }
+        }
+        fan = best;
+    }
+
+    free(candidates);
+    free(dead_end);
+    free(emitted);
+    free(cache_time);
+    free(live);
+    free(adjacency);
+    free(offsets);
+}
+
+typedef struct {
+    unsigned int start;                 // First triangle
+    unsigned int count;
+    float sort_key;
+} MeshCluster;
+
+static int compare_clusters(const void* a, const void* b) {
+    float ka = ((const MeshCluster*)a)->sort_key;
+    float kb = ((const MeshCluster*)b)->sort_key;
+    return (ka < kb) - (ka > kb);       // Descending
+}
+
+void mesh_optimize_overdraw(unsigned int* out_indices, const unsigned int* indices,
+                            unsigned int index_count, const float* vertices,
+                            unsigned int vertex_count, unsigned int stride,
+                            unsigned int cache_size, float threshold) {
+    unsigned int tri_count = index_count / 3;
+    memcpy(out_indices, indices, index_count * sizeof(unsigned int));
+    if (tri_count < 2) return;
+
+    // Clusters start where the cache went cold: a triangle missing on all three vertices
+    MeshCluster* clusters = malloc(tri_count * sizeof(MeshCluster));
+    unsigned int cluster_count = 0;
+    unsigned int* cache_time = calloc(vertex_count, sizeof(unsigned int));
+    unsigned int timestamp = cache_size + 1;
+
+    for (unsigned int t = 0; t < tri_count; t++) {
+        int misses = 0;
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = indices[t * 3 + k];
+            if (timestamp - cache_time[v] > cache_size) {
+                cache_time[v] = timestamp++;
+                misses++;
+            }
+        }
+        if (t == 0 || misses == 3) {
+            clusters[cluster_count].start = t;
+            clusters[cluster_count].count = 0;
+            cluster_count++;
+        }
+        clusters[cluster_count - 1].count++;
+    }
+    free(cache_time);
+
+    if (cluster_count < 2) {
+        free(clusters);
+        return;
+    }
+
+    // Area weighted centroid of the mesh and of every cluster, and cluster normals
+    float (*centroids)[3] = malloc(cluster_count * sizeof(*centroids));
+    float (*normals)[3] = malloc(cluster_count * sizeof(*normals));
+    double mesh_centroid[3] = {0.0, 0.0, 0.0};
+    double mesh_area = 0.0;
+
+    for (unsigned int c = 0; c < cluster_count; c++) {
+        double centroid[3] = {0.0, 0.0, 0.0};
+        double normal[3] = {0.0, 0.0, 0.0};
+        double area = 0.0;
+
+        for (unsigned int t = clusters[c].start; t < clusters[c].start + clusters[c].count; t++) {
+            const float* p0 = vertices + indices[t * 3 + 0] * stride;
+            const float* p1 = vertices + indices[t * 3 + 1] * stride;
+            const float* p2 = vertices + indices[t * 3 + 2] * stride;
+
+            double e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+            double e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+            double n[3] = {e1[1] * e2[2] - e1[2] * e2[1],
+                           e1[2] * e2[0] - e1[0] * e2[2],
+                           e1[0] * e2[1] - e1[1] * e2[0]};
+            double a = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+            for (int k = 0; k < 3; k++) {
+                centroid[k] += a * (p0[k] + p1[k] + p2[k]) / 3.0;
+                normal[k] += n[k];
+            }
+            area += a;
+        }
+
+        for (int k = 0; k < 3; k++) {
+            mesh_centroid[k] += centroid[k];
+            centroids[c][k] = area > 0.0 ? (float)(centroid[k] / area) : 0.0f;
+            normals[c][k] = (float)normal[k];
+        }
+        mesh_area += area;
+    }
+
+    if (mesh_area > 0.0) {
+        for (int k = 0; k < 3; k++) mesh_centroid[k] /= mesh_area;
+    }
+
+    // Clusters facing away from the center occlude the rest, so they go first
+    for (unsigned int c = 0; c < cluster_count; c++) {
+        float* n = normals[c];
+        float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        float key = 0.0f;
+        if (length > 0.0f) {
+            for (int k = 0; k < 3; k++) {
+                key += (centroids[c][k] - (float)mesh_centroid[k]) * n[k] / length;
+            }
+        }
+        clusters[c].sort_key = key;
+    }
+    free(normals);
+    free(centroids);
+
+    qsort(clusters, cluster_count, sizeof(MeshCluster), compare_clusters);
+
+    unsigned int out_count = 0;
+    for (unsigned int c = 0; c < cluster_count; c++) {
+        unsigned int count = clusters[c].count * 3;
+        memcpy(out_indices + out_count, indices + clusters[c].start * 3, count * sizeof(unsigned int));
+        out_count += count;
+    }
+    free(clusters);
+
+    // Cluster edges cost some reuse; give up on the order if it costs too much
+    float before = mesh_acmr(indices, index_count, vertex_count, cache_size);
+    float after = mesh_acmr(out_indices, index_count, vertex_count, cache_size);
+    if (after > before * threshold) {
+        memcpy(out_indices, indices, index_count * sizeof(unsigned int));
+    }
+}
+
+unsigned int mesh_optimize(float* vertices, unsigned int* indices, unsigned int index_count,
+                           unsigned int vertex_count, unsigned int stride) {
+    if (index_count < 3 || vertex_count == 0) return vertex_count;
+
+    unsigned int* scratch = malloc(index_count * sizeof(unsigned int));
+    mesh_optimize_vertex_cache(scratch, indices, index_count, vertex_count, MESH_CACHE_SIZE);
+    mesh_optimize_overdraw(indices, scratch, index_count, vertices, vertex_count, stride,
+                           MESH_CACHE_SIZE, MESH_OVERDRAW_THRESHOLD);
+    free(scratch);
+
+    // Renumber vertices in first-use order
+    float* packed = malloc((size_t)vertex_count * stride * sizeof(float));
+    unsigned int count = mesh_compact_vertices(packed, indices, index_count, vertices, vertex_count, stride);
+    memcpy(vertices, packed, (size_t)count * stride * sizeof(float));
+    free(packed);
+
+    return count;
+}
@@ -0,0 +1,44 @@
+#ifndef MESH_OPTIMIZE_H
+#define MESH_OPTIMIZE_H
+
+// Import-time index and vertex reordering for indexed triangle lists
+//
+// Triangles are reordered for the post-transform vertex cache with Tipsify
+// (Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality
+// and Reduced Overdraw"), then clusters of that order are sorted so outward
+// facing parts of the mesh draw first, and finally vertices are renumbered
+// in first-use order so vertex fetch walks memory linearly.
+//
+// ACMR (average cache miss ratio) is vertex shader invocations per triangle
+// on a FIFO cache of MESH_CACHE_SIZE entries: 3.0 is no reuse, ~0.5 the
+// best a closed mesh can do.
+
+#define MESH_CACHE_SIZE 16              // Post-transform cache entries assumed
+
+// Overdraw ordering is kept only if ACMR grows by at most this factor
+#define MESH_OVERDRAW_THRESHOLD 1.05f
+
+// ACMR of indices on a FIFO cache of cache_size entries
+float mesh_acmr(const unsigned int* indices, unsigned int index_count,
+                unsigned int vertex_count, unsigned int cache_size);
+
+// Reorder triangles for the vertex cache (Tipsify). out_indices must hold
+// index_count entries and may not alias indices.
+void mesh_optimize_vertex_cache(unsigned int* out_indices, const unsigned int* indices,
+                                unsigned int index_count, unsigned int vertex_count,
+                                unsigned int cache_size);
+
+// Sort the clusters of a cache-optimized order front to back (outward facing
+// first), keeping the result only if ACMR stays within threshold of the input.
+// Vertices are interleaved with the position in their first three floats.
+void mesh_optimize_overdraw(unsigned int* out_indices, const unsigned int* indices,
+                            unsigned int index_count, const float* vertices,
+                            unsigned int vertex_count, unsigned int stride,
+                            unsigned int cache_size, float threshold);
+
+// Full pass in place: vertex cache, overdraw, then vertex fetch order.
+// Unreferenced vertices are dropped; returns the new vertex count.
+unsigned int mesh_optimize(float* vertices, unsigned int* indices, unsigned int index_count,
+                           unsigned int vertex_count, unsigned int stride);
+
+#endif // MESH_OPTIMIZE_H
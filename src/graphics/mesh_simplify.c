@@ -0,0 +1,521 @@
+#include "mesh_simplify.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+// Symmetric 4x4 quadric: xx, xy, xz, xw, yy, yz, yw, zz, zw, ww
+typedef struct {
+    double a[10];
+} Quadric;
+
+typedef struct {
+    float cost;
+    unsigned int from;
+    unsigned int to;
+} Collapse;
+
+// Border and seam edges get a perpendicular plane quadric with this weight so
+// open boundaries (leaf cards, cut-off trunks) and UV islands keep their outline
+#define BORDER_WEIGHT 10.0
+
+static void quadric_from_plane(Quadric* q, double a, double b, double c, double d, double w) {
+    q->a[0] = a * a * w; q->a[1] = a * b * w; q->a[2] = a * c * w; q->a[3] = a * d * w;
+    q->a[4] = b * b * w; q->a[5] = b * c * w; q->a[6] = b * d * w;
+    q->a[7] = c * c * w; q->a[8] = c * d * w;
+    q->a[9] = d * d * w;
+}
+
+static void quadric_add(Quadric* q, const Quadric* other) {
+    for (int i = 0; i < 10; i++) {
+        q->a[i] += other->a[i];
+    }
+}
+
+static double quadric_error(const Quadric* q, const float* p) {
+    double x = p[0], y = p[1], z = p[2];
+    const double* a = q->a;
+    double e = a[0] * x * x + 2.0 * a[1] * x * y + 2.0 * a[2] * x * z + 2.0 * a[3] * x
+             + a[4] * y * y + 2.0 * a[5] * y * z + 2.0 * a[6] * y
+             + a[7] * z * z + 2.0 * a[8] * z
+             + a[9];
+    return fabs(e);
+}
+
+static void triangle_normal(float* n, const float* a, const float* b, const float* c) {
+    float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    float e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+    n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+    n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+static unsigned int hash_position(const float* p) {
+    uint32_t bits[3];
+    memcpy(bits, p, sizeof(bits));
+    uint32_t h = bits[0] * 73856093u ^ bits[1] * 19349663u ^ bits[2] * 83492791u;
+    return h ^ (h >> 16);
+}
+
+// Map every vertex to the first vertex whose first float_count floats are
+// identical (3 welds positions, stride whole vertices)
+static unsigned int weld_vertices(unsigned int* canonical, const float* vertices,
+                                  unsigned int vertex_count, unsigned int stride,
+                                  unsigned int float_count) {
+    unsigned int table_size = 1;
+    while (table_size < vertex_count * 2) table_size <<= 1;
+
+    unsigned int* table = malloc(table_size * sizeof(unsigned int));
+    memset(table, 0xff, table_size * sizeof(unsigned int));
+
+    unsigned int unique = 0;
+    for (unsigned int v = 0; v < vertex_count; v++) {
+        const float* p = vertices + v * stride;
+        unsigned int slot = hash_position(p) & (table_size - 1);
+
+        while (table[slot] != UINT32_MAX) {
+            const float* q = vertices + table[slot] * stride;
+            unsigned int k = 0;
+            while (k < float_count && p[k] == q[k]) k++;
+            if (k == float_count) break;
+            slot = (slot + 1) & (table_size - 1);
+        }
+
+        if (table[slot] == UINT32_MAX) {
+            table[slot] = v;
+            unique++;
+        }
+        canonical[v] = table[slot];
+    }
+
+    free(table);
+    return unique;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// A triangle edge over welded vertices and the attribute vertices at its ends
+typedef struct {
+    uint64_t key;                       // Welded endpoints, smaller first
+    uint64_t wedges;                    // Attribute vertices in the same order
+} EdgeWedges;
+
+static int compare_edge_wedges(const void* a, const void* b) {
+    const EdgeWedges* x = (const EdgeWedges*)a;
+    const EdgeWedges* y = (const EdgeWedges*)b;
+    if (x->key != y->key) return (x->key > y->key) - (x->key < y->key);
+    return (x->wedges > y->wedges) - (x->wedges < y->wedges);
+}
+
+static int compare_collapse(const void* a, const void* b) {
+    float x = ((const Collapse*)a)->cost;
+    float y = ((const Collapse*)b)->cost;
+    return (x > y) - (x < y);
+}
+
+// Collect the unique undirected edges of all live triangles, sorted.
+// Returns the number of unique edges; border edges are flagged in is_border.
+static unsigned int collect_edges(uint64_t* edges, unsigned char* is_border,
+                                  const unsigned int* tris, const unsigned char* dead,
+                                  unsigned int tri_count) {
+    unsigned int count = 0;
+    for (unsigned int t = 0; t < tri_count; t++) {
+        if (dead[t]) continue;
+        for (int e = 0; e < 3; e++) {
+            unsigned int a = tris[t * 3 + e];
+            unsigned int b = tris[t * 3 + (e + 1) % 3];
+            if (a > b) { unsigned int tmp = a; a = b; b = tmp; }
+            edges[count++] = ((uint64_t)a << 32) | b;
+        }
+    }
+
+    qsort(edges, count, sizeof(uint64_t), compare_u64);
+
+    unsigned int unique = 0;
+    for (unsigned int i = 0; i < count;) {
+        unsigned int j = i + 1;
+        while (j < count && edges[j] == edges[i]) j++;
+        if (is_border) is_border[unique] = (j - i) == 1;
+        edges[unique++] = edges[i];
+        i = j;
+    }
+    return unique;
+}
+
+// Collect the seam edges of all live triangles, sorted: edges shared by
+// triangles that use different attribute vertices (UV or normal seams).
+// Returns the number of seam edges.
+static unsigned int collect_seams(uint64_t* seams, const unsigned int* tris, const unsigned int* corners,
+                                  const unsigned char* dead, unsigned int tri_count) {
+    EdgeWedges* list = malloc(tri_count * 3 * sizeof(EdgeWedges));
+    unsigned int count = 0;
+    for (unsigned int t = 0; t < tri_count; t++) {
+        if (dead[t]) continue;
+        for (int e = 0; e < 3; e++) {
+            unsigned int a = tris[t * 3 + e], b = tris[t * 3 + (e + 1) % 3];
+            unsigned int wa = corners[t * 3 + e], wb = corners[t * 3 + (e + 1) % 3];
+            if (a > b) {
+                unsigned int tmp = a; a = b; b = tmp;
+                tmp = wa; wa = wb; wb = tmp;
+            }
+            list[count].key = ((uint64_t)a << 32) | b;
+            list[count].wedges = ((uint64_t)wa << 32) | wb;
+            count++;
+        }
+    }
+
+    qsort(list, count, sizeof(EdgeWedges), compare_edge_wedges);
+
+    unsigned int seam_count = 0;
+    for (unsigned int i = 0; i < count;) {
+        unsigned int j = i + 1;
+        while (j < count && list[j].key == list[i].key) j++;
+        if (list[j - 1].wedges != list[i].wedges) seams[seam_count++] = list[i].key;
+        i = j;
+    }
+
+    free(list);
+    return seam_count;
+}
+
+// Attribute vertex that a corner at from with attribute vertex wedge takes
+// when from collapses onto to: the one at to across a triangle that dies in
+// the collapse, on the same side of any seam. Returns false if no dying
+// triangle is on that side or the dying triangles disagree.
+static bool collapse_wedge(unsigned int* out, const unsigned int* tris, const unsigned int* corners,
+                           const unsigned char* dead, const unsigned int* adj_offsets,
+                           const unsigned int* adj, unsigned int from, unsigned int to,
+                           unsigned int wedge) {
+    bool found = false;
+    for (unsigned int i = adj_offsets[from]; i < adj_offsets[from + 1]; i++) {
+        unsigned int t = adj[i];
+        if (dead[t]) continue;
+
+        int k_from = -1, k_to = -1;
+        for (int k = 0; k < 3; k++) {
+            if (tris[t * 3 + k] == from) k_from = k;
+            if (tris[t * 3 + k] == to) k_to = k;
+        }
+        if (k_to < 0 || corners[t * 3 + k_from] != wedge) continue;
+
+        unsigned int target = corners[t * 3 + k_to];
+        if (found && target != *out) return false;
+        *out = target;
+        found = true;
+    }
+    return found;
+}
+
+// Reject collapses that would tear a seam: every surviving corner at from
+// must find its side's attribute vertex at to
+static int collapse_tears_seam(const unsigned int* tris, const unsigned int* corners,
+                               const unsigned char* dead, const unsigned int* adj_offsets,
+                               const unsigned int* adj, unsigned int from, unsigned int to) {
+    for (unsigned int i = adj_offsets[from]; i < adj_offsets[from + 1]; i++) {
+        unsigned int t = adj[i];
+        if (dead[t]) continue;
+
+        const unsigned int* tri = tris + t * 3;
+        if (tri[0] == to || tri[1] == to || tri[2] == to) continue;
+
+        for (int k = 0; k < 3; k++) {
+            unsigned int target;
+            if (tri[k] == from &&
+                !collapse_wedge(&target, tris, corners, dead, adj_offsets, adj, from, to, corners[t * 3 + k])) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// Reject collapses that flip or degenerate any surviving triangle around from
+static int collapse_flips(const unsigned int* tris, const unsigned char* dead,
+                          const unsigned int* adj_offsets, const unsigned int* adj,
+                          const float* vertices, unsigned int stride,
+                          unsigned int from, unsigned int to) {
+    const float* target = vertices + to * stride;
+
+    for (unsigned int i = adj_offsets[from]; i < adj_offsets[from + 1]; i++) {
+        unsigned int t = adj[i];
+        if (dead[t]) continue;
+
+        const unsigned int* tri = tris + t * 3;
+        if (tri[0] == to || tri[1] == to || tri[2] == to) continue;
+
+        const float* p[3];
+        const float* moved[3];
+        for (int k = 0; k < 3; k++) {
+            p[k] = vertices + tri[k] * stride;
+            moved[k] = (tri[k] == from) ? target : p[k];
+        }
+
+        float n0[3], n1[3];
+        triangle_normal(n0, p[0], p[1], p[2]);
+        triangle_normal(n1, moved[0], moved[1], moved[2]);
+
+        float len0 = sqrtf(n0[0] * n0[0] + n0[1] * n0[1] + n0[2] * n0[2]);
+        float len1 = sqrtf(n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2]);
+        float d = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2];
+
+        if (d < 0.25f * len0 * len1 || len1 == 0.0f) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+unsigned int mesh_simplify(unsigned int* out_indices,
+                           const unsigned int* indices, unsigned int index_count,
+                           const float* vertices, unsigned int vertex_count,
+                           unsigned int stride, unsigned int target_index_count,
+                           float target_error) {
+    unsigned int tri_count = index_count / 3;
+    if (tri_count == 0 || target_index_count >= index_count) {
+        memcpy(out_indices, indices, index_count * sizeof(unsigned int));
+        return index_count;
+    }
+
+    // Positions weld for the geometry; whole vertices weld into the attribute
+    // vertices each corner uses (duplicates of one vertex are not a seam)
+    unsigned int* canonical = malloc(vertex_count * sizeof(unsigned int));
+    unsigned int* wedge = malloc(vertex_count * sizeof(unsigned int));
+    weld_vertices(canonical, vertices, vertex_count, stride, 3);
+    weld_vertices(wedge, vertices, vertex_count, stride, stride);
+
+    // Triangles over welded vertices and the attribute vertex at each corner;
+    // collapses rewrite both in place
+    unsigned int* tris = malloc(tri_count * 3 * sizeof(unsigned int));
+    unsigned int* corners = malloc(tri_count * 3 * sizeof(unsigned int));
+    unsigned char* dead = calloc(tri_count, 1);
+    unsigned int live_tris = 0;
+
+    float bmin[3] = {INFINITY, INFINITY, INFINITY};
+    float bmax[3] = {-INFINITY, -INFINITY, -INFINITY};
+
+    for (unsigned int t = 0; t < tri_count; t++) {
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = canonical[indices[t * 3 + k]];
+            tris[t * 3 + k] = v;
+            corners[t * 3 + k] = wedge[indices[t * 3 + k]];
+            const float* p = vertices + v * stride;
+            for (int c = 0; c < 3; c++) {
+                if (p[c] < bmin[c]) bmin[c] = p[c];
+                if (p[c] > bmax[c]) bmax[c] = p[c];
+            }
+        }
+        const unsigned int* tri = tris + t * 3;
+        if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) {
+            dead[t] = 1;
+        } else {
+            live_tris++;
+        }
+    }
+
+    float extent = fmaxf(bmax[0] - bmin[0], fmaxf(bmax[1] - bmin[1], bmax[2] - bmin[2]));
+    double error_limit = (double)target_error * extent;
+    error_limit *= error_limit;
+
+    // Accumulate area weighted plane quadrics per welded vertex
+    Quadric* quadrics = calloc(vertex_count, sizeof(Quadric));
+    for (unsigned int t = 0; t < tri_count; t++) {
+        if (dead[t]) continue;
+        const unsigned int* tri = tris + t * 3;
+        const float* p0 = vertices + tri[0] * stride;
+        float n[3];
+        triangle_normal(n, p0, vertices + tri[1] * stride, vertices + tri[2] * stride);
+
+        float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (len == 0.0f) continue;
+        n[0] /= len; n[1] /= len; n[2] /= len;
+
+        Quadric q;
+        double d = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+        quadric_from_plane(&q, n[0], n[1], n[2], d, len * 0.5);
+        for (int k = 0; k < 3; k++) {
+            quadric_add(&quadrics[tri[k]], &q);
+        }
+    }
+
+    uint64_t* edges = malloc(tri_count * 3 * sizeof(uint64_t));
+    unsigned char* is_border = malloc(tri_count * 3);
+    uint64_t* seams = malloc(tri_count * 3 * sizeof(uint64_t));
+
+    // Border and seam edges: plane through the edge, perpendicular to its triangle(s)
+    unsigned int edge_count = collect_edges(edges, is_border, tris, dead, tri_count);
+    unsigned int seam_count = collect_seams(seams, tris, corners, dead, tri_count);
+    for (unsigned int t = 0; t < tri_count; t++) {
+        if (dead[t]) continue;
+        const unsigned int* tri = tris + t * 3;
+        for (int e = 0; e < 3; e++) {
+            unsigned int a = tri[e], b = tri[(e + 1) % 3];
+            uint64_t key = a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+            uint64_t* found = bsearch(&key, edges, edge_count, sizeof(uint64_t), compare_u64);
+            bool border = found && is_border[found - edges];
+            if (!border && !bsearch(&key, seams, seam_count, sizeof(uint64_t), compare_u64)) continue;
+
+            const float* pa = vertices + a * stride;
+            const float* pb = vertices + b * stride;
+            float n[3];
+            triangle_normal(n, pa, pb, vertices + tri[(e + 2) % 3] * stride);
+
+            float dir[3] = {pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2]};
+            float pn[3] = {
+                dir[1] * n[2] - dir[2] * n[1],
+                dir[2] * n[0] - dir[0] * n[2],
+                dir[0] * n[1] - dir[1] * n[0]
+            };
+            float len = sqrtf(pn[0] * pn[0] + pn[1] * pn[1] + pn[2] * pn[2]);
+            if (len == 0.0f) continue;
+            pn[0] /= len; pn[1] /= len; pn[2] /= len;
+
+            float edge_len2 = dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2];
+            Quadric q;
+            double d = -(pn[0] * pa[0] + pn[1] * pa[1] + pn[2] * pa[2]);
+            quadric_from_plane(&q, pn[0], pn[1], pn[2], d, BORDER_WEIGHT * edge_len2);
+            quadric_add(&quadrics[a], &q);
+            quadric_add(&quadrics[b], &q);
+        }
+    }
+
+    unsigned int* adj_offsets = malloc((vertex_count + 1) * sizeof(unsigned int));
+    unsigned int* adj = malloc(tri_count * 3 * sizeof(unsigned int));
+    Collapse* collapses = malloc(tri_count * 3 * 2 * sizeof(Collapse));
+    unsigned char* locked = malloc(vertex_count);
+
+    unsigned int target_tris = target_index_count / 3;
+
+    // Each pass collapses the cheapest independent edges, then rebuilds
+    while (live_tris > target_tris) {
+        // Vertex -> triangle adjacency
+        memset(adj_offsets, 0, (vertex_count + 1) * sizeof(unsigned int));
+        for (unsigned int t = 0; t < tri_count; t++) {
+            if (dead[t]) continue;
+            for (int k = 0; k < 3; k++) adj_offsets[tris[t * 3 + k] + 1]++;
+        }
+        for (unsigned int v = 0; v < vertex_count; v++) adj_offsets[v + 1] += adj_offsets[v];
+        for (unsigned int t = 0; t < tri_count; t++) {
+            if (dead[t]) continue;
+            for (int k = 0; k < 3; k++) adj[adj_offsets[tris[t * 3 + k]]++] = t;
+        }
+        for (unsigned int v = vertex_count; v > 0; v--) adj_offsets[v] = adj_offsets[v - 1];
+        adj_offsets[0] = 0;
+
+        // Both directions are candidates: seams may allow only one of them
+        edge_count = collect_edges(edges, NULL, tris, dead, tri_count);
+        for (unsigned int e = 0; e < edge_count; e++) {
+            unsigned int a = (unsigned int)(edges[e] >> 32);
+            unsigned int b = (unsigned int)(edges[e] & 0xffffffffu);
+
+            Quadric q = quadrics[a];
+            quadric_add(&q, &quadrics[b]);
+
+            collapses[e * 2].cost = (float)quadric_error(&q, vertices + b * stride);
+            collapses[e * 2].from = a;
+            collapses[e * 2].to = b;
+            collapses[e * 2 + 1].cost = (float)quadric_error(&q, vertices + a * stride);
+            collapses[e * 2 + 1].from = b;
+            collapses[e * 2 + 1].to = a;
+        }
+        qsort(collapses, edge_count * 2, sizeof(Collapse), compare_collapse);
+
+        memset(locked, 0, vertex_count);
+        unsigned int performed = 0;
+
+        for (unsigned int e = 0; e < edge_count * 2 && live_tris > target_tris; e++) {
+            const Collapse* c = &collapses[e];
+            if (c->cost > error_limit) break;
+            if (locked[c->from] || locked[c->to]) continue;
+            if (collapse_tears_seam(tris, corners, dead, adj_offsets, adj, c->from, c->to)) continue;
+            if (collapse_flips(tris, dead, adj_offsets, adj, vertices, stride, c->from, c->to)) continue;
+
+            quadric_add(&quadrics[c->to], &quadrics[c->from]);
+            locked[c->from] = 1;
+            locked[c->to] = 1;
+
+            // Surviving corners take their side's attributes at to, while the
+            // triangles that die with the edge are still there to look them up
+            for (unsigned int i = adj_offsets[c->from]; i < adj_offsets[c->from + 1]; i++) {
+                unsigned int t = adj[i];
+                if (dead[t]) continue;
+
+                unsigned int* tri = tris + t * 3;
+                if (tri[0] == c->to || tri[1] == c->to || tri[2] == c->to) continue;
+                for (int k = 0; k < 3; k++) {
+                    if (tri[k] == c->from) {
+                        collapse_wedge(&corners[t * 3 + k], tris, corners, dead, adj_offsets, adj,
+                                       c->from, c->to, corners[t * 3 + k]);
+                    }
+                }
+            }
+
+            for (unsigned int i = adj_offsets[c->from]; i < adj_offsets[c->from + 1]; i++) {
+                unsigned int t = adj[i];
+                if (dead[t]) continue;
+
+                unsigned int* tri = tris + t * 3;
+                for (int k = 0; k < 3; k++) {
+                    if (tri[k] == c->from) tri[k] = c->to;
+                }
+                if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) {
+                    dead[t] = 1;
+                    live_tris--;
+                }
+            }
+            performed++;
+        }
+
+        if (performed == 0) break;
+    }
+
+    // Corners reference the attribute vertices they ended up with
+    unsigned int out_count = 0;
+    for (unsigned int t = 0; t < tri_count; t++) {
+        if (dead[t]) continue;
+        for (int k = 0; k < 3; k++) {
+            out_indices[out_count++] = corners[t * 3 + k];
+        }
+    }
+
+    free(locked);
+    free(collapses);
+    free(adj);
+    free(adj_offsets);
+    free(seams);
+    free(is_border);
+    free(edges);
+    free(quadrics);
+    free(dead);
+    free(corners);
+    free(tris);
+    free(wedge);
+    free(canonical);
+
+    return out_count;
+}
+
+unsigned int mesh_compact_vertices(float* out_vertices, unsigned int* indices,
+                                   unsigned int index_count, const float* vertices,
+                                   unsigned int vertex_count, unsigned int stride) {
+    unsigned int* remap = malloc(vertex_count * sizeof(unsigned int));
+    memset(remap, 0xff, vertex_count * sizeof(unsigned int));
+
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < index_count; i++) {
+        unsigned int v = indices[i];
+        if (remap[v] == UINT32_MAX) {
+            remap[v] = count;
+            memcpy(out_vertices + count * stride, vertices + v * stride, stride * sizeof(float));
+            count++;
+        }
+        indices[i] = remap[v];
+    }
+
+    free(remap);
+    return count;
+}
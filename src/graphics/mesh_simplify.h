@@ -0,0 +1,33 @@
+#ifndef MESH_SIMPLIFY_H
+#define MESH_SIMPLIFY_H
+
+// Quadric error metric mesh simplification (Garland & Heckbert)
+//
+// Works on indexed triangle lists with interleaved vertices whose first three
+// floats are the position. Vertices sharing a position are welded internally,
+// so unindexed "one vertex per corner" meshes simplify as well.
+//
+// Collapses are half-edge collapses onto existing vertices, so the output
+// indices always reference vertices of the input buffer. Vertices that share
+// a position but differ in other attributes mark a seam (UV island edges,
+// hard normal edges): seams are weighted like open borders, and a collapse
+// is only taken if every corner around the removed vertex finds a vertex on
+// its own side of the seam, so texture and shading discontinuities survive.
+
+// Simplify towards target_index_count. Collapses whose error exceeds
+// target_error (relative to the mesh extent) are not performed.
+// out_indices must hold index_count entries. Returns the new index count.
+unsigned int mesh_simplify(unsigned int* out_indices,
+                           const unsigned int* indices, unsigned int index_count,
+                           const float* vertices, unsigned int vertex_count,
+                           unsigned int stride, unsigned int target_index_count,
+                           float target_error);
+
+// Drop vertices not referenced by indices. Rewrites indices in place and
+// writes the packed vertices to out_vertices (vertex_count * stride floats).
+// Returns the new vertex count.
+unsigned int mesh_compact_vertices(float* out_vertices, unsigned int* indices,
+                                   unsigned int index_count, const float* vertices,
+                                   unsigned int vertex_count, unsigned int stride);
+
+#endif // MESH_SIMPLIFY_H
@@ -0,0 +1,212 @@
+#include "render_queue.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#define INITIAL_PACKET_CAPACITY 256
+
+uint64_t render_queue_make_key(RenderPass pass, GLuint shader, const Material* material,
+                               GLuint vao, float depth01) {
+    if (depth01 < 0.0f) depth01 = 0.0f;
+    if (depth01 > 1.0f) depth01 = 1.0f;
+    uint64_t depth = (uint64_t)(depth01 * (float)0xFFFFF);
+
+    // Materials are grouped by address; collisions only cost an extra bind
+    uint64_t material_bits = ((uint64_t)(uintptr_t)material >> 4) & 0xFFFF;
+
+    uint64_t key = (uint64_t)(pass & 0x3) << 62;
+    if (pass == RENDER_PASS_TRANSPARENT) {
+        key |= (0xFFFFF - depth) << 42;
+        key |= (uint64_t)(shader & 0x3FF) << 32;
+        key |= material_bits << 16;
+        key |= (uint64_t)(vao & 0xFFFF);
+    } else {
+        key |= (uint64_t)(shader & 0x3FF) << 52;
+        key |= material_bits << 36;
+        key |= (uint64_t)(vao & 0xFFFF) << 20;
+        key |= depth;
+    }
+    return key;
+}
+
+RenderQueue* render_queue_create(void) {
+    RenderQueue* queue = malloc(sizeof(RenderQueue));
+    memset(queue, 0, sizeof(RenderQueue));
+
+    queue->packet_capacity = INITIAL_PACKET_CAPACITY;
+    queue->packets = malloc(sizeof(RenderPacket) * queue->packet_capacity);
+    queue->default_material = material_create_default();
+
+    return queue;
+}
+
+void render_queue_begin(RenderQueue* queue) {
+    queue->packet_count = 0;
+    memset(&queue->stats, 0, sizeof(RenderStats));
+}
+
+void render_queue_push(RenderQueue* queue, const RenderPacket* packet) {
+    if (queue->packet_count >= queue->packet_capacity) {
+        queue->packet_capacity *= 2;
+        queue->packets = realloc(queue->packets, sizeof(RenderPacket) * queue->packet_capacity);
+    }
+    queue->packets[queue->packet_count++] = *packet;
+}
+
+// LSD radix sort of (key, index) pairs, 8 bits per pass. Passes where every
+// key has the same byte are skipped, which is most of them in practice.
+// Returns the buffer index holding the sorted result.
+static int render_queue_radix_sort(RenderQueue* queue) {
+    unsigned int n = queue->packet_count;
+
+    if (n > queue->sort_capacity) {
+        queue->sort_capacity = queue->packet_capacity;
+        for (int b = 0; b < 2; b++) {
+            queue->sort_keys[b] = realloc(queue->sort_keys[b], sizeof(uint64_t) * queue->sort_capacity);
+            queue->sort_indices[b] = realloc(queue->sort_indices[b], sizeof(uint32_t) * queue->sort_capacity);
+        }
+    }
+
+    for (unsigned int i = 0; i < n; i++) {
+        queue->sort_keys[0][i] = queue->packets[i].key;
+        queue->sort_indices[0][i] = i;
+    }
+
+    int src = 0;
+    for (int shift = 0; shift < 64; shift += 8) {
+        unsigned int histogram[256] = {0};
+        for (unsigned int i = 0; i < n; i++) {
+            histogram[(queue->sort_keys[src][i] >> shift) & 0xFF]++;
+        }
+
+        // All keys share this byte: order is unchanged
+        if (histogram[(queue->sort_keys[src][0] >> shift) & 0xFF] == n) continue;
+
+        unsigned int offset = 0;
+        for (int b = 0; b < 256; b++) {
+            unsigned int count = histogram[b];
+            histogram[b] = offset;
+            offset += count;
+        }
+
+        int dst = src ^ 1;
+        for (unsigned int i = 0; i < n; i++) {
+            uint64_t key = queue->sort_keys[src][i];
+            unsigned int pos = histogram[(key >> shift) & 0xFF]++;
+            queue->sort_keys[dst][pos] = key;
+            queue->sort_indices[dst][pos] = queue->sort_indices[src][i];
+        }
+        src = dst;
+    }
+
+    return src;
+}
+
+void render_queue_submit(RenderQueue* queue) {
+    if (queue->packet_count == 0) return;
+
+    int sorted = render_queue_radix_sort(queue);
+    const uint32_t* order = queue->sort_indices[sorted];
+
+    Shader* current_shader = NULL;
+    GLuint current_vao = 0;
+    const Material* current_material = NULL;
+    const VertexDecode* current_decode = NULL;
+    GLuint bound_textures[2] = {0, 0};
+
+    // Handles of the bound program, resolved once per program switch
+    ShaderUniform transform_uniform = SHADER_UNIFORM_NONE;
+    ShaderUniform ambient_uniform = SHADER_UNIFORM_NONE, diffuse_uniform = SHADER_UNIFORM_NONE;
+    ShaderUniform specular_uniform = SHADER_UNIFORM_NONE, shininess_uniform = SHADER_UNIFORM_NONE;
+    ShaderUniform has_diffuse_uniform = SHADER_UNIFORM_NONE, has_specular_uniform = SHADER_UNIFORM_NONE;
+    ShaderUniform position_offset_uniform = SHADER_UNIFORM_NONE, position_scale_uniform = SHADER_UNIFORM_NONE;
+    ShaderUniform normal_scale_uniform = SHADER_UNIFORM_NONE;
+
+    for (unsigned int i = 0; i < queue->packet_count; i++) {
+        const RenderPacket* packet = &queue->packets[order[i]];
+        const Material* mat = packet->material ? packet->material : &queue->default_material;
+
+        if (packet->shader != current_shader) {
+            current_shader = packet->shader;
+            current_material = NULL;
+            current_decode = NULL;
+            shader_use(current_shader);
+            queue->stats.shader_binds++;
+
+            // Camera and light come from FrameData; only samplers are per program
+            shader_set_int(current_shader, "diffuse_map", 0);
+            shader_set_int(current_shader, "specular_map", 1);
+
+            transform_uniform = shader_uniform(current_shader, "transform");
+            ambient_uniform = shader_uniform(current_shader, "material_ambient");
+            diffuse_uniform = shader_uniform(current_shader, "material_diffuse");
+            specular_uniform = shader_uniform(current_shader, "material_specular");
+            shininess_uniform = shader_uniform(current_shader, "material_shininess");
+            has_diffuse_uniform = shader_uniform(current_shader, "has_diffuse_map");
+            has_specular_uniform = shader_uniform(current_shader, "has_specular_map");
+            position_offset_uniform = shader_uniform(current_shader, "position_offset");
+            position_scale_uniform = shader_uniform(current_shader, "position_scale");
+            normal_scale_uniform = shader_uniform(current_shader, "normal_scale");
+        }
+
+        if (mat != current_material) {
+            current_material = mat;
+            queue->stats.material_binds++;
+
+            shader_uniform_vec3v(current_shader, ambient_uniform, mat->ambient);
+            shader_uniform_vec3v(current_shader, diffuse_uniform, mat->diffuse);
+            shader_uniform_vec3v(current_shader, specular_uniform, mat->specular);
+            shader_uniform_float(current_shader, shininess_uniform, mat->shininess);
+            shader_uniform_int(current_shader, has_diffuse_uniform, mat->diffuse_map ? 1 : 0);
+            shader_uniform_int(current_shader, has_specular_uniform, mat->specular_map ? 1 : 0);
+
+            // Only touch texture units whose binding actually changes
+            GLuint wanted[2] = {mat->diffuse_map, mat->specular_map};
+            for (int unit = 0; unit < 2; unit++) {
+                if (wanted[unit] && wanted[unit] != bound_textures[unit]) {
+                    glActiveTexture(GL_TEXTURE0 + unit);
+                    glBindTexture(GL_TEXTURE_2D, wanted[unit]);
+                    bound_textures[unit] = wanted[unit];
+                    queue->stats.texture_binds++;
+                }
+            }
+        }
+
+        if (packet->vao != current_vao) {
+            current_vao = packet->vao;
+            glBindVertexArray(current_vao);
+            queue->stats.vao_binds++;
+        }
+
+        if (packet->decode != current_decode) {
+            current_decode = packet->decode;
+            shader_uniform_vec3v(current_shader, position_offset_uniform, current_decode->offset);
+            shader_uniform_vec3v(current_shader, position_scale_uniform, current_decode->scale);
+            shader_uniform_float(current_shader, normal_scale_uniform, current_decode->normal_scale);
+        }
+
+        shader_uniform_mat4(current_shader, transform_uniform, packet->transform);
+        glDrawElements(GL_TRIANGLES, packet->index_count, packet->index_type, 0);
+        queue->stats.draw_calls++;
+    }
+
+    // Leave clean state for the passes that follow
+    for (int unit = 1; unit >= 0; unit--) {
+        if (bound_textures[unit]) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+    }
+    glBindVertexArray(0);
+}
+
+void render_queue_free(RenderQueue* queue) {
+    if (!queue) return;
+
+    free(queue->packets);
+    for (int b = 0; b < 2; b++) {
+        free(queue->sort_keys[b]);
+        free(queue->sort_indices[b]);
+    }
+    free(queue);
+}
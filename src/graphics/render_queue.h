@@ -0,0 +1,76 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glad/glad.h>
+#include <stdint.h>
+#include "../entities/material.h"
+#include "shader.h"
+#include "vertex_format.h"
+
+// Passes in submission order (top bits of the sort key)
+typedef enum {
+    RENDER_PASS_OPAQUE = 0,
+    RENDER_PASS_ALPHA_TESTED = 1,
+    RENDER_PASS_TRANSPARENT = 2
+} RenderPass;
+
+// One indexed draw with everything needed to submit it
+typedef struct {
+    uint64_t key;
+    Shader* shader;
+    GLuint vao;
+    unsigned int index_count;
+    GLenum index_type;          // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    const Material* material;   // NULL = default material
+    const float* transform;     // Must stay valid until the queue is submitted
+    const VertexDecode* decode; // Vertex layout decode (the mesh's), must stay valid too
+} RenderPacket;
+
+// Per-frame counters (reset by render_queue_begin)
+typedef struct {
+    unsigned int draw_calls;
+    unsigned int shader_binds;
+    unsigned int material_binds;
+    unsigned int texture_binds;
+    unsigned int vao_binds;
+} RenderStats;
+
+typedef struct {
+    RenderPacket* packets;
+    unsigned int packet_count;
+    unsigned int packet_capacity;
+
+    // Radix sort buffers (key + packet index pairs)
+    uint64_t* sort_keys[2];
+    uint32_t* sort_indices[2];
+    unsigned int sort_capacity;
+
+    Material default_material;
+
+    RenderStats stats;
+} RenderQueue;
+
+// Sort key layout, most significant first:
+//   pass (2) | shader (10) | material (16) | mesh (16) | depth (20)
+// Opaque passes sort front to back inside a mesh group to help early-z.
+// The transparent pass puts inverted depth right after the pass bits so it
+// draws back to front regardless of state.
+uint64_t render_queue_make_key(RenderPass pass, GLuint shader, const Material* material,
+                               GLuint vao, float depth01);
+
+RenderQueue* render_queue_create(void);
+
+// Start a new frame: drop queued packets and reset stats
+void render_queue_begin(RenderQueue* queue);
+
+// Queue a draw (copied into the queue)
+void render_queue_push(RenderQueue* queue, const RenderPacket* packet);
+
+// Radix sort packets by key and submit them, skipping redundant binds.
+// Camera and light are read from the FrameData block, so the frame's
+// FrameData must be bound; uniform uploads go through the shader's value cache.
+void render_queue_submit(RenderQueue* queue);
+
+void render_queue_free(RenderQueue* queue);
+
+#endif // RENDER_QUEUE_H
@@ -1,5 +1,8 @@
 #include "shader.h"
+#include "frame_data.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 
 static void check_compile_errors(GLuint shader, const char* type) {
@@ -59,36 +62,215 @@ GLuint shader_compile(const char* vertex_src, const char* fragment_src) {
     return program;
 }
 
-Shader shader_create(const char* vertex_src, const char* fragment_src) {
-    GLuint program = shader_compile(vertex_src, fragment_src);
-    
+static uint32_t shader_hash_name(const char* name) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static unsigned int shader_table_size_for(unsigned int count) {
+    unsigned int size = 8;
+    while (size < count * 2) size *= 2;
+    return size;
+}
+
+// Build an open-addressed table over entries carrying their hash at hash_offset
+static int* shader_build_table(unsigned int count, unsigned int table_size,
+                               const void* entries, size_t stride, size_t hash_offset) {
+    int* table = malloc(sizeof(int) * table_size);
+    for (unsigned int i = 0; i < table_size; i++) table[i] = -1;
+
+    for (unsigned int i = 0; i < count; i++) {
+        uint32_t hash;
+        memcpy(&hash, (const char*)entries + i * stride + hash_offset, sizeof(hash));
+        unsigned int slot = hash & (table_size - 1);
+        while (table[slot] != -1) slot = (slot + 1) & (table_size - 1);
+        table[slot] = (int)i;
+    }
+    return table;
+}
+
+static void shader_reflect(Shader* shader) {
+    GLuint program = shader->program;
+    GLint count = 0;
+
+    // Plain uniforms (block members have no location and are skipped)
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    shader->uniforms = malloc(sizeof(ShaderUniformInfo) * (count > 0 ? count : 1));
+    shader->uniform_count = 0;
+
+    for (GLint i = 0; i < count; i++) {
+        ShaderUniformInfo* info = &shader->uniforms[shader->uniform_count];
+        memset(info, 0, sizeof(ShaderUniformInfo));
+
+        GLsizei length = 0;
+        glGetActiveUniform(program, (GLuint)i, sizeof(info->name), &length,
+                           &info->array_size, &info->type, info->name);
+
+        char* bracket = strchr(info->name, '[');
+        if (bracket) *bracket = '\0';
+
+        info->location = glGetUniformLocation(program, info->name);
+        if (info->location < 0) continue;
+
+        info->hash = shader_hash_name(info->name);
+        shader->uniform_count++;
+    }
+
+    // Uniform blocks
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    shader->blocks = malloc(sizeof(ShaderBlockInfo) * (count > 0 ? count : 1));
+    shader->block_count = (unsigned int)(count > 0 ? count : 0);
+
+    for (unsigned int i = 0; i < shader->block_count; i++) {
+        ShaderBlockInfo* info = &shader->blocks[i];
+        memset(info, 0, sizeof(ShaderBlockInfo));
+
+        glGetActiveUniformBlockName(program, i, sizeof(info->name), NULL, info->name);
+        glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_DATA_SIZE, &info->data_size);
+        info->index = i;
+        info->hash = shader_hash_name(info->name);
+    }
+
+    shader->uniform_table_size = shader_table_size_for(shader->uniform_count);
+    shader->uniform_table = shader_build_table(shader->uniform_count, shader->uniform_table_size,
+                                               shader->uniforms, sizeof(ShaderUniformInfo),
+                                               offsetof(ShaderUniformInfo, hash));
+    shader->block_table_size = shader_table_size_for(shader->block_count);
+    shader->block_table = shader_build_table(shader->block_count, shader->block_table_size,
+                                             shader->blocks, sizeof(ShaderBlockInfo),
+                                             offsetof(ShaderBlockInfo, hash));
+}
+
+Shader shader_create(const char* vertex_src, const char* fragment_src, const char* name) {
     Shader shader;
-    shader.program = program;
-    strncpy(shader.name, "shader", sizeof(shader.name) - 1);
+    memset(&shader, 0, sizeof(Shader));
+
+    shader.program = shader_compile(vertex_src, fragment_src);
+    strncpy(shader.name, name ? name : "shader", sizeof(shader.name) - 1);
+
+    shader_reflect(&shader);
+
+    // Programs that declare the shared per-frame block read it from its fixed binding
+    GLuint frame_block = shader_block_index(&shader, FRAME_DATA_BLOCK_NAME);
+    if (frame_block != GL_INVALID_INDEX) {
+        glUniformBlockBinding(shader.program, frame_block, FRAME_DATA_BINDING);
+        if (shader.blocks[frame_block].data_size != (GLint)sizeof(FrameData)) {
+            fprintf(stderr, "Shader '%s': %s block is %d bytes, expected %d\n", shader.name,
+                    FRAME_DATA_BLOCK_NAME, shader.blocks[frame_block].data_size, (int)sizeof(FrameData));
+        }
+    }
+    printf("Shader '%s': %u uniforms, %u blocks\n", shader.name, shader.uniform_count, shader.block_count);
 
     return shader;
 }
 
 void shader_destroy(Shader* shader) {
-    glDeleteProgram(shader->program);
+    if (shader->program) glDeleteProgram(shader->program);
+    free(shader->uniforms);
+    free(shader->blocks);
+    free(shader->uniform_table);
+    free(shader->block_table);
+    memset(shader, 0, sizeof(Shader));
 }
 
-void shader_use(Shader* shader) {
+void shader_use(const Shader* shader) {
     glUseProgram(shader->program);
 }
 
+ShaderUniform shader_uniform(const Shader* shader, const char* name) {
+    if (!shader->uniform_table) return SHADER_UNIFORM_NONE;
+
+    uint32_t hash = shader_hash_name(name);
+    unsigned int mask = shader->uniform_table_size - 1;
+    for (unsigned int slot = hash & mask; shader->uniform_table[slot] != -1; slot = (slot + 1) & mask) {
+        const ShaderUniformInfo* info = &shader->uniforms[shader->uniform_table[slot]];
+        if (info->hash == hash && strcmp(info->name, name) == 0) {
+            return (ShaderUniform){shader->uniform_table[slot]};
+        }
+    }
+    return SHADER_UNIFORM_NONE;
+}
+
+GLint shader_uniform_location(const Shader* shader, ShaderUniform uniform) {
+    if (uniform.index < 0) return -1;
+    return shader->uniforms[uniform.index].location;
+}
+
+GLuint shader_block_index(const Shader* shader, const char* name) {
+    if (!shader->block_table) return GL_INVALID_INDEX;
+
+    uint32_t hash = shader_hash_name(name);
+    unsigned int mask = shader->block_table_size - 1;
+    for (unsigned int slot = hash & mask; shader->block_table[slot] != -1; slot = (slot + 1) & mask) {
+        const ShaderBlockInfo* info = &shader->blocks[shader->block_table[slot]];
+        if (info->hash == hash && strcmp(info->name, name) == 0) {
+            return info->index;
+        }
+    }
+    return GL_INVALID_INDEX;
+}
+
+// Returns the uniform if value differs from the cached upload (and caches it)
+static ShaderUniformInfo* shader_uniform_changed(Shader* shader, ShaderUniform uniform,
+                                                 const void* value, size_t size) {
+    if (uniform.index < 0) return NULL;
+
+    ShaderUniformInfo* info = &shader->uniforms[uniform.index];
+    if (info->has_value && memcmp(info->value, value, size) == 0) return NULL;
+
+    memcpy(info->value, value, size);
+    info->has_value = true;
+    return info;
+}
+
+void shader_uniform_int(Shader* shader, ShaderUniform uniform, int value) {
+    ShaderUniformInfo* info = shader_uniform_changed(shader, uniform, &value, sizeof(value));
+    if (info) glUniform1i(info->location, value);
+}
+
+void shader_uniform_float(Shader* shader, ShaderUniform uniform, float value) {
+    ShaderUniformInfo* info = shader_uniform_changed(shader, uniform, &value, sizeof(value));
+    if (info) glUniform1f(info->location, value);
+}
+
+void shader_uniform_vec2(Shader* shader, ShaderUniform uniform, float x, float y) {
+    float value[2] = {x, y};
+    ShaderUniformInfo* info = shader_uniform_changed(shader, uniform, value, sizeof(value));
+    if (info) glUniform2fv(info->location, 1, value);
+}
+
+void shader_uniform_vec3(Shader* shader, ShaderUniform uniform, float x, float y, float z) {
+    float value[3] = {x, y, z};
+    shader_uniform_vec3v(shader, uniform, value);
+}
+
+void shader_uniform_vec3v(Shader* shader, ShaderUniform uniform, const float* value) {
+    ShaderUniformInfo* info = shader_uniform_changed(shader, uniform, value, sizeof(float) * 3);
+    if (info) glUniform3fv(info->location, 1, value);
+}
+
+void shader_uniform_mat4(Shader* shader, ShaderUniform uniform, const float* matrix) {
+    ShaderUniformInfo* info = shader_uniform_changed(shader, uniform, matrix, sizeof(float) * 16);
+    if (info) glUniformMatrix4fv(info->location, 1, GL_FALSE, matrix);
+}
+
 void shader_set_int(Shader* shader, const char* name, int value) {
-    glUniform1i(glGetUniformLocation(shader->program, name), value);
+    shader_uniform_int(shader, shader_uniform(shader, name), value);
 }
 
 void shader_set_float(Shader* shader, const char* name, float value) {
-    glUniform1f(glGetUniformLocation(shader->program, name), value);
+    shader_uniform_float(shader, shader_uniform(shader, name), value);
 }
 
 void shader_set_vec3(Shader* shader, const char* name, float x, float y, float z) {
-    glUniform3f(glGetUniformLocation(shader->program, name), x, y, z);
+    shader_uniform_vec3(shader, shader_uniform(shader, name), x, y, z);
 }
 
 void shader_set_mat4(Shader* shader, const char* name, float* matrix) {
-    glUniformMatrix4fv(glGetUniformLocation(shader->program, name), 1, GL_FALSE, matrix);
+    shader_uniform_mat4(shader, shader_uniform(shader, name), matrix);
 }
@@ -2,19 +2,77 @@
 #define SHADER_H
 
 #include <glad/glad.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 // Compile and link shader program from source strings
 GLuint shader_compile(const char* vertex_src, const char* fragment_src);
 
-// Shader wrapper structure (for future use)
+// Active uniform reflected at link time. Plain (non-block) uniforms keep the
+// last value uploaded through the handle setters so repeats can be skipped.
+typedef struct {
+    char name[64];          // Array uniforms are stored without the "[0]"
+    uint32_t hash;
+    GLint location;
+    GLenum type;
+    GLint array_size;
+    bool has_value;
+    float value[16];        // Last upload (ints are stored bitwise)
+} ShaderUniformInfo;
+
+// Active uniform block reflected at link time
+typedef struct {
+    char name[64];
+    uint32_t hash;
+    GLuint index;
+    GLint data_size;
+} ShaderBlockInfo;
+
+// Resolved uniform: an index into the shader's reflection table.
+// Resolve once with shader_uniform() and keep it; -1 means not active.
+typedef struct {
+    int index;
+} ShaderUniform;
+
+#define SHADER_UNIFORM_NONE ((ShaderUniform){-1})
+
 typedef struct {
     GLuint program;
     char name[64];
+
+    ShaderUniformInfo* uniforms;
+    unsigned int uniform_count;
+    ShaderBlockInfo* blocks;
+    unsigned int block_count;
+
+    // Open-addressed name hash tables (power of two sizes), -1 = empty
+    int* uniform_table;
+    unsigned int uniform_table_size;
+    int* block_table;
+    unsigned int block_table_size;
 } Shader;
 
-Shader shader_create(const char* vertex_src, const char* fragment_src);
+// Compile, link and reflect. name is only used for log messages.
+// A FrameData block, if declared, is bound to FRAME_DATA_BINDING.
+Shader shader_create(const char* vertex_src, const char* fragment_src, const char* name);
 void shader_destroy(Shader* shader);
-void shader_use(Shader* shader);
+void shader_use(const Shader* shader);
+
+// Lookups (hashed, meant for init time)
+ShaderUniform shader_uniform(const Shader* shader, const char* name);
+GLint shader_uniform_location(const Shader* shader, ShaderUniform uniform);
+GLuint shader_block_index(const Shader* shader, const char* name);  // GL_INVALID_INDEX if missing
+
+// Handle setters. The program must be bound; inactive handles are ignored and
+// values equal to the last upload through these setters are skipped.
+void shader_uniform_int(Shader* shader, ShaderUniform uniform, int value);
+void shader_uniform_float(Shader* shader, ShaderUniform uniform, float value);
+void shader_uniform_vec2(Shader* shader, ShaderUniform uniform, float x, float y);
+void shader_uniform_vec3(Shader* shader, ShaderUniform uniform, float x, float y, float z);
+void shader_uniform_vec3v(Shader* shader, ShaderUniform uniform, const float* value);
+void shader_uniform_mat4(Shader* shader, ShaderUniform uniform, const float* matrix);
+
+// Name-based convenience setters (hash lookup per call, avoid in loops)
 void shader_set_int(Shader* shader, const char* name, int value);
 void shader_set_float(Shader* shader, const char* name, float value);
 void shader_set_vec3(Shader* shader, const char* name, float x, float y, float z);
@@ -1,36 +1,356 @@
+#define _XOPEN_SOURCE 700   // realpath
 #include "texture.h"
+#include "texture_cook.h"
+#include "../engine/asset_loader.h"
 #include <stb_image/stb_image.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdbool.h>
 
-GLuint texture_load(const char* path) {
-    GLuint texture_id;
-    glGenTextures(1, &texture_id);
-    
+#ifndef PATH_MAX
+#define PATH_MAX 4096
+#endif
+
+typedef struct TextureLoad TextureLoad;
+
+// A registered texture
+typedef struct {
+    char path[PATH_MAX];        // Resolved
+    unsigned int flags;
+    GLuint texture;
+    unsigned int refs;
+
+    int width, height, channels;    // 0 until the image is uploaded
+    const char* encoding;           // As stored on the GPU
+    size_t vram_bytes;
+    size_t decoded_bytes;
+    TextureLoad* load;              // Pending async load, if any
+} TextureEntry;
+
+// Image decoded on a loader thread for texture_load_async
+struct TextureLoad {
+    char path[PATH_MAX];
+    TextureEntry* entry;        // NULL once released (the upload only frees)
+    AssetRequest* request;
+    bool s3tc;                  // Cooked BC1/BC3 files are usable
+
+    TextureCookBlob blob;       // Mapped cooked file, if one was usable
+    unsigned char* pixels;      // Decoded source image otherwise
     int width, height, channels;
-    unsigned char* data = stbi_load(path, &width, &height, &channels, 0);
-    
-    if (!data) {
-        fprintf(stderr, "Failed to load texture: %s\n", path);
-        glDeleteTextures(1, &texture_id);
-        return 0;
+};
+
+static TextureEntry** entries = NULL;
+static unsigned int entry_count = 0;
+static unsigned int entry_capacity = 0;
+
+// Absolute path with links and ./.. resolved, as given if the file is missing
+static void texture_resolve_path(char* out, const char* path) {
+    if (!realpath(path, out)) {
+        snprintf(out, PATH_MAX, "%s", path);
     }
-    
+}
+
+static TextureEntry* texture_find(const char* resolved, unsigned int flags) {
+    for (unsigned int i = 0; i < entry_count; i++) {
+        if (entries[i]->flags == flags && strcmp(entries[i]->path, resolved) == 0) return entries[i];
+    }
+    return NULL;
+}
+
+static TextureEntry* texture_find_name(GLuint texture) {
+    for (unsigned int i = 0; i < entry_count; i++) {
+        if (entries[i]->texture == texture) return entries[i];
+    }
+    return NULL;
+}
+
+static TextureEntry* texture_add(const char* resolved, unsigned int flags, GLuint texture) {
+    if (entry_count == entry_capacity) {
+        unsigned int capacity = entry_capacity ? entry_capacity * 2 : 32;
+        TextureEntry** grown = (TextureEntry**)realloc(entries, capacity * sizeof(TextureEntry*));
+        if (!grown) return NULL;
+        entries = grown;
+        entry_capacity = capacity;
+    }
+
+    TextureEntry* entry = (TextureEntry*)calloc(1, sizeof(TextureEntry));
+    if (!entry) return NULL;
+    snprintf(entry->path, sizeof(entry->path), "%s", resolved);
+    entry->flags = flags;
+    entry->texture = texture;
+    entry->refs = 1;
+    entries[entry_count++] = entry;
+    return entry;
+}
+
+static void texture_remove(TextureEntry* entry) {
+    for (unsigned int i = 0; i < entry_count; i++) {
+        if (entries[i] == entry) {
+            entries[i] = entries[--entry_count];
+            break;
+        }
+    }
+    free(entry);
+}
+
+static void texture_set_params(unsigned int flags) {
+    GLint wrap = (flags & TEXTURE_CLAMP) ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+// Upload decoded pixels with a full mip chain into the entry's texture
+static void texture_upload_pixels(TextureEntry* entry, const unsigned char* pixels, int width, int height, int channels) {
     GLenum format = GL_RGB;
     if (channels == 1) format = GL_RED;
     else if (channels == 3) format = GL_RGB;
     else if (channels == 4) format = GL_RGBA;
-    
-    glBindTexture(GL_TEXTURE_2D, texture_id);
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+
+    glBindTexture(GL_TEXTURE_2D, entry->texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
     glGenerateMipmap(GL_TEXTURE_2D);
-    
-    // Set texture parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    
+    texture_set_params(entry->flags);
+
+    // The mip chain adds a third; drivers store RGB padded to four bytes
+    static const char* encodings[5] = {"RGB8", "R8", "RGB8", "RGB8", "RGBA8"};
+    entry->width = width;
+    entry->height = height;
+    entry->channels = channels;
+    entry->encoding = encodings[channels >= 1 && channels <= 4 ? channels : 0];
+    entry->vram_bytes = (size_t)width * height * (channels == 3 ? 4 : channels) * 4 / 3;
+    entry->decoded_bytes = (size_t)width * height * channels;
+}
+
+// Upload a cooked file's levels one by one, as stored
+static void texture_upload_cooked(TextureEntry* entry, const TextureCookBlob* blob) {
+    GLenum format = texture_cook_gl_format(blob->format);
+
+    glBindTexture(GL_TEXTURE_2D, entry->texture);
+    entry->vram_bytes = 0;
+    for (unsigned int l = 0; l < blob->level_count; l++) {
+        const TextureCookLevel* level = &blob->levels[l];
+        if (blob->format == TEXTURE_COOK_RGBA8) {
+            glTexImage2D(GL_TEXTURE_2D, (GLint)l, (GLint)format, (GLsizei)level->width, (GLsizei)level->height,
+                         0, GL_RGBA, GL_UNSIGNED_BYTE, texture_cook_level_data(blob, l));
+        } else {
+            glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)l, format, (GLsizei)level->width, (GLsizei)level->height,
+                                   0, (GLsizei)level->size, texture_cook_level_data(blob, l));
+        }
+        entry->vram_bytes += level->size;
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)blob->level_count - 1);
+    texture_set_params(entry->flags);
+
+    entry->width = (int)blob->width;
+    entry->height = (int)blob->height;
+    static const int channels[TEXTURE_COOK_FORMAT_COUNT] = {3, 4, 2, 4};
+    entry->channels = channels[blob->format];
+    entry->encoding = texture_cook_format_name(blob->format);
+    entry->decoded_bytes = 0;
+}
+
+// S3TC (BC1/BC3) is an extension on GL 3.3, unlike RGTC (BC5). Main thread only.
+static bool texture_s3tc_supported(void) {
+    static int supported = -1;
+    if (supported < 0) {
+        supported = 0;
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++) {
+            const char* name = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+            if (name && strcmp(name, "GL_EXT_texture_compression_s3tc") == 0) {
+                supported = 1;
+                break;
+            }
+        }
+    }
+    return supported == 1;
+}
+
+// Map path's cooked file if it is fresh and the GL can sample its format
+static bool texture_open_cooked(const char* path, bool s3tc, TextureCookBlob* blob) {
+    if (!texture_cook_open(path, blob)) return false;
+    bool needs_s3tc = blob->format == TEXTURE_COOK_BC1 || blob->format == TEXTURE_COOK_BC3;
+    if (needs_s3tc && !s3tc) {
+        texture_cook_close(blob);
+        return false;
+    }
+    return true;
+}
+
+// Load and upload on the calling thread, the cooked file when there is one
+static bool texture_load_now(TextureEntry* entry) {
+    TextureCookBlob blob;
+    if (texture_open_cooked(entry->path, texture_s3tc_supported(), &blob)) {
+        texture_upload_cooked(entry, &blob);
+        texture_cook_close(&blob);
+        return true;
+    }
+
+    int width, height, channels;
+    unsigned char* data = stbi_load(entry->path, &width, &height, &channels, 0);
+    if (!data) {
+        fprintf(stderr, "Failed to load texture: %s\n", entry->path);
+        return false;
+    }
+
+    texture_upload_pixels(entry, data, width, height, channels);
     stbi_image_free(data);
+    return true;
+}
+
+// Forget a pending async load; its upload will only free the pixels
+static void texture_cancel_load(TextureEntry* entry) {
+    if (!entry->load) return;
+    asset_loader_cancel(entry->load->request);
+    entry->load->entry = NULL;
+    entry->load = NULL;
+}
+
+GLuint texture_load(const char* path) {
+    return texture_load_flags(path, 0);
+}
+
+GLuint texture_load_flags(const char* path, unsigned int flags) {
+    char resolved[PATH_MAX];
+    texture_resolve_path(resolved, path);
+
+    TextureEntry* entry = texture_find(resolved, flags);
+    if (entry) {
+        // Needed now: decode here rather than wait for the loader
+        if (entry->load) {
+            texture_cancel_load(entry);
+            texture_load_now(entry);
+        }
+        entry->refs++;
+        return entry->texture;
+    }
+
+    GLuint texture_id;
+    glGenTextures(1, &texture_id);
+    
+    entry = texture_add(resolved, flags, texture_id);
+    if (!entry || !texture_load_now(entry)) {
+        if (entry) texture_remove(entry);
+        glDeleteTextures(1, &texture_id);
+        return 0;
+    }
     
     return texture_id;
 }
+
+static bool texture_decode(void* data) {
+    TextureLoad* load = (TextureLoad*)data;
+    if (texture_open_cooked(load->path, load->s3tc, &load->blob)) return true;
+
+    load->pixels = stbi_load(load->path, &load->width, &load->height, &load->channels, 0);
+    if (!load->pixels) {
+        fprintf(stderr, "Failed to load texture: %s\n", load->path);
+        return false;
+    }
+    return true;
+}
+
+static void texture_upload(void* data, AssetStatus status) {
+    TextureLoad* load = (TextureLoad*)data;
+    if (load->entry) {
+        load->entry->load = NULL;
+        if (status == ASSET_LOADED && load->blob.mapping) {
+            texture_upload_cooked(load->entry, &load->blob);
+        } else if (status == ASSET_LOADED) {
+            texture_upload_pixels(load->entry, load->pixels, load->width, load->height, load->channels);
+        }
+    }
+
+    texture_cook_close(&load->blob);
+    if (load->pixels) stbi_image_free(load->pixels);
+    free(load);
+}
+
+GLuint texture_load_async(const char* path) {
+    char resolved[PATH_MAX];
+    texture_resolve_path(resolved, path);
+
+    TextureEntry* entry = texture_find(resolved, 0);
+    if (entry) {
+        entry->refs++;
+        return entry->texture;
+    }
+
+    TextureLoad* load = (TextureLoad*)calloc(1, sizeof(TextureLoad));
+    if (!load) return texture_load(path);
+    snprintf(load->path, sizeof(load->path), "%s", resolved);
+    load->s3tc = texture_s3tc_supported();
+
+    // Transparent until the image lands
+    static const unsigned char placeholder[4] = {0, 0, 0, 0};
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+    texture_set_params(0);
+
+    entry = texture_add(resolved, 0, texture);
+    if (!entry) {
+        free(load);
+        return texture;     // Unregistered, stays a placeholder
+    }
+    load->entry = entry;
+    entry->load = load;
+
+    AssetRequest* request = asset_loader_request(texture_decode, texture_upload, load);
+    if (request) load->request = request;   // Else it already ran and load is gone
+    return texture;
+}
+
+void texture_release(GLuint texture) {
+    if (texture == 0) return;
+
+    TextureEntry* entry = texture_find_name(texture);
+    if (entry) {
+        if (--entry->refs > 0) return;
+        texture_cancel_load(entry);
+        texture_remove(entry);
+    }
+
+    glDeleteTextures(1, &texture);
+}
+
+TextureStats texture_registry_stats(void) {
+    TextureStats stats = {0};
+    for (unsigned int i = 0; i < entry_count; i++) {
+        const TextureEntry* entry = entries[i];
+        stats.count++;
+        stats.vram_bytes += entry->vram_bytes;
+        stats.decoded_bytes += entry->decoded_bytes;
+        if (entry->load) stats.loading++;
+    }
+    return stats;
+}
+
+void texture_registry_print(void) {
+    TextureStats stats = texture_registry_stats();
+    printf("Textures: %u (%u loading), %.1f MB VRAM, %.1f MB decoded\n",
+           stats.count, stats.loading, stats.vram_bytes / (1024.0 * 1024.0),
+           stats.decoded_bytes / (1024.0 * 1024.0));
+
+    for (unsigned int i = 0; i < entry_count; i++) {
+        const TextureEntry* entry = entries[i];
+        const char* name = strrchr(entry->path, '/');
+        name = name ? name + 1 : entry->path;
+
+        if (entry->width == 0) {
+            printf("  %3u  %-40s refs %u  %s\n", entry->texture, name, entry->refs,
+                   entry->load ? "loading" : "failed");
+        } else {
+            printf("  %3u  %-40s refs %u  %dx%d %-5s  %.1f KB VRAM  %.1f KB decoded%s\n",
+                   entry->texture, name, entry->refs, entry->width, entry->height, entry->encoding,
+                   entry->vram_bytes / 1024.0, entry->decoded_bytes / 1024.0,
+                   (entry->flags & TEXTURE_CLAMP) ? "  clamp" : "");
+        }
+    }
+}
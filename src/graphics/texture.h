@@ -2,8 +2,46 @@
 #define TEXTURE_H
 
 #include <glad/glad.h>
+#include <stddef.h>
 
-// Load a texture from file path, returns OpenGL texture ID (0 on failure)
+// Textures are shared through a registry keyed by resolved file path and
+// load flags: loading a file again returns the same texture with one more
+// reference, so every image is decoded and uploaded once. texture_release
+// drops a reference and deletes the texture with the last one.
+//
+// Both loaders upload the block-compressed mip chain from TEXTURE_COOK_DIR
+// when `make texture-cook` has cooked an up to date copy (see
+// texture_cook.h), and decode the image and generate mipmaps otherwise.
+
+// Load flags (part of the registry key)
+#define TEXTURE_CLAMP 0x1       // Clamp to edge instead of repeating (sprites)
+
+// Registry totals for the debug overlay
+typedef struct {
+    unsigned int count;
+    unsigned int loading;       // Still showing the async placeholder
+    size_t vram_bytes;          // Including mip chains
+    size_t decoded_bytes;       // System memory each image needed while loading
+} TextureStats;
+
+// Load a texture from file path, returns OpenGL texture ID (0 on failure).
+// A texture still loading asynchronously is finished on the spot.
 GLuint texture_load(const char* path);
+GLuint texture_load_flags(const char* path, unsigned int flags);
+
+// Returns a texture ID immediately, holding a transparent 1x1 placeholder
+// until the image has been decoded on a loader thread and uploaded (see
+// asset_loader.h). Shaders that fall back to the material colour on zero
+// alpha draw untextured until then; a failed load keeps the placeholder.
+GLuint texture_load_async(const char* path);
+
+// Drop a reference from either loader; the last one deletes the texture and
+// cancels its load if still pending
+void texture_release(GLuint texture);
+
+TextureStats texture_registry_stats(void);
+
+// Print every registered texture with its references, size and memory use
+void texture_registry_print(void);
 
 #endif // TEXTURE_H
@@ -0,0 +1,608 @@
+#include "texture_cook.h"
+#include "../file_ops.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define TEXTURE_COOK_MAGIC 0x58455443u  // "CTEX"
+
+// Level data starts on this boundary
+#define TEXTURE_COOK_ALIGN 16
+
+#define TEXTURE_COOK_PATH_MAX 256
+
+// On-disk header, followed by each level's blocks
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    char source[TEXTURE_COOK_PATH_MAX];     // Path cooked from (for reference only)
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t source_hash;                   // FNV-1a over the source's contents
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t level_count;
+    TextureCookLevel levels[TEXTURE_COOK_MAX_LEVELS];
+    uint64_t file_size;
+} TextureCookHeader;
+
+// How texels are averaged into the next mip level
+typedef enum {
+    MIP_FILTER_SRGB,        // Colour: average in linear light
+    MIP_FILTER_LINEAR,      // Data: average as stored
+    MIP_FILTER_NORMAL       // Unit vectors in [0, 1]: average, then renormalize
+} MipFilter;
+
+static size_t align_up(size_t offset) {
+    return (offset + TEXTURE_COOK_ALIGN - 1) & ~(size_t)(TEXTURE_COOK_ALIGN - 1);
+}
+
+static unsigned int block_bytes(TextureCookFormat format) {
+    return format == TEXTURE_COOK_BC1 ? 8 : 16;
+}
+
+static size_t level_bytes(TextureCookFormat format, unsigned int width, unsigned int height) {
+    if (format == TEXTURE_COOK_RGBA8) return (size_t)width * height * 4;
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * block_bytes(format);
+}
+
+static const char* base_name(const char* path) {
+    const char* name = strrchr(path, '/');
+    return name ? name + 1 : path;
+}
+
+// What a texture's texels mean, which decides its format and mip filter
+typedef enum {
+    CONTENT_COLOR,          // sRGB colour: BC1, or BC3 with alpha
+    CONTENT_DATA,           // Linear data (specular, metal/roughness): BC1 or BC3
+    CONTENT_NORMAL,         // Tangent space normals: BC5, renormalized mips
+    CONTENT_VECTOR2,        // Two channel vectors (DuDv distortion): BC5
+    CONTENT_PACKED          // Several maps sharing channels or tiles: RGBA8
+} TextureContent;
+
+// Data textures by file name; anything not listed is colour. Add an entry
+// when a shader starts reading a new image as data.
+static const struct {
+    const char* name;
+    TextureContent content;
+} data_textures[] = {
+    {"watermaps.png", CONTENT_PACKED},      // Water normals (.xzy) and DuDv (.xy) tiles
+    {"waterdudv.png", CONTENT_VECTOR2},
+    {"waternormal.png", CONTENT_NORMAL},
+    {"waternormals.png", CONTENT_NORMAL},
+    {"curtissP40_normal.png", CONTENT_NORMAL},
+    {"curtissP40_metallicRoughness.png", CONTENT_DATA},
+    {"cristalCurtiss_metallicRoughness.png", CONTENT_DATA},
+    {"DB2X2_L01_Spec.png", CONTENT_DATA},
+};
+
+static TextureContent content_for(const char* image_path) {
+    const char* name = base_name(image_path);
+    for (size_t i = 0; i < sizeof(data_textures) / sizeof(data_textures[0]); i++) {
+        if (strcmp(name, data_textures[i].name) == 0) return data_textures[i].content;
+    }
+    return CONTENT_COLOR;
+}
+
+void texture_cook_path(const char* image_path, char* out, size_t out_size) {
+    snprintf(out, out_size, "%s/%s.ctex", TEXTURE_COOK_DIR, base_name(image_path));
+}
+
+GLenum texture_cook_gl_format(TextureCookFormat format) {
+    switch (format) {
+    case TEXTURE_COOK_BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case TEXTURE_COOK_BC5: return GL_COMPRESSED_RG_RGTC2;
+    case TEXTURE_COOK_RGBA8: return GL_RGBA8;
+    default: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    }
+}
+
+const char* texture_cook_format_name(TextureCookFormat format) {
+    switch (format) {
+    case TEXTURE_COOK_BC3: return "BC3";
+    case TEXTURE_COOK_BC5: return "BC5";
+    case TEXTURE_COOK_RGBA8: return "RGBA8";
+    default: return "BC1";
+    }
+}
+
+TextureCookFormat texture_cook_choose_format(const char* image_path, bool has_alpha) {
+    switch (content_for(image_path)) {
+    case CONTENT_NORMAL:
+    case CONTENT_VECTOR2: return TEXTURE_COOK_BC5;
+    case CONTENT_PACKED: return TEXTURE_COOK_RGBA8;
+    default: return has_alpha ? TEXTURE_COOK_BC3 : TEXTURE_COOK_BC1;
+    }
+}
+
+static MipFilter mip_filter_for(const char* image_path) {
+    switch (content_for(image_path)) {
+    case CONTENT_COLOR: return MIP_FILTER_SRGB;
+    case CONTENT_NORMAL: return MIP_FILTER_NORMAL;
+    default: return MIP_FILTER_LINEAR;
+    }
+}
+
+// Header and level table describe ranges that lie inside the file
+static bool texture_cook_valid(const TextureCookHeader* header, size_t file_size) {
+    if (header->magic != TEXTURE_COOK_MAGIC || header->version != TEXTURE_COOK_VERSION ||
+        header->file_size != file_size || header->format >= TEXTURE_COOK_FORMAT_COUNT ||
+        header->level_count == 0 || header->level_count > TEXTURE_COOK_MAX_LEVELS) {
+        return false;
+    }
+
+    unsigned int width = header->width, height = header->height;
+    for (unsigned int l = 0; l < header->level_count; l++) {
+        const TextureCookLevel* level = &header->levels[l];
+        if (level->width != width || level->height != height ||
+            level->size != level_bytes((TextureCookFormat)header->format, width, height) ||
+            level->offset % TEXTURE_COOK_ALIGN != 0 || level->offset < sizeof(TextureCookHeader) ||
+            level->offset + level->size > file_size) {
+            return false;
+        }
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+
+    return true;
+}
+
+// Source unchanged since cooking: same size and mtime, or failing that the same contents
+static bool texture_cook_fresh(const TextureCookHeader* header, const char* image_path) {
+    uint64_t size;
+    int64_t mtime;
+    if (!file_stamp(image_path, &size, &mtime) || size != header->source_size) return false;
+    if (mtime == header->source_mtime) return true;
+
+    uint64_t hash = FNV1A_BASIS;
+    return hash_file(image_path, &hash) && hash == header->source_hash;
+}
+
+bool texture_cook_open(const char* image_path, TextureCookBlob* blob) {
+    char path[TEXTURE_COOK_PATH_MAX];
+    texture_cook_path(image_path, path, sizeof(path));
+
+    memset(blob, 0, sizeof(*blob));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TextureCookHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    const TextureCookHeader* header = (const TextureCookHeader*)mapping;
+    if (!texture_cook_valid(header, (size_t)st.st_size) || !texture_cook_fresh(header, image_path)) {
+        printf("Stale cooked texture: %s\n", path);
+        munmap(mapping, (size_t)st.st_size);
+        return false;
+    }
+
+    blob->mapping = mapping;
+    blob->mapping_size = (size_t)st.st_size;
+    blob->format = (TextureCookFormat)header->format;
+    blob->width = header->width;
+    blob->height = header->height;
+    blob->levels = header->levels;
+    blob->level_count = header->level_count;
+
+    return true;
+}
+
+void texture_cook_close(TextureCookBlob* blob) {
+    if (blob->mapping) {
+        munmap(blob->mapping, blob->mapping_size);
+    }
+    memset(blob, 0, sizeof(*blob));
+}
+
+const void* texture_cook_level_data(const TextureCookBlob* blob, unsigned int level) {
+    return (const char*)blob->mapping + blob->levels[level].offset;
+}
+
+// ===== Mip chain =====
+
+static float srgb_to_linear(float c) {
+    return c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+}
+
+static float linear_to_srgb(float c) {
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * powf(c, 1.0f / 2.4f) - 0.055f;
+}
+
+static unsigned char unorm8(float c) {
+    c = c < 0.0f ? 0.0f : (c > 1.0f ? 1.0f : c);
+    return (unsigned char)lrintf(c * 255.0f);
+}
+
+// RGBA8 -> RGBA floats in the space the filter averages in
+static float* mip_to_float(const unsigned char* pixels, size_t count, MipFilter filter) {
+    float decode[256];
+    for (int i = 0; i < 256; i++) {
+        decode[i] = filter == MIP_FILTER_SRGB ? srgb_to_linear(i / 255.0f) : i / 255.0f;
+    }
+
+    float* out = (float*)malloc(count * 4 * sizeof(float));
+    if (!out) return NULL;
+    for (size_t i = 0; i < count; i++) {
+        for (int c = 0; c < 3; c++) out[i * 4 + c] = decode[pixels[i * 4 + c]];
+        out[i * 4 + 3] = pixels[i * 4 + 3] / 255.0f;
+    }
+    return out;
+}
+
+static void mip_to_rgba8(unsigned char* out, const float* texels, size_t count, MipFilter filter) {
+    for (size_t i = 0; i < count; i++) {
+        for (int c = 0; c < 3; c++) {
+            float v = texels[i * 4 + c];
+            out[i * 4 + c] = unorm8(filter == MIP_FILTER_SRGB ? linear_to_srgb(v) : v);
+        }
+        out[i * 4 + 3] = unorm8(texels[i * 4 + 3]);
+    }
+}
+
+// 2x2 box filter (the last row/column repeats on odd sizes)
+static void mip_downsample(float* out, const float* src, unsigned int width, unsigned int height,
+                           unsigned int out_width, unsigned int out_height, MipFilter filter) {
+    for (unsigned int y = 0; y < out_height; y++) {
+        unsigned int y0 = y * 2 < height ? y * 2 : height - 1;
+        unsigned int y1 = y * 2 + 1 < height ? y * 2 + 1 : height - 1;
+
+        for (unsigned int x = 0; x < out_width; x++) {
+            unsigned int x0 = x * 2 < width ? x * 2 : width - 1;
+            unsigned int x1 = x * 2 + 1 < width ? x * 2 + 1 : width - 1;
+            const float* a = &src[((size_t)y0 * width + x0) * 4];
+            const float* b = &src[((size_t)y0 * width + x1) * 4];
+            const float* c = &src[((size_t)y1 * width + x0) * 4];
+            const float* d = &src[((size_t)y1 * width + x1) * 4];
+            float* t = &out[((size_t)y * out_width + x) * 4];
+
+            for (int k = 0; k < 4; k++) {
+                t[k] = 0.25f * (a[k] + b[k] + c[k] + d[k]);
+            }
+
+            if (filter == MIP_FILTER_NORMAL) {
+                float n[3] = {t[0] * 2.0f - 1.0f, t[1] * 2.0f - 1.0f, t[2] * 2.0f - 1.0f};
+                float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                if (length > 0.0f) {
+                    for (int k = 0; k < 3; k++) t[k] = (n[k] / length) * 0.5f + 0.5f;
+                }
+            }
+        }
+    }
+}
+
+// ===== Block encoders =====
+
+static uint16_t pack_565(const float c[3]) {
+    int r = (int)lrintf(c[0] * 31.0f / 255.0f);
+    int g = (int)lrintf(c[1] * 63.0f / 255.0f);
+    int b = (int)lrintf(c[2] * 31.0f / 255.0f);
+    r = r < 0 ? 0 : (r > 31 ? 31 : r);
+    g = g < 0 ? 0 : (g > 63 ? 63 : g);
+    b = b < 0 ? 0 : (b > 31 ? 31 : b);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+// Expanded the way the hardware does it (bit replication)
+static void unpack_565(uint16_t v, float out[3]) {
+    unsigned int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    out[0] = (float)((r << 3) | (r >> 2));
+    out[1] = (float)((g << 2) | (g >> 4));
+    out[2] = (float)((b << 3) | (b >> 2));
+}
+
+// Nearest palette entry per texel for endpoints c0, c1 (four colour mode);
+// returns the squared error
+static float bc1_fit(const float texels[16][3], uint16_t c0, uint16_t c1, unsigned char indices[16]) {
+    float palette[4][3];
+    unpack_565(c0, palette[0]);
+    unpack_565(c1, palette[1]);
+    for (int k = 0; k < 3; k++) {
+        palette[2][k] = (2.0f * palette[0][k] + palette[1][k]) / 3.0f;
+        palette[3][k] = (palette[0][k] + 2.0f * palette[1][k]) / 3.0f;
+    }
+
+    float error = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        float best = INFINITY;
+        for (int p = 0; p < 4; p++) {
+            float dr = texels[i][0] - palette[p][0];
+            float dg = texels[i][1] - palette[p][1];
+            float db = texels[i][2] - palette[p][2];
+            float e = dr * dr + dg * dg + db * db;
+            if (e < best) {
+                best = e;
+                indices[i] = (unsigned char)p;
+            }
+        }
+        error += best;
+    }
+    return error;
+}
+
+static void clamp_color(float c[3]) {
+    for (int k = 0; k < 3; k++) c[k] = c[k] < 0.0f ? 0.0f : (c[k] > 255.0f ? 255.0f : c[k]);
+}
+
+// Endpoints along the principal axis of the block's colours, then one least
+// squares refit of the endpoints to the chosen indices
+static void encode_bc1_block(unsigned char out[8], const float texels[16][3]) {
+    float mean[3] = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 16; i++) {
+        for (int k = 0; k < 3; k++) mean[k] += texels[i][k] / 16.0f;
+    }
+
+    float cov[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};     // rr rg rb gg gb bb
+    for (int i = 0; i < 16; i++) {
+        float d[3] = {texels[i][0] - mean[0], texels[i][1] - mean[1], texels[i][2] - mean[2]};
+        cov[0] += d[0] * d[0]; cov[1] += d[0] * d[1]; cov[2] += d[0] * d[2];
+        cov[3] += d[1] * d[1]; cov[4] += d[1] * d[2]; cov[5] += d[2] * d[2];
+    }
+
+    // Power iteration for the dominant eigenvector
+    float axis[3] = {1.0f, 1.0f, 1.0f};
+    for (int iter = 0; iter < 8; iter++) {
+        float next[3] = {cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+                         cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+                         cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2]};
+        float length = sqrtf(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+        if (length < 1e-6f) break;
+        for (int k = 0; k < 3; k++) axis[k] = next[k] / length;
+    }
+
+    float t_min = INFINITY, t_max = -INFINITY;
+    for (int i = 0; i < 16; i++) {
+        float t = (texels[i][0] - mean[0]) * axis[0] + (texels[i][1] - mean[1]) * axis[1] +
+                  (texels[i][2] - mean[2]) * axis[2];
+        t_min = fminf(t_min, t);
+        t_max = fmaxf(t_max, t);
+    }
+
+    // Inset a little: the extremes are rarely worth a whole palette entry
+    float inset = (t_max - t_min) / 16.0f;
+    float e0[3], e1[3];
+    for (int k = 0; k < 3; k++) {
+        e0[k] = mean[k] + axis[k] * (t_max - inset);
+        e1[k] = mean[k] + axis[k] * (t_min + inset);
+    }
+    clamp_color(e0);
+    clamp_color(e1);
+
+    uint16_t c0 = pack_565(e0), c1 = pack_565(e1);
+    unsigned char indices[16];
+    float error = bc1_fit(texels, c0, c1, indices);
+
+    // Weight of endpoint 0 for each palette entry
+    static const float weights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+    float aa = 0.0f, bb = 0.0f, ab = 0.0f, ax[3] = {0.0f, 0.0f, 0.0f}, bx[3] = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 16; i++) {
+        float a = weights[indices[i]], b = 1.0f - a;
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+        for (int k = 0; k < 3; k++) {
+            ax[k] += a * texels[i][k];
+            bx[k] += b * texels[i][k];
+        }
+    }
+    float det = aa * bb - ab * ab;
+    if (fabsf(det) > 1e-6f) {
+        for (int k = 0; k < 3; k++) {
+            e0[k] = (ax[k] * bb - bx[k] * ab) / det;
+            e1[k] = (bx[k] * aa - ax[k] * ab) / det;
+        }
+        clamp_color(e0);
+        clamp_color(e1);
+
+        uint16_t r0 = pack_565(e0), r1 = pack_565(e1);
+        unsigned char refit[16];
+        float refit_error = bc1_fit(texels, r0, r1, refit);
+        if (refit_error < error) {
+            c0 = r0;
+            c1 = r1;
+            memcpy(indices, refit, sizeof(indices));
+        }
+    }
+
+    // c0 > c1 selects four colour mode; swapping endpoints swaps indices 0/1 and 2/3
+    if (c0 < c1) {
+        uint16_t swap = c0;
+        c0 = c1;
+        c1 = swap;
+        for (int i = 0; i < 16; i++) indices[i] ^= 1;
+    } else if (c0 == c1) {
+        memset(indices, 0, sizeof(indices));
+    }
+
+    uint32_t bits = 0;
+    for (int i = 0; i < 16; i++) bits |= (uint32_t)indices[i] << (2 * i);
+
+    out[0] = (unsigned char)(c0 & 0xff);
+    out[1] = (unsigned char)(c0 >> 8);
+    out[2] = (unsigned char)(c1 & 0xff);
+    out[3] = (unsigned char)(c1 >> 8);
+    for (int b = 0; b < 4; b++) out[4 + b] = (unsigned char)(bits >> (8 * b));
+}
+
+// One channel: endpoints at the extremes, eight-value mode
+static void encode_bc4_block(unsigned char out[8], const unsigned char values[16]) {
+    unsigned char lo = 255, hi = 0;
+    for (int i = 0; i < 16; i++) {
+        if (values[i] < lo) lo = values[i];
+        if (values[i] > hi) hi = values[i];
+    }
+
+    out[0] = hi;
+    out[1] = lo;
+    uint64_t bits = 0;
+    if (hi > lo) {
+        float palette[8];
+        palette[0] = hi;
+        palette[1] = lo;
+        for (int p = 2; p < 8; p++) {
+            palette[p] = ((8 - p) * (float)hi + (p - 1) * (float)lo) / 7.0f;
+        }
+
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            float best_error = INFINITY;
+            for (int p = 0; p < 8; p++) {
+                float e = fabsf(values[i] - palette[p]);
+                if (e < best_error) {
+                    best_error = e;
+                    best = p;
+                }
+            }
+            bits |= (uint64_t)best << (3 * i);
+        }
+    }
+    for (int b = 0; b < 6; b++) out[2 + b] = (unsigned char)(bits >> (8 * b));
+}
+
+// Encode one RGBA8 level into blocks (edge blocks repeat the last row/column);
+// RGBA8 levels are stored as they are
+static void encode_level(unsigned char* out, const unsigned char* rgba, unsigned int width,
+                         unsigned int height, TextureCookFormat format) {
+    if (format == TEXTURE_COOK_RGBA8) {
+        memcpy(out, rgba, (size_t)width * height * 4);
+        return;
+    }
+
+    for (unsigned int by = 0; by < (height + 3) / 4; by++) {
+        for (unsigned int bx = 0; bx < (width + 3) / 4; bx++) {
+            float colors[16][3];
+            unsigned char channels[4][16];
+            for (unsigned int i = 0; i < 16; i++) {
+                unsigned int x = bx * 4 + (i & 3), y = by * 4 + (i >> 2);
+                if (x >= width) x = width - 1;
+                if (y >= height) y = height - 1;
+                const unsigned char* texel = &rgba[((size_t)y * width + x) * 4];
+                for (int k = 0; k < 4; k++) channels[k][i] = texel[k];
+                for (int k = 0; k < 3; k++) colors[i][k] = texel[k];
+            }
+
+            switch (format) {
+            case TEXTURE_COOK_BC1:
+                encode_bc1_block(out, colors);
+                break;
+            case TEXTURE_COOK_BC3:
+                encode_bc4_block(out, channels[3]);
+                encode_bc1_block(out + 8, colors);
+                break;
+            default:
+                encode_bc4_block(out, channels[0]);
+                encode_bc4_block(out + 8, channels[1]);
+                break;
+            }
+            out += block_bytes(format);
+        }
+    }
+}
+
+bool texture_cook_write(const char* image_path, const unsigned char* pixels, unsigned int width,
+                        unsigned int height, TextureCookFormat format, size_t* encoded_bytes) {
+    if (width == 0 || height == 0) return false;
+    if (!ensure_cache_dir(TEXTURE_COOK_DIR)) return false;
+
+    char path[TEXTURE_COOK_PATH_MAX];
+    texture_cook_path(image_path, path, sizeof(path));
+
+    TextureCookHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = TEXTURE_COOK_MAGIC;
+    header.version = TEXTURE_COOK_VERSION;
+    header.format = format;
+    header.width = width;
+    header.height = height;
+    snprintf(header.source, sizeof(header.source), "%s", image_path);
+
+    header.source_hash = FNV1A_BASIS;
+    if (!file_stamp(image_path, &header.source_size, &header.source_mtime) ||
+        !hash_file(image_path, &header.source_hash)) {
+        return false;
+    }
+
+    // Full chain down to 1x1
+    size_t offset = sizeof(TextureCookHeader);
+    unsigned int w = width, h = height;
+    for (;;) {
+        TextureCookLevel* level = &header.levels[header.level_count++];
+        level->width = w;
+        level->height = h;
+        level->size = level_bytes(format, w, h);
+        offset = align_up(offset);
+        level->offset = offset;
+        offset += level->size;
+
+        if ((w == 1 && h == 1) || header.level_count == TEXTURE_COOK_MAX_LEVELS) break;
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+    }
+    header.file_size = offset;
+
+    FILE* file = cache_write_begin(path);
+    if (!file) {
+        fprintf(stderr, "Failed to write cooked texture: %s\n", path);
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    size_t written = sizeof(header);
+
+    MipFilter filter = mip_filter_for(image_path);
+    size_t count = (size_t)width * height;
+    float* texels = mip_to_float(pixels, count, filter);
+    // Levels alternate between texels and next; next starts at level 1's size
+    size_t next_count = header.level_count > 1 ? (size_t)header.levels[1].width * header.levels[1].height : 1;
+    float* next = (float*)malloc(next_count * 4 * sizeof(float));
+    unsigned char* rgba = (unsigned char*)malloc(count * 4);
+    unsigned char* blocks = (unsigned char*)malloc(header.levels[0].size);
+    ok = ok && texels && next && rgba && blocks;
+
+    for (unsigned int l = 0; ok && l < header.level_count; l++) {
+        const TextureCookLevel* level = &header.levels[l];
+        if (l == 0) {
+            memcpy(rgba, pixels, count * 4);
+        } else {
+            const TextureCookLevel* above = &header.levels[l - 1];
+            mip_downsample(next, texels, above->width, above->height, level->width, level->height, filter);
+            float* swap = texels;
+            texels = next;
+            next = swap;
+            mip_to_rgba8(rgba, texels, (size_t)level->width * level->height, filter);
+        }
+        encode_level(blocks, rgba, level->width, level->height, format);
+
+        // Zero padding up to the level's aligned offset
+        static const unsigned char zeros[TEXTURE_COOK_ALIGN] = {0};
+        size_t pad = level->offset - written;
+        ok = (pad == 0 || fwrite(zeros, 1, pad, file) == pad) &&
+             fwrite(blocks, 1, level->size, file) == level->size;
+        written = level->offset + level->size;
+    }
+
+    free(blocks);
+    free(rgba);
+    free(next);
+    free(texels);
+
+    if (!cache_write_end(file, path, ok)) {
+        fprintf(stderr, "Failed to write cooked texture: %s\n", path);
+        return false;
+    }
+
+    if (encoded_bytes) *encoded_bytes = header.file_size - sizeof(TextureCookHeader);
+    return true;
+}
@@ -0,0 +1,91 @@
+#ifndef TEXTURE_COOK_H
+#define TEXTURE_COOK_H
+
+#include <glad/glad.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Cooked (block-compressed) textures
+// A .ctex file holds an image's full mip chain already encoded in a GPU
+// block format, so loading it is an mmap and one glCompressedTexImage2D per
+// level instead of a PNG/JPEG decode, a glGenerateMipmap and four bytes per
+// texel of VRAM. Files are written offline by `make texture-cook`.
+//
+// Mips are box filtered in linear light (sRGB decoded, averaged, encoded
+// again) so they don't darken. Data textures are listed by file name in
+// texture_cook.c and averaged as stored (normal maps are renormalized).
+// Formats:
+//   BC1    opaque colour or data, 4 bits per texel
+//   BC3    colour or data with alpha, 8 bits per texel
+//   BC5    two channel data: normal maps (x and y, shaders rebuild z), DuDv
+//   RGBA8  packed data maps whose channels can't take block noise
+//
+// The header records the source's size, mtime and a content hash; a cooked
+// file is used for any path whose contents match, and a stale or missing one
+// makes the loader fall back to the source image.
+//
+// Bump TEXTURE_COOK_VERSION whenever the layout or the encoders change.
+#define TEXTURE_COOK_DIR "cache/textures"
+#define TEXTURE_COOK_VERSION 2
+#define TEXTURE_COOK_MAX_LEVELS 16      // Mip chain of a 32768 texel image
+
+// S3TC isn't core, so the loader doesn't define its enums
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+typedef enum {
+    TEXTURE_COOK_BC1,
+    TEXTURE_COOK_BC3,
+    TEXTURE_COOK_BC5,
+    TEXTURE_COOK_RGBA8,
+    TEXTURE_COOK_FORMAT_COUNT
+} TextureCookFormat;
+
+// One mip level (offsets are from the start of the file)
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    uint64_t offset;
+    uint64_t size;
+} TextureCookLevel;
+
+// Read-only view of a cooked texture (pointers into the mapped file)
+typedef struct {
+    void* mapping;
+    size_t mapping_size;
+
+    TextureCookFormat format;
+    unsigned int width;
+    unsigned int height;
+    const TextureCookLevel* levels;
+    unsigned int level_count;
+} TextureCookBlob;
+
+// Where image_path's cooked file lives
+void texture_cook_path(const char* image_path, char* out, size_t out_size);
+
+// Map image_path's cooked file; returns false on miss or stale/corrupt file
+bool texture_cook_open(const char* image_path, TextureCookBlob* blob);
+void texture_cook_close(TextureCookBlob* blob);
+
+// Data of a mapped level
+const void* texture_cook_level_data(const TextureCookBlob* blob, unsigned int level);
+
+// GL internal format of a cooked format
+GLenum texture_cook_gl_format(TextureCookFormat format);
+const char* texture_cook_format_name(TextureCookFormat format);
+
+// Format image_path cooks to, given whether any texel is translucent
+TextureCookFormat texture_cook_choose_format(const char* image_path, bool has_alpha);
+
+// Encode RGBA8 pixels (rows top first) with their mip chain into image_path's
+// cooked file in format; the total encoded size goes to encoded_bytes
+bool texture_cook_write(const char* image_path, const unsigned char* pixels, unsigned int width,
+                        unsigned int height, TextureCookFormat format, size_t* encoded_bytes);
+
+#endif // TEXTURE_COOK_H
@@ -0,0 +1,259 @@
+#include "vertex_format.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Largest stored octahedral component per layout (normals are stored as
+// plain integers and scaled in the shader, sidestepping the GL 3.3 vs 4.2
+// snorm conversion difference)
+#define NORMAL_MAX_16 32767.0f
+#define NORMAL_MAX_8 127.0f
+
+unsigned int vertex_format_stride(VertexFormat format) {
+    switch (format) {
+    case VERTEX_FORMAT_COMPACT16: return 16;
+    case VERTEX_FORMAT_COMPACT12: return 12;
+    default: return VERTEX_FLOATS * sizeof(float);
+    }
+}
+
+// Round to nearest even, overflow to infinity, small values to (sub)normals or zero
+static uint16_t float_to_half(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+    uint32_t float_exponent = (bits >> 23) & 0xff;
+    uint32_t mantissa = bits & 0x7fffff;
+    int32_t exponent = (int32_t)float_exponent - 127 + 15;
+
+    if (float_exponent == 0xff) return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+    if (exponent >= 31) return sign | 0x7c00;
+
+    if (exponent <= 0) {
+        if (exponent < -10) return sign;
+        mantissa |= 0x800000;
+        uint32_t shift = (uint32_t)(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1))) half++;
+        return sign | (uint16_t)half;
+    }
+
+    uint32_t half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1fff;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) half++;  // May carry into the exponent
+    return sign | (uint16_t)half;
+}
+
+static float half_to_float(uint16_t half) {
+    uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+
+    if (exponent == 0) {
+        float value = (float)mantissa * (1.0f / 16777216.0f);
+        return sign ? -value : value;
+    }
+
+    uint32_t bits = exponent == 31 ? (sign | 0x7f800000 | (mantissa << 13))
+                                   : (sign | ((exponent - 15 + 127) << 23) | (mantissa << 13));
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static float sign_not_zero(float v) {
+    return v >= 0.0f ? 1.0f : -1.0f;
+}
+
+// Unit normal -> octahedral square [-1, 1]^2
+static void octahedral_encode(float out[2], const float* n) {
+    float l1 = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+    if (l1 == 0.0f) {
+        out[0] = 0.0f;
+        out[1] = 0.0f;
+        return;
+    }
+
+    float x = n[0] / l1, y = n[1] / l1;
+    if (n[2] < 0.0f) {
+        float folded_x = (1.0f - fabsf(y)) * sign_not_zero(x);
+        float folded_y = (1.0f - fabsf(x)) * sign_not_zero(y);
+        x = folded_x;
+        y = folded_y;
+    }
+    out[0] = x;
+    out[1] = y;
+}
+
+// Mirrors decode_normal in the model vertex shaders
+static void octahedral_decode(float* out, float x, float y) {
+    float n[3] = {x, y, 1.0f - fabsf(x) - fabsf(y)};
+    if (n[2] < 0.0f) {
+        float unfolded_x = (1.0f - fabsf(n[1])) * sign_not_zero(n[0]);
+        float unfolded_y = (1.0f - fabsf(n[0])) * sign_not_zero(n[1]);
+        n[0] = unfolded_x;
+        n[1] = unfolded_y;
+    }
+    float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    for (int k = 0; k < 3; k++) out[k] = n[k] / length;
+}
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static uint16_t quantize_unorm16(float v, float min, float extent) {
+    if (extent <= 0.0f) return 0;
+    return (uint16_t)lrintf(clampf((v - min) / extent, 0.0f, 1.0f) * 65535.0f);
+}
+
+void vertex_format_encode(void* out, VertexFormat format, const float* vertices,
+                          unsigned int vertex_count, const float min[3], const float max[3]) {
+    if (format == VERTEX_FORMAT_FLOAT) {
+        memcpy(out, vertices, (size_t)vertex_count * VERTEX_FLOATS * sizeof(float));
+        return;
+    }
+
+    unsigned int stride = vertex_format_stride(format);
+    float extent[3] = {max[0] - min[0], max[1] - min[1], max[2] - min[2]};
+
+    for (unsigned int i = 0; i < vertex_count; i++) {
+        const float* v = vertices + (size_t)i * VERTEX_FLOATS;
+        unsigned char* dst = (unsigned char*)out + (size_t)i * stride;
+
+        uint16_t position[4] = {0, 0, 0, 0};
+        for (int k = 0; k < 3; k++) {
+            position[k] = quantize_unorm16(v[k], min[k], extent[k]);
+        }
+
+        float oct[2];
+        octahedral_encode(oct, v + 3);
+        uint16_t texcoord[2] = {float_to_half(v[6]), float_to_half(v[7])};
+
+        if (format == VERTEX_FORMAT_COMPACT16) {
+            int16_t normal[2] = {(int16_t)lrintf(oct[0] * NORMAL_MAX_16), (int16_t)lrintf(oct[1] * NORMAL_MAX_16)};
+            memcpy(dst, position, 8);
+            memcpy(dst + 8, normal, 4);
+            memcpy(dst + 12, texcoord, 4);
+        } else {
+            int8_t normal[2] = {(int8_t)lrintf(oct[0] * NORMAL_MAX_8), (int8_t)lrintf(oct[1] * NORMAL_MAX_8)};
+            memcpy(dst, position, 6);
+            memcpy(dst + 6, normal, 2);
+            memcpy(dst + 8, texcoord, 4);
+        }
+    }
+}
+
+void vertex_format_decode(float* out, VertexFormat format, const void* vertices,
+                          unsigned int vertex_count, const float min[3], const float max[3]) {
+    if (format == VERTEX_FORMAT_FLOAT) {
+        memcpy(out, vertices, (size_t)vertex_count * VERTEX_FLOATS * sizeof(float));
+        return;
+    }
+
+    unsigned int stride = vertex_format_stride(format);
+    for (unsigned int i = 0; i < vertex_count; i++) {
+        const unsigned char* src = (const unsigned char*)vertices + (size_t)i * stride;
+        float* v = out + (size_t)i * VERTEX_FLOATS;
+
+        uint16_t position[3], texcoord[2];
+        float oct[2];
+        memcpy(position, src, 6);
+        if (format == VERTEX_FORMAT_COMPACT16) {
+            int16_t normal[2];
+            memcpy(normal, src + 8, 4);
+            memcpy(texcoord, src + 12, 4);
+            oct[0] = clampf(normal[0] / NORMAL_MAX_16, -1.0f, 1.0f);
+            oct[1] = clampf(normal[1] / NORMAL_MAX_16, -1.0f, 1.0f);
+        } else {
+            int8_t normal[2];
+            memcpy(normal, src + 6, 2);
+            memcpy(texcoord, src + 8, 4);
+            oct[0] = clampf(normal[0] / NORMAL_MAX_8, -1.0f, 1.0f);
+            oct[1] = clampf(normal[1] / NORMAL_MAX_8, -1.0f, 1.0f);
+        }
+
+        for (int k = 0; k < 3; k++) {
+            v[k] = min[k] + (position[k] / 65535.0f) * (max[k] - min[k]);
+        }
+        octahedral_decode(v + 3, oct[0], oct[1]);
+        v[6] = half_to_float(texcoord[0]);
+        v[7] = half_to_float(texcoord[1]);
+    }
+}
+
+// Round trip within the error bounds?
+static bool vertex_format_within_bounds(VertexFormat format, const float* vertices, unsigned int vertex_count,
+                                        const float min[3], const float max[3], void* scratch,
+                                        float* decoded) {
+    vertex_format_encode(scratch, format, vertices, vertex_count, min, max);
+    vertex_format_decode(decoded, format, scratch, vertex_count, min, max);
+
+    float largest_extent = fmaxf(fmaxf(max[0] - min[0], max[1] - min[1]), max[2] - min[2]);
+    float position_limit = VERTEX_POSITION_ERROR * largest_extent;
+    float normal_limit = cosf(VERTEX_NORMAL_ERROR_DEGREES * (float)M_PI / 180.0f);
+
+    for (unsigned int i = 0; i < vertex_count; i++) {
+        const float* a = vertices + (size_t)i * VERTEX_FLOATS;
+        const float* b = decoded + (size_t)i * VERTEX_FLOATS;
+
+        for (int k = 0; k < 3; k++) {
+            if (fabsf(a[k] - b[k]) > position_limit) return false;
+        }
+
+        float length = sqrtf(a[3] * a[3] + a[4] * a[4] + a[5] * a[5]);
+        if (length > 0.0f && (a[3] * b[3] + a[4] * b[4] + a[5] * b[5]) / length < normal_limit) return false;
+
+        if (!(fabsf(a[6] - b[6]) <= VERTEX_TEXCOORD_ERROR) || !(fabsf(a[7] - b[7]) <= VERTEX_TEXCOORD_ERROR)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+VertexFormat vertex_format_choose(const float* vertices, unsigned int vertex_count,
+                                  const float min[3], const float max[3]) {
+    if (vertex_count == 0) return VERTEX_FORMAT_FLOAT;
+
+    // Bytes for the largest compact layout, floats for the decoded copy
+    void* scratch = malloc((size_t)vertex_count * vertex_format_stride(VERTEX_FORMAT_COMPACT16));
+    float* decoded = malloc((size_t)vertex_count * VERTEX_FLOATS * sizeof(float));
+
+    VertexFormat format = VERTEX_FORMAT_FLOAT;
+    if (vertex_format_within_bounds(VERTEX_FORMAT_COMPACT12, vertices, vertex_count, min, max, scratch, decoded)) {
+        format = VERTEX_FORMAT_COMPACT12;
+    } else if (vertex_format_within_bounds(VERTEX_FORMAT_COMPACT16, vertices, vertex_count, min, max, scratch, decoded)) {
+        format = VERTEX_FORMAT_COMPACT16;
+    }
+
+    free(decoded);
+    free(scratch);
+    return format;
+}
+
+VertexDecode vertex_format_decode_params(VertexFormat format, const float min[3], const float max[3]) {
+    VertexDecode decode;
+    if (format == VERTEX_FORMAT_FLOAT) {
+        for (int k = 0; k < 3; k++) {
+            decode.offset[k] = 0.0f;
+            decode.scale[k] = 1.0f;
+        }
+        decode.normal_scale = 0.0f;
+        return decode;
+    }
+
+    // unorm16 positions arrive in the shader as [0, 1]
+    for (int k = 0; k < 3; k++) {
+        decode.offset[k] = min[k];
+        decode.scale[k] = max[k] - min[k];
+    }
+    decode.normal_scale = 1.0f / (format == VERTEX_FORMAT_COMPACT16 ? NORMAL_MAX_16 : NORMAL_MAX_8);
+    return decode;
+}
@@ -0,0 +1,59 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Vertex layouts for model meshes
+//
+// Source vertices are always 8 interleaved floats (position, normal,
+// texcoord). The compact layouts store positions as 16-bit unorm relative to
+// a bounding box, normals octahedral-encoded as two 8 or 16-bit integers, and
+// texcoords as half floats. Shaders rebuild the position as
+// offset + position * scale and decode octahedral normals when normal_scale
+// is set; float vertices decode with offset 0, scale 1, normal_scale 0.
+//
+// vertex_format_choose picks the smallest layout whose round trip stays
+// within the error bounds below, falling back to floats (for example for
+// texcoords tiled far outside [0, 1], where half floats lose precision).
+
+typedef enum {
+    VERTEX_FORMAT_FLOAT,        // 32 bytes: float position[3], normal[3], texcoord[2]
+    VERTEX_FORMAT_COMPACT16,    // 16 bytes: unorm16 position[3] + pad, snorm16 normal[2], half texcoord[2]
+    VERTEX_FORMAT_COMPACT12,    // 12 bytes: unorm16 position[3], snorm8 normal[2], half texcoord[2]
+    VERTEX_FORMAT_COUNT
+} VertexFormat;
+
+#define VERTEX_FLOATS 8                         // Floats per source vertex
+
+// Largest round trip errors a compact layout may introduce
+#define VERTEX_POSITION_ERROR 1e-4f             // Relative to the largest bounding box extent
+#define VERTEX_NORMAL_ERROR_DEGREES 1.5f
+#define VERTEX_TEXCOORD_ERROR (1.0f / 4096.0f)  // A quarter texel at 1024 x 1024
+
+// How a shader turns stored attributes back into model space
+typedef struct {
+    float offset[3];
+    float scale[3];
+    float normal_scale;         // 0 = float normals, else octahedral components times this
+} VertexDecode;
+
+unsigned int vertex_format_stride(VertexFormat format);
+
+// Smallest layout that represents every vertex within the error bounds,
+// positions quantized against [min, max]
+VertexFormat vertex_format_choose(const float* vertices, unsigned int vertex_count,
+                                  const float min[3], const float max[3]);
+
+// Encode float vertices into format (out holds vertex_count * stride bytes)
+void vertex_format_encode(void* out, VertexFormat format, const float* vertices,
+                          unsigned int vertex_count, const float min[3], const float max[3]);
+
+// Decode vertices of format back into floats (VERTEX_FLOATS per vertex)
+void vertex_format_decode(float* out, VertexFormat format, const void* vertices,
+                          unsigned int vertex_count, const float min[3], const float max[3]);
+
+// Shader decode parameters for vertices of format quantized against [min, max]
+VertexDecode vertex_format_decode_params(VertexFormat format, const float min[3], const float max[3]);
+
+#endif // VERTEX_FORMAT_H
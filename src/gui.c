@@ -1,4 +1,5 @@
 #include "gui.h"
+#include "config.h"
 #include <stdio.h>
 
 DebugElements gui_debug_elements_init() {
@@ -36,6 +37,7 @@ void gui_render_debug_elements(struct nk_context* ctx, DebugElements* elements,
     const float height = 1000.0f;
     const float padding = 10.0f;
     elements->is_place_tree_click = false;
+    elements->is_list_textures_click = false;
     struct nk_rect bounds = nk_rect(
         padding,
         padding,
@@ -60,6 +62,57 @@ void gui_render_debug_elements(struct nk_context* ctx, DebugElements* elements,
         char entity_count_text[64];
         snprintf(entity_count_text, sizeof(entity_count_text), "Entity Count: %d", elements->entity_count);
         nk_label(ctx, entity_count_text, NK_TEXT_LEFT);
+
+        char culling_text[96];
+        snprintf(culling_text, sizeof(culling_text), "Visible: %u  Culled: %u frustum, %u distance",
+                 elements->entities_visible, elements->entities_frustum_culled,
+                 elements->entities_distance_culled);
+        nk_label(ctx, culling_text, NK_TEXT_LEFT);
+
+        char lod_text[96];
+        snprintf(lod_text, sizeof(lod_text), "Entity Triangles: %u / %u at full detail",
+                 elements->entity_triangles, elements->entity_triangles_full);
+        nk_label(ctx, lod_text, NK_TEXT_LEFT);
+
+        char ground_cover_text[64];
+        snprintf(ground_cover_text, sizeof(ground_cover_text), "Ground Cover: %u", elements->ground_cover_instances);
+        nk_label(ctx, ground_cover_text, NK_TEXT_LEFT);
+
+        char draw_calls_text[64];
+        snprintf(draw_calls_text, sizeof(draw_calls_text), "Draw Calls: %u  State Changes: %u",
+                 elements->draw_calls, elements->state_changes);
+        nk_label(ctx, draw_calls_text, NK_TEXT_LEFT);
+
+        char sim_text[64];
+        snprintf(sim_text, sizeof(sim_text), "Sim: %d Hz, %u ticks this frame",
+                 SIM_TICK_RATE, elements->sim_ticks);
+        nk_label(ctx, sim_text, NK_TEXT_LEFT);
+
+        char projectile_text[64];
+        snprintf(projectile_text, sizeof(projectile_text), "Projectiles: %u", elements->projectiles);
+        nk_label(ctx, projectile_text, NK_TEXT_LEFT);
+
+        char explosion_text[96];
+        snprintf(explosion_text, sizeof(explosion_text), "Explosions: %u  Particles: %u / %u",
+                 elements->explosions, elements->explosion_particles, elements->explosion_particles_wanted);
+        nk_label(ctx, explosion_text, NK_TEXT_LEFT);
+
+        char contrail_text[64];
+        snprintf(contrail_text, sizeof(contrail_text), "Contrail points uploaded: %u", elements->contrail_points);
+        nk_label(ctx, contrail_text, NK_TEXT_LEFT);
+
+        char enemy_text[64];
+        snprintf(enemy_text, sizeof(enemy_text), "Enemies: %u  Visible: %u", elements->enemies, elements->enemies_visible);
+        nk_label(ctx, enemy_text, NK_TEXT_LEFT);
+
+        char assets_text[64];
+        snprintf(assets_text, sizeof(assets_text), "Assets Loading: %u", elements->assets_loading);
+        nk_label(ctx, assets_text, NK_TEXT_LEFT);
+
+        char textures_text[64];
+        snprintf(textures_text, sizeof(textures_text), "Textures: %u (%.1f MB VRAM)",
+                 elements->textures, elements->texture_vram_mb);
+        nk_label(ctx, textures_text, NK_TEXT_LEFT);
         
         // Display frame time
         char frame_time_text[64];
@@ -113,6 +166,10 @@ void gui_render_debug_elements(struct nk_context* ctx, DebugElements* elements,
             elements->is_place_tree_click = true;
         }
 
+        if (nk_button_label(ctx, "List Textures")) {
+            elements->is_list_textures_click = true;
+        }
+
 
         // printf("%s --- %s\n", camera_position_text, player_position_text);
     }
@@ -13,6 +13,25 @@ typedef struct {
     float mouse_pos_x, mouse_pos_y;
     double last_time;
     unsigned int entity_count;
+    unsigned int entities_visible;
+    unsigned int entities_frustum_culled;
+    unsigned int entities_distance_culled;
+    unsigned int entity_triangles;            // At the selected LOD levels
+    unsigned int entity_triangles_full;       // Had every entity been drawn at full detail
+    unsigned int ground_cover_instances;
+    unsigned int draw_calls;
+    unsigned int state_changes;  // Shader + material + texture + VAO binds
+    unsigned int sim_ticks;      // Simulation ticks run for this frame
+    unsigned int projectiles;    // Live projectiles
+    unsigned int explosions;     // Explosions drawn
+    unsigned int explosion_particles;
+    unsigned int explosion_particles_wanted;  // Before the particle budget
+    unsigned int contrail_points;             // Trail points uploaded this frame
+    unsigned int enemies;                     // Live enemies
+    unsigned int enemies_visible;             // Enemies drawn
+    unsigned int assets_loading;              // Async loads not yet uploaded
+    unsigned int textures;                    // Registered textures
+    double texture_vram_mb;
 
     // debug setting camera from gui
     float camera_yaw;
@@ -29,6 +48,7 @@ typedef struct {
 
     // gui button click events
     bool is_place_tree_click;
+    bool is_list_textures_click;
 } DebugElements;
 
 // Initialize the FPS counter
@@ -0,0 +1,36 @@
+#include "frustum.h"
+#include <math.h>
+
+void frustum_from_matrix(Frustum* frustum, const float* m) {
+    // Gribb/Hartmann: planes are row 3 +/- rows 0..2 of the matrix
+    // (column-major, so row r is m[r], m[4 + r], m[8 + r], m[12 + r])
+    for (int i = 0; i < 3; i++) {
+        for (int side = 0; side < 2; side++) {
+            float sign = side == 0 ? 1.0f : -1.0f;
+            float* plane = frustum->planes[i * 2 + side];
+            for (int c = 0; c < 4; c++) {
+                plane[c] = m[c * 4 + 3] + sign * m[c * 4 + i];
+            }
+        }
+    }
+
+    for (int p = 0; p < 6; p++) {
+        float* plane = frustum->planes[p];
+        float len = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (len > 0.0f) {
+            plane[0] /= len;
+            plane[1] /= len;
+            plane[2] /= len;
+            plane[3] /= len;
+        }
+    }
+}
+
+bool frustum_test_sphere(const Frustum* frustum, const float center[3], float radius) {
+    for (int p = 0; p < 6; p++) {
+        const float* plane = frustum->planes[p];
+        float dist = plane[0] * center[0] + plane[1] * center[1] + plane[2] * center[2] + plane[3];
+        if (dist < -radius) return false;
+    }
+    return true;
+}
@@ -0,0 +1,33 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <stdbool.h>
+#include "simd.h"
+
+// View frustum as six normalized planes (a, b, c, d) with normals pointing
+// inwards: a point p is inside a plane when a*px + b*py + c*pz + d >= 0.
+// Order: left, right, bottom, top, near, far.
+typedef struct {
+    float planes[6][4];
+} Frustum;
+
+// Extract planes from a column-major projection * view matrix
+void frustum_from_matrix(Frustum* frustum, const float* view_proj);
+
+// Sphere test (true if the sphere touches the frustum)
+bool frustum_test_sphere(const Frustum* frustum, const float center[3], float radius);
+
+// Four spheres at once (one per lane); returns a bit mask of lanes that touch the frustum
+static inline int frustum_test_spheres4(const Frustum* frustum, v4f cx, v4f cy, v4f cz, v4f radius) {
+    v4f neg_radius = v4_sub(v4_set1(0.0f), radius);
+    int outside = 0;
+    for (int p = 0; p < 6; p++) {
+        const float* plane = frustum->planes[p];
+        v4f dist = v4_add(v4_add(v4_mul(cx, v4_set1(plane[0])), v4_mul(cy, v4_set1(plane[1]))),
+                          v4_add(v4_mul(cz, v4_set1(plane[2])), v4_set1(plane[3])));
+        outside |= v4_lt_mask(dist, neg_radius);
+    }
+    return ~outside & 0xF;
+}
+
+#endif // FRUSTUM_H
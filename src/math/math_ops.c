@@ -1,4 +1,5 @@
 #include "math_ops.h"
+#include "simd.h"
 #include <math.h>
 
 void mat4_identity(float* m) {
@@ -64,6 +65,107 @@ void mat4_scale(float* m, float sx, float sy, float sz) {
     m[10] = sz;
 }
 
+void mat4_compose_trs(float* m, const float* position, const float* rotation, const float* scale) {
+    float sx = sinf(rotation[0]), cx = cosf(rotation[0]);
+    float sy = sinf(rotation[1]), cy = cosf(rotation[1]);
+    float sz = sinf(rotation[2]), cz = cosf(rotation[2]);
+
+    // Columns of Rz * Ry * Rx, each scaled by its axis scale
+    m[0] = cz * cy * scale[0];
+    m[1] = sz * cy * scale[0];
+    m[2] = -sy * scale[0];
+    m[3] = 0.0f;
+
+    m[4] = (cz * sy * sx - sz * cx) * scale[1];
+    m[5] = (sz * sy * sx + cz * cx) * scale[1];
+    m[6] = cy * sx * scale[1];
+    m[7] = 0.0f;
+
+    m[8] = (cz * sy * cx + sz * sx) * scale[2];
+    m[9] = (sz * sy * cx - cz * sx) * scale[2];
+    m[10] = cy * cx * scale[2];
+    m[11] = 0.0f;
+
+    m[12] = position[0];
+    m[13] = position[1];
+    m[14] = position[2];
+    m[15] = 1.0f;
+}
+
+void mat4_compose_trs_batch(float (*out)[16], const float (*positions)[3],
+                            const float (*rotations)[3], const float (*scales)[3],
+                            const uint32_t* indices, unsigned int count) {
+    unsigned int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        uint32_t e[4];
+        for (int k = 0; k < 4; k++) {
+            e[k] = indices ? indices[i + k] : i + k;
+        }
+
+        // Gather the four entities into one lane each
+        v4f rx = v4_set(rotations[e[0]][0], rotations[e[1]][0], rotations[e[2]][0], rotations[e[3]][0]);
+        v4f ry = v4_set(rotations[e[0]][1], rotations[e[1]][1], rotations[e[2]][1], rotations[e[3]][1]);
+        v4f rz = v4_set(rotations[e[0]][2], rotations[e[1]][2], rotations[e[2]][2], rotations[e[3]][2]);
+        v4f scx = v4_set(scales[e[0]][0], scales[e[1]][0], scales[e[2]][0], scales[e[3]][0]);
+        v4f scy = v4_set(scales[e[0]][1], scales[e[1]][1], scales[e[2]][1], scales[e[3]][1]);
+        v4f scz = v4_set(scales[e[0]][2], scales[e[1]][2], scales[e[2]][2], scales[e[3]][2]);
+
+        v4f sx, cx, sy, cy, sz, cz;
+        v4_sincos(rx, &sx, &cx);
+        v4_sincos(ry, &sy, &cy);
+        v4_sincos(rz, &sz, &cz);
+
+        v4f sysx = v4_mul(sy, sx);
+        v4f sycx = v4_mul(sy, cx);
+        v4f zero = v4_set1(0.0f);
+
+        // Column 0
+        v4f m0 = v4_mul(v4_mul(cz, cy), scx);
+        v4f m1 = v4_mul(v4_mul(sz, cy), scx);
+        v4f m2 = v4_mul(v4_sub(zero, sy), scx);
+        v4f m3 = zero;
+
+        // Column 1
+        v4f m4 = v4_mul(v4_sub(v4_mul(cz, sysx), v4_mul(sz, cx)), scy);
+        v4f m5 = v4_mul(v4_add(v4_mul(sz, sysx), v4_mul(cz, cx)), scy);
+        v4f m6 = v4_mul(v4_mul(cy, sx), scy);
+        v4f m7 = zero;
+
+        // Column 2
+        v4f m8 = v4_mul(v4_add(v4_mul(cz, sycx), v4_mul(sz, sx)), scz);
+        v4f m9 = v4_mul(v4_sub(v4_mul(sz, sycx), v4_mul(cz, sx)), scz);
+        v4f m10 = v4_mul(v4_mul(cy, cx), scz);
+        v4f m11 = zero;
+
+        // Transpose lanes back into per-entity columns and store
+        v4_transpose(&m0, &m1, &m2, &m3);
+        v4_transpose(&m4, &m5, &m6, &m7);
+        v4_transpose(&m8, &m9, &m10, &m11);
+
+        v4f col0[4] = {m0, m1, m2, m3};
+        v4f col1[4] = {m4, m5, m6, m7};
+        v4f col2[4] = {m8, m9, m10, m11};
+
+        for (int k = 0; k < 4; k++) {
+            float* m = out[e[k]];
+            v4_store(m + 0, col0[k]);
+            v4_store(m + 4, col1[k]);
+            v4_store(m + 8, col2[k]);
+            m[12] = positions[e[k]][0];
+            m[13] = positions[e[k]][1];
+            m[14] = positions[e[k]][2];
+            m[15] = 1.0f;
+        }
+    }
+
+    // Remainder
+    for (; i < count; i++) {
+        uint32_t e = indices ? indices[i] : i;
+        mat4_compose_trs(out[e], positions[e], rotations[e], scales[e]);
+    }
+}
+
 void mat4_perspective(float* m, float fov_degrees, float aspect, float near, float far) {
     memset(m, 0, 16 * sizeof(float));
     float fov_rad = fov_degrees * M_PI / 180.0f;
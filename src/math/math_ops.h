@@ -2,6 +2,7 @@
 #define MATHOPS_H
 
 #include <string.h>
+#include <stdint.h>
 
 
 // Matrix operations (column-major like OpenGL)
@@ -28,6 +29,17 @@ void mat4_translate(float* m, float x, float y, float z);
 // Create scale matrix
 void mat4_scale(float* m, float sx, float sy, float sz);
 
+// Compose T * Rz * Ry * Rx * S directly from position, Euler angles and
+// scale (same result as multiplying the individual matrices)
+void mat4_compose_trs(float* m, const float* position, const float* rotation, const float* scale);
+
+// Batched mat4_compose_trs, four transforms per SIMD iteration.
+// With indices, only entries indices[0..count) are read and written;
+// with indices == NULL, entries 0..count-1 are.
+void mat4_compose_trs_batch(float (*out)[16], const float (*positions)[3],
+                            const float (*rotations)[3], const float (*scales)[3],
+                            const uint32_t* indices, unsigned int count);
+
 // Create perspective projection matrix
 void mat4_perspective(float* m, float fov_degrees, float aspect, float near, float far);
 
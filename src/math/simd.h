@@ -0,0 +1,192 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+// Minimal 4-wide float SIMD layer: SSE2 on x86, NEON on arm64 (Apple Silicon),
+// plain structs otherwise. Only what the batched math kernels need.
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define SIMD_SSE2 1
+#include <emmintrin.h>
+typedef __m128 v4f;
+typedef __m128i v4i;
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SIMD_NEON 1
+#include <arm_neon.h>
+typedef float32x4_t v4f;
+typedef int32x4_t v4i;
+#else
+#define SIMD_SCALAR 1
+typedef struct { float v[4]; } v4f;
+typedef struct { int v[4]; } v4i;
+#endif
+
+#if defined(SIMD_SSE2)
+
+static inline v4f v4_set1(float x) { return _mm_set1_ps(x); }
+static inline v4f v4_load(const float* p) { return _mm_loadu_ps(p); }
+static inline void v4_store(float* p, v4f a) { _mm_storeu_ps(p, a); }
+static inline v4f v4_add(v4f a, v4f b) { return _mm_add_ps(a, b); }
+static inline v4f v4_sub(v4f a, v4f b) { return _mm_sub_ps(a, b); }
+static inline v4f v4_mul(v4f a, v4f b) { return _mm_mul_ps(a, b); }
+static inline v4f v4_min(v4f a, v4f b) { return _mm_min_ps(a, b); }
+static inline v4f v4_max(v4f a, v4f b) { return _mm_max_ps(a, b); }
+static inline v4i v4_round_to_int(v4f a) { return _mm_cvtps_epi32(a); }
+static inline v4f v4_from_int(v4i a) { return _mm_cvtepi32_ps(a); }
+static inline v4i v4i_set1(int x) { return _mm_set1_epi32(x); }
+static inline v4i v4i_add(v4i a, v4i b) { return _mm_add_epi32(a, b); }
+static inline v4i v4i_and(v4i a, v4i b) { return _mm_and_si128(a, b); }
+static inline v4i v4i_shl30(v4i a) { return _mm_slli_epi32(a, 30); }
+
+// Flip sign where the matching lane of bits has bit 31 set
+static inline v4f v4_xor_sign(v4f a, v4i bits) {
+    return _mm_xor_ps(a, _mm_castsi128_ps(bits));
+}
+
+// Lanes where mask_bits != 0 take a, others b
+static inline v4f v4_select_nonzero(v4i mask_bits, v4f a, v4f b) {
+    __m128 mask = _mm_castsi128_ps(_mm_cmpeq_epi32(mask_bits, _mm_setzero_si128()));
+    return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b));
+}
+
+static inline void v4_transpose(v4f* a, v4f* b, v4f* c, v4f* d) {
+    _MM_TRANSPOSE4_PS(*a, *b, *c, *d);
+}
+
+// Bit i set where lane i of a < b
+static inline int v4_lt_mask(v4f a, v4f b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+
+#elif defined(SIMD_NEON)
+
+static inline v4f v4_set1(float x) { return vdupq_n_f32(x); }
+static inline v4f v4_load(const float* p) { return vld1q_f32(p); }
+static inline void v4_store(float* p, v4f a) { vst1q_f32(p, a); }
+static inline v4f v4_add(v4f a, v4f b) { return vaddq_f32(a, b); }
+static inline v4f v4_sub(v4f a, v4f b) { return vsubq_f32(a, b); }
+static inline v4f v4_mul(v4f a, v4f b) { return vmulq_f32(a, b); }
+static inline v4f v4_min(v4f a, v4f b) { return vminq_f32(a, b); }
+static inline v4f v4_max(v4f a, v4f b) { return vmaxq_f32(a, b); }
+static inline v4i v4_round_to_int(v4f a) { return vcvtnq_s32_f32(a); }
+static inline v4f v4_from_int(v4i a) { return vcvtq_f32_s32(a); }
+static inline v4i v4i_set1(int x) { return vdupq_n_s32(x); }
+static inline v4i v4i_add(v4i a, v4i b) { return vaddq_s32(a, b); }
+static inline v4i v4i_and(v4i a, v4i b) { return vandq_s32(a, b); }
+static inline v4i v4i_shl30(v4i a) { return vshlq_n_s32(a, 30); }
+
+static inline v4f v4_xor_sign(v4f a, v4i bits) {
+    return vreinterpretq_f32_s32(veorq_s32(vreinterpretq_s32_f32(a), bits));
+}
+
+static inline v4f v4_select_nonzero(v4i mask_bits, v4f a, v4f b) {
+    return vbslq_f32(vtstq_s32(mask_bits, mask_bits), a, b);
+}
+
+static inline void v4_transpose(v4f* a, v4f* b, v4f* c, v4f* d) {
+    float32x4x2_t ab = vtrnq_f32(*a, *b);
+    float32x4x2_t cd = vtrnq_f32(*c, *d);
+    *a = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+    *b = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+    *c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+    *d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+}
+
+static inline int v4_lt_mask(v4f a, v4f b) {
+    static const uint32_t bits[4] = {1, 2, 4, 8};
+    return (int)vaddvq_u32(vandq_u32(vcltq_f32(a, b), vld1q_u32(bits)));
+}
+
+#else
+
+#include <math.h>
+#include <string.h>
+
+#define V4_MAP(expr) v4f r; for (int i = 0; i < 4; i++) r.v[i] = (expr); return r
+#define V4I_MAP(expr) v4i r; for (int i = 0; i < 4; i++) r.v[i] = (expr); return r
+
+static inline v4f v4_set1(float x) { V4_MAP(x); }
+static inline v4f v4_load(const float* p) { V4_MAP(p[i]); }
+static inline void v4_store(float* p, v4f a) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+static inline v4f v4_add(v4f a, v4f b) { V4_MAP(a.v[i] + b.v[i]); }
+static inline v4f v4_sub(v4f a, v4f b) { V4_MAP(a.v[i] - b.v[i]); }
+static inline v4f v4_mul(v4f a, v4f b) { V4_MAP(a.v[i] * b.v[i]); }
+static inline v4f v4_min(v4f a, v4f b) { V4_MAP(a.v[i] < b.v[i] ? a.v[i] : b.v[i]); }
+static inline v4f v4_max(v4f a, v4f b) { V4_MAP(a.v[i] > b.v[i] ? a.v[i] : b.v[i]); }
+static inline v4i v4_round_to_int(v4f a) { V4I_MAP((int)lrintf(a.v[i])); }
+static inline v4f v4_from_int(v4i a) { V4_MAP((float)a.v[i]); }
+static inline v4i v4i_set1(int x) { V4I_MAP(x); }
+static inline v4i v4i_add(v4i a, v4i b) { V4I_MAP(a.v[i] + b.v[i]); }
+static inline v4i v4i_and(v4i a, v4i b) { V4I_MAP(a.v[i] & b.v[i]); }
+static inline v4i v4i_shl30(v4i a) { V4I_MAP((int)((unsigned int)a.v[i] << 30)); }
+
+static inline v4f v4_xor_sign(v4f a, v4i bits) {
+    v4f r;
+    for (int i = 0; i < 4; i++) {
+        unsigned int u;
+        memcpy(&u, &a.v[i], sizeof(u));
+        u ^= (unsigned int)bits.v[i];
+        memcpy(&r.v[i], &u, sizeof(u));
+    }
+    return r;
+}
+
+static inline v4f v4_select_nonzero(v4i mask_bits, v4f a, v4f b) { V4_MAP(mask_bits.v[i] ? a.v[i] : b.v[i]); }
+
+static inline void v4_transpose(v4f* a, v4f* b, v4f* c, v4f* d) {
+    v4f* rows[4] = {a, b, c, d};
+    float m[4][4];
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            m[j][i] = rows[i]->v[j];
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            rows[i]->v[j] = m[i][j];
+}
+
+static inline int v4_lt_mask(v4f a, v4f b) {
+    int mask = 0;
+    for (int i = 0; i < 4; i++) mask |= (a.v[i] < b.v[i]) << i;
+    return mask;
+}
+
+#undef V4_MAP
+#undef V4I_MAP
+
+#endif
+
+// Build a vector from four scalars (lane 0 first)
+static inline v4f v4_set(float x, float y, float z, float w) {
+    float tmp[4] = {x, y, z, w};
+    return v4_load(tmp);
+}
+
+// Vectorized sincos with Cody-Waite range reduction and Cephes minimax
+// polynomials on [-pi/4, pi/4]; max error ~2 ulp for |x| < 8192
+static inline void v4_sincos(v4f x, v4f* out_sin, v4f* out_cos) {
+    v4i quadrant = v4_round_to_int(v4_mul(x, v4_set1(0.63661977236758134f)));  // 2/pi
+    v4f q = v4_from_int(quadrant);
+
+    // r = x - q * pi/2, pi/2 split in two parts for precision
+    v4f r = v4_sub(x, v4_mul(q, v4_set1(1.5707963705062866f)));
+    r = v4_sub(r, v4_mul(q, v4_set1(-4.37113900018624283e-8f)));
+    v4f r2 = v4_mul(r, r);
+
+    v4f s = v4_add(v4_mul(r2, v4_set1(-1.9515295891e-4f)), v4_set1(8.3321608736e-3f));
+    s = v4_add(v4_mul(s, r2), v4_set1(-1.6666654611e-1f));
+    s = v4_add(v4_mul(v4_mul(s, r2), r), r);
+
+    v4f c = v4_add(v4_mul(r2, v4_set1(2.443315711809948e-5f)), v4_set1(-1.388731625493765e-3f));
+    c = v4_add(v4_mul(c, r2), v4_set1(4.166664568298827e-2f));
+    c = v4_add(v4_mul(v4_mul(c, r2), r2), v4_sub(v4_set1(1.0f), v4_mul(r2, v4_set1(0.5f))));
+
+    // Odd quadrants swap sin/cos; quadrants 2,3 negate sin, 1,2 negate cos
+    v4i odd = v4i_and(quadrant, v4i_set1(1));
+    v4f sin_r = v4_select_nonzero(odd, c, s);
+    v4f cos_r = v4_select_nonzero(odd, s, c);
+
+    v4i sin_sign = v4i_shl30(v4i_and(quadrant, v4i_set1(2)));
+    v4i cos_sign = v4i_shl30(v4i_and(v4i_add(quadrant, v4i_set1(1)), v4i_set1(2)));
+
+    *out_sin = v4_xor_sign(sin_r, sin_sign);
+    *out_cos = v4_xor_sign(cos_r, cos_sign);
+}
+
+#endif // SIMD_H
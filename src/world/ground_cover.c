@@ -0,0 +1,355 @@
+#include "ground_cover.h"
+#include "../file_ops.h"
+#include "../graphics/shader.h"
+#include "../graphics/texture.h"
+#include "../graphics/state.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <stdint.h>
+
+#define GROUND_COVER_SIZE (2 * GROUND_COVER_RANGE + 1)
+
+// Crossed quads: two unit quads standing on y = 0, rotated 90 degrees apart
+// pos (x, y, z)        texcoord (u, v) - v = 0 is the top of the image
+static const float CROSSED_QUAD_VERTICES[] = {
+    -0.5f, 0.0f,  0.0f,   0.0f, 1.0f,
+     0.5f, 0.0f,  0.0f,   1.0f, 1.0f,
+     0.5f, 1.0f,  0.0f,   1.0f, 0.0f,
+    -0.5f, 1.0f,  0.0f,   0.0f, 0.0f,
+
+     0.0f, 0.0f, -0.5f,   0.0f, 1.0f,
+     0.0f, 0.0f,  0.5f,   1.0f, 1.0f,
+     0.0f, 1.0f,  0.5f,   1.0f, 0.0f,
+     0.0f, 1.0f, -0.5f,   0.0f, 0.0f,
+};
+
+static const unsigned int CROSSED_QUAD_INDICES[] = {
+    0, 1, 2,  2, 3, 0,
+    4, 5, 6,  6, 7, 4
+};
+
+// Same mixing as tree placement so different cells get unrelated sequences
+static uint32_t hash_cell(int x, int z, int seed) {
+    uint32_t h = (uint32_t)seed;
+    h ^= (uint32_t)x * 73856093u;
+    h ^= (uint32_t)z * 19349663u;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h ? h : 1u;
+}
+
+// xorshift32, returns [0, 1)
+static float next_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return (float)(x >> 8) / 16777216.0f;
+}
+
+// Wrap a cell coordinate onto the slot table (cells in range never collide)
+static unsigned int cell_slot(int x, int z) {
+    int sx = ((x % GROUND_COVER_SIZE) + GROUND_COVER_SIZE) % GROUND_COVER_SIZE;
+    int sz = ((z % GROUND_COVER_SIZE) + GROUND_COVER_SIZE) % GROUND_COVER_SIZE;
+    return (unsigned int)(sz * GROUND_COVER_SIZE + sx);
+}
+
+// Scatter candidates over one cell and keep those on flat, grassy ground.
+// Candidates are generated in random order, so any prefix of the result is
+// an even thinning of the whole cell (used for distance falloff).
+static unsigned int ground_cover_build_cell(GroundCoverManager* manager, int cell_x, int cell_z) {
+    const int G = GROUND_COVER_HEIGHT_GRID;
+    const float step = GROUND_COVER_CELL_SIZE / (float)G;
+    const float max_height = HEIGHT * SCALE;
+
+    float origin_x = (float)cell_x * GROUND_COVER_CELL_SIZE;
+    float origin_z = (float)cell_z * GROUND_COVER_CELL_SIZE;
+
+    // Coarse height grid; the noise is far too expensive per instance
+    float heights[(GROUND_COVER_HEIGHT_GRID + 1) * (GROUND_COVER_HEIGHT_GRID + 1)];
+    for (int gz = 0; gz <= G; gz++) {
+        for (int gx = 0; gx <= G; gx++) {
+            heights[gz * (G + 1) + gx] = terrain_get_world_height(
+                origin_x + (float)gx * step, origin_z + (float)gz * step, manager->terrain_seed);
+        }
+    }
+
+    uint32_t rng = hash_cell(cell_x, cell_z, manager->placement_seed);
+    unsigned int count = 0;
+
+    for (unsigned int i = 0; i < GROUND_COVER_CELL_INSTANCES; i++) {
+        // Always draw the same amount of randoms so results don't depend on filtering
+        float u = next_random(&rng);
+        float v = next_random(&rng);
+        float r_kind = next_random(&rng);
+        float r_scale = next_random(&rng);
+        float r_rot = next_random(&rng);
+        float r_tint = next_random(&rng);
+
+        float fx = u * (float)G;
+        float fz = v * (float)G;
+        int ix = (int)fx;
+        int iz = (int)fz;
+        if (ix >= G) ix = G - 1;
+        if (iz >= G) iz = G - 1;
+        fx -= (float)ix;
+        fz -= (float)iz;
+
+        float h00 = heights[iz * (G + 1) + ix];
+        float h10 = heights[iz * (G + 1) + ix + 1];
+        float h01 = heights[(iz + 1) * (G + 1) + ix];
+        float h11 = heights[(iz + 1) * (G + 1) + ix + 1];
+
+        float h0 = h00 + (h10 - h00) * fx;
+        float h1 = h01 + (h11 - h01) * fx;
+        float y = h0 + (h1 - h0) * fz;
+
+        float normalized = y / max_height;
+        if (normalized < GROUND_COVER_MIN_HEIGHT || normalized > GROUND_COVER_MAX_HEIGHT) {
+            continue;
+        }
+
+        // Slope from the bilinear patch's gradient
+        float dhdx = ((h10 - h00) * (1.0f - fz) + (h11 - h01) * fz) / step;
+        float dhdz = (h1 - h0) / step;
+        float normal_y = 1.0f / sqrtf(1.0f + dhdx * dhdx + dhdz * dhdz);
+        if (normal_y < GROUND_COVER_MIN_NORMAL_Y) {
+            continue;
+        }
+
+        bool shrub = r_kind < GROUND_COVER_SHRUB_RATIO;
+
+        GroundCoverInstance* inst = &manager->scratch[count++];
+        inst->position[0] = origin_x + u * GROUND_COVER_CELL_SIZE;
+        inst->position[1] = y;
+        inst->position[2] = origin_z + v * GROUND_COVER_CELL_SIZE;
+        inst->scale = shrub ? 3.0f + r_scale * 3.0f : 1.5f + r_scale * 1.5f;
+        inst->rotation = r_rot * 2.0f * 3.14159265358979323846f;
+        inst->kind = shrub ? 1.0f : 0.0f;
+        inst->tint = 0.8f + r_tint * 0.4f;
+        inst->sway = r_rot * 6.2831853f + u * 3.0f;
+    }
+
+    return count;
+}
+
+GroundCoverManager* ground_cover_create(const TerrainSeed* terrain_seed, int placement_seed) {
+    GroundCoverManager* manager = malloc(sizeof(GroundCoverManager));
+    memset(manager, 0, sizeof(GroundCoverManager));
+
+    manager->terrain_seed = terrain_seed;
+    manager->placement_seed = placement_seed;
+    manager->cell_count = GROUND_COVER_SIZE * GROUND_COVER_SIZE;
+    manager->cells = calloc(manager->cell_count, sizeof(GroundCoverCell));
+    manager->scratch = malloc(sizeof(GroundCoverInstance) * GROUND_COVER_CELL_INSTANCES);
+
+    // Force every cell to be built on the first update
+    manager->center_x = INT32_MAX;
+    manager->center_z = INT32_MAX;
+
+    // Shared mesh
+    glGenBuffers(1, &manager->mesh_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, manager->mesh_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(CROSSED_QUAD_VERTICES), CROSSED_QUAD_VERTICES, GL_STATIC_DRAW);
+
+    glGenBuffers(1, &manager->mesh_ibo);
+
+    // Per-cell VAO: shared mesh + own instance buffer
+    for (unsigned int i = 0; i < manager->cell_count; i++) {
+        GroundCoverCell* cell = &manager->cells[i];
+
+        glGenVertexArrays(1, &cell->vao);
+        glGenBuffers(1, &cell->instance_vbo);
+        glBindVertexArray(cell->vao);
+
+        // Position (location 0), texcoord (location 1)
+        glBindBuffer(GL_ARRAY_BUFFER, manager->mesh_vbo);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+
+        // Instance position + scale (location 2), rotation/kind/tint/sway (location 3)
+        glBindBuffer(GL_ARRAY_BUFFER, cell->instance_vbo);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(GroundCoverInstance), (void*)0);
+        glEnableVertexAttribArray(2);
+        glVertexAttribDivisor(2, 1);
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(GroundCoverInstance), (void*)(4 * sizeof(float)));
+        glEnableVertexAttribArray(3);
+        glVertexAttribDivisor(3, 1);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, manager->mesh_ibo);
+        if (i == 0) {
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(CROSSED_QUAD_INDICES), CROSSED_QUAD_INDICES, GL_STATIC_DRAW);
+        }
+    }
+    glBindVertexArray(0);
+
+    const char* vert_src = load_shader_source("assets/shaders/groundcoververt.glsl");
+    const char* frag_src = load_shader_source("assets/shaders/groundcoverfrag.glsl");
+    manager->shader = shader_create(vert_src, frag_src, "ground cover");
+    free((void*)vert_src);
+    free((void*)frag_src);
+
+    GroundCoverUniforms* u = &manager->uniforms;
+    u->fadestart = shader_uniform(&manager->shader, "fadestart");
+    u->fadeend = shader_uniform(&manager->shader, "fadeend");
+    u->grasstexture = shader_uniform(&manager->shader, "grasstexture");
+    u->shrubtexture = shader_uniform(&manager->shader, "shrubtexture");
+
+    manager->grass_texture = texture_load_flags("assets/textures/grass.png", TEXTURE_CLAMP);
+    manager->shrub_texture = texture_load_flags("assets/textures/shrub2.png", TEXTURE_CLAMP);
+    if (manager->grass_texture == 0 || manager->shrub_texture == 0) {
+        fprintf(stderr, "Warning: Failed to load ground cover textures\n");
+    }
+
+    printf("Ground cover initialized (%u cells, %u candidates per cell)\n",
+           manager->cell_count, GROUND_COVER_CELL_INSTANCES);
+
+    return manager;
+}
+
+void ground_cover_update(GroundCoverManager* manager, float camera_x, float camera_z) {
+    int center_x = (int)floorf(camera_x / GROUND_COVER_CELL_SIZE);
+    int center_z = (int)floorf(camera_z / GROUND_COVER_CELL_SIZE);
+    manager->center_x = center_x;
+    manager->center_z = center_z;
+
+    // Walk rings outwards so the nearest missing cells are built first
+    unsigned int built = 0;
+    for (int ring = 0; ring <= GROUND_COVER_RANGE && built < GROUND_COVER_CELLS_PER_UPDATE; ring++) {
+        for (int dz = -ring; dz <= ring && built < GROUND_COVER_CELLS_PER_UPDATE; dz++) {
+            for (int dx = -ring; dx <= ring && built < GROUND_COVER_CELLS_PER_UPDATE; dx++) {
+                if (abs(dx) != ring && abs(dz) != ring) continue;
+
+                int x = center_x + dx;
+                int z = center_z + dz;
+                GroundCoverCell* cell = &manager->cells[cell_slot(x, z)];
+                if (cell->ready && cell->x == x && cell->z == z) continue;
+
+                cell->x = x;
+                cell->z = z;
+                cell->instance_count = ground_cover_build_cell(manager, x, z);
+
+                glBindBuffer(GL_ARRAY_BUFFER, cell->instance_vbo);
+                glBufferData(GL_ARRAY_BUFFER, cell->instance_count * sizeof(GroundCoverInstance),
+                             manager->scratch, GL_STATIC_DRAW);
+
+                cell->ready = true;
+                built++;
+            }
+        }
+    }
+}
+
+// Fraction of a cell's instances drawn at a given distance
+static float ground_cover_density(float dist) {
+    if (dist <= GROUND_COVER_FULL_DENSITY_DIST) return 1.0f;
+    if (dist >= GROUND_COVER_MAX_DIST) return 0.0f;
+    float t = 1.0f - (dist - GROUND_COVER_FULL_DENSITY_DIST) /
+                     (GROUND_COVER_MAX_DIST - GROUND_COVER_FULL_DENSITY_DIST);
+    return t * t;
+}
+
+void ground_cover_render(GroundCoverManager* manager, float camera_x, float camera_z) {
+    manager->drawn_instances = 0;
+    manager->drawn_cells = 0;
+
+    // Order cells nearest first so the budget is spent close to the camera
+    unsigned int order[GROUND_COVER_SIZE * GROUND_COVER_SIZE];
+    float dists[GROUND_COVER_SIZE * GROUND_COVER_SIZE];
+    unsigned int count = 0;
+
+    for (unsigned int i = 0; i < manager->cell_count; i++) {
+        GroundCoverCell* cell = &manager->cells[i];
+        if (!cell->ready || cell->instance_count == 0) continue;
+        if (abs(cell->x - manager->center_x) > GROUND_COVER_RANGE ||
+            abs(cell->z - manager->center_z) > GROUND_COVER_RANGE) continue;
+
+        // Distance to the closest point of the cell
+        float min_x = (float)cell->x * GROUND_COVER_CELL_SIZE;
+        float min_z = (float)cell->z * GROUND_COVER_CELL_SIZE;
+        float dx = fmaxf(fmaxf(min_x - camera_x, camera_x - (min_x + GROUND_COVER_CELL_SIZE)), 0.0f);
+        float dz = fmaxf(fmaxf(min_z - camera_z, camera_z - (min_z + GROUND_COVER_CELL_SIZE)), 0.0f);
+        float dist = sqrtf(dx * dx + dz * dz);
+        if (dist >= GROUND_COVER_MAX_DIST) continue;
+
+        // Insertion sort, at most (2 * RANGE + 1)^2 entries
+        unsigned int j = count++;
+        while (j > 0 && dists[j - 1] > dist) {
+            order[j] = order[j - 1];
+            dists[j] = dists[j - 1];
+            j--;
+        }
+        order[j] = i;
+        dists[j] = dist;
+    }
+
+    if (count == 0) return;
+
+    Shader* shader = &manager->shader;
+    const GroundCoverUniforms* u = &manager->uniforms;
+    shader_use(shader);
+    shader_uniform_float(shader, u->fadestart, GROUND_COVER_FULL_DENSITY_DIST);
+    shader_uniform_float(shader, u->fadeend, GROUND_COVER_MAX_DIST);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, manager->grass_texture);
+    shader_uniform_int(shader, u->grasstexture, 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, manager->shrub_texture);
+    shader_uniform_int(shader, u->shrubtexture, 1);
+
+    // Quads are visible from both sides
+    state_disable_cull_face();
+
+    unsigned int budget = GROUND_COVER_BUDGET;
+    for (unsigned int i = 0; i < count && budget > 0; i++) {
+        GroundCoverCell* cell = &manager->cells[order[i]];
+
+        unsigned int instances = (unsigned int)((float)cell->instance_count * ground_cover_density(dists[i]));
+        if (instances > budget) instances = budget;
+        if (instances == 0) continue;
+
+        glBindVertexArray(cell->vao);
+        glDrawElementsInstanced(GL_TRIANGLES, 12, GL_UNSIGNED_INT, 0, instances);
+
+        budget -= instances;
+        manager->drawn_instances += instances;
+        manager->drawn_cells++;
+    }
+
+    state_enable_cull_face();
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindVertexArray(0);
+}
+
+void ground_cover_cleanup(GroundCoverManager* manager) {
+    if (!manager) return;
+
+    for (unsigned int i = 0; i < manager->cell_count; i++) {
+        glDeleteVertexArrays(1, &manager->cells[i].vao);
+        glDeleteBuffers(1, &manager->cells[i].instance_vbo);
+    }
+    free(manager->cells);
+    free(manager->scratch);
+
+    glDeleteBuffers(1, &manager->mesh_vbo);
+    glDeleteBuffers(1, &manager->mesh_ibo);
+
+    shader_destroy(&manager->shader);
+    texture_release(manager->grass_texture);
+    texture_release(manager->shrub_texture);
+
+    free(manager);
+}
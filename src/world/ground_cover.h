@@ -0,0 +1,84 @@
+#ifndef GROUND_COVER_H
+#define GROUND_COVER_H
+
+#include "terrain.h"
+
+// Ground cover configuration
+#define GROUND_COVER_CELL_SIZE 64.0f        // World size of one scatter cell
+#define GROUND_COVER_RANGE 4                // Cells kept around the camera in each direction
+#define GROUND_COVER_CELL_INSTANCES 2560    // Candidate instances per cell (before filtering)
+#define GROUND_COVER_HEIGHT_GRID 8          // Height samples per cell side for filtering
+#define GROUND_COVER_CELLS_PER_UPDATE 2     // Cells regenerated per frame when the camera moves
+#define GROUND_COVER_BUDGET 160000          // Maximum instances drawn per frame
+#define GROUND_COVER_FULL_DENSITY_DIST 96.0f  // Full density up to this distance
+#define GROUND_COVER_MAX_DIST 288.0f          // No instances past this distance
+
+// Placement filters (height is normalized like the terrain shader's height)
+#define GROUND_COVER_MIN_HEIGHT 0.012f
+#define GROUND_COVER_MAX_HEIGHT 0.3f
+#define GROUND_COVER_MIN_NORMAL_Y 0.8f      // Steeper slopes stay bare
+#define GROUND_COVER_SHRUB_RATIO 0.08f      // Fraction of instances that are shrubs
+
+// Per-instance data, uploaded as-is to the instance buffer
+typedef struct {
+    float position[3];
+    float scale;
+    float rotation;
+    float kind;     // 0 = grass, 1 = shrub
+    float tint;     // Brightness variation
+    float sway;     // Wind phase
+} GroundCoverInstance;
+
+// One scatter cell with its own instance buffer
+typedef struct {
+    int x, z;                    // Cell coordinates
+    GLuint vao;
+    GLuint instance_vbo;
+    unsigned int instance_count; // Accepted instances (random order)
+    bool ready;
+} GroundCoverCell;
+
+// Ground cover shader uniforms, resolved once at creation
+typedef struct {
+    ShaderUniform fadestart, fadeend;
+    ShaderUniform grasstexture, shrubtexture;
+} GroundCoverUniforms;
+
+typedef struct {
+    GroundCoverCell* cells;
+    unsigned int cell_count;
+    int center_x, center_z;      // Cell the camera was in at the last update
+
+    // Shared crossed-quad mesh
+    GLuint mesh_vbo;
+    GLuint mesh_ibo;
+
+    Shader shader;
+    GroundCoverUniforms uniforms;
+    GLuint grass_texture;
+    GLuint shrub_texture;
+
+    const TerrainSeed* terrain_seed;
+    int placement_seed;
+
+    // Scratch space for building one cell
+    GroundCoverInstance* scratch;
+
+    // Stats from the last render
+    unsigned int drawn_instances;
+    unsigned int drawn_cells;
+} GroundCoverManager;
+
+// Create ground cover system (loads shader and textures)
+GroundCoverManager* ground_cover_create(const TerrainSeed* terrain_seed, int placement_seed);
+
+// Regenerate cells that fell out of range (a few per frame)
+void ground_cover_update(GroundCoverManager* manager, float camera_x, float camera_z);
+
+// Draw all ready cells, one instanced call each, within the instance budget
+void ground_cover_render(GroundCoverManager* manager, float camera_x, float camera_z);
+
+// Cleanup ground cover system
+void ground_cover_cleanup(GroundCoverManager* manager);
+
+#endif // GROUND_COVER_H
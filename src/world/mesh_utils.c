@@ -176,6 +176,113 @@ ProceduralMesh mesh_merge(ProceduralMesh* mesh1, ProceduralMesh* mesh2) {
     return result;
 }
 
+// ============================================================================
+// Mesh Builder
+// ============================================================================
+
+MeshBuilder mesh_builder_create(unsigned int vertex_capacity, unsigned int index_capacity) {
+    MeshBuilder builder;
+    builder.vertex_count = 0;
+    builder.index_count = 0;
+    builder.vertex_capacity = 0;
+    builder.index_capacity = 0;
+    builder.vertices = NULL;
+    builder.indices = NULL;
+
+    builder.min[0] = builder.min[1] = builder.min[2] = INFINITY;
+    builder.max[0] = builder.max[1] = builder.max[2] = -INFINITY;
+
+    mesh_builder_reserve(&builder, vertex_capacity, index_capacity);
+
+    return builder;
+}
+
+void mesh_builder_free(MeshBuilder* builder) {
+    if (builder->vertices) free(builder->vertices);
+    if (builder->indices) free(builder->indices);
+
+    builder->vertices = NULL;
+    builder->indices = NULL;
+    builder->vertex_count = 0;
+    builder->index_count = 0;
+    builder->vertex_capacity = 0;
+    builder->index_capacity = 0;
+}
+
+void mesh_builder_reserve(MeshBuilder* builder, unsigned int vertex_capacity, unsigned int index_capacity) {
+    if (vertex_capacity > builder->vertex_capacity) {
+        builder->vertices = realloc(builder->vertices,
+                                    (size_t)vertex_capacity * MESH_BUILDER_STRIDE * sizeof(float));
+        builder->vertex_capacity = vertex_capacity;
+    }
+
+    if (index_capacity > builder->index_capacity) {
+        builder->indices = realloc(builder->indices, (size_t)index_capacity * sizeof(unsigned int));
+        builder->index_capacity = index_capacity;
+    }
+}
+
+void mesh_builder_append(MeshBuilder* builder, const ProceduralMesh* part,
+                         const float* m, const float* tc) {
+    // Capacity normally comes from a dry run; grow geometrically as a fallback
+    if (builder->vertex_count + part->vertex_count > builder->vertex_capacity ||
+        builder->index_count + part->index_count > builder->index_capacity) {
+        mesh_builder_reserve(builder,
+                             IMAX(builder->vertex_capacity * 2, builder->vertex_count + part->vertex_count),
+                             IMAX(builder->index_capacity * 2, builder->index_count + part->index_count));
+    }
+
+    unsigned int base = builder->vertex_count;
+    float* out = &builder->vertices[(size_t)base * MESH_BUILDER_STRIDE];
+
+    for (unsigned int i = 0; i < part->vertex_count; i++, out += MESH_BUILDER_STRIDE) {
+        const float* v = &part->vertices[i * 3];
+        const float* n = &part->normals[i * 3];
+        const float* t = &part->texcoords[i * 2];
+
+        // Position (w = 1)
+        out[0] = m[0] * v[0] + m[4] * v[1] + m[8] * v[2] + m[12];
+        out[1] = m[1] * v[0] + m[5] * v[1] + m[9] * v[2] + m[13];
+        out[2] = m[2] * v[0] + m[6] * v[1] + m[10] * v[2] + m[14];
+
+        // Normal (w = 0), renormalized like mesh_transform
+        float nx = m[0] * n[0] + m[4] * n[1] + m[8] * n[2];
+        float ny = m[1] * n[0] + m[5] * n[1] + m[9] * n[2];
+        float nz = m[2] * n[0] + m[6] * n[1] + m[10] * n[2];
+        float len = sqrtf(nx * nx + ny * ny + nz * nz);
+        if (len > 0.0f) {
+            nx /= len; ny /= len; nz /= len;
+        }
+        out[3] = nx;
+        out[4] = ny;
+        out[5] = nz;
+
+        // Texcoord as 2D point (u, v, 0, 1)
+        if (tc) {
+            out[6] = tc[0] * t[0] + tc[4] * t[1] + tc[12];
+            out[7] = tc[1] * t[0] + tc[5] * t[1] + tc[13];
+        } else {
+            out[6] = t[0];
+            out[7] = t[1];
+        }
+
+        builder->min[0] = FMIN(builder->min[0], out[0]);
+        builder->min[1] = FMIN(builder->min[1], out[1]);
+        builder->min[2] = FMIN(builder->min[2], out[2]);
+        builder->max[0] = FMAX(builder->max[0], out[0]);
+        builder->max[1] = FMAX(builder->max[1], out[1]);
+        builder->max[2] = FMAX(builder->max[2], out[2]);
+    }
+
+    unsigned int* out_idx = &builder->indices[builder->index_count];
+    for (unsigned int i = 0; i < part->index_count; i++) {
+        out_idx[i] = part->indices[i] + base;
+    }
+
+    builder->vertex_count += part->vertex_count;
+    builder->index_count += part->index_count;
+}
+
 // ============================================================================
 // Primitive Generators
 // ============================================================================
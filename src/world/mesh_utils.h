@@ -15,6 +15,24 @@ typedef struct {
     unsigned int capacity;  // Current array capacity
 } ProceduralMesh;
 
+// Interleaved, GPU-ready mesh builder
+// Vertex layout matches entity Mesh: position(3) + normal(3) + texcoord(2)
+#define MESH_BUILDER_STRIDE 8
+
+typedef struct {
+    float* vertices;       // Interleaved vertex data (MESH_BUILDER_STRIDE floats per vertex)
+    unsigned int* indices; // Triangle indices
+
+    unsigned int vertex_count;
+    unsigned int index_count;
+    unsigned int vertex_capacity;
+    unsigned int index_capacity;
+
+    // Bounds of everything appended so far
+    float min[3];
+    float max[3];
+} MeshBuilder;
+
 // Mesh management
 ProceduralMesh mesh_create(unsigned int initial_capacity);
 void mesh_free(ProceduralMesh* mesh);
@@ -31,6 +49,15 @@ void mesh_transform_texcoords(ProceduralMesh* mesh, float* transform_matrix);
 // Mesh merging
 ProceduralMesh mesh_merge(ProceduralMesh* mesh1, ProceduralMesh* mesh2);
 
+// Mesh builder (append transformed parts in place, no intermediate merges)
+MeshBuilder mesh_builder_create(unsigned int vertex_capacity, unsigned int index_capacity);
+void mesh_builder_free(MeshBuilder* builder);
+void mesh_builder_reserve(MeshBuilder* builder, unsigned int vertex_capacity, unsigned int index_capacity);
+// Append part transformed by transform_matrix (positions and normals) and
+// tc_transform (texcoords, may be NULL)
+void mesh_builder_append(MeshBuilder* builder, const ProceduralMesh* part,
+                         const float* transform_matrix, const float* tc_transform);
+
 // Primitive mesh generators
 ProceduralMesh mesh_create_frustum(unsigned int detail, float radius1, float radius2);
 ProceduralMesh mesh_create_cone_type1(unsigned int detail);
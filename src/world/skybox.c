@@ -68,7 +68,8 @@ SkyboxGL skybox_init(void) {
     // Skybox shaders (from original skyboxvert.glsl and skyboxfrag.glsl)
     const char* skybox_vertex_src = load_shader_source("assets/shaders/skyboxvert.glsl");
     const char* skybox_fragment_src = load_shader_source("assets/shaders/skyboxfrag.glsl");    
-    skybox.shader = shader_compile(skybox_vertex_src, skybox_fragment_src);
+    skybox.shader = shader_create(skybox_vertex_src, skybox_fragment_src, "skybox");
+    skybox.skybox_uniform = shader_uniform(&skybox.shader, "skybox");
     
     // Load cubemap textures (like original textures.impfile lines 118-126)
     const char* cubemap_faces[6] = {
@@ -117,32 +118,22 @@ GLuint load_cubemap(const char* faces[6]) {
     return texture_id;
 }
 
-void skybox_render(SkyboxGL* skybox, float* persp, float* view) {
-    if (!skybox->shader || !skybox->cubemap_texture) return;
+void skybox_render(SkyboxGL* skybox) {
+    if (!skybox->shader.program || !skybox->cubemap_texture) return;
     
     // Draw skybox (like original displaySkybox in display.cpp)
     glCullFace(GL_FRONT);  // Cull front faces for skybox (line 28)
     glDepthFunc(GL_LEQUAL);  // Change depth function so depth test passes when values are equal to depth buffer's content
     
-    glUseProgram(skybox->shader);
+    shader_use(&skybox->shader);
     
     // Bind cubemap texture
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_CUBE_MAP, skybox->cubemap_texture);
-    glUniform1i(glGetUniformLocation(skybox->shader, "skybox"), 0);
-    
-    // Set uniforms
-    glUniformMatrix4fv(glGetUniformLocation(skybox->shader, "persp"), 1, GL_FALSE, persp);
-    
-    // Remove translation from view matrix (only keep rotation, like original line 36)
-    // skyboxView = mat4(mat3(cam.viewMatrix()))
-    float skybox_view[16] = {
-        view[0], view[1], view[2], 0.0f,
-        view[4], view[5], view[6], 0.0f,
-        view[8], view[9], view[10], 0.0f,
-        0.0f, 0.0f, 0.0f, 1.0f
-    };
-    glUniformMatrix4fv(glGetUniformLocation(skybox->shader, "view"), 1, GL_FALSE, skybox_view);
+    shader_uniform_int(&skybox->shader, skybox->skybox_uniform, 0);
+    
+    // persp/view come from FrameData; the vertex shader drops the view
+    // translation itself (like original line 36: mat4(mat3(cam.viewMatrix())))
     
     // Draw cube
     glBindVertexArray(skybox->vao);
@@ -162,6 +153,6 @@ void skybox_cleanup(SkyboxGL* skybox) {
     if (skybox->vao) glDeleteVertexArrays(1, &skybox->vao);
     if (skybox->vbo) glDeleteBuffers(1, &skybox->vbo);
     if (skybox->ibo) glDeleteBuffers(1, &skybox->ibo);
-    if (skybox->shader) glDeleteProgram(skybox->shader);
+    shader_destroy(&skybox->shader);
     if (skybox->cubemap_texture) glDeleteTextures(1, &skybox->cubemap_texture);
 }
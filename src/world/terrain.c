@@ -8,6 +8,7 @@
 
 #include "../graphics/texture.h"
 #include "../graphics/shader.h"
+#include "../graphics/mesh_optimize.h"
 #include <stb_image/stb_image.h>
 
 // Use proper noise implementation from noise.c (working implementation)
@@ -80,6 +81,21 @@ float terrain_get_height(float x, float z, const TerrainSeed* seed) {
     return height;
 }
 
+float terrain_get_world_height(float x, float z, const TerrainSeed* seed) {
+    // Chunk vertices are sampled at noise (tx, tz) but drawn at world
+    // (tz, tx) * SCALE * PREC / (PREC + 1), see chunk_create and terrainvert
+    float spacing = SCALE * (float)PREC / (float)(PREC + 1);
+    float height = terrain_get_height(z / spacing, x / spacing, seed) * HEIGHT;
+
+    // Same min height clamp as chunk_create
+    if (height <= 0.0f)
+        height = fminf(-0.007f, height);
+    else
+        height = fmaxf(0.007f, height);
+
+    return height * SCALE;
+}
+
 ChunkTable chunk_table_create(unsigned int range, float scale, float h) {
     ChunkTable ct;
     ct.size = 2 * range + 1;
@@ -133,6 +149,17 @@ static void init_global_indices() {
             g_chunk_indices[idx++] = base + (PREC + 1) + 1;
         }
     }
+
+    // Row order reloads every vertex once per row; reorder triangles for the
+    // vertex cache (the grid's vertex order already fetches linearly)
+    unsigned int vertex_count = (PREC + 1) * (PREC + 1);
+    unsigned int* optimized = (unsigned int*)malloc(g_index_count * sizeof(unsigned int));
+    mesh_optimize_vertex_cache(optimized, g_chunk_indices, g_index_count, vertex_count, MESH_CACHE_SIZE);
+    printf("Terrain chunk indices: ACMR %.2f -> %.2f\n",
+           mesh_acmr(g_chunk_indices, g_index_count, vertex_count, MESH_CACHE_SIZE),
+           mesh_acmr(optimized, g_index_count, vertex_count, MESH_CACHE_SIZE));
+    free(g_chunk_indices);
+    g_chunk_indices = optimized;
 }
 
 void chunk_table_add_chunk(ChunkTable* ct, unsigned int index, const ChunkMesh* mesh, int x, int z) {
@@ -178,29 +205,14 @@ void chunk_table_update_chunk(ChunkTable* ct, unsigned int index, const ChunkMes
     glBufferSubData(GL_ARRAY_BUFFER, 0, mesh->vertex_count * 3 * sizeof(float), mesh->vertices);
 }
 
-void chunk_table_draw(ChunkTable* ct, GLuint shader_program, float* view_matrix, float* proj_matrix) {
+void chunk_table_draw(ChunkTable* ct, Shader* shader) {
     unsigned int index_count = PREC * PREC * 6;
     
-    // Set uniforms that are constant for all chunks
-    GLint persp_loc = glGetUniformLocation(shader_program, "persp");
-    GLint view_loc = glGetUniformLocation(shader_program, "view");
-    GLint lightdir_loc = glGetUniformLocation(shader_program, "lightdir");
-    GLint maxheight_loc = glGetUniformLocation(shader_program, "maxheight");
-    GLint chunksz_loc = glGetUniformLocation(shader_program, "chunksz");
-    GLint prec_loc = glGetUniformLocation(shader_program, "prec");
-    GLint transform_loc = glGetUniformLocation(shader_program, "transform");
-    
-    glUniformMatrix4fv(persp_loc, 1, GL_FALSE, proj_matrix);
-    glUniformMatrix4fv(view_loc, 1, GL_FALSE, view_matrix);
-    
-    float light_dir[3] = {-1.0f, 1.0f, -1.0f};
-    float len = sqrtf(light_dir[0]*light_dir[0] + light_dir[1]*light_dir[1] + light_dir[2]*light_dir[2]);
-    light_dir[0] /= len; light_dir[1] /= len; light_dir[2] /= len;
-    glUniform3fv(lightdir_loc, 1, light_dir);
-    
-    glUniform1f(maxheight_loc, ct->height * SCALE);
-    glUniform1f(chunksz_loc, ct->scale);
-    glUniform1i(prec_loc, PREC);
+    // Set uniforms that are constant for all chunks (camera and light come from FrameData)
+    ShaderUniform transform_uniform = shader_uniform(shader, "transform");
+    shader_set_float(shader, "maxheight", ct->height * SCALE);
+    shader_set_float(shader, "chunksz", ct->scale);
+    shader_set_int(shader, "prec", PREC);
     
     // Draw each chunk with its transform
     for (unsigned int i = 0; i < ct->chunk_count; i++) {
@@ -211,7 +223,7 @@ void chunk_table_draw(ChunkTable* ct, GLuint shader_program, float* view_matrix,
         transform[13] = 0.0f;
         transform[14] = ct->positions[i].z * ct->scale * 2.0f;
         
-        glUniformMatrix4fv(transform_loc, 1, GL_FALSE, transform);
+        shader_uniform_mat4(shader, transform_uniform, transform);
         
         glBindVertexArray(ct->vaos[i]);
         glDrawElements(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, 0);
@@ -332,43 +344,12 @@ void chunk_mesh_free(ChunkMesh* mesh) {
 
 // ===== LOD Manager =====
 
-// Setup GlobalVals UBO for viewdist - like C++ game.cpp initGlobalValUniformBlock()
-static void setup_global_vals_ubo(GLuint terrain_shader, GLuint water_shader) {
-    // Calculate viewdist like C++: CHUNK_SZ * SCALE * 2.0f * RANGE * pow(LOD_SCALE, MAX_LOD - 2)
-    float viewdist = CHUNK_SZ * SCALE * 2.0f * (float)RANGE * powf(LOD_SCALE, MAX_LOD - 2);
-
-    float global_vals[] = { viewdist };
-
-    GLuint ubo;
-    glGenBuffers(1, &ubo);
-    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-    glBufferData(GL_UNIFORM_BUFFER, sizeof(global_vals), global_vals, GL_STATIC_DRAW);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-
-    // Bind UBO to binding point 0
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, ubo);
-
-    // Set uniform block binding for terrain shader
-    GLuint terrain_block_index = glGetUniformBlockIndex(terrain_shader, "GlobalVals");
-    if (terrain_block_index != GL_INVALID_INDEX) {
-        glUniformBlockBinding(terrain_shader, terrain_block_index, 0);
-    }
-
-    // Set uniform block binding for water shader
-    GLuint water_block_index = glGetUniformBlockIndex(water_shader, "GlobalVals");
-    if (water_block_index != GL_INVALID_INDEX) {
-        glUniformBlockBinding(water_shader, water_block_index, 0);
-    }
-
-    printf("GlobalVals UBO initialized (viewdist=%.1f)\n", viewdist);
-}
-
 TerrainLODManagerGL terrain_lod_manager_create(const TerrainSeed* seed) {
 
     // Load terrain shader and texture
     const char* vertex_shader_src = load_shader_source("assets/shaders/terrainvert.glsl");
     const char* fragment_shader_src = load_shader_source("assets/shaders/terrainfrag.glsl");
-    GLuint terrain_shader = shader_compile(vertex_shader_src, fragment_shader_src);
+    Shader terrain_shader = shader_create(vertex_shader_src, fragment_shader_src, "terrain");
     GLuint terrain_texture = texture_load("assets/textures/terraintextures.png");
 
 
@@ -398,6 +379,16 @@ TerrainLODManagerGL terrain_lod_manager_create(const TerrainSeed* seed) {
     // Load terrain shader and texture (will be done in main for now)
     lod.terrain_shader = terrain_shader;
     lod.terrain_texture = terrain_texture;
+
+    TerrainUniforms* u = &lod.uniforms;
+    u->transform = shader_uniform(&terrain_shader, "transform");
+    u->maxheight = shader_uniform(&terrain_shader, "maxheight");
+    u->prec = shader_uniform(&terrain_shader, "prec");
+    u->chunksz = shader_uniform(&terrain_shader, "chunksz");
+    u->center = shader_uniform(&terrain_shader, "center");
+    u->minrange = shader_uniform(&terrain_shader, "minrange");
+    u->maxrange = shader_uniform(&terrain_shader, "maxrange");
+    u->terraintexture = shader_uniform(&terrain_shader, "terraintexture");
     
     return lod;
 }
@@ -498,23 +489,20 @@ void terrain_lod_manager_update(TerrainLODManagerGL* lod, const TerrainSeed* see
     }
 }
 
-void terrain_lod_manager_render(TerrainLODManagerGL* lod, float* view, float* proj, 
-                                float camera_x, float camera_y, float camera_z, float time) {
-    glUseProgram(lod->terrain_shader);
+void terrain_lod_manager_render(TerrainLODManagerGL* lod) {
+    Shader* shader = &lod->terrain_shader;
+    const TerrainUniforms* u = &lod->uniforms;
+    shader_use(shader);
     
-    // Set common uniforms (like original displayTerrain)
-    glUniformMatrix4fv(glGetUniformLocation(lod->terrain_shader, "persp"), 1, GL_FALSE, proj);
-    glUniformMatrix4fv(glGetUniformLocation(lod->terrain_shader, "view"), 1, GL_FALSE, view);
-    glUniform3f(glGetUniformLocation(lod->terrain_shader, "lightdir"), -0.57735f, -0.57735f, -0.57735f);
-    glUniform3f(glGetUniformLocation(lod->terrain_shader, "camerapos"), camera_x, camera_y, camera_z);
-    glUniform1f(glGetUniformLocation(lod->terrain_shader, "time"), time);
-    glUniform1f(glGetUniformLocation(lod->terrain_shader, "maxheight"), HEIGHT);
-    glUniform1i(glGetUniformLocation(lod->terrain_shader, "prec"), PREC);
+    // Set common uniforms (like original displayTerrain); camera, light
+    // and time come from the FrameData block
+    shader_uniform_float(shader, u->maxheight, HEIGHT);
+    shader_uniform_int(shader, u->prec, PREC);
     
     // Bind terrain texture
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, lod->terrain_texture);
-    glUniform1i(glGetUniformLocation(lod->terrain_shader, "terraintexture"), 0);
+    shader_uniform_int(shader, u->terraintexture, 0);
     
     // Calculate center for LOD distance-based rendering - like C++ display.cpp
     // NOTE: In original, glm::vec2(center.z, center.x) - z is used for x!
@@ -522,7 +510,7 @@ void terrain_lod_manager_render(TerrainLODManagerGL* lod, float* view, float* pr
     // Must use PREC/(PREC+1) factor to match chunk positioning
     float center_world_x = (float)center.z * (float)PREC / (float)(PREC + 1) * lod->lod_levels[0].scale * SCALE * 2.0f;
     float center_world_z = (float)center.x * (float)PREC / (float)(PREC + 1) * lod->lod_levels[0].scale * SCALE * 2.0f;
-    glUniform2f(glGetUniformLocation(lod->terrain_shader, "center"), center_world_x, center_world_z);
+    shader_uniform_vec2(shader, u->center, center_world_x, center_world_z);
     
     float min_dist = 0.0f;
     
@@ -531,10 +519,10 @@ void terrain_lod_manager_render(TerrainLODManagerGL* lod, float* view, float* pr
         ChunkTable* ct = &lod->lod_levels[level];
         
         // Set chunksz uniform for this LOD (ct->scale is already the full chunkscale)
-        glUniform1f(glGetUniformLocation(lod->terrain_shader, "chunksz"), ct->scale);
+        shader_uniform_float(shader, u->chunksz, ct->scale);
 
         // Calculate max distance for this LOD - EXACTLY like C++ display.cpp lines 155-175
-        float max_dist;
+        float max_dist = -1.0f;
         if (level < lod->num_lods - 1) {
             float chunkscale = ct->scale * 2.0f * (float)PREC / (float)(PREC + 1);
             float range = (float)((ct->size - 1) / 2) - 0.5f;
@@ -542,13 +530,13 @@ void terrain_lod_manager_render(TerrainLODManagerGL* lod, float* view, float* pr
             float d = 8.0f * (float)level + 4.0f;
             max_dist = chunkscale * range * SCALE + d;
 
-            glUniform1f(glGetUniformLocation(lod->terrain_shader, "minrange"), min_dist);
-            glUniform1f(glGetUniformLocation(lod->terrain_shader, "maxrange"), max_dist);
+            shader_uniform_float(shader, u->minrange, min_dist);
+            shader_uniform_float(shader, u->maxrange, max_dist);
 
             min_dist = max_dist - 2.0f * d;
         } else {
-            glUniform1f(glGetUniformLocation(lod->terrain_shader, "minrange"), min_dist);
-            glUniform1f(glGetUniformLocation(lod->terrain_shader, "maxrange"), -1.0f);
+            shader_uniform_float(shader, u->minrange, min_dist);
+            shader_uniform_float(shader, u->maxrange, -1.0f);
         }
         
         // CRITICAL: For LOD levels > 0, skip inner chunks - like C++ display.cpp line 180-181
@@ -586,7 +574,7 @@ void terrain_lod_manager_render(TerrainLODManagerGL* lod, float* view, float* pr
                 0, 0, SCALE, 0,
                 x * SCALE, 0, z * SCALE, 1  // Translation IS multiplied by SCALE
             };
-            glUniformMatrix4fv(glGetUniformLocation(lod->terrain_shader, "transform"), 1, GL_FALSE, transform);
+            shader_uniform_mat4(shader, u->transform, transform);
             
             // Draw this chunk
             glBindVertexArray(ct->vaos[i]);
@@ -610,10 +598,6 @@ void terrain_lod_manager_cleanup(TerrainLODManagerGL* lod) {
     }
     free(lod->lod_levels);
     
-    if (lod->terrain_shader > 0) {
-        glDeleteProgram(lod->terrain_shader);
-    }
-    if (lod->terrain_texture > 0) {
-        glDeleteTextures(1, &lod->terrain_texture);
-    }
+    shader_destroy(&lod->terrain_shader);
+    texture_release(lod->terrain_texture);
 }
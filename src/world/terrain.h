@@ -4,6 +4,7 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <stdbool.h>
+#include "../graphics/shader.h"
 
 // Constants from original (infworld.hpp)
 #define PREC 40
@@ -57,11 +58,20 @@ typedef struct {
     int reusable_capacity;
 } ChunkTable;
 
+// Terrain shader uniforms, resolved once at creation
+typedef struct {
+    ShaderUniform transform;
+    ShaderUniform maxheight, prec, chunksz, center;
+    ShaderUniform minrange, maxrange;
+    ShaderUniform terraintexture;
+} TerrainUniforms;
+
 // LOD Manager (manages multiple chunk tables)
 typedef struct {
     ChunkTable* lod_levels;
     int num_lods;
-    GLuint terrain_shader;
+    Shader terrain_shader;
+    TerrainUniforms uniforms;
     GLuint terrain_texture;
 } TerrainLODManagerGL;
 
@@ -69,10 +79,14 @@ typedef struct {
 TerrainSeed terrain_seed_create(int seed);
 float terrain_get_height(float x, float z, const TerrainSeed* seed);
 
+// Height of the rendered terrain surface at world (x, z), in world units.
+// Accounts for the chunk layout (x/z swap, PREC/(PREC+1) spacing, SCALE)
+float terrain_get_world_height(float x, float z, const TerrainSeed* seed);
+
 ChunkTable chunk_table_create(unsigned int range, float scale, float h);
 void chunk_table_gen_buffers(ChunkTable* ct);
 void chunk_table_add_chunk(ChunkTable* ct, unsigned int index, const ChunkMesh* mesh, int x, int z);
-void chunk_table_draw(ChunkTable* ct, GLuint shader_program, float* view_matrix, float* proj_matrix);
+void chunk_table_draw(ChunkTable* ct, Shader* shader);
 void chunk_table_cleanup(ChunkTable* ct);
 
 ChunkMesh chunk_create(const TerrainSeed* seed, int chunkx, int chunkz, float maxheight, float chunkscale);
@@ -81,24 +95,28 @@ void chunk_mesh_free(ChunkMesh* mesh);
 TerrainLODManagerGL terrain_lod_manager_create(const TerrainSeed* seed);
 void terrain_lod_manager_generate_all(TerrainLODManagerGL* lod, const TerrainSeed* seed, int center_x, int center_z);
 void terrain_lod_manager_update(TerrainLODManagerGL* lod, const TerrainSeed* seed, float camera_x, float camera_z);
-void terrain_lod_manager_render(TerrainLODManagerGL* lod, float* view, float* proj, 
-                                float camera_x, float camera_y, float camera_z, float time);
+void terrain_lod_manager_render(TerrainLODManagerGL* lod);
 void terrain_lod_manager_cleanup(TerrainLODManagerGL* lod);
 
 // Water rendering (instanced quads like original)
+typedef struct {
+    ShaderUniform transform, range, scale;
+    ShaderUniform watermaps;
+} WaterUniforms;
+
 typedef struct {
     GLuint vao;
     GLuint vbo;
     GLuint ibo;
-    GLuint shader;
+    Shader shader;
+    WaterUniforms uniforms;
     GLuint texture;  // watermaps texture for normal mapping
     int range;
     float scale;
 } WaterManagerGL;
 
 WaterManagerGL water_manager_init(void);
-void water_render_gl(WaterManagerGL* water, float* persp, float* view, 
-                     float camera_x, float camera_y, float camera_z, float time);
+void water_render_gl(WaterManagerGL* water, float camera_x, float camera_z);
 void water_cleanup_gl(WaterManagerGL* water);
 
 // Skybox rendering (cubemap like original)
@@ -106,13 +124,14 @@ typedef struct {
     GLuint vao;
     GLuint vbo;
     GLuint ibo;
-    GLuint shader;
+    Shader shader;
+    ShaderUniform skybox_uniform;
     GLuint cubemap_texture;
 } SkyboxGL;
 
 SkyboxGL skybox_init(void);
 GLuint load_cubemap(const char* faces[6]);
-void skybox_render(SkyboxGL* skybox, float* persp, float* view);
+void skybox_render(SkyboxGL* skybox);
 void skybox_cleanup(SkyboxGL* skybox);
 
 #endif // TERRAIN_WORLD_H
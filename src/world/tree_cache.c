@@ -0,0 +1,130 @@
+#include "tree_cache.h"
+#include "../file_ops.h"
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define TREE_CACHE_MAGIC 0x45455254u  // "TREE"
+
+// On-disk header, followed by vertex data then index data
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t vertex_count;
+    uint32_t index_count;
+    float min[3];
+    float max[3];
+} TreeCacheHeader;
+
+uint64_t tree_cache_key(const char* tag, const char* str, float angle, float length,
+                        float thickness, float decrease_amt, unsigned int detail) {
+    uint64_t h = FNV1A_BASIS;
+    uint32_t version = TREE_CACHE_VERSION;
+
+    h = fnv1a(h, &version, sizeof(version));
+    h = fnv1a(h, tag, strlen(tag) + 1);
+    if (str) h = fnv1a(h, str, strlen(str));
+    h = fnv1a(h, "", 1);
+    h = fnv1a(h, &angle, sizeof(angle));
+    h = fnv1a(h, &length, sizeof(length));
+    h = fnv1a(h, &thickness, sizeof(thickness));
+    h = fnv1a(h, &decrease_amt, sizeof(decrease_amt));
+    h = fnv1a(h, &detail, sizeof(detail));
+
+    return h;
+}
+
+static void tree_cache_path(uint64_t key, char* out, size_t out_size) {
+    snprintf(out, out_size, "%s/%016llx.tree", TREE_CACHE_DIR, (unsigned long long)key);
+}
+
+static size_t blob_size(uint32_t vertex_count, uint32_t index_count) {
+    return sizeof(TreeCacheHeader) +
+           (size_t)vertex_count * MESH_BUILDER_STRIDE * sizeof(float) +
+           (size_t)index_count * sizeof(unsigned int);
+}
+
+bool tree_cache_open(uint64_t key, TreeCacheBlob* blob) {
+    char path[256];
+    tree_cache_path(key, path, sizeof(path));
+
+    memset(blob, 0, sizeof(*blob));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TreeCacheHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    const TreeCacheHeader* header = (const TreeCacheHeader*)mapping;
+    if (header->magic != TREE_CACHE_MAGIC || header->version != TREE_CACHE_VERSION ||
+        header->key != key ||
+        blob_size(header->vertex_count, header->index_count) != (size_t)st.st_size) {
+        printf("Stale tree cache entry: %s\n", path);
+        munmap(mapping, (size_t)st.st_size);
+        return false;
+    }
+
+    blob->mapping = mapping;
+    blob->mapping_size = (size_t)st.st_size;
+    blob->vertex_count = header->vertex_count;
+    blob->index_count = header->index_count;
+    memcpy(blob->min, header->min, sizeof(blob->min));
+    memcpy(blob->max, header->max, sizeof(blob->max));
+    blob->vertices = (const float*)(header + 1);
+    blob->indices = (const unsigned int*)(blob->vertices + (size_t)header->vertex_count * MESH_BUILDER_STRIDE);
+
+    return true;
+}
+
+void tree_cache_close(TreeCacheBlob* blob) {
+    if (blob->mapping) {
+        munmap(blob->mapping, blob->mapping_size);
+    }
+    memset(blob, 0, sizeof(*blob));
+}
+
+bool tree_cache_store(uint64_t key, const MeshBuilder* builder) {
+    if (!ensure_cache_dir(TREE_CACHE_DIR)) return false;
+
+    char path[256];
+    tree_cache_path(key, path, sizeof(path));
+
+    TreeCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = TREE_CACHE_MAGIC;
+    header.version = TREE_CACHE_VERSION;
+    header.key = key;
+    header.vertex_count = builder->vertex_count;
+    header.index_count = builder->index_count;
+    memcpy(header.min, builder->min, sizeof(header.min));
+    memcpy(header.max, builder->max, sizeof(header.max));
+
+    FILE* file = cache_write_begin(path);
+    if (!file) {
+        fprintf(stderr, "Failed to write tree cache: %s\n", path);
+        return false;
+    }
+
+    size_t vertex_floats = (size_t)builder->vertex_count * MESH_BUILDER_STRIDE;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(builder->vertices, sizeof(float), vertex_floats, file) == vertex_floats &&
+              fwrite(builder->indices, sizeof(unsigned int), builder->index_count, file) == builder->index_count;
+    if (!cache_write_end(file, path, ok)) {
+        fprintf(stderr, "Failed to write tree cache: %s\n", path);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,43 @@
+#ifndef TREE_CACHE_H
+#define TREE_CACHE_H
+
+#include "mesh_utils.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Baked procedural tree cache
+// Generated tree meshes are written to TREE_CACHE_DIR as compact binary blobs
+// named after a hash of their generation parameters. On later runs the blob
+// is mmap'd and handed straight to the GPU instead of re-running the L-System.
+//
+// Bump TREE_CACHE_VERSION whenever the generator output changes so that old
+// blobs are treated as stale and regenerated.
+#define TREE_CACHE_DIR "cache/trees"
+#define TREE_CACHE_VERSION 2
+
+// Read-only view of a baked tree (pointers into the mapped file)
+typedef struct {
+    void* mapping;
+    size_t mapping_size;
+
+    const float* vertices;        // Interleaved, MESH_BUILDER_STRIDE floats per vertex
+    const unsigned int* indices;
+    unsigned int vertex_count;
+    unsigned int index_count;
+    float min[3];
+    float max[3];
+} TreeCacheBlob;
+
+// Key from generator tag, L-System string (may be NULL) and parameters
+uint64_t tree_cache_key(const char* tag, const char* str, float angle, float length,
+                        float thickness, float decrease_amt, unsigned int detail);
+
+// Map a baked tree; returns false on miss or stale/corrupt blob
+bool tree_cache_open(uint64_t key, TreeCacheBlob* blob);
+void tree_cache_close(TreeCacheBlob* blob);
+
+// Bake builder contents for key (overwrites stale blobs)
+bool tree_cache_store(uint64_t key, const MeshBuilder* builder);
+
+#endif // TREE_CACHE_H
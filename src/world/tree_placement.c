@@ -8,6 +8,15 @@
 // Terrain height scale (same as used in terrain rendering)
 #define TERRAIN_MAX_HEIGHT (HEIGHT * SCALE)
 
+// Simplified detail levels generated for the OBJ tree
+#define TREE_MODEL_LOD_COUNT 3
+
+// Entities fetched per duplicate check (a 5 unit probe rarely touches more than one)
+#define TREE_DUPLICATE_QUERY_MAX 16
+
+// Candidates per height sampling job
+#define TREE_HEIGHT_MIN_BATCH 8
+
 // Simple hash function for deterministic tree placement
 static unsigned int hash_position(int x, int z, int seed) {
     unsigned int h = seed;
@@ -56,6 +65,13 @@ static void get_tree_offset(int grid_x, int grid_z, int seed, float* offset_x, f
     *offset_z = (hash_to_float(h2) - 0.5f) * TREE_GRID_SIZE * 0.8f;
 }
 
+// Trees placed while the model was loading have empty bounds
+static void tree_placement_model_ready(Model* model, void* user) {
+    TreePlacementManager* manager = user;
+    entity_manager_model_changed(manager->entity_manager, model);
+    printf("Tree model loaded: %u meshes\n", model->mesh_count);
+}
+
 TreePlacementManager* tree_placement_create(EntityManager* entity_manager,
                                            const TerrainSeed* terrain_seed,
                                            int placement_seed) {
@@ -65,16 +81,18 @@ TreePlacementManager* tree_placement_create(EntityManager* entity_manager,
     manager->entity_manager = entity_manager;
     manager->terrain_seed = terrain_seed;
     manager->placement_seed = placement_seed;
+    manager->jobs = NULL;
+    manager->candidates = NULL;
+    manager->candidate_capacity = 0;
     // manager->last_camera_x = 0.0f;
     // manager->last_camera_z = 0.0f;
 
-    // Load tree model from OBJ file
+    // Load tree model from OBJ file; trees are placed (and drawn once it lands) meanwhile
     printf("Loading tree model from OBJ...\n");
-    manager->tree_model = model_load("assets/models/Tree.obj");
+    manager->tree_model = model_load_async("assets/models/Tree.obj", TREE_MODEL_LOD_COUNT,
+                                           tree_placement_model_ready, manager);
     
-    if (manager->tree_model) {
-        printf("Tree model loaded: %u meshes\n", manager->tree_model->mesh_count);
-    } else {
+    if (!manager->tree_model) {
         printf("ERROR: Failed to load tree model!\n");
     }
 
@@ -83,6 +101,30 @@ TreePlacementManager* tree_placement_create(EntityManager* entity_manager,
     return manager;
 }
 
+// Terrain height under each candidate, with the same clamp as the terrain mesh
+static void tree_placement_sample_heights(void* data, unsigned int begin, unsigned int end) {
+    TreePlacementManager* manager = data;
+
+    for (unsigned int c = begin; c < end; c++) {
+        TreeCandidate* candidate = &manager->candidates[c];
+
+        // Get terrain height at this position (normalized -1 to 1)
+        float height_normalized = terrain_get_height(candidate->world_x, candidate->world_z,
+                                                     manager->terrain_seed);
+
+        // Convert to actual world height (same scaling as terrain shader)
+        float world_y = height_normalized * TERRAIN_MAX_HEIGHT;
+
+        // Apply same min height logic as terrain (from terrain.c)
+        if (world_y <= 0.0f)
+            world_y = fminf(-0.007f * TERRAIN_MAX_HEIGHT, world_y);
+        else
+            world_y = fmaxf(0.007f * TERRAIN_MAX_HEIGHT, world_y);
+
+        candidate->world_y = world_y;
+    }
+}
+
 void tree_placement_update(TreePlacementManager* manager, float camera_x, float camera_z) {
     if (!manager->tree_model) return;
 
@@ -92,9 +134,14 @@ void tree_placement_update(TreePlacementManager* manager, float camera_x, float
     int min_grid_z = (int)floor((camera_z - TREE_RENDER_RANGE) / TREE_GRID_SIZE);
     int max_grid_z = (int)ceil((camera_z + TREE_RENDER_RANGE) / TREE_GRID_SIZE);
 
-    int trees_spawned = 0;
+    unsigned int max_candidates = (unsigned int)((max_grid_x - min_grid_x + 1) * (max_grid_z - min_grid_z + 1));
+    if (max_candidates > manager->candidate_capacity) {
+        manager->candidate_capacity = max_candidates;
+        manager->candidates = realloc(manager->candidates, sizeof(TreeCandidate) * max_candidates);
+    }
 
-    // Iterate through grid cells in range
+    // Gather grid cells in range that should hold a tree (cheap hashes only)
+    unsigned int candidate_count = 0;
     for (int grid_x = min_grid_x; grid_x <= max_grid_x; grid_x++) {
         for (int grid_z = min_grid_z; grid_z <= max_grid_z; grid_z++) {
             // Check if tree should exist at this position
@@ -126,72 +173,89 @@ void tree_placement_update(TreePlacementManager* manager, float camera_x, float
                 continue;
             }
 
-            // Get terrain height at this position (normalized -1 to 1)
-            float height_normalized = terrain_get_height(world_x, world_z, manager->terrain_seed);
-            
-            // Convert to actual world height (same scaling as terrain shader)
-            float world_y = height_normalized * TERRAIN_MAX_HEIGHT;
-            
-            // Apply same min height logic as terrain (from terrain.c)
-            if (world_y <= 0.0f)
-                world_y = fminf(-0.007f * TERRAIN_MAX_HEIGHT, world_y);
-            else
-                world_y = fmaxf(0.007f * TERRAIN_MAX_HEIGHT, world_y);
-
-            // Don't place trees underwater (water is at y=0) or on very low terrain
-            if (world_y < 10.0f) {
-                continue;
-            }
+            TreeCandidate* candidate = &manager->candidates[candidate_count++];
+            candidate->grid_x = grid_x;
+            candidate->grid_z = grid_z;
+            candidate->world_x = world_x;
+            candidate->world_z = world_z;
+        }
+    }
 
-            // Check if tree already exists at this position
-            bool already_exists = false;
-            for (unsigned int i = 0; i < manager->entity_manager->entity_count; i++) {
-                Entity* entity = &manager->entity_manager->entities[i];
-                if (entity->type != ENTITY_TYPE_PROP) continue;
-
-                float ex = entity->position[0];
-                float ez = entity->position[2];
-                float edx = ex - world_x;
-                float edz = ez - world_z;
-
-                // If there's an entity within 5 units, assume it's this tree
-                if (edx * edx + edz * edz < 25.0f) {
-                    already_exists = true;
-                    break;
-                }
-            }
+    // Noise sampling is the expensive part and touches no shared state
+    job_system_parallel_for(manager->jobs, candidate_count, TREE_HEIGHT_MIN_BATCH,
+                            tree_placement_sample_heights, manager);
 
-            if (already_exists) {
-                continue;
-            }
+    // Spawning mutates the entity manager, so it stays on this thread
+    int trees_spawned = 0;
+    for (unsigned int c = 0; c < candidate_count; c++) {
+        const TreeCandidate* candidate = &manager->candidates[c];
+        int grid_x = candidate->grid_x;
+        int grid_z = candidate->grid_z;
+        float world_x = candidate->world_x;
+        float world_y = candidate->world_y;
+        float world_z = candidate->world_z;
+
+        // Don't place trees underwater (water is at y=0) or on very low terrain
+        if (world_y < 10.0f) {
+            continue;
+        }
 
-            // Limit spawning per frame to avoid lag
-            if (trees_spawned >= MAX_TREES_PER_UPDATE) {
-                continue;
-            }
-            
-            // Limit total trees to prevent memory issues
-            if (manager->entity_manager->entity_count > 200) {
-                continue;
+        // Check if tree already exists at this position
+        bool already_exists = false;
+        EntityManager* entities = manager->entity_manager;
+        float probe[3] = {world_x, world_y, world_z};
+        EntityHandle nearby[TREE_DUPLICATE_QUERY_MAX];
+        unsigned int nearby_count = entity_manager_query_radius(entities, probe, 5.0f,
+                                                                nearby, TREE_DUPLICATE_QUERY_MAX);
+        if (nearby_count > TREE_DUPLICATE_QUERY_MAX) nearby_count = TREE_DUPLICATE_QUERY_MAX;
+
+        for (unsigned int n = 0; n < nearby_count; n++) {
+            unsigned int i;
+            if (!entity_manager_lookup(entities, nearby[n], &i)) continue;
+            if (entities->types[i] != ENTITY_TYPE_PROP) continue;
+
+            float ex = entities->positions[i][0];
+            float ez = entities->positions[i][2];
+            float edx = ex - world_x;
+            float edz = ez - world_z;
+
+            // If there's an entity within 5 units, assume it's this tree
+            if (edx * edx + edz * edz < 25.0f) {
+                already_exists = true;
+                break;
             }
+        }
 
-            // Get tree properties
-            float scale = get_tree_scale(grid_x, grid_z, manager->placement_seed);
-            float rotation_y = get_tree_rotation(grid_x, grid_z, manager->placement_seed);
-
-            // Create tree entity
-            Entity* tree = entity_manager_create_entity(
-                manager->entity_manager,
-                ENTITY_TYPE_PROP,
-                manager->tree_model,
-                (float[]){world_x, world_y, world_z},
-                (float[]){0.0f, rotation_y, 0.0f},
-                (float[]){scale, scale, scale}
-            );
-
-            if (tree) {
-                trees_spawned++;
-            }
+        if (already_exists) {
+            continue;
+        }
+
+        // Limit spawning per frame to avoid lag
+        if (trees_spawned >= MAX_TREES_PER_UPDATE) {
+            continue;
+        }
+        
+        // Limit total trees to prevent memory issues
+        if (manager->entity_manager->entity_count > 200) {
+            continue;
+        }
+
+        // Get tree properties
+        float scale = get_tree_scale(grid_x, grid_z, manager->placement_seed);
+        float rotation_y = get_tree_rotation(grid_x, grid_z, manager->placement_seed);
+
+        // Create tree entity
+        EntityHandle tree = entity_manager_create_entity(
+            manager->entity_manager,
+            ENTITY_TYPE_PROP,
+            manager->tree_model,
+            (float[]){world_x, world_y, world_z},
+            (float[]){0.0f, rotation_y, 0.0f},
+            (float[]){scale, scale, scale}
+        );
+
+        if (!entity_handle_is_null(tree)) {
+            trees_spawned++;
         }
     }
 
@@ -206,6 +270,7 @@ void tree_placement_cleanup(TreePlacementManager* manager) {
     if (manager->tree_model) {
         model_free(manager->tree_model);
     }
+    free(manager->candidates);
 
     free(manager);
 }
@@ -10,6 +10,12 @@
 #define TREE_RENDER_RANGE 400.0f   // Maximum distance to render trees
 #define MAX_TREES_PER_UPDATE 5     // Limit trees spawned per frame
 
+// Grid point that passed the density and range checks this update
+typedef struct {
+    int grid_x, grid_z;
+    float world_x, world_y, world_z;
+} TreeCandidate;
+
 // Tree placement manager
 typedef struct {
     EntityManager* entity_manager;
@@ -22,6 +28,11 @@ typedef struct {
 
     // Seed for deterministic placement
     int placement_seed;
+
+    // Candidates whose terrain height is sampled on the job pool
+    JobSystem* jobs;
+    TreeCandidate* candidates;
+    unsigned int candidate_capacity;
 } TreePlacementManager;
 
 // Initialize tree placement system
@@ -1,4 +1,6 @@
 #include "trees.h"
+#include "tree_cache.h"
+#include "../graphics/mesh_optimize.h"
 #include "../math/math_ops.h"
 #include <stdlib.h>
 #include <string.h>
@@ -13,6 +15,9 @@
 #define FMAX(a, b) ((a) > (b) ? (a) : (b))
 #define IMAX(a, b) ((a) > (b) ? (a) : (b))
 
+// Lowest detail a LOD level is generated at (cone/frustum need at least 3 sides)
+#define TREE_MIN_LOD_DETAIL 3
+
 // ============================================================================
 // Branch Properties (transformation state for L-System interpretation)
 // ============================================================================
@@ -106,173 +111,222 @@ char* lsystem_generate(unsigned int iterations, const char* axiom, const char* r
 }
 
 // ============================================================================
-// Branch Mesh Generation
+// Branch Part Templates
 // ============================================================================
 
-static ProceduralMesh create_branch_segment(BranchProperties* branch, float thickness,
-                                   float decrease_amt, float length,
+// Every part of a tree is an affine copy of a handful of primitives, so the
+// primitives are generated once and appended in place into a MeshBuilder.
+typedef struct {
+    ProceduralMesh branch_end;  // Bark cone (texcoords already in bark region)
+    ProceduralMesh leaves;      // Leaf plane (texcoords already in leaf region)
+    ProceduralMesh* segments;   // Bark frustum per depth (radii depend on depth)
+    unsigned int segment_count;
+
+    float thickness;
+    float decrease_amt;
+    float length;
+    unsigned int detail;
+    int leaf_count;
+} TreeParts;
+
+// Bark occupies the left half of the tree texture, leaves the right half
+static void bark_texcoord_transform(float* out, float scale_v) {
+    float translate[16], scale[16];
+    mat4_translate(translate, 0.01f, 0.0f, 0.0f);
+    mat4_scale(scale, 0.48f, scale_v, 1.0f);
+    mat4_multiply(out, translate, scale);
+}
+
+static void leaf_texcoord_transform(float* out) {
+    float translate[16], scale[16];
+    mat4_translate(translate, 0.51f, 0.0f, 0.0f);
+    mat4_scale(scale, 0.48f, 1.0f, 1.0f);
+    mat4_multiply(out, translate, scale);
+}
+
+static TreeParts tree_parts_create(float thickness, float decrease_amt, float length,
                                    unsigned int detail) {
-    float radius1 = FMAX(thickness - decrease_amt * (float)branch->depth, 0.01f);
-    float radius2 = FMAX(thickness - decrease_amt * (float)(branch->depth + 1), 0.01f);
+    TreeParts parts;
+    parts.thickness = thickness;
+    parts.decrease_amt = decrease_amt;
+    parts.length = length;
+    parts.detail = detail;
+    parts.leaf_count = IMAX((2 * (int)detail) / 3 - 1, 1);
+    parts.segments = NULL;
+    parts.segment_count = 0;
+
+    float tc[16];
+    parts.branch_end = mesh_create_cone_type1(detail);
+    bark_texcoord_transform(tc, 2.0f);
+    mesh_transform_texcoords(&parts.branch_end, tc);
+
+    parts.leaves = mesh_create_plane(IMAX((int)detail / 2 - 2, 0));
+    leaf_texcoord_transform(tc);
+    mesh_transform_texcoords(&parts.leaves, tc);
+
+    return parts;
+}
 
-    ProceduralMesh segment = mesh_create_frustum(detail, radius1, radius2);
+static void tree_parts_free(TreeParts* parts) {
+    mesh_free(&parts->branch_end);
+    mesh_free(&parts->leaves);
+    for (unsigned int i = 0; i < parts->segment_count; i++) {
+        mesh_free(&parts->segments[i]);
+    }
+    free(parts->segments);
+    parts->segments = NULL;
+    parts->segment_count = 0;
+}
 
-    // Transform texture coordinates (bark texture is left half)
-    float tc_transform[16];
-    mat4_identity(tc_transform);
-    mat4_translate(tc_transform, 0.01f, 0.0f, 0.0f);
-    float scale_mat[16];
-    mat4_identity(scale_mat);
-    mat4_scale(scale_mat, 0.48f, 2.0f, 1.0f);
-    float tc_final[16];
-    mat4_multiply(tc_transform, scale_mat, tc_final);
-    mesh_transform_texcoords(&segment, tc_final);
+// Frustum templates are created lazily, one per branch depth
+static const ProceduralMesh* tree_parts_segment(TreeParts* parts, unsigned int depth) {
+    if (depth >= parts->segment_count) {
+        unsigned int new_count = depth + 1;
+        parts->segments = realloc(parts->segments, new_count * sizeof(ProceduralMesh));
+
+        float tc[16];
+        bark_texcoord_transform(tc, 2.0f);
 
+        for (unsigned int d = parts->segment_count; d < new_count; d++) {
+            float radius1 = FMAX(parts->thickness - parts->decrease_amt * (float)d, 0.01f);
+            float radius2 = FMAX(parts->thickness - parts->decrease_amt * (float)(d + 1), 0.01f);
+            parts->segments[d] = mesh_create_frustum(parts->detail, radius1, radius2);
+            mesh_transform_texcoords(&parts->segments[d], tc);
+        }
+        parts->segment_count = new_count;
+    }
+    return &parts->segments[depth];
+}
+
+// ============================================================================
+// Branch Mesh Generation
+// ============================================================================
+
+static void append_branch_segment(MeshBuilder* builder, TreeParts* parts, BranchProperties* branch) {
     // Scale to desired length (frustum has height 1.0 by default)
     float scale_height[16];
-    mat4_identity(scale_height);
-    mat4_scale(scale_height, 1.0f, length, 1.0f);
+    mat4_scale(scale_height, 1.0f, parts->length, 1.0f);
 
     // Combine transformations: translation * branch_transform * scale
     float translate[16];
-    mat4_identity(translate);
     mat4_translate(translate, branch->position[0], branch->position[1], branch->position[2]);
 
     float temp[16], final_transform[16];
-    mat4_multiply(branch->transform, scale_height, temp);
-    mat4_multiply(translate, temp, final_transform);
-
-    mesh_transform(&segment, final_transform);
+    mat4_multiply(temp, branch->transform, scale_height);
+    mat4_multiply(final_transform, translate, temp);
 
-    return segment;
+    mesh_builder_append(builder, tree_parts_segment(parts, branch->depth), final_transform, NULL);
 }
 
-static ProceduralMesh create_branch_end(BranchProperties* branch, float thickness,
-                               float decrease_amt, float length,
-                               unsigned int detail) {
-    ProceduralMesh end_segment = mesh_create_cone_type1(detail);
+static void append_branch_end(MeshBuilder* builder, TreeParts* parts, BranchProperties* branch) {
+    float length = parts->length;
 
-    // Transform texture coordinates (bark)
-    float tc_transform[16];
-    mat4_identity(tc_transform);
-    mat4_translate(tc_transform, 0.01f, 0.0f, 0.0f);
-    float scale_mat[16];
-    mat4_identity(scale_mat);
-    mat4_scale(scale_mat, 0.48f, 2.0f, 1.0f);
-    float tc_final[16];
-    mat4_multiply(tc_transform, scale_mat, tc_final);
-    mesh_transform_texcoords(&end_segment, tc_final);
-
-    // Scale cone
-    float radius = FMAX(thickness - decrease_amt * (float)branch->depth, 0.01f);
+    // Cone: translation * branch_transform * scale
+    float radius = FMAX(parts->thickness - parts->decrease_amt * (float)branch->depth, 0.01f);
     float scale_cone[16];
-    mat4_identity(scale_cone);
     mat4_scale(scale_cone, radius, length, radius);
-    mesh_transform(&end_segment, scale_cone);
 
-    // Transform to position
     float translate[16];
-    mat4_identity(translate);
     mat4_translate(translate, branch->position[0], branch->position[1], branch->position[2]);
 
-    float final_transform[16];
-    mat4_multiply(translate, branch->transform, final_transform);
-    mesh_transform(&end_segment, final_transform);
+    float temp[16], final_transform[16];
+    mat4_multiply(temp, branch->transform, scale_cone);
+    mat4_multiply(final_transform, translate, temp);
+    mesh_builder_append(builder, &parts->branch_end, final_transform, NULL);
 
     // Add leaves
     float scale = 1.0f;
     if (branch->depth <= 2)
         scale = 0.5f;
 
-    // Leaf texture coordinates (right half of texture)
-    mat4_identity(tc_transform);
-    mat4_translate(tc_transform, 0.51f, 0.0f, 0.0f);
-    mat4_identity(scale_mat);
-    mat4_scale(scale_mat, 0.48f, 1.0f, 1.0f);
-    mat4_multiply(tc_transform, scale_mat, tc_final);
-
-    int leaf_count = IMAX((2 * (int)detail) / 3 - 1, 1);
-    int leaf_detail = IMAX((int)detail / 2 - 2, 0);
+    // Calculate offset
+    float offset_vec[3];
+    offset_vec[0] = branch->transform[4] * length * (1.0f - scale);
+    offset_vec[1] = branch->transform[5] * length * (1.0f - scale);
+    offset_vec[2] = branch->transform[6] * length * (1.0f - scale);
 
-    for (int i = 0; i < leaf_count; i++) {
-        ProceduralMesh leaves = mesh_create_plane(leaf_detail);
-        mesh_transform_texcoords(&leaves, tc_final);
+    float scale_leaf[16];
+    mat4_scale(scale_leaf, scale, scale, scale);
 
-        // Calculate offset
-        float offset_vec[3];
-        offset_vec[0] = branch->transform[4] * length;
-        offset_vec[1] = branch->transform[5] * length;
-        offset_vec[2] = branch->transform[6] * length;
+    float translate_up[16];
+    mat4_translate(translate_up, 0.0f, 1.0f, 0.0f);
 
-        offset_vec[0] *= (1.0f - scale);
-        offset_vec[1] *= (1.0f - scale);
-        offset_vec[2] *= (1.0f - scale);
+    float translate_pos[16];
+    mat4_translate(translate_pos,
+                  branch->position[0] + offset_vec[0],
+                  branch->position[1] + offset_vec[1],
+                  branch->position[2] + offset_vec[2]);
 
-        // Build leaf transformation
+    for (int i = 0; i < parts->leaf_count; i++) {
         float rotation[16];
-        mat4_identity(rotation);
         mat4_rotate_y(rotation, (120.0f * M_PI / 180.0f) * (float)i);
 
-        float scale_leaf[16];
-        mat4_identity(scale_leaf);
-        mat4_scale(scale_leaf, scale, scale, scale);
-
-        float translate_up[16];
-        mat4_identity(translate_up);
-        mat4_translate(translate_up, 0.0f, 1.0f, 0.0f);
-
-        float translate_pos[16];
-        mat4_identity(translate_pos);
-        mat4_translate(translate_pos,
-                      branch->position[0] + offset_vec[0],
-                      branch->position[1] + offset_vec[1],
-                      branch->position[2] + offset_vec[2]);
-
         // Combine: translate_pos * branch_transform * rotation * scale * translate_up
         float temp1[16], temp2[16], temp3[16], temp4[16];
-        mat4_multiply(rotation, scale_leaf, temp1);
-        mat4_multiply(temp1, translate_up, temp2);
-        mat4_multiply(branch->transform, temp2, temp3);
-        mat4_multiply(translate_pos, temp3, temp4);
+        mat4_multiply(temp1, rotation, scale_leaf);
+        mat4_multiply(temp2, temp1, translate_up);
+        mat4_multiply(temp3, branch->transform, temp2);
+        mat4_multiply(temp4, translate_pos, temp3);
 
-        mesh_transform(&leaves, temp4);
+        mesh_builder_append(builder, &parts->leaves, temp4, NULL);
+    }
+}
 
-        ProceduralMesh merged = mesh_merge(&end_segment, &leaves);
-        mesh_free(&end_segment);
-        mesh_free(&leaves);
-        end_segment = merged;
+// Dry run over the L-System string: exact vertex/index counts for the builder
+static void tree_count_geometry(const char* str, const TreeParts* parts,
+                                unsigned int* out_vertices, unsigned int* out_indices) {
+    // Frustum vertex/index counts do not depend on the radii
+    unsigned int segment_vertices = parts->detail * 2;
+    unsigned int segment_indices = parts->detail * 6;
+    unsigned int end_vertices = parts->branch_end.vertex_count +
+                                parts->leaves.vertex_count * parts->leaf_count;
+    unsigned int end_indices = parts->branch_end.index_count +
+                               parts->leaves.index_count * parts->leaf_count;
+
+    unsigned int vertices = 0;
+    unsigned int indices = 0;
+
+    for (size_t i = 0; str[i] != '\0'; i++) {
+        if (str[i] != 'F') continue;
+
+        if (str[i + 1] == '\0' || str[i + 1] == ']') {
+            vertices += end_vertices;
+            indices += end_indices;
+        } else {
+            vertices += segment_vertices;
+            indices += segment_indices;
+        }
     }
 
-    return end_segment;
+    *out_vertices = vertices;
+    *out_indices = indices;
 }
 
 // ============================================================================
 // L-System String Interpreter
 // ============================================================================
 
-Model* tree_create_from_string(const char* str, float angle, float length,
-                                float thickness, float decrease_amt,
-                                unsigned int detail) {
+static void tree_build_from_string(MeshBuilder* builder, const char* str, float angle, float length,
+                                   float thickness, float decrease_amt, unsigned int detail) {
     // Rotation matrices for each command
     float rot_x_pos[16], rot_x_neg[16];
     float rot_y_pos[16];
     float rot_z_pos[16], rot_z_neg[16];
 
-    mat4_identity(rot_x_pos);
     mat4_rotate_x(rot_x_pos, angle);
-
-    mat4_identity(rot_x_neg);
     mat4_rotate_x(rot_x_neg, -angle);
-
-    mat4_identity(rot_y_pos);
     mat4_rotate_y(rot_y_pos, angle);
-
-    mat4_identity(rot_z_pos);
     mat4_rotate_z(rot_z_pos, angle);
-
-    mat4_identity(rot_z_neg);
     mat4_rotate_z(rot_z_neg, -angle);
 
+    TreeParts parts = tree_parts_create(thickness, decrease_amt, length, detail);
+
+    // Size the builder once so appends never reallocate
+    unsigned int vertex_count, index_count;
+    tree_count_geometry(str, &parts, &vertex_count, &index_count);
+    mesh_builder_reserve(builder, builder->vertex_count + vertex_count,
+                         builder->index_count + index_count);
+
     // Initialize branch stack
     BranchStack branch_stack = stack_create(64);
 
@@ -282,52 +336,26 @@ Model* tree_create_from_string(const char* str, float angle, float length,
     branch.position[0] = branch.position[1] = branch.position[2] = 0.0f;
     branch.depth = 0;
 
-    // Accumulate meshes
-    ProceduralMesh plant = mesh_create(1024);
     size_t str_len = strlen(str);
 
     for (size_t i = 0; i < str_len; i++) {
         char ch = str[i];
-        ProceduralMesh tree_part;
-        bool has_part = false;
-
-        // Check for rotation commands
-        if (ch == '<') {
-            float temp[16];
-            mat4_multiply(branch.transform, rot_x_pos, temp);
-            memcpy(branch.transform, temp, sizeof(float) * 16);
-            continue;
-        } else if (ch == '>') {
-            float temp[16];
-            mat4_multiply(branch.transform, rot_x_neg, temp);
-            memcpy(branch.transform, temp, sizeof(float) * 16);
-            continue;
-        } else if (ch == '&') {
-            float temp[16];
-            mat4_multiply(branch.transform, rot_y_pos, temp);
-            memcpy(branch.transform, temp, sizeof(float) * 16);
-            continue;
-        } else if (ch == '+') {
-            float temp[16];
-            mat4_multiply(branch.transform, rot_z_pos, temp);
-            memcpy(branch.transform, temp, sizeof(float) * 16);
-            continue;
-        } else if (ch == '-') {
-            float temp[16];
-            mat4_multiply(branch.transform, rot_z_neg, temp);
-            memcpy(branch.transform, temp, sizeof(float) * 16);
-            continue;
-        }
+        const float* rotation = NULL;
 
         switch (ch) {
+        case '<': rotation = rot_x_pos; break;
+        case '>': rotation = rot_x_neg; break;
+        case '&': rotation = rot_y_pos; break;
+        case '+': rotation = rot_z_pos; break;
+        case '-': rotation = rot_z_neg; break;
+
         case 'F':
             // Check if this is a terminal branch (end of string or before ])
             if (i == str_len - 1 || str[i + 1] == ']') {
-                tree_part = create_branch_end(&branch, thickness, decrease_amt, length, detail);
+                append_branch_end(builder, &parts, &branch);
             } else {
-                tree_part = create_branch_segment(&branch, thickness, decrease_amt, length, detail);
+                append_branch_segment(builder, &parts, &branch);
             }
-            has_part = true;
 
             // Update position (move forward along Y in local space)
             branch.position[0] += branch.transform[4] * length;
@@ -348,82 +376,105 @@ Model* tree_create_from_string(const char* str, float angle, float length,
             break;
         }
 
-        // Merge the part into the plant
-        if (has_part) {
-            ProceduralMesh merged = mesh_merge(&plant, &tree_part);
-            mesh_free(&plant);
-            mesh_free(&tree_part);
-            plant = merged;
+        if (rotation) {
+            float temp[16];
+            mat4_multiply(temp, branch.transform, rotation);
+            memcpy(branch.transform, temp, sizeof(float) * 16);
         }
     }
 
     stack_free(&branch_stack);
+    tree_parts_free(&parts);
+}
 
-    printf("Tree mesh generated: %u vertices, %u indices\n", plant.vertex_count, plant.index_count);
-
-    // Convert mesh to Model
+// Upload interleaved vertex data as a single-mesh Model
+static Model* tree_model_create(const float* vertices, unsigned int vertex_count,
+                                const unsigned int* indices, unsigned int index_count,
+                                const float* min, const float* max, const char* name) {
     Model* model = malloc(sizeof(Model));
+    memset(model, 0, sizeof(Model));
+
     model->mesh_count = 1;
     model->meshes = malloc(sizeof(Mesh));
+    memset(model->meshes, 0, sizeof(Mesh));
 
-    // Create single mesh with the plant data
-    Mesh* final_mesh = &model->meshes[0];
-
-    // Generate VAO/VBO/IBO
-    glGenVertexArrays(1, &final_mesh->vao);
-    glGenBuffers(1, &final_mesh->vbo);
-    glGenBuffers(1, &final_mesh->ibo);
-
-    glBindVertexArray(final_mesh->vao);
-
-    // Interleave vertex data: pos(3) + normal(3) + texcoord(2) = 8 floats per vertex
-    float* interleaved = malloc(plant.vertex_count * 8 * sizeof(float));
-    for (unsigned int i = 0; i < plant.vertex_count; i++) {
-        interleaved[i * 8 + 0] = plant.vertices[i * 3 + 0];
-        interleaved[i * 8 + 1] = plant.vertices[i * 3 + 1];
-        interleaved[i * 8 + 2] = plant.vertices[i * 3 + 2];
-        interleaved[i * 8 + 3] = plant.normals[i * 3 + 0];
-        interleaved[i * 8 + 4] = plant.normals[i * 3 + 1];
-        interleaved[i * 8 + 5] = plant.normals[i * 3 + 2];
-        interleaved[i * 8 + 6] = plant.texcoords[i * 2 + 0];
-        interleaved[i * 8 + 7] = plant.texcoords[i * 2 + 1];
-    }
+    mesh_upload(&model->meshes[0], vertices, vertex_count, indices, index_count);
+    model->meshes[0].material = NULL;  // Will be set by caller
 
-    glBindBuffer(GL_ARRAY_BUFFER, final_mesh->vbo);
-    glBufferData(GL_ARRAY_BUFFER, plant.vertex_count * 8 * sizeof(float),
-                 interleaved, GL_STATIC_DRAW);
+    model->material_count = 0;
+    model->materials = NULL;
+    strncpy(model->name, name, sizeof(model->name) - 1);
+    strcpy(model->filepath, "");
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, final_mesh->ibo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, plant.index_count * sizeof(unsigned int),
-                 plant.indices, GL_STATIC_DRAW);
+    memcpy(model->min, min, sizeof(model->min));
+    memcpy(model->max, max, sizeof(model->max));
 
-    // Set attribute pointers
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    return model;
+}
 
-    glBindVertexArray(0);
+// Create the Model from builder contents and bake it for the next run
+static Model* tree_model_from_builder(uint64_t key, MeshBuilder* builder, const char* name) {
+    // Reorder for the vertex cache, overdraw and vertex fetch before baking
+    float acmr_before = mesh_acmr(builder->indices, builder->index_count, builder->vertex_count, MESH_CACHE_SIZE);
+    builder->vertex_count = mesh_optimize(builder->vertices, builder->indices, builder->index_count,
+                                          builder->vertex_count, MESH_BUILDER_STRIDE);
+    float acmr_after = mesh_acmr(builder->indices, builder->index_count, builder->vertex_count, MESH_CACHE_SIZE);
+    printf("Tree mesh optimized: ACMR %.2f -> %.2f\n", acmr_before, acmr_after);
+
+    tree_cache_store(key, builder);
+    return tree_model_create(builder->vertices, builder->vertex_count,
+                             builder->indices, builder->index_count,
+                             builder->min, builder->max, name);
+}
 
-    free(interleaved);
+// Upload a baked tree straight from the mapped cache file (NULL on miss)
+static Model* tree_model_from_cache(uint64_t key, const char* name) {
+    TreeCacheBlob blob;
+    if (!tree_cache_open(key, &blob)) return NULL;
 
-    final_mesh->vertex_count = plant.vertex_count;
-    final_mesh->index_count = plant.index_count;
-    final_mesh->material = NULL;  // Will be set by caller
+    Model* model = tree_model_create(blob.vertices, blob.vertex_count,
+                                     blob.indices, blob.index_count,
+                                     blob.min, blob.max, name);
+    printf("Tree mesh loaded from cache: %u vertices, %u indices\n", blob.vertex_count, blob.index_count);
 
-    mesh_free(&plant);
+    tree_cache_close(&blob);
+    return model;
+}
 
-    // Initialize model metadata
-    model->material_count = 0;
-    model->materials = NULL;
-    strcpy(model->name, "procedural_tree");
-    strcpy(model->filepath, "");
+static Model* tree_level_from_string(const char* str, float angle, float length,
+                                     float thickness, float decrease_amt,
+                                     unsigned int detail) {
+    uint64_t key = tree_cache_key("lsystem", str, angle, length, thickness, decrease_amt, detail);
+    Model* model = tree_model_from_cache(key, "procedural_tree");
+    if (model) return model;
+
+    MeshBuilder builder = mesh_builder_create(0, 0);
+    tree_build_from_string(&builder, str, angle, length, thickness, decrease_amt, detail);
 
-    // Bounding box (approximate)
-    model->min[0] = model->min[1] = model->min[2] = -5.0f;
-    model->max[0] = model->max[1] = model->max[2] = 5.0f;
+    printf("Tree mesh generated: %u vertices, %u indices\n", builder.vertex_count, builder.index_count);
+
+    model = tree_model_from_builder(key, &builder, "procedural_tree");
+    mesh_builder_free(&builder);
+
+    return model;
+}
+
+// Detail of the next coarser level, or 0 when the chain should stop
+static unsigned int tree_next_lod_detail(Model* model, unsigned int detail) {
+    if (model->lod_count >= MODEL_MAX_LODS) return 0;
+    unsigned int next = detail / 2;
+    return next >= TREE_MIN_LOD_DETAIL && next < detail ? next : 0;
+}
+
+Model* tree_create_from_string(const char* str, float angle, float length,
+                                float thickness, float decrease_amt,
+                                unsigned int detail) {
+    Model* model = tree_level_from_string(str, angle, length, thickness, decrease_amt, detail);
+
+    // Coarser levels regenerate the same string with fewer sides per segment
+    for (unsigned int d = tree_next_lod_detail(model, detail); d; d = tree_next_lod_detail(model, d)) {
+        model_add_lod(model, tree_level_from_string(str, angle, length, thickness, decrease_amt, d));
+    }
 
     return model;
 }
@@ -432,7 +483,7 @@ Model* tree_create_from_string(const char* str, float angle, float length,
 // Predefined Tree Generators
 // ============================================================================
 
-Model* tree_create_generic(unsigned int detail) {
+static Model* tree_level_generic(unsigned int detail) {
     const float ANGLE = 30.0f * M_PI / 180.0f;
     const float LENGTH = 0.8f;
     const float THICKNESS = 0.15f;
@@ -441,7 +492,17 @@ Model* tree_create_generic(unsigned int detail) {
     const char* RULE = "F[&&>F]F[--F][&&&&-F][&&&&&&&&-F]";
 
     char* str = lsystem_generate(ITERATIONS, "F", RULE);
-    Model* tree_model = tree_create_from_string(str, ANGLE, LENGTH, THICKNESS, DECREASE, detail);
+
+    // The trunk base is part of the "generic" output, hence its own tag
+    uint64_t key = tree_cache_key("generic", str, ANGLE, LENGTH, THICKNESS, DECREASE, detail);
+    Model* tree_model = tree_model_from_cache(key, "procedural_tree");
+    if (tree_model) {
+        free(str);
+        return tree_model;
+    }
+
+    MeshBuilder builder = mesh_builder_create(0, 0);
+    tree_build_from_string(&builder, str, ANGLE, LENGTH, THICKNESS, DECREASE, detail);
     free(str);
 
     // Add trunk base if detail is high enough
@@ -449,172 +510,110 @@ Model* tree_create_generic(unsigned int detail) {
         ProceduralMesh trunk_base = mesh_create_frustum(detail, THICKNESS, THICKNESS);
 
         float translate[16];
-        mat4_identity(translate);
         mat4_translate(translate, 0.0f, -1.0f, 0.0f);
-        mesh_transform(&trunk_base, translate);
-
-        // Transform texture coordinates
-        float tc_transform[16];
-        mat4_identity(tc_transform);
-        mat4_translate(tc_transform, 0.01f, 0.0f, 0.0f);
-        float scale_mat[16];
-        mat4_identity(scale_mat);
-        mat4_scale(scale_mat, 0.48f, 8.0f / 5.0f, 1.0f);
+
         float tc_final[16];
-        mat4_multiply(tc_transform, scale_mat, tc_final);
-        mesh_transform_texcoords(&trunk_base, tc_final);
+        bark_texcoord_transform(tc_final, 8.0f / 5.0f);
 
-        // Merge with existing tree (would need to rebuild model)
-        // For simplicity, we'll skip this for now
+        mesh_builder_append(&builder, &trunk_base, translate, tc_final);
         mesh_free(&trunk_base);
     }
 
+    printf("Tree mesh generated: %u vertices, %u indices\n", builder.vertex_count, builder.index_count);
+
+    tree_model = tree_model_from_builder(key, &builder, "procedural_tree");
+    mesh_builder_free(&builder);
+
     return tree_model;
 }
 
-Model* tree_create_pine(unsigned int detail) {
-    ProceduralMesh pine_tree = mesh_create(1024);
+static Model* tree_level_pine(unsigned int detail) {
+    uint64_t key = tree_cache_key("pine", NULL, 0.0f, 5.0f, 0.3f, 0.0f, detail);
+    Model* model = tree_model_from_cache(key, "pine_tree");
+    if (model) return model;
 
     // Generate trunk (cone)
     ProceduralMesh trunk = mesh_create_cone_type1(detail);
+    ProceduralMesh bottom = mesh_create_frustum(detail, 0.3f, 0.3f);
+    ProceduralMesh part = mesh_create_cone_type2(detail);
+
+    // Trunk + optional base + 4 foliage cones
+    MeshBuilder builder = mesh_builder_create(
+        trunk.vertex_count + bottom.vertex_count + part.vertex_count * 4,
+        trunk.index_count + bottom.index_count + part.index_count * 4);
+
     float scale_trunk[16];
-    mat4_identity(scale_trunk);
     mat4_scale(scale_trunk, 0.3f, 5.0f, 0.3f);
-    mesh_transform(&trunk, scale_trunk);
 
     // Transform texture coordinates
     float tc_transform[16];
-    mat4_identity(tc_transform);
     mat4_scale(tc_transform, 0.5f, 8.0f, 1.0f);
-    mesh_transform_texcoords(&trunk, tc_transform);
 
-    pine_tree = mesh_merge(&pine_tree, &trunk);
+    mesh_builder_append(&builder, &trunk, scale_trunk, tc_transform);
     mesh_free(&trunk);
 
     // Add trunk base if detail > 4
     if (detail > 4) {
-        ProceduralMesh bottom = mesh_create_frustum(detail, 0.3f, 0.3f);
         float translate[16];
-        mat4_identity(translate);
         mat4_translate(translate, 0.0f, -1.0f, 0.0f);
-        mesh_transform(&bottom, translate);
 
-        mat4_identity(tc_transform);
-        mat4_translate(tc_transform, 0.01f, 0.0f, 0.0f);
-        float scale_mat[16];
-        mat4_identity(scale_mat);
-        mat4_scale(scale_mat, 0.48f, 8.0f / 5.0f, 1.0f);
         float tc_final[16];
-        mat4_multiply(tc_transform, scale_mat, tc_final);
-        mesh_transform_texcoords(&bottom, tc_final);
+        bark_texcoord_transform(tc_final, 8.0f / 5.0f);
 
-        ProceduralMesh merged = mesh_merge(&pine_tree, &bottom);
-        mesh_free(&pine_tree);
-        mesh_free(&bottom);
-        pine_tree = merged;
+        mesh_builder_append(&builder, &bottom, translate, tc_final);
     }
+    mesh_free(&bottom);
 
     // Generate foliage (stacked cones)
     float top_y = 5.0f;
-    mat4_identity(tc_transform);
-    mat4_translate(tc_transform, 0.51f, 0.02f, 0.0f);
-    float scale_mat[16];
-    mat4_identity(scale_mat);
+    float translate_tc[16], scale_mat[16], tc_final[16];
+    mat4_translate(translate_tc, 0.51f, 0.02f, 0.0f);
     mat4_scale(scale_mat, 0.48f, 0.96f, 1.0f);
-    float tc_final[16];
-    mat4_multiply(tc_transform, scale_mat, tc_final);
+    mat4_multiply(tc_final, translate_tc, scale_mat);
 
     for (int i = 0; i < 4; i++) {
-        ProceduralMesh part = mesh_create_cone_type2(detail);
         float scale = 0.75f + 0.25f * powf(1.5f, (float)i);
         float height = 1.6f + 0.2f * (float)i;
 
         float transform[16];
-        mat4_identity(transform);
         mat4_translate(transform, 0.0f, top_y - height, 0.0f);
 
         float scale_part[16];
-        mat4_identity(scale_part);
         mat4_scale(scale_part, scale, height, scale);
 
         float rotation[16];
-        mat4_identity(rotation);
         mat4_rotate_y(rotation, (M_PI / 16.0f) * (float)i);
 
         float temp1[16], temp2[16];
-        mat4_multiply(transform, rotation, temp1);
-        mat4_multiply(temp1, scale_part, temp2);
-
-        mesh_transform(&part, temp2);
-        mesh_transform_texcoords(&part, tc_final);
+        mat4_multiply(temp1, transform, rotation);
+        mat4_multiply(temp2, temp1, scale_part);
 
-        ProceduralMesh merged = mesh_merge(&pine_tree, &part);
-        mesh_free(&pine_tree);
-        mesh_free(&part);
-        pine_tree = merged;
+        mesh_builder_append(&builder, &part, temp2, tc_final);
 
         top_y -= scale * 0.6f;
     }
+    mesh_free(&part);
 
-    printf("Pine tree mesh generated: %u vertices, %u indices\n", pine_tree.vertex_count, pine_tree.index_count);
-
-    // Convert to Model
-    Model* model = malloc(sizeof(Model));
-    model->mesh_count = 1;
-    model->meshes = malloc(sizeof(Mesh));
-
-    Mesh* final_mesh = &model->meshes[0];
-
-    glGenVertexArrays(1, &final_mesh->vao);
-    glGenBuffers(1, &final_mesh->vbo);
-    glGenBuffers(1, &final_mesh->ibo);
-
-    glBindVertexArray(final_mesh->vao);
-
-    // Interleave vertex data
-    float* interleaved = malloc(pine_tree.vertex_count * 8 * sizeof(float));
-    for (unsigned int i = 0; i < pine_tree.vertex_count; i++) {
-        interleaved[i * 8 + 0] = pine_tree.vertices[i * 3 + 0];
-        interleaved[i * 8 + 1] = pine_tree.vertices[i * 3 + 1];
-        interleaved[i * 8 + 2] = pine_tree.vertices[i * 3 + 2];
-        interleaved[i * 8 + 3] = pine_tree.normals[i * 3 + 0];
-        interleaved[i * 8 + 4] = pine_tree.normals[i * 3 + 1];
-        interleaved[i * 8 + 5] = pine_tree.normals[i * 3 + 2];
-        interleaved[i * 8 + 6] = pine_tree.texcoords[i * 2 + 0];
-        interleaved[i * 8 + 7] = pine_tree.texcoords[i * 2 + 1];
-    }
-
-    glBindBuffer(GL_ARRAY_BUFFER, final_mesh->vbo);
-    glBufferData(GL_ARRAY_BUFFER, pine_tree.vertex_count * 8 * sizeof(float),
-                 interleaved, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, final_mesh->ibo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, pine_tree.index_count * sizeof(unsigned int),
-                 pine_tree.indices, GL_STATIC_DRAW);
+    printf("Pine tree mesh generated: %u vertices, %u indices\n", builder.vertex_count, builder.index_count);
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    model = tree_model_from_builder(key, &builder, "pine_tree");
+    mesh_builder_free(&builder);
 
-    glBindVertexArray(0);
-
-    free(interleaved);
-
-    final_mesh->vertex_count = pine_tree.vertex_count;
-    final_mesh->index_count = pine_tree.index_count;
-    final_mesh->material = NULL;
-
-    mesh_free(&pine_tree);
+    return model;
+}
 
-    model->material_count = 0;
-    model->materials = NULL;
-    strcpy(model->name, "pine_tree");
-    strcpy(model->filepath, "");
-    model->min[0] = model->min[1] = model->min[2] = -5.0f;
-    model->max[0] = model->max[1] = model->max[2] = 5.0f;
+Model* tree_create_generic(unsigned int detail) {
+    Model* model = tree_level_generic(detail);
+    for (unsigned int d = tree_next_lod_detail(model, detail); d; d = tree_next_lod_detail(model, d)) {
+        model_add_lod(model, tree_level_generic(d));
+    }
+    return model;
+}
 
+Model* tree_create_pine(unsigned int detail) {
+    Model* model = tree_level_pine(detail);
+    for (unsigned int d = tree_next_lod_detail(model, detail); d; d = tree_next_lod_detail(model, d)) {
+        model_add_lod(model, tree_level_pine(d));
+    }
     return model;
 }
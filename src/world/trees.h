@@ -30,6 +30,7 @@ char* lsystem_generate(unsigned int iterations, const char* axiom, const char* r
 // thickness: starting thickness at the base
 // decrease_amt: how much thickness decreases per depth level
 // detail: polygon detail for meshes (higher = more vertices)
+// The returned model carries coarser LOD levels built at halved detail.
 Model* tree_create_from_string(const char* str, float angle, float length,
                                 float thickness, float decrease_amt,
                                 unsigned int detail);
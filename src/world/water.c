@@ -47,7 +47,13 @@ WaterManagerGL water_manager_init(void) {
     // Load water shader (simplified version - watersimplefrag.glsl)
     const char* water_vert = load_shader_source("assets/shaders/instancedvert.glsl");
     const char* water_frag = load_shader_source("assets/shaders/waterfrag.glsl"); 
-    water.shader = shader_compile(water_vert, water_frag);
+    water.shader = shader_create(water_vert, water_frag, "water");
+
+    WaterUniforms* u = &water.uniforms;
+    u->transform = shader_uniform(&water.shader, "transform");
+    u->range = shader_uniform(&water.shader, "range");
+    u->scale = shader_uniform(&water.shader, "scale");
+    u->watermaps = shader_uniform(&water.shader, "watermaps");
     
     // Load watermaps texture for normal mapping
     water.texture = texture_load("assets/textures/watermaps.png");
@@ -58,9 +64,10 @@ WaterManagerGL water_manager_init(void) {
     return water;
 }
 
-void water_render_gl(WaterManagerGL* water, float* persp, float* view, 
-                     float camera_x, float camera_y, float camera_z, float time) {
-    glUseProgram(water->shader);
+void water_render_gl(WaterManagerGL* water, float camera_x, float camera_z) {
+    Shader* shader = &water->shader;
+    const WaterUniforms* u = &water->uniforms;
+    shader_use(shader);
 
     // Unbind any textures from entity rendering to prevent them from being used by water shader
     glActiveTexture(GL_TEXTURE0);
@@ -71,12 +78,9 @@ void water_render_gl(WaterManagerGL* water, float* persp, float* view,
     // Bind watermaps texture
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, water->texture);
-    glUniform1i(glGetUniformLocation(water->shader, "watermaps"), 0);
+    shader_uniform_int(shader, u->watermaps, 0);
 
-    // Uniforms
-    glUniformMatrix4fv(glGetUniformLocation(water->shader, "persp"), 1, GL_FALSE, persp);
-    glUniformMatrix4fv(glGetUniformLocation(water->shader, "view"), 1, GL_FALSE, view);
-    
+    // Uniforms (camera, light, fog and time come from the FrameData block)
     // Like original display.cpp line 67: water follows camera position directly
     // transform = translate(camera.x, 0, camera.z) * scale(quadscale)
     float transform[16] = {
@@ -85,14 +89,10 @@ void water_render_gl(WaterManagerGL* water, float* persp, float* view,
         0, 0, water->scale, 0,
         camera_x, 0, camera_z, 1
     };
-    glUniformMatrix4fv(glGetUniformLocation(water->shader, "transform"), 1, GL_FALSE, transform);
+    shader_uniform_mat4(shader, u->transform, transform);
     
-    glUniform1i(glGetUniformLocation(water->shader, "range"), water->range);
-    glUniform1f(glGetUniformLocation(water->shader, "scale"), water->scale);
-    glUniform3f(glGetUniformLocation(water->shader, "lightdir"), -0.57735f, -0.57735f, -0.57735f);
-    glUniform3f(glGetUniformLocation(water->shader, "camerapos"), camera_x, camera_y, camera_z);
-    glUniform1f(glGetUniformLocation(water->shader, "viewdist"), 10000.0f);
-    glUniform1f(glGetUniformLocation(water->shader, "time"), time);
+    shader_uniform_int(shader, u->range, water->range);
+    shader_uniform_float(shader, u->scale, water->scale);
 
     // Draw instanced
     glBindVertexArray(water->vao);
@@ -107,8 +107,6 @@ void water_cleanup_gl(WaterManagerGL* water) {
     glDeleteVertexArrays(1, &water->vao);
     glDeleteBuffers(1, &water->vbo);
     glDeleteBuffers(1, &water->ibo);
-    glDeleteProgram(water->shader);
-    if (water->texture > 0) {
-        glDeleteTextures(1, &water->texture);
-    }
+    shader_destroy(&water->shader);
+    texture_release(water->texture);
 }
@@ -0,0 +1,54 @@
+// Offline model cooker: bakes OBJ models into cooked .cmdl files
+// (see src/entities/model_cook.h). Files whose cooked copy is up to date are
+// skipped, so `make model-cook` only re-cooks what changed.
+//
+// Usage: model_cook model.obj...
+
+#define _POSIX_C_SOURCE 199309L
+#include "../src/entities/model_cook.h"
+#include <stdio.h>
+#include <time.h>
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s model.obj...\n", argv[0]);
+        return 1;
+    }
+
+    int failed = 0;
+    for (int i = 1; i < argc; i++) {
+        const char* obj_path = argv[i];
+        char cooked_path[MODEL_PATH_MAX];
+        model_cook_path(obj_path, cooked_path, sizeof(cooked_path));
+
+        ModelCookBlob blob;
+        if (model_cook_open(obj_path, &blob)) {
+            model_cook_close(&blob);
+            printf("Up to date: %s\n", cooked_path);
+            continue;
+        }
+
+        double start = now_ms();
+        ModelData data;
+        if (!model_data_load_obj(obj_path, &data)) {
+            failed++;
+            continue;
+        }
+
+        if (model_cook_write(obj_path, &data)) {
+            printf("Cooked %s -> %s (%u meshes, %u materials) in %.1f ms\n",
+                   obj_path, cooked_path, data.mesh_count, data.material_count, now_ms() - start);
+        } else {
+            failed++;
+        }
+        model_data_free(&data);
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,76 @@
+// Offline texture cooker: encodes images with their mip chains into cooked
+// .ctex files (see src/graphics/texture_cook.h). Files whose cooked copy is
+// up to date are skipped, so `make texture-cook` only re-cooks what changed.
+//
+// Usage: texture_cook image...
+
+#define _POSIX_C_SOURCE 199309L
+#include "../src/graphics/texture_cook.h"
+#include <stb_image/stb_image.h>
+#include <stdio.h>
+#include <time.h>
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s image...\n", argv[0]);
+        return 1;
+    }
+
+    int failed = 0;
+    size_t total_source = 0, total_cooked = 0;
+    for (int i = 1; i < argc; i++) {
+        const char* image_path = argv[i];
+        char cooked_path[256];
+        texture_cook_path(image_path, cooked_path, sizeof(cooked_path));
+
+        TextureCookBlob blob;
+        if (texture_cook_open(image_path, &blob)) {
+            texture_cook_close(&blob);
+            printf("Up to date: %s\n", cooked_path);
+            continue;
+        }
+
+        double start = now_ms();
+        int width, height, channels;
+        unsigned char* pixels = stbi_load(image_path, &width, &height, &channels, 4);
+        if (!pixels) {
+            fprintf(stderr, "Failed to load texture: %s\n", image_path);
+            failed++;
+            continue;
+        }
+
+        bool has_alpha = false;
+        if (channels == 2 || channels == 4) {
+            for (size_t t = 0; t < (size_t)width * height && !has_alpha; t++) {
+                has_alpha = pixels[t * 4 + 3] < 255;
+            }
+        }
+
+        TextureCookFormat format = texture_cook_choose_format(image_path, has_alpha);
+        size_t encoded = 0;
+        if (texture_cook_write(image_path, pixels, (unsigned int)width, (unsigned int)height, format, &encoded)) {
+            // What the runtime path used to upload: level 0 at 4 bytes per texel plus mips
+            size_t uncompressed = (size_t)width * height * 4 * 4 / 3;
+            printf("Cooked %s -> %s (%s, %dx%d) %.1f KB (%.1f KB uncompressed) in %.1f ms\n",
+                   image_path, cooked_path, texture_cook_format_name(format), width, height,
+                   encoded / 1024.0, uncompressed / 1024.0, now_ms() - start);
+            total_source += uncompressed;
+            total_cooked += encoded;
+        } else {
+            failed++;
+        }
+        stbi_image_free(pixels);
+    }
+
+    if (total_cooked > 0) {
+        printf("Cooked %.1f MB of textures into %.1f MB\n",
+               total_source / (1024.0 * 1024.0), total_cooked / (1024.0 * 1024.0));
+    }
+    return failed ? 1 : 0;
+}